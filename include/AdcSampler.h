@@ -0,0 +1,51 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+
+// Kanały ADC1 w trybie ciągłym (DMA, sterownik adc_digi z ESP-IDF 4.4):
+// przetwornik próbkuje kolejne kanały wzorca bez udziału CPU, update()
+// odbiera wszystkie próbki z bufora i uśrednia je dla każdego kanału
+// (nadpróbkowanie - średnia z ułamkiem LSB). Średnia przeliczana na mV
+// z kalibracją fabryczną (eFuse), interpolacją między sąsiednimi kodami.
+// ADC1 zajęty przez DMA - analogRead() na tych pinach już nie działa.
+// Wywołania z jednego zadania (zadanie czujników).
+class AdcSampler {
+    public:
+        static const uint8_t MAX_CHANNELS = 4;
+        static const uint32_t SAMPLE_RATE_HZ = 20000;   // Najniższa dla ESP32 w trybie ciągłym
+        static const uint32_t FRAME_BYTES = 256;        // Próbki na przerwanie DMA
+        static const uint32_t BUFFER_BYTES = 6144;      // ~150 ms próbek - więcej niż okres zadania czujników
+        static const uint32_t DEFAULT_VREF_MV = 1100;   // Bez kalibracji w eFuse
+
+        // Numer kanału lub -1 (pin bez ADC1); przed begin()
+        int8_t addChannel(uint8_t pin);
+        bool begin();
+        void update();
+
+        // Średnia z próbek odebranych w ostatnim update(); false - brak próbek
+        bool getMillivolts(uint8_t channel, float& millivolts) const;
+        uint16_t getSampleCount(uint8_t channel) const { return channels[channel].samples; }
+        uint32_t getOverflows() const { return overflows; }   // Zadanie nie zdążyło odebrać próbek
+
+    private:
+        struct Channel {
+            uint8_t pin;
+            uint8_t adcChannel;
+            uint32_t rawSum;
+            uint16_t samples;
+            float millivolts;
+        };
+
+        Channel channels[MAX_CHANNELS] = {};
+        uint8_t channelCount = 0;
+        bool running = false;
+        uint32_t overflows = 0;
+        esp_adc_cal_characteristics_t calibration = {};
+
+        float toMillivolts(uint32_t rawSum, uint16_t samples) const;
+};
+
+#endif // ADC_SAMPLER_H
@@ -0,0 +1,78 @@
+#ifndef BMS_REQUEST_PIPELINE_H
+#define BMS_REQUEST_PIPELINE_H
+
+#include <Arduino.h>
+
+// Statystyki pojedynczego zapytania do BMS
+struct BmsCommandStats {
+    uint32_t sent;             // Wysłane zapytania
+    uint32_t received;         // Otrzymane odpowiedzi
+    uint32_t timeouts;         // Zapytania bez odpowiedzi
+    uint32_t lastLatencyMs;    // Ostatni czas odpowiedzi [ms]
+    uint32_t minLatencyMs;     // Najkrótszy czas odpowiedzi [ms]
+    uint32_t maxLatencyMs;     // Najdłuższy czas odpowiedzi [ms]
+    uint32_t totalLatencyMs;   // Suma czasów (do średniej)
+};
+
+// Nieblokująca maszyna stanów wysyłająca kolejne zapytania JBD:
+// następne zapytanie idzie dopiero po odpowiedzi na poprzednie albo po
+// przekroczeniu czasu, cały cykl powtarzany co cycleIntervalMs
+class BmsRequestPipeline {
+    public:
+        typedef bool (*SendFunction)(const uint8_t* command, size_t length);
+        static const uint8_t MAX_COMMANDS = 4;
+
+    private:
+        enum State {
+            IDLE,       // Oczekiwanie na kolejny cykl
+            WAITING     // Oczekiwanie na odpowiedź na bieżące zapytanie
+        };
+
+        struct Command {
+            const uint8_t* data;
+            size_t length;
+            uint8_t code;          // Kod rejestru JBD (3. bajt ramki)
+            BmsCommandStats stats;
+        };
+
+        Command commands[MAX_COMMANDS];
+        uint8_t commandCount = 0;
+        SendFunction sendFunction;
+
+        State state = IDLE;
+        uint8_t current = 0;
+        bool cycleStarted = false;
+        unsigned long cycleStartTime = 0;
+        unsigned long sentTime = 0;
+        const unsigned long cycleInterval;
+        const unsigned long responseTimeout;
+        uint32_t completedCycles = 0;
+
+        // Metody pomocnicze
+        void sendCurrent(unsigned long now);
+        void advance(unsigned long now);
+
+    public:
+        BmsRequestPipeline(SendFunction send, unsigned long cycleIntervalMs, unsigned long responseTimeoutMs);
+
+        // Konfiguracja
+        bool addCommand(const uint8_t* command, size_t length);
+
+        // Wywoływane cyklicznie z zadania BLE
+        void update(unsigned long now);
+
+        // Wywoływane po zdekodowaniu odpowiedzi o danym kodzie
+        void onResponse(uint8_t code, unsigned long now);
+
+        // Przerwanie bieżącego cyklu (np. po rozłączeniu)
+        void reset();
+
+        // Gettery
+        bool isBusy() const;
+        uint32_t getCompletedCycles() const;
+        uint8_t getCommandCount() const;
+        uint8_t getCommandCode(uint8_t index) const;
+        BmsCommandStats getStats(uint8_t index) const;
+};
+
+#endif // BMS_REQUEST_PIPELINE_H
@@ -0,0 +1,48 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+// Fazy startu w kolejności typowego przebiegu
+enum BootPhase : uint8_t {
+    BOOT_DISPLAY,       // I2C i inicjalizacja OLED
+    BOOT_RTC,           // Odczyt zegara DS3231
+    BOOT_RESTORE,       // Odtworzenie stanu z pamięci RTC (tylko szybkie wznowienie)
+    BOOT_BUTTON_HOLD,   // Potwierdzenie włączenia przytrzymaniem SET po wybudzeniu
+    BOOT_FIRST_FRAME,   // Pierwsza klatka ekranu głównego
+    BOOT_TEMP_SENSORS,  // DS18B20
+    BOOT_STORAGE,       // LittleFS, konfiguracja, zapis przejazdu
+    BOOT_SENSORS,       // Licznik kilometrów, czujniki prędkości i kadencji
+    BOOT_BLE,           // Inicjalizacja BLE
+    BOOT_READY,         // Koniec inicjalizacji, zadania czujników i BLE ruszają
+    BOOT_PHASE_COUNT
+};
+
+// Czasy faz startu liczone od startu aplikacji (esp_timer_get_time()).
+// Czas ROM i bootloadera przed aplikacją nie jest wliczany - także po
+// wybudzeniu, więc to nie jest pełny czas od naciśnięcia przycisku.
+// Zapisywany jest koniec fazy; fazy z różnych zadań trafiają do osobnych
+// pól, więc nie potrzeba blokady.
+class BootProfile {
+    private:
+        volatile uint32_t phaseUs[BOOT_PHASE_COUNT];  // 0 - faza pominięta
+        bool fastResume = false;
+
+    public:
+        BootProfile();
+
+        // Koniec fazy (zapisywane tylko pierwsze wywołanie w danym starcie)
+        void mark(BootPhase phase);
+        void setFastResume(bool value) { fastResume = value; }
+
+        // Raport tekstowy (log startowy i polecenie "boot" na porcie szeregowym)
+        void printReport(Print& out) const;
+
+        // Gettery
+        bool isFastResume() const { return fastResume; }
+        bool isMarked(BootPhase phase) const { return phaseUs[phase] != 0; }
+        uint32_t getPhaseUs(BootPhase phase) const { return phaseUs[phase]; }
+        static const char* getPhaseName(BootPhase phase);
+};
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,128 @@
+#ifndef BUTTON_ENGINE_H
+#define BUTTON_ENGINE_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+// Gesty rozpoznawane przez silnik przycisków
+enum ButtonGesture : uint8_t {
+    GESTURE_NONE,
+    GESTURE_PRESS,          // Każde wciśnięcie (po eliminacji drgań)
+    GESTURE_CLICK,
+    GESTURE_DOUBLE_CLICK,
+    GESTURE_LONG_PRESS,     // Przytrzymanie - zgłaszane w trakcie, bez czekania na puszczenie
+    GESTURE_CHORD           // Kilka przycisków przytrzymanych razem
+};
+
+struct ButtonEvent {
+    ButtonGesture gesture;
+    uint8_t buttons;        // Maska przycisków (bit = indeks z addButton)
+    uint32_t time;          // millis() zdarzenia
+};
+
+// Przyciski na przerwaniach: przerwanie (CHANGE) wkłada do kolejki tylko
+// numer przycisku i czas zbocza, a process() w zadaniu wejścia usuwa drgania
+// i rozpoznaje gesty automatem opisanym tabelą przejść. Bez zboczy i
+// aktywnych liczników czasu process() nic nie robi.
+class ButtonEngine {
+    public:
+        static const uint8_t MAX_BUTTONS = 4;
+        static const uint8_t QUEUE_LENGTH = 16;
+        static const uint32_t DEBOUNCE_MS = 25;      // Blokada po zboczu (drgania styku)
+        static const uint32_t CHORD_MS = 500;        // Przytrzymanie kombinacji
+
+        typedef void (*EventHandler)(const ButtonEvent& event);
+        typedef void (*WakeCallback)();              // Wywoływane z przerwania
+
+        enum State : uint8_t {
+            STATE_IDLE,
+            STATE_PRESSED,          // Czeka na puszczenie lub długie przytrzymanie
+            STATE_RELEASED,         // Czeka na drugie kliknięcie
+            STATE_SECOND_PRESS,
+            STATE_HELD,             // Długie przytrzymanie zgłoszone
+            STATE_SUPPRESSED        // Gest anulowany - czeka na puszczenie
+        };
+
+        enum Input : uint8_t {
+            INPUT_PRESS,
+            INPUT_RELEASE,
+            INPUT_TIMEOUT,
+            INPUT_CANCEL            // Kombinacja lub suppress()
+        };
+
+        enum Timer : uint8_t {
+            TIMER_NONE,
+            TIMER_LONG,
+            TIMER_DOUBLE
+        };
+
+        struct Transition {
+            State from;
+            Input input;
+            State to;
+            Timer timer;            // Licznik uruchamiany po przejściu
+            ButtonGesture gesture;  // Zgłaszany gest
+        };
+
+    private:
+        struct Button {
+            uint8_t pin;
+            uint16_t longPressMs;
+            uint16_t doubleClickMs;     // 0 - kliknięcie zgłaszane od razu po puszczeniu
+            bool pressed;               // Stan po eliminacji drgań
+            bool settling;              // Trwa blokada po zboczu
+            uint32_t settleUntil;
+            State state;
+            bool timerActive;
+            uint32_t deadline;
+        };
+
+        struct Edge {
+            uint8_t button;
+            uint32_t time;
+        };
+
+        struct IsrContext {
+            ButtonEngine* engine;
+            uint8_t button;
+        };
+
+        static const Transition TRANSITIONS[];
+
+        Button buttons[MAX_BUTTONS];
+        IsrContext isrContexts[MAX_BUTTONS];
+        uint8_t buttonCount = 0;
+        QueueHandle_t edgeQueue = nullptr;
+        volatile bool edgesLost = false;
+        WakeCallback wake = nullptr;
+        EventHandler handler = nullptr;
+
+        uint8_t pressedMask = 0;
+        uint8_t chordMask = 0;
+        uint32_t chordStart = 0;
+        bool chordReported = false;
+
+        static void IRAM_ATTR handleEdge(void* arg);
+        void sample(uint8_t index, uint32_t time);
+        void setPressed(uint8_t index, bool pressed, uint32_t time);
+        void feed(uint8_t index, Input input, uint32_t time);
+        void emit(ButtonGesture gesture, uint8_t mask, uint32_t time);
+
+    public:
+        bool begin(EventHandler eventHandler, WakeCallback wakeCallback = nullptr);
+
+        // Przycisk zwierający pin do GND, zwraca indeks (bit w masce) lub -1
+        int8_t addButton(uint8_t pin, uint16_t longPressMs, uint16_t doubleClickMs = 0);
+
+        // Zdarzenia z kolejki i liczniki czasu (zadanie wejścia)
+        void process(uint32_t now);
+
+        // Anuluje rozpoczęte gesty - przyciski działają ponownie po puszczeniu
+        void suppress(uint32_t now);
+
+        bool isPressed(uint8_t index) const { return index < buttonCount && buttons[index].pressed; }
+        uint8_t getPressedMask() const { return pressedMask; }
+};
+
+#endif // BUTTON_ENGINE_H
@@ -0,0 +1,71 @@
+#ifndef CADENCE_SENSOR_H
+#define CADENCE_SENSOR_H
+
+#include <Arduino.h>
+#include <driver/pcnt.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+// Czujnik kadencji z tarczą PAS (kilka magnesów na obrót korby). Impulsy
+// zlicza sprzętowy licznik PCNT, a wynik liczy timer esp_timer co
+// PUBLISH_INTERVAL_MS - bez udziału zadań programu.
+//  - mała kadencja: okres między dwoma ostatnimi impulsami (przerwanie na
+//    zboczu zapisuje czas), wynik co 1/magnets obrotu
+//  - duża kadencja: przerwanie wyłączone, liczba impulsów z PCNT w oknie 1 s
+class CadenceSensor {
+    public:
+        static const uint32_t PUBLISH_INTERVAL_MS = 250;   // Wynik 4 razy na sekundę
+        static const uint8_t COUNT_WINDOW = 4;             // Okno zliczania: 4 x 250 ms
+        static const uint8_t COUNTING_ENTER_HZ = 20;       // Impulsy/s: przejście na zliczanie
+        static const uint8_t COUNTING_EXIT_HZ = 15;        // Impulsy/s: powrót do pomiaru okresu
+        static const uint8_t MIN_RPM = 10;                 // Wolniej = brak pedałowania
+        static const uint8_t AVERAGE_BUCKETS = 60;         // Średnia z 5 minut pedałowania
+        static const uint8_t AVERAGE_BUCKET_SAMPLES = 20;  // 20 x 250 ms = 5 s na przedział
+        static const int16_t COUNTER_LIMIT = 30000;        // PCNT wraca do zera po tej wartości
+
+    private:
+        uint8_t pin = 0xFF;
+        uint8_t magnets = 1;
+        pcnt_unit_t unit = PCNT_UNIT_0;
+        esp_timer_handle_t timer = nullptr;
+        portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+        // Dane z przerwania (tryb pomiaru okresu)
+        volatile uint32_t lastEdgeUs = 0;
+        volatile uint32_t previousEdgeUs = 0;
+        volatile uint32_t edgeCount = 0;
+
+        // Dane timera
+        bool countingMode = false;
+        int16_t lastCounter = 0;
+        uint16_t windowPulses[COUNT_WINDOW] = {};
+        uint8_t windowIndex = 0;
+
+        struct AverageBucket {
+            uint16_t sum;      // Suma kadencji z próbek z pedałowaniem
+            uint8_t samples;
+        };
+        AverageBucket buckets[AVERAGE_BUCKETS] = {};
+        uint8_t bucketIndex = 0;
+        uint8_t bucketSamples = 0;              // Próbki (także bez pedałowania) w bieżącym przedziale
+
+        // Wyniki
+        volatile uint16_t cadence = 0;
+        volatile uint16_t averageCadence = 0;
+
+        static void IRAM_ATTR handleEdge(void* arg);
+        static void handleTimer(void* arg);
+        void publish();
+        uint16_t measurePeriod(uint32_t nowUs);
+        void setCountingMode(bool enabled);
+        void addToAverage(uint16_t rpm);
+
+    public:
+        bool begin(uint8_t sensorPin, uint8_t magnetCount, pcnt_unit_t counterUnit = PCNT_UNIT_0);
+
+        uint16_t getCadence() const { return cadence; }                 // obr/min
+        uint16_t getAverageCadence() const { return averageCadence; }   // obr/min, tylko pedałowanie
+        bool isCounting() const { return countingMode; }
+};
+
+#endif // CADENCE_SENSOR_H
@@ -0,0 +1,140 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+// Sekcje obrazu konfiguracji - tylko typy o stałym rozmiarze, bez String.
+// Nowe pola dopisuje się na końcu sekcji ConfigData (starszy obraz wczytuje
+// się wtedy z wartościami domyślnymi dla brakujących pól).
+// Tryb świateł - te same wartości co LightSettings::LightMode
+enum ConfigLightMode : uint8_t {
+    LIGHTS_NONE = 0,
+    LIGHTS_FRONT = 1,
+    LIGHTS_REAR = 2,
+    LIGHTS_BOTH = 3
+};
+
+struct __attribute__((packed)) ConfigLights {
+    uint8_t dayLights;          // ConfigLightMode
+    uint8_t nightLights;
+    uint8_t dayBlink;
+    uint8_t nightBlink;
+    uint16_t blinkFrequency;    // [ms]
+};
+
+struct __attribute__((packed)) ConfigBacklight {
+    uint8_t dayBrightness;      // [%]
+    uint8_t nightBrightness;
+    uint8_t autoMode;
+};
+
+struct __attribute__((packed)) ConfigWifi {
+    char ssid[32];
+    char password[64];
+};
+
+enum ConfigControllerType : uint8_t {
+    CONTROLLER_KT_LCD = 0,
+    CONTROLLER_S866 = 1
+};
+
+// Klucze parametrów sterownika w JSON (indeks = numer parametru, 0-20) -
+// bez tworzenia String(i) dla każdego klucza
+extern const char* const PARAM_KEYS[];
+
+struct __attribute__((packed)) ConfigController {
+    uint8_t type;               // ConfigControllerType
+    int16_t ktParams[23];       // P1-P5, C1-C15, L1-L3
+    int16_t s866Params[20];     // P1-P20
+};
+
+struct __attribute__((packed)) ConfigGeneral {
+    uint8_t wheelSize;          // Cale, 0 = 700C
+    uint8_t ntpEnabled;
+};
+
+struct __attribute__((packed)) ConfigBluetooth {
+    uint8_t bmsEnabled;
+    uint8_t tpmsEnabled;
+};
+
+struct __attribute__((packed)) ConfigLightLevels {
+    uint8_t dayBrightness;      // [%] światła w trybie dziennym
+    uint8_t nightBrightness;    // [%] światła w trybie nocnym
+    uint16_t rampMs;            // Płynne włączanie/wyłączanie, 0 - bez
+};
+
+struct __attribute__((packed)) ConfigData {
+    ConfigLights lights;
+    ConfigBacklight backlight;
+    ConfigWifi wifi;
+    ConfigController controller;
+    ConfigGeneral general;
+    ConfigBluetooth bluetooth;
+    ConfigLightLevels lightLevels;
+};
+
+// Nagłówek pliku: CRC-32 liczone z danych o długości length
+struct __attribute__((packed)) ConfigHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;
+    uint32_t crc;
+};
+
+// Cała konfiguracja w jednym pliku binarnym /config.bin, wczytywanym jednym
+// odczytem. Zapis przez plik tymczasowy i zmianę nazwy - po zaniku zasilania
+// zostaje poprzedni poprawny obraz.
+class ConfigStore {
+    public:
+        static const uint32_t MAGIC = 0x43574D50;  // "PMWC"
+        static const uint16_t VERSION = 1;
+
+    private:
+        fs::FS* fs = nullptr;
+        ConfigData data;
+        bool loaded = false;        // Obraz wczytany z pliku (nie domyślny)
+        bool corrupted = false;     // Plik jest, ale obraz odrzucony (CRC, wersja, długość)
+        uint32_t saveErrors = 0;
+        uint32_t loadTimeUs = 0;
+
+        static const char* const PATH;
+        static const char* const TEMP_PATH;
+
+        void setDefaults();
+
+    public:
+        ConfigStore();
+
+        // Wczytanie obrazu; false - brak pliku lub błąd CRC (dane domyślne, isCorrupted())
+        bool begin(fs::FS& fileSystem);
+        bool save();
+
+        bool isLoaded() const { return loaded; }
+        bool isCorrupted() const { return corrupted; }
+        uint32_t getSaveErrors() const { return saveErrors; }
+        uint32_t getLoadTimeUs() const { return loadTimeUs; }
+        static size_t getImageSize() { return sizeof(ConfigHeader) + sizeof(ConfigData); }
+        uint32_t getCrc() const;    // Skrót bieżących ustawień (wykrywanie zmian)
+
+        // Gettery
+        const ConfigLights& lights() const { return data.lights; }
+        const ConfigBacklight& backlight() const { return data.backlight; }
+        const ConfigWifi& wifi() const { return data.wifi; }
+        const ConfigController& controller() const { return data.controller; }
+        const ConfigGeneral& general() const { return data.general; }
+        const ConfigBluetooth& bluetooth() const { return data.bluetooth; }
+        const ConfigLightLevels& lightLevels() const { return data.lightLevels; }
+
+        // Settery (do pliku trafiają po save())
+        void setLights(const ConfigLights& value) { data.lights = value; }
+        void setBacklight(const ConfigBacklight& value) { data.backlight = value; }
+        void setWifi(const ConfigWifi& value) { data.wifi = value; }
+        void setController(const ConfigController& value) { data.controller = value; }
+        void setGeneral(const ConfigGeneral& value) { data.general = value; }
+        void setBluetooth(const ConfigBluetooth& value) { data.bluetooth = value; }
+        void setLightLevels(const ConfigLightLevels& value) { data.lightLevels = value; }
+};
+
+#endif // CONFIG_STORE_H
@@ -0,0 +1,9 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <Arduino.h>
+
+// CRC-32 (IEEE 802.3, jak zlib) dla rekordów zapisywanych we flash
+uint32_t crc32(const void* data, size_t length);
+
+#endif // CRC32_H
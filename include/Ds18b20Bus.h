@@ -0,0 +1,39 @@
+#ifndef DS18B20_BUS_H
+#define DS18B20_BUS_H
+
+#include <Arduino.h>
+#include "RmtOneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+typedef uint8_t DeviceAddress[8];
+
+// Polecenia DS18B20 na magistrali RmtOneWire - nazwy i znaczenie jak w
+// bibliotece DallasTemperature (część używana przez TemperatureEngine).
+// Bez oczekiwania na koniec konwersji i bez zapisu konfiguracji do EEPROM
+// czujnika (po włączeniu zasilania rozdzielczość z EEPROM, fabrycznie 12 bitów).
+class Ds18b20Bus {
+    public:
+        explicit Ds18b20Bus(RmtOneWire* wire) : wire(wire) {}
+
+        bool begin() { return wire->begin(); }
+
+        // Przeszukanie magistrali (tylko przy starcie - kilkaset transakcji)
+        bool getAddress(uint8_t* address, uint8_t index);
+        bool validAddress(const uint8_t* address) const;
+
+        uint8_t getResolution(const uint8_t* address);     // 0 - brak odpowiedzi
+        bool setResolution(const uint8_t* address, uint8_t bits);
+
+        bool requestTemperaturesByAddress(const uint8_t* address);
+        float getTempC(const uint8_t* address);              // DEVICE_DISCONNECTED_C - błąd
+
+        RmtOneWire* getWire() const { return wire; }
+
+    private:
+        RmtOneWire* wire;
+
+        bool readScratchPad(const uint8_t* address, uint8_t* scratchPad);
+};
+
+#endif // DS18B20_BUS_H
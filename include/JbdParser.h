@@ -0,0 +1,110 @@
+#ifndef JBD_PARSER_H
+#define JBD_PARSER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Limity BMS (JBD obsługuje do 32 cel i 8 czujników NTC)
+const uint8_t BMS_MAX_CELLS = 32;
+const uint8_t BMS_MAX_NTC = 8;
+
+// Dane z BMS
+struct BmsData {
+    float voltage;                      // Napięcie całkowite [V]
+    float current;                      // Prąd [A]
+    float remainingCapacity;            // Pozostała pojemność [Ah]
+    float totalCapacity;                // Całkowita pojemność [Ah]
+    uint8_t soc;                        // Stan naładowania [%]
+    uint16_t cycles;                    // Liczba cykli
+    uint16_t protectionStatus;          // Flagi zabezpieczeń
+    uint8_t cellCount;                  // Liczba cel zgłoszona przez BMS
+    float cellVoltages[BMS_MAX_CELLS];  // Napięcia cel [V]
+    uint8_t ntcCount;                   // Liczba czujników NTC
+    float temperatures[BMS_MAX_NTC];    // Temperatury [°C]
+    bool charging;                      // Status ładowania (MOSFET ładowania)
+    bool discharging;                   // Status rozładowania (MOSFET rozładowania)
+};
+
+// Liczniki parsera
+struct JbdParserStats {
+    uint32_t framesOk;         // Poprawnie zdekodowane ramki
+    uint32_t checksumErrors;   // Błędna suma kontrolna
+    uint32_t lengthErrors;     // Niepoprawna długość danych dla rejestru
+    uint32_t endByteErrors;    // Brak bajtu końca ramki (0x77)
+    uint32_t statusErrors;     // BMS zgłosił błąd w odpowiedzi
+    uint32_t unknownCommands;  // Nieobsługiwany rejestr
+    uint32_t timeouts;         // Porzucone niekompletne ramki
+    uint32_t skippedBytes;     // Bajty pominięte przy synchronizacji
+    uint32_t overflows;        // Bajty odrzucone z powodu pełnego bufora
+};
+
+// Bufor pierścieniowy jeden producent / jeden konsument (bez blokad).
+// Producent: callback BLE, konsument: zadanie BLE.
+class JbdRingBuffer {
+    public:
+        static const uint16_t CAPACITY = 512;  // Potęga dwójki
+
+    private:
+        static const uint16_t MASK = CAPACITY - 1;
+        uint8_t buffer[CAPACITY];
+        std::atomic<uint16_t> head;  // Zapis (producent)
+        std::atomic<uint16_t> tail;  // Odczyt (konsument)
+
+    public:
+        JbdRingBuffer() : head(0), tail(0) {}
+
+        // Producent
+        size_t push(const uint8_t* data, size_t length);
+
+        // Konsument
+        size_t available() const;
+        uint8_t peek(size_t offset) const;
+        void consume(size_t count);
+        void clear();
+};
+
+// Przyrostowy parser ramek JBD:
+// 0xDD | rejestr | status | długość | dane... | suma (2B) | 0x77
+// Ramki mogą przychodzić w dowolnych fragmentach (powiadomienia BLE
+// są ograniczone przez MTU). Dekodowanie odbywa się bezpośrednio
+// z bufora pierścieniowego, bez kopiowania ramki.
+class JbdParser {
+    private:
+        static const uint8_t FRAME_START = 0xDD;
+        static const uint8_t FRAME_END = 0x77;
+        static const uint8_t HEADER_SIZE = 4;    // start, rejestr, status, długość
+        static const uint8_t TRAILER_SIZE = 3;   // suma kontrolna, koniec
+        static const uint8_t MAX_DATA_LENGTH = 128;
+
+        JbdRingBuffer ring;
+        JbdParserStats stats;
+        std::atomic<uint32_t> overflowCount;
+        const unsigned long partialTimeout;
+        bool partialPending = false;
+        unsigned long partialSince = 0;
+
+        // Metody pomocnicze
+        uint16_t readU16(size_t offset) const;
+        bool decode(uint8_t command, uint8_t length, BmsData& bms);
+        bool decodeBasicInfo(uint8_t length, BmsData& bms);
+        bool decodeCellInfo(uint8_t length, BmsData& bms);
+        bool decodeTemperatures(uint8_t length, BmsData& bms);
+
+    public:
+        explicit JbdParser(unsigned long partialTimeoutMs = 500);
+
+        // Producent - callback BLE (bez blokad, bez alokacji)
+        void push(const uint8_t* data, size_t length);
+
+        // Konsument - dekoduje jedną kompletną ramkę do bms,
+        // zwraca true i kod rejestru, gdy ramka była poprawna
+        bool poll(BmsData& bms, uint8_t& command, unsigned long now);
+
+        // Odrzucenie zbuforowanych danych (np. po rozłączeniu)
+        void reset();
+
+        // Gettery
+        JbdParserStats getStats() const;
+};
+
+#endif // JBD_PARSER_H
@@ -0,0 +1,27 @@
+#ifndef LEGACY_CONFIG_H
+#define LEGACY_CONFIG_H
+
+#include <FS.h>
+#include "ConfigStore.h"
+
+// Przeniesienie ustawień z dawnych plików JSON do obrazu ConfigStore
+// (pierwsze uruchomienie po aktualizacji z wersji bez /config.bin).
+// Pliki czytane w dawnej kolejności - późniejszy nadpisuje wcześniejszy:
+// config.json, lights.json, display_config.json, general_config.json,
+// bluetooth_config.json. Tryb świateł zapisywano jako liczbę (config.json)
+// albo nazwę "FRONT"/"REAR"/"BOTH" (lights.json).
+class LegacyConfig {
+    public:
+        static const char* const FILES[];
+        static const size_t FILE_COUNT;
+
+        // Odczyt plików do store (bez zapisu obrazu); false - brak wszystkich plików.
+        // Pola nieobecne w plikach zostają z obrazu (domyślne po nieudanym begin()).
+        static bool read(fs::FS& fs, ConfigStore& store);
+
+        // Zapis obrazu i usunięcie dawnych plików - dopiero gdy zapisany
+        // obraz wczytuje się poprawnie (inaczej pliki zostają do następnej próby)
+        static bool commit(fs::FS& fs, ConfigStore& store);
+};
+
+#endif // LEGACY_CONFIG_H
@@ -0,0 +1,70 @@
+#ifndef LIGHT_ENGINE_H
+#define LIGHT_ENGINE_H
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Światła na peryferium LEDC (sterownik z ESP-IDF 4.x). Jasność to PWM
+// z timera PWM_TIMER, zmiany płynne (rampa sprzętowa LEDC, bez zadania).
+// Miganie: kanał przełączany na timer BLINK_TIMER o okresie równym okresowi
+// migania i wypełnieniu 50% - przebieg generuje sprzęt, bez przerwań i bez
+// pętli głównej. Dzielnik z częścią ułamkową (zegar REF_TICK 1 MHz) daje
+// dokładny okres także przy niecałkowitej częstotliwości (np. 700 ms).
+// Migające wyjście świeci z pełną jasnością. Wywołania z wielu zadań
+// (przyciski, serwer WWW) - stan chroniony muteksem.
+class LightEngine {
+    public:
+        enum Output : uint8_t {
+            OUTPUT_FRONT_DAY,
+            OUTPUT_FRONT,
+            OUTPUT_REAR,
+            OUTPUT_COUNT
+        };
+
+        static const uint32_t PWM_FREQUENCY_HZ = 5000;     // Powyżej migotania widocznego w ruchu
+        static const uint8_t PWM_RESOLUTION_BITS = 10;
+        static const uint16_t MIN_BLINK_PERIOD_MS = 100;
+        static const uint16_t MAX_BLINK_PERIOD_MS = 2000;
+        static const uint16_t MAX_RAMP_MS = 2000;
+
+        bool begin(uint8_t frontDayPin, uint8_t frontPin, uint8_t rearPin);
+
+        // Okres migania [ms] dla wszystkich migających wyjść
+        void setBlinkPeriod(uint16_t periodMs);
+        void setRamp(uint16_t rampMs) { this->rampMs = rampMs > MAX_RAMP_MS ? MAX_RAMP_MS : rampMs; }
+
+        // Jasność [%] (0 - wyłączone); blink - miganie zamiast PWM.
+        // Nowa rampa czeka na koniec poprzedniej (sterownik LEDC).
+        void set(Output output, uint8_t brightness, bool blink = false);
+
+        // Natychmiastowe wyłączenie wszystkich wyjść (uśpienie)
+        void off();
+
+        uint8_t getBrightness(Output output) const { return outputs[output].brightness; }
+        bool isBlinking(Output output) const { return outputs[output].blink; }
+
+    private:
+        static const ledc_mode_t SPEED_MODE = LEDC_LOW_SPEED_MODE;
+        static const ledc_timer_t PWM_TIMER = LEDC_TIMER_0;
+        static const ledc_timer_t BLINK_TIMER = LEDC_TIMER_1;
+
+        struct OutputState {
+            ledc_channel_t channel;
+            uint8_t brightness;
+            bool blink;
+        };
+
+        OutputState outputs[OUTPUT_COUNT] = {};
+        SemaphoreHandle_t mutex = nullptr;
+        bool started = false;
+        uint16_t rampMs = 0;
+        uint16_t blinkPeriodMs = 0;
+        uint8_t blinkResolutionBits = 0;
+
+        bool configureBlinkTimer(uint16_t periodMs);
+        static uint32_t dutyFor(uint8_t brightness);
+};
+
+#endif // LIGHT_ENGINE_H
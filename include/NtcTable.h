@@ -0,0 +1,90 @@
+#ifndef NTC_TABLE_H
+#define NTC_TABLE_H
+
+#include <Arduino.h>
+
+// Temperatura termistora NTC 10k (B3950) w dzielniku: NTC do masy, rezystor
+// SERIES_OHMS do 3,3 V, napięcie z kalibrowanego ADC. Tablica temperatur co
+// STEP_MV liczona przez kompilator z równania Steinharta-Harta
+// (1/T = A + B ln R + C ln^3 R), w programie tylko interpolacja liniowa -
+// bez log() w czasie pracy. Napięcie spoza tablicy: zwarcie lub brak czujnika.
+// Ograniczenia C++11: funkcje constexpr z jednym return (rekurencja),
+// indeksy tablicy z własnego odpowiednika std::index_sequence.
+namespace NtcTable {
+
+    // Termistor 10k B3950 i dzielnik 4,7k - zakres ok. -15..155 °C
+    constexpr double COEFF_A = 1.009249522e-3;
+    constexpr double COEFF_B = 2.378405444e-4;
+    constexpr double COEFF_C = 2.019202697e-7;
+    constexpr double SERIES_OHMS = 4700.0;
+    constexpr double SUPPLY_MV = 3300.0;
+
+    // ADC z tłumieniem 11 dB: odczyt 0 to ok. 140 mV, nasycenie ok. 3100 mV
+    const uint16_t MIN_MV = 150;
+    const uint16_t MAX_MV = 3050;
+    const uint16_t STEP_MV = 25;
+    const uint8_t SIZE = (MAX_MV - MIN_MV) / STEP_MV + 1;
+
+    // --- Obliczenia w czasie kompilacji ---
+
+    constexpr double E = 2.718281828459045;
+
+    // ln x = 2 atanh((x - 1) / (x + 1)), szereg zbieżny szybko dla x w [0,5; 2]
+    constexpr double atanhSeries(double power, double square, int n) {
+        return n > 41 ? 0.0 : power / n + atanhSeries(power * square, square, n + 2);
+    }
+    constexpr double lnNear1(double y) {
+        return 2.0 * atanhSeries(y, y * y, 1);
+    }
+    constexpr double ln(double x) {
+        return x > 2.0 ? ln(x / E) + 1.0
+             : x < 0.5 ? ln(x * E) - 1.0
+             : lnNear1((x - 1.0) / (x + 1.0));
+    }
+
+    constexpr double celsiusFromLnOhms(double lnR) {
+        return 1.0 / (COEFF_A + COEFF_B * lnR + COEFF_C * lnR * lnR * lnR) - 273.15;
+    }
+    constexpr double celsiusFromOhms(double ohms) {
+        return celsiusFromLnOhms(ln(ohms));
+    }
+    constexpr double ohmsAt(int index) {
+        return SERIES_OHMS * (MIN_MV + index * STEP_MV) / (SUPPLY_MV - (MIN_MV + index * STEP_MV));
+    }
+
+    template<int... I> struct Indices {};
+    template<int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+    template<int... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+    template<typename> struct Table;
+    template<int... I> struct Table<Indices<I...>> {
+        static constexpr float celsius[sizeof...(I)] = {(float)celsiusFromOhms(ohmsAt(I))...};
+    };
+    template<int... I> constexpr float Table<Indices<I...>>::celsius[sizeof...(I)];
+
+    typedef Table<MakeIndices<SIZE>::type> Values;
+
+    constexpr bool descending(int index) {
+        return index >= SIZE - 1 || (Values::celsius[index] > Values::celsius[index + 1] && descending(index + 1));
+    }
+
+    static_assert(ln(10000.0) > 9.21034 && ln(10000.0) < 9.21035, "ln() w czasie kompilacji");
+    static_assert(celsiusFromOhms(10000.0) > 24.5 && celsiusFromOhms(10000.0) < 25.5, "10k przy 25 °C");
+    static_assert(descending(0), "temperatura maleje ze wzrostem napięcia");
+
+    // --- W czasie pracy ---
+
+    // false - napięcie poza tablicą (zwarcie, brak czujnika lub dzielnika)
+    inline bool celsiusFromMillivolts(float millivolts, float& celsius) {
+        if (millivolts < MIN_MV || millivolts > MAX_MV) return false;
+        float position = (millivolts - MIN_MV) / STEP_MV;
+        uint8_t index = (uint8_t)position;
+        if (index >= SIZE - 1) index = SIZE - 2;
+        float fraction = position - index;
+        celsius = Values::celsius[index] + (Values::celsius[index + 1] - Values::celsius[index]) * fraction;
+        return true;
+    }
+
+}
+
+#endif // NTC_TABLE_H
@@ -0,0 +1,57 @@
+#ifndef ODOMETER_JOURNAL_H
+#define ODOMETER_JOURNAL_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+
+// Wpis dziennika licznika (16 B). Wartości bezwzględne, więc do odtworzenia
+// stanu wystarcza ostatni poprawny wpis.
+struct __attribute__((packed)) OdometerEntry {
+    uint32_t sequence;      // Rośnie z każdym wpisem, 0xFFFFFFFF = pusta pozycja
+    uint32_t totalMeters;
+    uint32_t tripMeters;
+    uint32_t crc;           // CRC-32 poprzednich 12 bajtów
+};
+
+// Dziennik licznika na osobnej partycji flash. Wpisy są dopisywane kolejno
+// w sektorze (bez kasowania), po zapełnieniu sektora dziennik przechodzi do
+// następnego (w pierścieniu), kasuje go i zaczyna od bieżącej wartości -
+// starsze sektory stają się nieaktualne. Zanik zasilania w trakcie zapisu
+// zostawia wpis z błędnym CRC, który jest pomijany przy odczycie.
+class OdometerJournal {
+    public:
+        static const uint32_t SECTOR_SIZE = 4096;
+        static const uint16_t ENTRIES_PER_SECTOR = SECTOR_SIZE / sizeof(OdometerEntry);
+
+    private:
+        const esp_partition_t* partition;
+        uint16_t sectorCount;
+        uint16_t sector;          // Sektor z ostatnim wpisem
+        uint16_t slot;            // Następna wolna pozycja w sektorze
+        bool empty;               // Brak poprawnych wpisów (nowa partycja)
+        OdometerEntry last;       // Ostatni poprawny wpis
+
+        uint32_t sectorErases;
+        uint32_t entriesWritten;
+
+        // Metody pomocnicze
+        bool readEntries(uint16_t sector, uint16_t first, OdometerEntry* entries, uint16_t count);
+        static bool isValid(const OdometerEntry& entry);
+        static bool isErased(const OdometerEntry& entry);
+
+    public:
+        OdometerJournal();
+
+        // Odczyt stanu z partycji (false - brak partycji w tablicy)
+        bool begin(const char* label);
+        bool isEmpty() const { return empty; }
+
+        bool append(uint32_t totalMeters, uint32_t tripMeters);
+
+        uint32_t getTotalMeters() const { return last.totalMeters; }
+        uint32_t getTripMeters() const { return last.tripMeters; }
+        uint32_t getSectorErases() const { return sectorErases; }
+        uint32_t getEntriesWritten() const { return entriesWritten; }
+};
+
+#endif // ODOMETER_JOURNAL_H
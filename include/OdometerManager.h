@@ -3,43 +3,75 @@
 
 #include <Arduino.h>
 #include <Preferences.h>
-#include "Odometer.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "OdometerJournal.h"
 
+// Wynik ustawienia licznika całkowitego
+enum OdometerSetResult : uint8_t {
+    ODOMETER_SET_OK,
+    ODOMETER_SET_INVALID,        // Wartość poza zakresem - licznik bez zmiany
+    ODOMETER_SET_SAVE_FAILED     // Wartość przyjęta, zapis nieudany (ponowiony przy kolejnym zapisie)
+};
+
+// Licznik całkowity i licznik podróży w pełnych metrach. Stan zapisywany
+// w dzienniku na partycji "odometer"; bez tej partycji (stara tablica partycji)
+// w Preferences jako liczby całkowite.
 class OdometerManager {
     private:
-        Odometer* odometer;
+        OdometerJournal journal;
+        bool journalReady = false;
         Preferences preferences;
+        SemaphoreHandle_t mutex = nullptr;
+
+        const char* PARTITION_LABEL = "odometer";
         const char* PREF_NAMESPACE = "odometer";
-        const char* TOTAL_DISTANCE_KEY = "total_dist";
+        const char* TOTAL_DISTANCE_KEY = "total_dist";   // Dawny format [km, float]
         const char* TRIP_DISTANCE_KEY = "trip_dist";
+        const char* TOTAL_METERS_KEY = "total_m";        // Zapis bez partycji [m]
+        const char* TRIP_METERS_KEY = "trip_m";
 
-        unsigned long lastSaveTime = 0;        // Czas ostatniego zapisu
-        const unsigned long SAVE_INTERVAL = 300000; // Zapisuj co 5 minut (300000 ms)
-        float lastSavedTotal = 0.0f;          // Ostatnio zapisana całkowita odległość
-        float lastSavedTrip = 0.0f;           // Ostatnio zapisana odległość podróży
-        const float DISTANCE_THRESHOLD = 0.1f; // Próg zmiany dystansu (100 metrów)
-        
-        // Metody pomocnicze
-        void saveToPreferences();
+        volatile uint32_t totalMeters = 0;
+        volatile uint32_t tripMeters = 0;
+
+        unsigned long lastSaveTime = 0;              // Czas ostatniego zapisu
+        const unsigned long SAVE_INTERVAL = 300000;  // Zapis zmian najpóźniej co 5 minut
+        uint32_t savedTotal = 0;                     // Ostatnio zapisane wartości
+        uint32_t savedTrip = 0;
+        const uint32_t SAVE_DISTANCE = 100;          // Próg zmiany dystansu [m]
+        uint32_t saveErrors = 0;                     // Nieudane zapisy (dziennik lub NVS)
+
+        // Metody pomocnicze (wywoływane pod blokadą)
+        bool save();
         void loadFromPreferences();
+        void lock();
+        void unlock();
 
     public:
-        OdometerManager();
-        ~OdometerManager();
-
         // Podstawowe operacje
         void begin();
         void update();
-        
+        void shutdown();    // Zapis przed uśpieniem
+
+        // Przyrost dystansu z czujnika prędkości
+        void addDistance(uint32_t meters);
+
         // Gettery
-        float getTotalDistance() const;
-        float getTripDistance() const;
-        
-        // Resetowanie licznika podróży
-        void resetTrip();
-        
-        // Kalibracja
-        void calibrate(float actualDistance);
+        float getTotalDistance() const;   // km
+        float getTripDistance() const;    // km
+        uint32_t getTotalMeters() const { return totalMeters; }
+        uint32_t getTripMeters() const { return tripMeters; }
+        uint32_t getSaveErrors() const { return saveErrors; }
+        bool isJournalReady() const { return journalReady; }
+        const OdometerJournal& getJournal() const { return journal; }
+
+        // Resetowanie licznika podróży (false - błąd zapisu, wartość w RAM wyzerowana)
+        bool resetTrip();
+
+        // Ustawienie licznika całkowitego (np. po wymianie sterownika) [km]
+        OdometerSetResult setTotalDistance(float kilometers);
+
+        void printReport(Print& out) const;
 };
 
-#endif // ODOMETER_MANAGER_H
\ No newline at end of file
+#endif // ODOMETER_MANAGER_H
@@ -0,0 +1,41 @@
+#ifndef ONE_WIRE_BENCH_H
+#define ONE_WIRE_BENCH_H
+
+#include <Arduino.h>
+#include "RmtOneWire.h"
+
+// Wpływ transmisji 1-Wire na opóźnienie przerwań (polecenie "owbench"):
+// timer sprzętowy zgłasza przerwanie co PERIOD_US, a przerwanie odczytuje
+// licznik timera, czyli czas od alarmu. Przez PHASE_MS ciągłe odczyty
+// pamięci podręcznej czujnika:
+//  - biblioteka OneWire - bit po bicie, przerwania wyłączone w każdym slocie
+//  - RmtOneWire - sloty nadaje RMT, zadanie czeka na wynik
+// Przerwanie obsługuje rdzeń wywołującego zadania (ten sam co transmisję).
+class OneWireBench {
+    public:
+        static const uint32_t PERIOD_US = 100;
+        static const uint32_t PHASE_MS = 1000;
+        static const uint8_t TIMER_NUMBER = 0;
+        static const uint8_t BUCKETS = 6;
+
+        struct Result {
+            uint32_t reads;
+            uint32_t readErrors;
+            uint64_t readMicros;
+            uint32_t interrupts;
+            uint32_t maxLatencyUs;
+            uint32_t histogram[BUCKETS];
+        };
+
+        // Blokuje wywołujące zadanie na 2 x PHASE_MS, potem pin wraca do RMT
+        static void run(RmtOneWire& wire, const uint8_t* rom, Print& out);
+        // Pomiar bez wypisywania (test na symulatorze); false - brak czujnika
+        static bool measure(RmtOneWire& wire, const uint8_t* rom, Result& bitBang, Result& rmt);
+
+    private:
+        template<typename Wire>
+        static void runPhase(Wire& wire, const uint8_t* rom, Result& result);
+        static void printResult(const char* name, const Result& result, Print& out);
+};
+
+#endif // ONE_WIRE_BENCH_H
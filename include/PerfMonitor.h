@@ -0,0 +1,105 @@
+#ifndef PERF_MONITOR_H
+#define PERF_MONITOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+// Pomiar czasu wykonania podsystemów na liczniku cykli CPU.
+// Z flagą PERF_ENABLED=0 makro PERF_SCOPE() i cała klasa znikają z kodu.
+#ifndef PERF_ENABLED
+#define PERF_ENABLED 1
+#endif
+
+// Mierzone podsystemy
+enum PerfSection : uint8_t {
+    PERF_DISPLAY,      // Rysowanie ekranu głównego (drawMainDisplay)
+    PERF_RENDER,       // Wysłanie zmienionych obszarów do OLED
+    PERF_BUTTONS,      // Obsługa przycisków (handleButtons)
+    PERF_TEMPERATURE,  // Odczyt temperatur (handleTemperature)
+    PERF_ODOMETER,     // Czujnik prędkości i licznik kilometrów (updateWheelSpeed, odometerManager.update)
+    PERF_BMS,          // Dekodowanie ramek BMS
+    PERF_WEBSOCKET,    // Budowa i wysłanie danych WebSocket
+    PERF_SECTION_COUNT
+};
+
+// Przedziały histogramu: [0, 2) us, [2, 4) us, ... [2^14, 2^15) us, >= 2^15 us
+static const uint8_t PERF_BUCKET_COUNT = 16;
+
+// Statystyki podsystemu
+struct PerfStats {
+    uint32_t count;      // Liczba pomiarów
+    uint32_t lastUs;     // Ostatni pomiar [us]
+    uint32_t minUs;      // Najkrótszy [us]
+    uint32_t maxUs;      // Najdłuższy [us]
+    uint32_t avgUs;      // Średni [us]
+    uint32_t p50Us;      // Percentyle szacowane z histogramu (górna granica przedziału) [us]
+    uint32_t p90Us;
+    uint32_t p99Us;
+    uint32_t buckets[PERF_BUCKET_COUNT];
+};
+
+#if PERF_ENABLED
+
+class PerfMonitor {
+    private:
+        struct Section {
+            uint32_t count;
+            uint32_t lastCycles;
+            uint32_t minCycles;
+            uint32_t maxCycles;
+            uint64_t totalCycles;
+            uint32_t buckets[PERF_BUCKET_COUNT];
+        };
+
+        Section sections[PERF_SECTION_COUNT];
+        uint32_t cyclesPerUs = 240;
+        mutable portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+        // Metody pomocnicze
+        static uint8_t bucketFor(uint32_t us);
+        static uint32_t bucketUpperBound(uint8_t bucket);
+        static uint32_t percentile(const uint32_t* buckets, uint32_t count, uint8_t percent, uint32_t maxUs);
+
+    public:
+        PerfMonitor();
+
+        // Odczyt częstotliwości CPU (po ustawieniu zegara)
+        void begin();
+
+        // Zapis pomiaru - wywoływane przez PerfScope
+        void record(PerfSection section, uint32_t cycles);
+        void reset();
+
+        // Raport tekstowy (polecenie "perf" na porcie szeregowym)
+        void printReport(Print& out) const;
+
+        // Gettery
+        PerfStats getStats(PerfSection section) const;
+        static const char* getSectionName(PerfSection section);
+        static uint32_t getBucketLowerBound(uint8_t bucket);
+};
+
+extern PerfMonitor perfMonitor;
+
+// Pomiar od utworzenia do końca zasięgu
+class PerfScope {
+    private:
+        const PerfSection section;
+        const uint32_t start;
+
+    public:
+        explicit PerfScope(PerfSection section) : section(section), start(ESP.getCycleCount()) {}
+        ~PerfScope() { perfMonitor.record(section, ESP.getCycleCount() - start); }
+};
+
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+#define PERF_SCOPE(section) PerfScope PERF_CONCAT(perfScope, __LINE__)(section)
+
+#else
+
+#define PERF_SCOPE(section) do {} while (0)
+
+#endif // PERF_ENABLED
+
+#endif // PERF_MONITOR_H
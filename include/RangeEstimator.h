@@ -0,0 +1,65 @@
+#ifndef RANGE_ESTIMATOR_H
+#define RANGE_ESTIMATOR_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Zasięg z modelu zużycia energii: energia z BMS (napięcie x prąd) dzielona
+// przez dystans z czujnika koła daje Wh/km, uśrednione wykładniczo osobno dla
+// każdego poziomu wspomagania. Zasięg = energia pozostała w baterii / Wh/km
+// dla bieżącego poziomu. Stała pamięć, O(1) na próbkę.
+//  - addPowerSample(): zadanie BLE, po każdej ramce 0x03 z BMS
+//  - update(), estimateKm(): zadanie czujników
+// Przekazanie energii między zadaniami przez licznik atomowy (bez blokad).
+class RangeEstimator {
+    public:
+        static const uint8_t LEVELS = 6;                 // Wspomaganie 0-5
+        static const uint32_t SEGMENT_METERS = 200;      // Dystans jednego pomiaru Wh/km
+        static const uint32_t MAX_SAMPLE_GAP_MS = 5000;  // Dłuższa przerwa w danych BMS - bez całkowania
+        static const uint32_t STANDSTILL_MS = 10000;     // Energia na postoju nie wchodzi do Wh/km
+        static const uint16_t WARMUP_SEGMENTS = 10;      // Średnia zwykła, potem wykładnicza (alfa 1/10)
+        static constexpr float MIN_WH_PER_KM = 0.5f;
+        static constexpr float MAX_WH_PER_KM = 100.0f;
+
+        // Zużycie przed pierwszym pomiarem na danym poziomie [Wh/km]
+        static const float DEFAULT_WH_PER_KM[LEVELS];
+
+        RangeEstimator();
+
+        // Próbka z BMS; prąd ujemny = rozładowanie (konwencja JBD)
+        void addPowerSample(float voltage, float current, uint32_t nowMs);
+
+        // Przejechany dystans od poprzedniego wywołania
+        void update(uint32_t meters, uint8_t assistLevel, uint32_t nowMs);
+
+        // Zasięg [km] dla pozostałej energii [Wh]
+        float estimateKm(float remainingWh, uint8_t assistLevel) const;
+
+        float getWhPerKm(uint8_t assistLevel) const;
+        uint16_t getSegments(uint8_t assistLevel) const;
+        void printReport(Print& out) const;
+
+        // Wyuczone współczynniki w pamięci RTC (przetrwają głębokie uśpienie)
+        void store() const;
+        bool restore();
+
+    private:
+        // Zadanie BLE
+        uint32_t lastSampleMs = 0;
+        bool hasSample = false;
+        float lastPowerW = 0;
+        float residualMwh = 0;              // Część energii poniżej 1 mWh
+        std::atomic<int32_t> pendingMwh;    // Energia do odebrania przez update()
+
+        // Zadanie czujników
+        float whPerKm[LEVELS];
+        uint16_t segments[LEVELS];
+        int32_t segmentMwh = 0;
+        uint32_t segmentMeters = 0;
+        uint8_t segmentLevel = 0;
+        uint32_t lastMoveMs = 0;
+
+        void closeSegment();
+};
+
+#endif // RANGE_ESTIMATOR_H
@@ -0,0 +1,84 @@
+#ifndef RENDER_TRACKER_H
+#define RENDER_TRACKER_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+// Elementy ekranu głównego śledzone osobno
+enum DisplayWidget : uint8_t {
+    WIDGET_CLOCK,        // Zegar w górnym pasku
+    WIDGET_BATTERY,      // Procent baterii
+    WIDGET_VOLTAGE,      // Napięcie baterii
+    WIDGET_ASSIST,       // Poziom wspomagania
+    WIDGET_ASSIST_MODE,  // Tryb sterowania (PAS/GAZ/STOP...)
+    WIDGET_LIGHTS,       // Status świateł
+    WIDGET_SPEED,        // Duża prędkość
+    WIDGET_VALUE,        // Wartość i jednostka bieżącego ekranu
+    WIDGET_DESCRIPTION,  // Opis bieżącego ekranu
+    WIDGET_COUNT
+};
+
+// Obszar na wyświetlaczu w kafelkach 8x8 px (jednostki updateDisplayArea())
+struct TileRect {
+    uint8_t x;
+    uint8_t y;
+    uint8_t w;
+    uint8_t h;
+};
+
+// Statystyki przesyłania obrazu
+struct RenderStats {
+    uint32_t frames;          // Klatki wysłane do wyświetlacza
+    uint32_t skippedFrames;   // Klatki bez zmian (nic nie wysłano)
+    uint32_t fullFrames;      // Pełne odświeżenia (sendBuffer)
+    uint32_t bytesSent;       // Bajty obrazu wysłane przez I2C
+    uint32_t i2cTimeUs;       // Łączny czas transmisji I2C [us]
+    float framesPerSecond;    // Klatki/s w ostatnim oknie pomiarowym
+    uint32_t bytesPerSecond;  // Bajty/s w ostatnim oknie pomiarowym
+    uint32_t i2cUsPerSecond;  // Czas I2C w ostatnim oknie [us/s]
+};
+
+// Śledzenie zmian elementów ekranu: każdy element zgłasza w klatce
+// podpis swojej zawartości (touch), a flush() wysyła do wyświetlacza
+// tylko wiersze kafelków zajmowane przez elementy, które się zmieniły
+class RenderTracker {
+    private:
+        static const uint8_t TILE_COLUMNS = 16;  // 128 px / 8
+        static const uint8_t TILE_ROWS = 8;      // 64 px / 8
+        static const uint8_t BYTES_PER_TILE = 8;
+        static const unsigned long STATS_WINDOW_MS = 1000;
+
+        TileRect areas[WIDGET_COUNT];
+        uint32_t current[WIDGET_COUNT];   // Podpisy z bieżącej klatki
+        uint32_t sent[WIDGET_COUNT];      // Podpisy ostatnio wysłanej zawartości
+        bool fullRefresh = true;
+        const unsigned long minFrameInterval;
+        unsigned long lastFlushTime = 0;
+
+        RenderStats stats;
+        unsigned long windowStart = 0;
+        uint32_t windowFrames = 0;
+        uint32_t windowBytes = 0;
+        uint32_t windowI2cUs = 0;
+
+        // Metody pomocnicze
+        static uint32_t hashBytes(uint32_t hash, const uint8_t* data, size_t length);
+        void updateWindow(unsigned long now);
+
+    public:
+        RenderTracker(const TileRect* widgetAreas, unsigned long minFrameIntervalMs);
+
+        // Klatka: beginFrame() -> rysowanie + touch() -> flush()
+        void beginFrame();
+        void touch(DisplayWidget widget, const char* text);
+        void touch(DisplayWidget widget, uint32_t value);
+        bool flush(U8G2& display, unsigned long now);
+
+        // Wymuszenie pełnego odświeżenia (np. po komunikacie rysowanym poza śledzeniem)
+        void invalidate();
+
+        // Gettery
+        RenderStats getStats() const;
+};
+
+#endif // RENDER_TRACKER_H
@@ -0,0 +1,36 @@
+#ifndef RESUME_STATE_H
+#define RESUME_STATE_H
+
+#include <Arduino.h>
+
+// Stan potrzebny do narysowania pierwszej klatki po wybudzeniu
+struct ResumeData {
+    uint8_t mainScreen;
+    uint8_t subScreen;
+    uint8_t inSubScreen;
+    uint8_t assistLevel;
+    uint8_t lightMode;
+    uint8_t displayBrightness;  // Kontrast OLED (0-255)
+    uint32_t tripMeters;        // Licznik podróży do czasu odczytu dziennika
+    uint32_t rideMm;            // Statystyki podróży z czujnika koła
+    uint32_t movingMs;
+    float maxSpeed;
+    uint32_t configCrc;         // ConfigStore::getCrc() w chwili uśpienia
+};
+
+// Zapis stanu w pamięci RTC (przetrwa głębokie uśpienie, nie przetrwa
+// odłączenia zasilania). Po wybudzeniu przyciskiem stan jest odtwarzany
+// bez czytania flash, reszta inicjalizacji odbywa się w tle.
+class ResumeState {
+    public:
+        static const uint32_t MAGIC = 0x52574D50;  // "PMWR"
+
+        // Zapis przed esp_deep_sleep_start()
+        static void store(const ResumeData& data);
+
+        // Odczyt po wybudzeniu; false - brak zapisu lub uszkodzona pamięć RTC
+        static bool restore(ResumeData& data);
+        static void invalidate();
+};
+
+#endif // RESUME_STATE_H
@@ -0,0 +1,111 @@
+#ifndef RIDE_LOGGER_H
+#define RIDE_LOGGER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "Telemetry.h"
+
+// Próbka przejazdu zapisywana w LittleFS (32 B, little-endian, bez wyrównania)
+struct __attribute__((packed)) RideRecord {
+    uint32_t timestamp;       // Czas unix [s]
+    uint16_t speed;           // 0.1 km/h
+    uint16_t cadence;         // obr/min
+    int16_t power;            // W
+    uint16_t voltage;         // 10 mV
+    int16_t current;          // 10 mA
+    int16_t tempAir;          // 0.1 °C
+    int16_t tempController;   // 0.1 °C
+    int16_t tempMotor;        // 0.1 °C
+    uint16_t pressureFront;   // 0.01 bar
+    uint16_t pressureRear;    // 0.01 bar
+    uint8_t battery;          // % naładowania
+    uint8_t flags;            // RIDE_FLAG_*
+    uint16_t sequence;        // Numer próbki (przerwy w numeracji = utracone próbki)
+    uint32_t crc;             // CRC-32 poprzednich 28 bajtów
+};
+
+const uint8_t RIDE_FLAG_START = 0x01;   // Pierwsza próbka po włączeniu systemu
+
+// Pozycja pobierania wszystkich segmentów (po jednym fragmencie odpowiedzi)
+struct RideDownload {
+    uint32_t segment;
+    uint32_t lastSegment;
+    size_t offset;
+};
+
+struct RideLoggerStats {
+    uint32_t firstSegment;
+    uint32_t lastSegment;
+    uint16_t segmentRecords;   // Rekordy w ostatnim segmencie
+    uint16_t buffered;         // Rekordy czekające w RAM
+    uint32_t recordsWritten;
+    uint32_t recordsDropped;   // Nadpisane w pełnym buforze (błąd zapisu)
+};
+
+// Rejestrator przejazdu. Próbki trafiają do bufora pierścieniowego w RAM
+// i są dopisywane do pliku partiami (FLUSH_RECORDS lub co FLUSH_INTERVAL_MS),
+// co ogranicza liczbę zapisów do flash. Segmenty /rides/NNNNN.bin mają stały
+// rozmiar, najstarszy jest usuwany po przekroczeniu MAX_SEGMENTS.
+class RideLogger {
+    public:
+        static const unsigned long SAMPLE_INTERVAL_MS = 1000;
+        static const uint16_t BUFFER_RECORDS = 64;             // 2 KiB RAM
+        static const uint16_t FLUSH_RECORDS = 32;              // Zapis po 1 KiB
+        static const unsigned long FLUSH_INTERVAL_MS = 60000;
+        static const uint16_t SEGMENT_RECORDS = 1024;          // 32 KiB, ok. 17 min jazdy
+        static const uint8_t MAX_SEGMENTS = 8;
+
+    private:
+        fs::FS* fs;
+        SemaphoreHandle_t mutex;
+
+        RideRecord buffer[BUFFER_RECORDS];
+        uint16_t head;             // Najstarszy rekord w buforze
+        uint16_t count;
+
+        uint32_t firstSegment;
+        uint32_t lastSegment;
+        uint16_t segmentRecords;
+        uint16_t sequence;
+        bool startPending;
+
+        uint32_t timeBase;         // Czas unix w chwili timeBaseMillis
+        unsigned long timeBaseMillis;
+        unsigned long lastSample;
+        unsigned long lastFlush;
+
+        uint32_t recordsWritten;
+        uint32_t recordsDropped;
+
+        // Metody pomocnicze
+        static void quantize(const TelemetrySnapshot& t, RideRecord& record);
+        bool writeBuffered();
+        void removeOldSegments();
+        void lock();
+        void unlock();
+
+    public:
+        RideLogger();
+
+        // Odczyt stanu segmentów z systemu plików (po zamontowaniu);
+        // false - brak katalogu /rides, próbki nie są zapisywane
+        bool begin(fs::FS& fileSystem);
+        bool isReady() const { return fs != nullptr; }
+        void setTime(uint32_t unixTime, unsigned long now);
+
+        // Wywoływane z zadania czujników (próbka co SAMPLE_INTERVAL_MS)
+        void sample(const TelemetrySnapshot& t, unsigned long now);
+        bool flush();
+
+        // Pobieranie segmentów bez wczytywania ich w całości do RAM
+        static void getSegmentPath(uint32_t segment, char* path, size_t length);
+        static bool isValid(const RideRecord& record);
+        RideDownload beginDownload();
+        size_t read(RideDownload& download, uint8_t* data, size_t maxLength);
+
+        RideLoggerStats getStats();
+};
+
+#endif // RIDE_LOGGER_H
@@ -0,0 +1,69 @@
+#ifndef RMT_ONE_WIRE_H
+#define RMT_ONE_WIRE_H
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include <freertos/ringbuf.h>
+
+// Magistrala 1-Wire na peryferium RMT (sterownik z ESP-IDF 4.x): sloty
+// nadaje kanał TX, stan linii zapisuje kanał RX na tym samym pinie (otwarty
+// dren, podciąganie 4,7k do 3,3 V). Bajt to jedna transakcja 8 slotów
+// (~560 us), w tym czasie zadanie czeka na bufor RX - bez zajmowania CPU
+// i bez wyłączania przerwań, jak w bibliotece OneWire (bit po bicie).
+// Interfejs jak OneWire (reset, select, write, read, search, crc8), bez
+// zasilania pasożytniczego. Wywołania z jednego zadania.
+class RmtOneWire {
+    public:
+        // Czasy slotów [us] (zegar RMT 1 MHz)
+        static const uint16_t RESET_LOW_US = 480;
+        static const uint16_t RESET_WAIT_US = 480;         // Okno impulsu obecności
+        static const uint16_t WRITE_1_LOW_US = 6;
+        static const uint16_t WRITE_0_LOW_US = 60;
+        static const uint16_t SLOT_US = 70;                // Razem z odstępem między slotami
+        static const uint16_t READ_SAMPLE_US = 15;         // Krótsze zwarcie linii - odczytana 1
+        static const uint32_t RX_TIMEOUT_MS = 10;
+
+        RmtOneWire(uint8_t pin, rmt_channel_t txChannel, rmt_channel_t rxChannel);
+
+        // Także po użyciu pinu przez inny sterownik (przyłącza pin do RMT)
+        bool begin();
+
+        uint8_t reset();                                   // 1 - czujnik odpowiedział
+        void select(const uint8_t rom[8]);
+        void skip();
+        void write(uint8_t value);
+        uint8_t read();
+        void write_bytes(const uint8_t* data, uint16_t count);
+        void read_bytes(uint8_t* data, uint16_t count);
+
+        void reset_search();
+        bool search(uint8_t* address);
+        static uint8_t crc8(const uint8_t* data, uint8_t length);
+
+        uint8_t getPin() const { return pin; }
+        uint32_t getTransactions() const { return transactions; }
+        uint32_t getErrors() const { return errors; }
+
+    private:
+        uint8_t pin;
+        rmt_channel_t txChannel;
+        rmt_channel_t rxChannel;
+        RingbufHandle_t rxBuffer = nullptr;
+        bool installed = false;
+
+        uint32_t transactions = 0;
+        uint32_t errors = 0;
+
+        // Stan wyszukiwania (algorytm z noty aplikacyjnej Maxim AN187)
+        uint8_t searchRom[8] = {};
+        int8_t lastDiscrepancy = -1;
+        bool lastDevice = false;
+
+        // Sloty z bitów (LSB najpierw); odczyt stanu linii w każdym slocie
+        bool transfer(uint32_t bits, uint8_t count, uint32_t* lineBits);
+        void startReceive();
+        uint8_t capture(uint16_t* lowDurations, uint8_t maxPulses);
+        void attachPin();
+};
+
+#endif // RMT_ONE_WIRE_H
@@ -0,0 +1,68 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+
+// Blokada sekwencyjna (seqlock) dla danych współdzielonych między zadaniami.
+//
+// Czytelnicy nie biorą żadnej blokady: kopiują dane i powtarzają odczyt,
+// jeśli w międzyczasie nastąpił zapis (nieparzysty lub zmieniony licznik).
+// Pisarze są serializowani sekcją krytyczną, więc funkcja modyfikująca
+// musi być krótka i nie może wywoływać blokujących funkcji (Serial, I2C, NVS).
+template <typename T>
+class SeqLock {
+    private:
+        std::atomic<uint32_t> sequence;
+        portMUX_TYPE writerMux = portMUX_INITIALIZER_UNLOCKED;
+        T data;
+
+    public:
+        SeqLock() : sequence(0), data() {}
+
+        // Spójna kopia danych, opcjonalnie z numerem wersji
+        T read(uint32_t* version = nullptr) const {
+            T copy;
+            uint32_t before;
+            uint32_t after;
+
+            do {
+                // Czekaj aż pisarz (na drugim rdzeniu) skończy zapis
+                do {
+                    before = sequence.load(std::memory_order_acquire);
+                } while (before & 1);
+
+                memcpy(&copy, &data, sizeof(T));
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = sequence.load(std::memory_order_relaxed);
+            } while (before != after);
+
+            if (version) *version = before >> 1;
+            return copy;
+        }
+
+        // Modyfikacja danych w miejscu: update([](T& d) { d.x = 1; })
+        template <typename F>
+        void update(F modify) {
+            portENTER_CRITICAL(&writerMux);
+
+            uint32_t seq = sequence.load(std::memory_order_relaxed);
+            sequence.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            modify(data);
+
+            sequence.store(seq + 2, std::memory_order_release);
+
+            portEXIT_CRITICAL(&writerMux);
+        }
+
+        // Numer wersji - rośnie o 1 przy każdym zapisie
+        uint32_t version() const {
+            return sequence.load(std::memory_order_acquire) >> 1;
+        }
+};
+
+#endif // SEQ_LOCK_H
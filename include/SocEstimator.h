@@ -0,0 +1,72 @@
+#ifndef SOC_ESTIMATOR_H
+#define SOC_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "JbdParser.h"   // BmsData
+
+// Stan naładowania baterii z kilku źródeł, liczony w zadaniu czujników (10 Hz):
+//  - między ramkami BMS (co 1 s) zliczanie ładunku z ostatniego prądu
+//  - ramka BMS (pojemność pozostała z rozdzielczością 0,01 Ah) koryguje
+//    wynik stopniowo - bez skoków o pełny procent
+//  - bateria w spoczynku (mały prąd przez REST_TIME_MS): korekta dryfu
+//    z napięcia spoczynkowego celi (tablica OCV)
+//  - bez BMS (BLE rozłączone): tylko napięcie z dzielnika na ADC
+class SocEstimator {
+    public:
+        enum Source : uint8_t {
+            SOURCE_NONE = 0,      // Brak danych
+            SOURCE_BMS,           // Zliczanie ładunku + BMS
+            SOURCE_VOLTAGE        // Tylko napięcie (tablica OCV)
+        };
+
+        static const uint32_t BMS_TIMEOUT_MS = 5000;     // Bez ramki 0x03 dłużej - BMS niedostępny
+        static const uint32_t MAX_STEP_MS = 1000;        // Dłuższa przerwa w wywołaniach - bez całkowania
+        static const uint32_t REST_TIME_MS = 300000;     // 5 min małego prądu - napięcie bliskie OCV
+        static constexpr float REST_CURRENT_A = 0.5f;
+        static constexpr float MIN_CELL_VOLTAGE = 2.5f;  // Niższy odczyt ADC - brak dzielnika
+        static constexpr float BMS_GAIN = 0.1f;          // Korekta na ramkę BMS (stała ~10 s)
+        static constexpr float OCV_GAIN = 0.02f;         // Korekta na ramkę w spoczynku (stała ~50 s)
+        static constexpr float VOLTAGE_GAIN = 0.01f;     // Filtr napięcia z ADC na wywołanie (~10 s)
+
+        explicit SocEstimator(uint8_t defaultCells, float defaultCapacityAh);
+
+        // Nowa ramka 0x03 z BMS
+        void addBmsSample(const BmsData& bms, uint32_t nowMs);
+
+        // Napięcie pakietu z ADC [V]; używane tylko bez BMS, poniżej MIN_CELL_VOLTAGE na celę - brak dzielnika
+        void addVoltageSample(float packVoltage, uint32_t nowMs);
+
+        // Zliczanie ładunku, wywoływane co okres zadania czujników
+        void update(uint32_t nowMs);
+
+        bool isBmsOnline(uint32_t nowMs) const { return hasBms && nowMs - lastBmsMs <= BMS_TIMEOUT_MS; }
+        Source getSource() const { return source; }
+        float getSoc() const { return soc; }                 // [%], 0 przy braku danych
+        float getCurrent() const { return current; }         // [A], ujemny przy rozładowaniu
+        float getVoltage() const { return voltage; }         // [V]
+        float getRemainingAh() const { return soc * capacityAh / 100.0f; }
+        float getRemainingWh() const { return getRemainingAh() * voltage; }
+
+        // Stan naładowania celi z napięcia spoczynkowego (tablica NMC) [%]
+        static float socFromCellVoltage(float cellVoltage);
+
+    private:
+        uint8_t cells;
+        float capacityAh;
+
+        Source source = SOURCE_NONE;
+        float soc = 0;
+        float current = 0;
+        float voltage = 0;
+        float filteredVoltage = 0;
+
+        bool hasBms = false;
+        uint32_t lastBmsMs = 0;
+        uint32_t lastUpdateMs = 0;
+        uint32_t restStartMs = 0;
+        bool resting = false;
+
+        void correct(float target, float gain);
+};
+
+#endif // SOC_ESTIMATOR_H
@@ -0,0 +1,70 @@
+#ifndef SYSTEM_CLOCK_H
+#define SYSTEM_CLOCK_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+// Zegar programowy prowadzony przez DS3231: układ czytany raz przy starcie,
+// potem czas to zakotwiczenie (sekunda unix + chwila esp_timer) i upływ
+// esp_timer - odczyt bez I2C, w sekcji krytycznej na kilka instrukcji.
+// Korekta:
+//  - SQW 1 Hz (zbocze opadające = zmiana sekundy DS3231): przerwanie
+//    przesuwa zakotwiczenie na każde zbocze, bez dalszych odczytów I2C
+//  - bez SQW: odczyt DS3231 co RESYNC_INTERVAL_MS, zegar utrzymywany
+//    w odczytanej sekundzie (dokładność do 1 s)
+// Przed głębokim uśpieniem czas trafia do pamięci RTC - po wybudzeniu
+// liczony z czasu systemowego (timer RTC działa w uśpieniu), korekta
+// z DS3231 w pierwszym update(). update() i adjust() używają magistrali
+// I2C - wywołania pod blokadą magistrali (wspólnej z wyświetlaczem).
+class SystemClock {
+    public:
+        static const uint32_t MAGIC = 0x4B574D50;               // "PMWK"
+        static const int64_t SQW_TIMEOUT_US = 1500000;          // Dłużej bez zbocza - SQW nieaktywne
+        static const uint32_t RESYNC_INTERVAL_MS = 600000;      // Bez SQW: odczyt DS3231 co 10 min
+        static const uint8_t SYNC_ATTEMPTS = 3;                 // Zbocze w trakcie odczytu - powtórzenie
+
+        // sqwPin < 0 - bez SQW; restoreFromSleep - czas z pamięci RTC (bez I2C)
+        void begin(RTC_DS3231& rtc, int8_t sqwPin, bool restoreFromSleep);
+        void update(uint32_t nowMs);
+        void adjust(uint32_t unixTime);     // Nowy czas także w DS3231
+
+        // Zapis przed esp_deep_sleep_start()
+        void store() const;
+
+        uint64_t nowMicros() const;         // Czas unix [us]
+        uint32_t now() const { return (uint32_t)(nowMicros() / 1000000ULL); }
+        bool isSqwActive() const;
+
+        void printReport(Print& out) const;
+
+    private:
+        RTC_DS3231* rtc = nullptr;
+        int8_t sqwPin = -1;
+        mutable portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+        // Zakotwiczenie (zmieniane też w przerwaniu SQW)
+        volatile uint32_t baseSeconds = 0;     // Czas unix w chwili baseUs
+        volatile int64_t baseUs = 0;           // esp_timer_get_time()
+        volatile uint32_t edgeSeconds = 0;     // Sekunda najbliższego zbocza po odczycie, 0 - zaokrąglenie
+        volatile int64_t lastEdgeUs = 0;
+        volatile uint32_t edges = 0;
+
+        // Stan korekty (zadanie z dostępem do I2C)
+        bool anchored = false;                 // Jest zakotwiczenie (odczyt lub pamięć RTC)
+        bool synced = false;                   // Zakotwiczenie z odczytu DS3231
+        bool restored = false;
+        bool syncPending = false;
+        uint32_t lastSyncMs = 0;
+        uint32_t rtcReads = 0;
+        uint32_t syncs = 0;
+        int32_t lastCorrectionMs = 0;
+
+        bool restore();
+        bool sync(uint32_t nowMs);
+        uint32_t edgeCount() const;
+        static void IRAM_ATTR handleSqw(void* arg);
+};
+
+#endif // SYSTEM_CLOCK_H
@@ -0,0 +1,63 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Konfiguracja pojedynczego zadania cyklicznego
+struct TaskConfig {
+    const char* name;        // Nazwa zadania (widoczna w FreeRTOS)
+    void (*step)();          // Funkcja wykonywana w każdym cyklu
+    uint32_t periodMs;       // Okres wywołań [ms]
+    UBaseType_t priority;    // Priorytet FreeRTOS
+    BaseType_t core;         // Rdzeń (0 - PRO_CPU, 1 - APP_CPU)
+    uint32_t stackSize;      // Rozmiar stosu [B]
+};
+
+// Statystyki czasowe zadania
+struct TaskStats {
+    uint32_t runs;           // Liczba wykonań
+    uint32_t overruns;       // Liczba przekroczeń okresu
+    uint32_t wakeups;        // Liczba wybudzeń przed czasem (notify)
+    uint32_t lastRunUs;      // Czas ostatniego wykonania [us]
+    uint32_t maxRunUs;       // Najdłuższe wykonanie [us]
+    uint32_t maxLatenessUs;  // Największe opóźnienie startu względem terminu [us]
+};
+
+class TaskScheduler {
+    private:
+        static const uint8_t MAX_TASKS = 8;
+
+        struct TaskSlot {
+            TaskConfig config;
+            TaskStats stats;
+            TaskHandle_t handle;
+        };
+
+        TaskSlot tasks[MAX_TASKS];
+        uint8_t taskCount = 0;
+        bool started = false;
+
+        // Metody pomocnicze
+        static void taskEntry(void* param);
+        static void runTask(TaskSlot& slot);
+
+    public:
+        TaskScheduler();
+
+        // Rejestracja zadań (przed begin()), zwraca identyfikator lub -1
+        int8_t addTask(const TaskConfig& config);
+        bool begin();
+
+        // Wybudzenie zadania przed upływem okresu (np. po wysłaniu do kolejki)
+        void notify(int8_t taskId);
+        void notifyFromISR(int8_t taskId);
+
+        // Gettery
+        uint8_t getTaskCount() const;
+        const char* getTaskName(uint8_t index) const;
+        TaskStats getStats(uint8_t index) const;
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,54 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "SeqLock.h"
+#include "JbdParser.h"   // BmsData
+
+// Komplet wartości pomiarowych publikowany przez zadania-producentów
+// (czujniki, BLE) i czytany przez wyświetlacz oraz WebSocket
+struct TelemetrySnapshot {
+    // Prędkość i kadencja
+    float speed_kmh;
+    float speed_avg_kmh;
+    float speed_max_kmh;
+    int cadence_rpm;
+    int cadence_avg_rpm;
+
+    // Temperatury [°C]
+    float temp_air;
+    float temp_controller;
+    float temp_motor;
+
+    // Zasięg i dystans [km]
+    float range_km;
+    float distance_km;
+
+    // Bateria
+    float battery_voltage;
+    float battery_current;
+    float battery_capacity_wh;
+    float battery_capacity_ah;
+    int battery_capacity_percent;
+    float battery_soc;            // [%], z dokładnością do ułamka procenta (SocEstimator)
+
+    // Moc [W]
+    int power_w;
+    int power_avg_w;
+    int power_max_w;
+
+    // Czujniki ciśnienia kół
+    float pressure_bar;           // przednie koło
+    float pressure_rear_bar;      // tylne koło
+    int pressure_battery;         // bateria przedniego czujnika [%]
+    int pressure_rear_battery;    // bateria tylnego czujnika [%]
+    float pressure_temp;          // temperatura przedniego czujnika
+    float pressure_rear_temp;     // temperatura tylnego czujnika
+
+    // BMS
+    BmsData bms;
+};
+
+typedef SeqLock<TelemetrySnapshot> Telemetry;
+
+#endif // TELEMETRY_H
@@ -0,0 +1,127 @@
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "Telemetry.h"
+
+// Pola danych dostępne w subskrypcji WebSocket (numer = bit w masce)
+enum TelemetryField : uint8_t {
+    FIELD_SPEED,            // uint16, 0.1 km/h
+    FIELD_CADENCE,          // uint16, obr/min
+    FIELD_POWER,            // int16, W
+    FIELD_VOLTAGE,          // uint16, 10 mV
+    FIELD_CURRENT,          // int16, 10 mA
+    FIELD_BATTERY,          // uint8, % naładowania
+    FIELD_TEMP_AIR,         // int16, 0.1 °C
+    FIELD_TEMP_CONTROLLER,  // int16, 0.1 °C
+    FIELD_TEMP_MOTOR,       // int16, 0.1 °C
+    FIELD_RANGE,            // uint16, 0.1 km
+    FIELD_DISTANCE,         // uint32, m
+    FIELD_CELLS,            // uint8 liczba + 32 x uint16, mV
+    FIELD_BMS_TEMPS,        // uint8 liczba + 8 x int16, 0.1 °C
+    FIELD_PRESSURE,         // 2 x uint16, 0.01 bar (przód, tył)
+    FIELD_TIME,             // uint32, czas unix [s] (zegar w pamięci)
+    FIELD_COUNT
+};
+
+// Pola wysyłane klientom bez subskrypcji (jak dotychczasowy JSON co 1 s)
+const uint32_t TELEMETRY_DEFAULT_FIELDS = (1UL << FIELD_SPEED) | (1UL << FIELD_TEMP_AIR) |
+                                          (1UL << FIELD_BATTERY) | (1UL << FIELD_POWER);
+
+enum TelemetryFormat : uint8_t {
+    TELEMETRY_FORMAT_JSON,
+    TELEMETRY_FORMAT_BINARY
+};
+
+// Zmiana subskrypcji przekazywana kolejką z obsługi WebSocket do zadania sieciowego
+struct TelemetrySubscription {
+    uint32_t clientId;
+    uint32_t fieldMask;     // 0 - rozłączenie klienta
+    uint8_t rateHz;         // 1-20
+    TelemetryFormat format;
+};
+
+// Wartości wszystkich pól w postaci wysyłanej (little-endian, bez wyrównania)
+struct __attribute__((packed)) TelemetryValues {
+    uint16_t speed;
+    uint16_t cadence;
+    int16_t power;
+    uint16_t voltage;
+    int16_t current;
+    uint8_t battery;
+    int16_t tempAir;
+    int16_t tempController;
+    int16_t tempMotor;
+    uint16_t range;
+    uint32_t distance;
+    uint8_t cellCount;
+    uint16_t cells[BMS_MAX_CELLS];
+    uint8_t bmsTempCount;
+    int16_t bmsTemps[BMS_MAX_NTC];
+    uint16_t pressure[2];
+    uint32_t time;
+};
+
+// Nagłówek ramki binarnej, po nim pola z maski w kolejności numerów
+struct __attribute__((packed)) TelemetryFrameHeader {
+    uint8_t magic;        // 'T'
+    uint8_t flags;        // TELEMETRY_FLAG_*
+    uint16_t sequence;    // Numer ramki dla klienta
+    uint32_t fieldMask;   // Pola obecne w tej ramce
+};
+
+const uint8_t TELEMETRY_FRAME_MAGIC = 'T';
+const uint8_t TELEMETRY_FLAG_KEYFRAME = 0x01;   // Ramka zawiera wszystkie subskrybowane pola
+
+// Strumień danych pomiarowych dla klientów WebSocket. Ramki binarne są
+// kodowane różnicowo - zawierają tylko pola zmienione od poprzedniej ramki
+// danego klienta, a co KEYFRAME_INTERVAL_MS wysyłana jest ramka pełna.
+// Wywoływane tylko z zadania sieciowego (bez blokad).
+class TelemetryStream {
+    public:
+        static const uint8_t MAX_CLIENTS = 4;
+        static const uint8_t MIN_RATE_HZ = 1;
+        static const uint8_t MAX_RATE_HZ = 20;
+        static const unsigned long KEYFRAME_INTERVAL_MS = 2000;
+
+    private:
+        struct Client {
+            uint32_t id;
+            bool active;
+            uint32_t fieldMask;
+            unsigned long intervalMs;
+            TelemetryFormat format;
+            unsigned long lastSent;
+            unsigned long lastKeyframe;
+            bool keyframePending;
+            uint16_t sequence;
+            TelemetryValues sent;    // Wartości znane klientowi
+        };
+
+        Client clients[MAX_CLIENTS];
+        uint8_t frame[sizeof(TelemetryFrameHeader) + sizeof(TelemetryValues)];
+        char text[768];
+
+        // Metody pomocnicze
+        static void quantize(const TelemetrySnapshot& t, uint32_t unixTime, TelemetryValues& values);
+        static const uint8_t* fieldData(const TelemetryValues& values, uint8_t field);
+        static size_t fieldSize(uint8_t field);
+        Client* find(uint32_t clientId);
+        size_t encodeBinary(Client& client, const TelemetryValues& values, bool keyframe);
+        size_t encodeJson(Client& client, const TelemetryValues& values);
+
+    public:
+        TelemetryStream();
+
+        // Subskrypcje (fieldMask == 0 usuwa klienta); false - brak miejsca
+        // dla nowego klienta (MAX_CLIENTS), klient nie dostaje danych
+        bool apply(const TelemetrySubscription& subscription);
+        static uint32_t fieldMaskFromName(const char* name);
+        static const char* getFieldName(uint8_t field);
+
+        // Wysłanie ramek klientom, dla których minął okres
+        void update(const TelemetrySnapshot& t, uint32_t unixTime, unsigned long now, AsyncWebSocket& ws);
+};
+
+#endif // TELEMETRY_STREAM_H
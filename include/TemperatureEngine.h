@@ -0,0 +1,79 @@
+#ifndef TEMPERATURE_ENGINE_H
+#define TEMPERATURE_ENGINE_H
+
+#include <Arduino.h>
+#include "Ds18b20Bus.h"
+
+// Czujniki DS18B20, po jednym na każdej magistrali 1-Wire (kanale):
+//  - adresy ROM wyszukiwane raz, przy starcie (brakujący czujnik - ponowne
+//    wyszukanie co DISCOVERY_RETRY_MS), odczyt i żądanie konwersji po adresie
+//  - konwersja na wszystkich magistralach naraz, odczyt po czasie konwersji
+//    dla najwyższej użytej rozdzielczości (bez sprawdzania gotowości);
+//    niższa rozdzielczość - krótszy odstęp żądań
+//  - rozdzielczość zależna od tempa zmian temperatury: szybkie zmiany -
+//    krótka konwersja (świeższy wynik), stała temperatura - 12 bitów (0,0625 °C)
+//  - tempo zmian z okna RATE_WINDOW_MS, zmiana o 1 LSB pomijana (odczyt
+//    migający na granicy kwantyzacji to nie zmiana temperatury)
+//  - liczniki odczytów i błędów oraz czas ostatniego poprawnego odczytu
+// Wywołanie update() z zadania czujników.
+class TemperatureEngine {
+    public:
+        static const uint8_t MAX_CHANNELS = 2;
+        static const uint32_t REQUEST_INTERVAL_MS = 1000;  // Przy 12 bitach, każdy bit mniej - połowa
+        static const uint32_t STALE_MS = 5000;              // Bez poprawnego odczytu - brak wartości
+        static const uint32_t DISCOVERY_RETRY_MS = 30000;
+        static const uint32_t RESOLUTION_HOLD_MS = 60000;   // Histereza zmian rozdzielczości
+        static const uint32_t RATE_WINDOW_MS = 5000;        // Okno pomiaru tempa zmian
+        static const uint8_t MIN_RESOLUTION = 10;           // 0,25 °C, 188 ms
+        static const uint8_t MAX_RESOLUTION = 12;           // 0,0625 °C, 750 ms
+        static constexpr float FAST_RATE_C_PER_S = 0.2f;    // Szybciej - rozdzielczość w dół
+        static constexpr float SLOW_RATE_C_PER_S = 0.05f;   // Wolniej - rozdzielczość w górę
+        static constexpr float MIN_VALID_C = -55.0f;
+        static constexpr float MAX_VALID_C = 125.0f;
+
+        struct Sensor {
+            DeviceAddress rom;
+            bool present;
+            uint8_t resolution;
+            float value;
+            float rate;               // Tempo zmian [°C/s] z ostatniego okna RATE_WINDOW_MS
+            float rateBaseValue;      // Odczyt na początku okna
+            uint32_t rateBaseMs;      // 0 - okno nierozpoczęte
+            uint32_t lastValidMs;
+            uint32_t lastResolutionChangeMs;
+            uint32_t lastDiscoveryMs;
+            uint32_t reads;
+            uint32_t errors;          // Brak odpowiedzi lub wartość poza zakresem
+            uint16_t consecutiveErrors;
+        };
+
+        // Kolejność wywołań addChannel() = numery kanałów
+        uint8_t addChannel(Ds18b20Bus* bus);
+        void begin(uint32_t nowMs);
+        void update(uint32_t nowMs);
+
+        // Ostatni poprawny odczyt; false - brak czujnika lub odczyt starszy niż STALE_MS
+        bool getTemperature(uint8_t channel, float& value, uint32_t nowMs) const;
+        const Sensor& getSensor(uint8_t channel) const { return sensors[channel]; }
+        uint8_t getChannelCount() const { return channelCount; }
+        uint32_t getRequestIntervalMs() const;   // Dla najwyższej rozdzielczości obecnych czujników
+        void printReport(Print& out, uint32_t nowMs) const;
+
+    private:
+        Ds18b20Bus* buses[MAX_CHANNELS] = {};
+        Sensor sensors[MAX_CHANNELS] = {};
+        uint8_t channelCount = 0;
+        bool conversionPending = false;
+        uint8_t requestedMask = 0;               // Kanały z konwersją w toku
+        uint32_t conversionStartMs = 0;
+        uint32_t conversionTimeMs = 0;
+        uint32_t lastRequestMs = 0;
+
+        bool discover(uint8_t channel, uint32_t nowMs);
+        void readResult(uint8_t channel, uint32_t nowMs);
+        void adaptResolution(uint8_t channel, uint32_t nowMs);
+        static uint32_t conversionMs(uint8_t resolution);
+        static float stepC(uint8_t resolution);   // 1 LSB [°C]
+};
+
+#endif // TEMPERATURE_ENGINE_H
@@ -0,0 +1,35 @@
+#ifndef TPMS_DECODER_H
+#define TPMS_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Dekodowanie rozgłoszeń BLE czujników ciśnienia w oponach (bez zależności
+// od Arduino; zapisane rozgłoszenia: sim/scenarios/tpms.txt).
+// Wejście: dane producenta z rozgłoszenia (AD typ 0xFF), razem z 2 bajtami
+// identyfikatora producenta.
+// Obsługiwany jest tylko format 0x0001 (czujniki z numerem koła w adresie).
+// Inne spotykane układy (np. 7 B: stan, bateria, temperatura, ciśnienie
+// w psi) nie mają identyfikatora producenta ani numeru koła - nie da się
+// ich odróżnić od innych urządzeń ani przypisać do koła, więc są pomijane.
+
+enum TpmsFormat : uint8_t {
+    TPMS_FORMAT_NONE = 0,
+    // 18 B: 0x0001 | numer czujnika (0x80 + n) i 5 B adresu | ciśnienie [Pa] (uint32 LE)
+    //       | temperatura [0,01 °C] (int32 LE) | bateria [%] | alarm
+    TPMS_FORMAT_0001
+};
+
+struct TpmsReading {
+    TpmsFormat format;
+    uint8_t position;         // Numer czujnika: 0 - przednie koło, 1 - tylne
+    float pressureBar;        // Nadciśnienie
+    float temperatureC;
+    uint8_t batteryPercent;
+    bool alarm;               // Czujnik zgłasza spadek ciśnienia lub błąd
+};
+
+// false - nierozpoznany format lub uszkodzone dane
+bool decodeTpmsAdvertisement(const uint8_t* manufacturerData, size_t length, TpmsReading& reading);
+
+#endif // TPMS_DECODER_H
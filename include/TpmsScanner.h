@@ -0,0 +1,70 @@
+#ifndef TPMS_SCANNER_H
+#define TPMS_SCANNER_H
+
+#include <Arduino.h>
+#include <BLEDevice.h>
+#include <freertos/FreeRTOS.h>
+#include "TpmsDecoder.h"
+
+// Czujnik TPMS zapamiętany po adresie MAC
+struct TpmsSensor {
+    uint8_t mac[6];
+    TpmsReading reading;
+    int8_t rssi;
+    uint32_t lastSeenMs;
+    uint32_t frames;          // Odebrane rozgłoszenia
+};
+
+// Pasywne skanowanie rozgłoszeń czujników TPMS, współdzielące radio
+// z połączeniem GATT do BMS:
+//  - skanowanie co SCAN_PERIOD_MS przez SCAN_DURATION_S (czujniki nadają co 1-2 s)
+//  - przy połączeniu z BMS okno skanowania to mała część interwału, więc
+//    kontroler ma czas na zdarzenia połączenia (zapytania i powiadomienia BMS)
+//  - bez skanowania w trakcie nawiązywania połączenia z BMS (isScanning())
+// Rozgłoszenia dekoduje callback stosu BT, wyniki trafiają do pamięci
+// czujników (MAX_SENSORS, najstarszy wpis jest zastępowany).
+class TpmsScanner : public BLEAdvertisedDeviceCallbacks {
+    public:
+        static const uint8_t MAX_SENSORS = 8;
+        static const uint32_t SCAN_PERIOD_MS = 10000;
+        static const uint32_t SCAN_DURATION_S = 2;
+        static const uint16_t SCAN_INTERVAL_MS = 200;
+        static const uint16_t SCAN_WINDOW_SHARED_MS = 30;   // Z połączeniem BMS (15% czasu radia)
+        static const uint16_t SCAN_WINDOW_ALONE_MS = 180;   // Bez połączenia
+        static const uint32_t STALE_MS = 900000;            // Czujnik na postoju nadaje rzadko
+
+        TpmsScanner();
+
+        // Po BLEDevice::init()
+        void begin();
+
+        // Zadanie BLE: rozpoczęcie kolejnego skanowania
+        void update(uint32_t nowMs, bool bmsConnected);
+        void stop();
+        bool isScanning() const { return scanning; }
+
+        // Ostatni odczyt czujnika o danym numerze (0 - przód, 1 - tył); false - brak lub nieaktualny
+        bool getSensor(uint8_t position, TpmsSensor& sensor, uint32_t nowMs);
+        uint32_t getUpdateCount() const { return updates; }
+        uint32_t getScanCount() const { return scans; }
+
+        // Callback stosu BT
+        void onResult(BLEAdvertisedDevice advertisedDevice) override;
+
+    private:
+        BLEScan* scan = nullptr;
+        portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+        TpmsSensor sensors[MAX_SENSORS];
+        uint8_t sensorCount = 0;
+        volatile bool scanning = false;
+        volatile uint32_t updates = 0;
+        uint32_t scans = 0;
+        uint32_t lastScanMs = 0;
+        uint16_t currentWindowMs = 0;
+
+        static TpmsScanner* instance;
+        static void onScanComplete(BLEScanResults results);
+        static bool parseMac(const std::string& text, uint8_t mac[6]);
+};
+
+#endif // TPMS_SCANNER_H
@@ -0,0 +1,38 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+
+// Pliki interfejsu webowego przygotowane przez tools/build_web.py (data/www):
+// skompresowane gzip, CSS/JS ze skrótem treści w nazwie. Obsługiwane są tylko
+// adresy z manifestu - bez sprawdzania istnienia plików przy każdym żądaniu.
+class WebAssets : public AsyncWebHandler {
+    public:
+        static const uint8_t MAX_ASSETS = 8;
+
+        // Wczytanie manifestu; false - brak plików interfejsu (uploadfs)
+        bool begin(FS& fs, const char* manifestPath = "/www/manifest.txt");
+        uint8_t count() const { return assetCount; }
+
+        bool canHandle(AsyncWebServerRequest* request) override;
+        void handleRequest(AsyncWebServerRequest* request) override;
+
+    private:
+        struct Asset {
+            char uri[48];
+            char file[56];
+            char etag[12];          // Skrót treści w cudzysłowie
+            char contentType[32];
+            uint32_t maxAge;        // [s], 0 - sprawdzany przy każdym wczytaniu strony
+        };
+
+        FS* fs = nullptr;
+        Asset assets[MAX_ASSETS];
+        uint8_t assetCount = 0;
+
+        const Asset* find(const String& uri) const;
+};
+
+#endif // WEB_ASSETS_H
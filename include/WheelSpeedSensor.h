@@ -0,0 +1,59 @@
+#ifndef WHEEL_SPEED_SENSOR_H
+#define WHEEL_SPEED_SENSOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+// Czujnik prędkości koła (kontaktron lub hallotron zwierający pin do GND,
+// jeden impuls na obrót). Przerwanie zapisuje czas impulsu i okres obrotu,
+// prędkość liczona jest z okresu w zadaniu czujników, więc zmienia się
+// po każdym obrocie koła.
+class WheelSpeedSensor {
+    public:
+        static const uint8_t MAX_SPEED_KMH = 100;                 // Krótsze okresy to drgania styku
+        static const unsigned long STANDSTILL_TIMEOUT_MS = 4000;  // Brak impulsu = postój (< ok. 2 km/h)
+
+    private:
+        uint8_t pin = 0xFF;
+        portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+        // Dane z przerwania
+        volatile uint16_t circumferenceMm = 2075;
+        volatile uint32_t minIntervalUs = 0;
+        volatile uint32_t pulseCount = 0;
+        volatile uint32_t lastPulseUs = 0;
+        volatile uint32_t periodUs = 0;          // 0 - pierwszy impuls po postoju
+
+        // Dane zadania czujników
+        uint32_t countedPulses = 0;
+        uint32_t pendingMm = 0;                  // Dystans jeszcze nieprzekazany do licznika
+        uint32_t rideMm = 0;                     // Dystans od włączenia (do średniej)
+        uint32_t movingMs = 0;                   // Czas jazdy od włączenia
+        unsigned long lastUpdate = 0;
+        float speed = 0.0f;
+        float maxSpeed = 0.0f;
+
+        static void IRAM_ATTR handlePulse(void* arg);
+
+    public:
+        void begin(uint8_t sensorPin, uint16_t wheelCircumferenceMm);
+        void setCircumference(uint16_t wheelCircumferenceMm);
+
+        // Obwód koła z rozmiaru w ustawieniach (cale, 0 = 700C)
+        static uint16_t circumferenceForWheelSize(uint8_t wheelSize);
+
+        // Wywoływane z zadania czujników
+        void update(unsigned long now);
+        uint32_t takeMeters();      // Pełne metry od poprzedniego wywołania (dla licznika)
+
+        float getSpeed() const { return speed; }                  // km/h
+        float getMaxSpeed() const { return maxSpeed; }
+        float getAverageSpeed() const;                            // Średnia z czasu jazdy
+        uint32_t getPulseCount() const { return pulseCount; }
+
+        // Statystyki podróży zachowywane w czasie głębokiego uśpienia
+        void getTripStats(uint32_t& rideMillimeters, uint32_t& movingMillis, float& maxKmh) const;
+        void restoreTripStats(uint32_t rideMillimeters, uint32_t movingMillis, float maxKmh);
+};
+
+#endif // WHEEL_SPEED_SENSOR_H
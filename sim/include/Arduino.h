@@ -0,0 +1,130 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// Rdzeń Arduino-ESP32 dla symulatora (env:native)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "IPAddress.h"
+#include "Esp.h"
+#include "esp_sleep.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+using std::abs;
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+
+// Atrybuty sekcji pamięci ESP32 - bez znaczenia na hoście, poza pamięcią RTC:
+// zmienne RTC_DATA_ATTR w osobnej sekcji, zachowywanej przez symulator między
+// głębokim uśpieniem a uruchomieniem z --wakeup (tylko format ELF)
+#define IRAM_ATTR
+#define DRAM_ATTR
+#ifdef __ELF__
+#define RTC_DATA_ATTR __attribute__((section("sim_rtc")))
+#else
+#define RTC_DATA_ATTR
+#endif
+#define RTC_NOINIT_ATTR
+#define PROGMEM
+#define PSTR(s) (s)
+
+#define HIGH 0x1
+#define LOW  0x0
+
+// Tryby pinów
+#define INPUT             0x01
+#define OUTPUT            0x03
+#define PULLUP            0x04
+#define INPUT_PULLUP      0x05
+#define PULLDOWN          0x08
+#define INPUT_PULLDOWN    0x09
+
+// Zbocza przerwań
+#define RISING    0x01
+#define FALLING   0x02
+#define CHANGE    0x03
+#define ONLOW     0x04
+#define ONHIGH    0x05
+
+#define PI 3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define digitalPinToInterrupt(p) (p)
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+// Czas (symulowany)
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// Piny
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+int8_t digitalPinToAnalogChannel(uint8_t pin);   // ADC1: 0-7, ADC2: 10-19, brak: -1
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+// Timer sprzętowy (esp32-hal-timer z rdzenia 2.x) - przerwanie w osobnym wątku
+typedef struct sim_hw_timer hw_timer_t;
+hw_timer_t* timerBegin(uint8_t num, uint16_t divider, bool countUp);
+void timerEnd(hw_timer_t* timer);
+void timerAttachInterrupt(hw_timer_t* timer, void (*handler)(), bool edge);
+void timerDetachInterrupt(hw_timer_t* timer);
+void timerAlarmWrite(hw_timer_t* timer, uint64_t alarmValue, bool autoreload);
+void timerAlarmEnable(hw_timer_t* timer);
+void timerAlarmDisable(hw_timer_t* timer);
+uint64_t timerRead(hw_timer_t* timer);
+
+// Liczby losowe
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+// Synchronizacja czasu (SNTP) - na hoście zegar systemowy jest już ustawiony
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+bool getLocalTime(struct tm* info, uint32_t timeoutMs = 5000);
+
+// strlcpy jest w glibc dopiero od wersji 2.38
+#if defined(__GLIBC__) && __GLIBC__ == 2 && __GLIBC_MINOR__ < 38
+#define SIM_NEEDS_STRLCPY
+size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+// Punkty wejścia szkicu
+void setup();
+void loop();
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,6 @@
+#ifndef SIM_ASYNCTCP_H
+#define SIM_ASYNCTCP_H
+
+// W symulatorze połączenia TCP obsługuje bezpośrednio ESPAsyncWebServer.h
+
+#endif // SIM_ASYNCTCP_H
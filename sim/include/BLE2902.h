@@ -0,0 +1,16 @@
+#ifndef SIM_BLE2902_H
+#define SIM_BLE2902_H
+
+#include "BLEDevice.h"
+
+// Deskryptor CCCD - w symulatorze powiadomienia włącza registerForNotify()
+class BLE2902 {
+    private:
+        bool notifications = false;
+
+    public:
+        void setNotifications(bool enable) { notifications = enable; }
+        bool getNotifications() const { return notifications; }
+};
+
+#endif // SIM_BLE2902_H
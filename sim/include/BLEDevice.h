@@ -0,0 +1,181 @@
+#ifndef SIM_BLEDEVICE_H
+#define SIM_BLEDEVICE_H
+
+// Klient BLE dla symulatora. Pod adresem dowolnego urządzenia odpowiada
+// symulowany BMS JBD (usługa 0xFF00, Rx 0xFF01, Tx 0xFF02): zapytania 0x03, 0x04
+// i 0x08 są obsługiwane po 30-80 ms, a odpowiedź przychodzi w powiadomieniach
+// po 20 bajtów (domyślne MTU), tak jak z prawdziwego modułu.
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+
+class BLERemoteCharacteristic;
+class BLERemoteService;
+class BLEClient;
+
+typedef void (*notify_callback)(BLERemoteCharacteristic* characteristic, uint8_t* data,
+                                size_t length, bool isNotify);
+
+class BLEUUID {
+    private:
+        std::string value;
+
+    public:
+        BLEUUID() {}
+        BLEUUID(const char* uuid);
+        BLEUUID(const std::string& uuid) : BLEUUID(uuid.c_str()) {}
+        BLEUUID(uint16_t uuid);
+
+        bool equals(const BLEUUID& other) const { return value == other.value; }
+        bool operator==(const BLEUUID& other) const { return equals(other); }
+        bool operator<(const BLEUUID& other) const { return value < other.value; }
+        std::string toString() const { return value; }
+};
+
+class BLEAddress {
+    private:
+        std::string value;
+
+    public:
+        BLEAddress(const char* address) : value(address) {}
+        BLEAddress(const std::string& address) : value(address) {}
+        std::string toString() const { return value; }
+        bool equals(const BLEAddress& other) const { return value == other.value; }
+};
+
+class BLERemoteCharacteristic {
+    private:
+        BLEUUID uuid;
+        BLERemoteService* service;
+        bool notifiable;
+        notify_callback callback = nullptr;
+
+    public:
+        BLERemoteCharacteristic(const BLEUUID& uuid, BLERemoteService* service, bool notifiable)
+            : uuid(uuid), service(service), notifiable(notifiable) {}
+
+        BLEUUID getUUID() const { return uuid; }
+        BLERemoteService* getRemoteService() { return service; }
+        bool canNotify() const { return notifiable; }
+        bool canWrite() const { return !notifiable; }
+        bool canWriteNoResponse() const { return !notifiable; }
+
+        void registerForNotify(notify_callback newCallback, bool notifications = true, bool descriptorRequiresRegistration = true);
+        void writeValue(uint8_t* data, size_t length, bool response = false);
+        void writeValue(const std::string& value, bool response = false) {
+            writeValue((uint8_t*)value.data(), value.size(), response);
+        }
+
+        // Dostarczenie powiadomienia (wątek symulowanego BMS)
+        void deliver(uint8_t* data, size_t length);
+};
+
+class BLERemoteService {
+    private:
+        BLEUUID uuid;
+        BLEClient* client;
+        std::map<BLEUUID, BLERemoteCharacteristic*> characteristics;
+
+    public:
+        BLERemoteService(const BLEUUID& uuid, BLEClient* client);
+        ~BLERemoteService();
+
+        BLEUUID getUUID() const { return uuid; }
+        BLEClient* getClient() { return client; }
+        BLERemoteCharacteristic* getCharacteristic(const BLEUUID& uuid);
+        BLERemoteCharacteristic* getCharacteristic(const char* uuid) { return getCharacteristic(BLEUUID(uuid)); }
+};
+
+class BLEClientCallbacks {
+    public:
+        virtual ~BLEClientCallbacks() {}
+        virtual void onConnect(BLEClient* client) { (void)client; }
+        virtual void onDisconnect(BLEClient* client) { (void)client; }
+};
+
+class BLEClient {
+    private:
+        bool connected = false;
+        BLERemoteService* service = nullptr;
+        BLEClientCallbacks* callbacks = nullptr;
+
+    public:
+        ~BLEClient();
+
+        bool connect(BLEAddress address, uint8_t type = 0);
+        void disconnect();
+        bool isConnected() const { return connected; }
+        void setClientCallbacks(BLEClientCallbacks* newCallbacks) { callbacks = newCallbacks; }
+        int getRssi() const { return -60; }
+        uint16_t getMTU() const { return 23; }
+
+        BLERemoteService* getService(const BLEUUID& uuid);
+        BLERemoteService* getService(const char* uuid) { return getService(BLEUUID(uuid)); }
+};
+
+// --- Skanowanie ---
+
+class BLEAdvertisedDevice {
+    private:
+        BLEAddress address;
+        std::string manufacturerData;
+        int rssi;
+
+    public:
+        BLEAdvertisedDevice(const BLEAddress& address, const std::string& manufacturerData, int rssi)
+            : address(address), manufacturerData(manufacturerData), rssi(rssi) {}
+
+        BLEAddress getAddress() { return address; }
+        bool haveManufacturerData() { return !manufacturerData.empty(); }
+        std::string getManufacturerData() { return manufacturerData; }
+        int getRSSI() { return rssi; }
+};
+
+class BLEAdvertisedDeviceCallbacks {
+    public:
+        virtual ~BLEAdvertisedDeviceCallbacks() {}
+        virtual void onResult(BLEAdvertisedDevice advertisedDevice) = 0;
+};
+
+class BLEScanResults {
+    public:
+        int getCount() { return 0; }   // Symulator nie gromadzi wyników
+};
+
+// Rozgłoszenia ze scenariusza (ble-adv) docierają tylko w trakcie skanowania
+// i w oknie (window) każdego interwału - jak w kontrolerze BLE
+class BLEScan {
+    private:
+        BLEAdvertisedDeviceCallbacks* callbacks = nullptr;
+        bool activeScan = true;
+        uint16_t intervalMs = 100;
+        uint16_t windowMs = 100;
+        bool scanning = false;
+        uint64_t startMicros = 0;
+        uint32_t scanId = 0;
+
+    public:
+        void setAdvertisedDeviceCallbacks(BLEAdvertisedDeviceCallbacks* newCallbacks, bool wantDuplicates = false,
+                                          bool shouldParse = true);
+        void setActiveScan(bool active) { activeScan = active; }
+        void setInterval(uint16_t intervalMSecs) { intervalMs = intervalMSecs; }
+        void setWindow(uint16_t windowMSecs) { windowMs = windowMSecs; }
+        bool start(uint32_t duration, void (*scanCompleteCB)(BLEScanResults), bool is_continue = false);
+        void stop();
+        void clearResults() {}
+
+        // Symulator: rozgłoszenie z wątku scenariusza
+        bool deliver(BLEAdvertisedDevice device);
+};
+
+class BLEDevice {
+    public:
+        static void init(const std::string& deviceName);
+        static BLEClient* createClient();
+        static BLEScan* getScan();
+        static void deinit(bool releaseMemory = false);
+        static bool getInitialized();
+};
+
+#endif // SIM_BLEDEVICE_H
@@ -0,0 +1,376 @@
+#ifndef SIM_ESPASYNCWEBSERVER_H
+#define SIM_ESPASYNCWEBSERVER_H
+
+// ESPAsyncWebServer dla symulatora: te same klasy i kolejność dopasowania
+// handlerów co w bibliotece, ale bez TCP. Żądania wstrzykuje scenariusz
+// (sim::httpRequest), odpowiedzi trafiają na stdout i do <katalog wyjściowy>/http.log,
+// a wiadomości WebSocket do <katalog wyjściowy>/ws.log.
+
+#include <Arduino.h>
+#include <FS.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+class AsyncWebServer;
+class AsyncWebServerRequest;
+class AsyncWebSocket;
+class AsyncWebSocketClient;
+
+typedef enum {
+    HTTP_GET     = 0b00000001,
+    HTTP_POST    = 0b00000010,
+    HTTP_DELETE  = 0b00000100,
+    HTTP_PUT     = 0b00001000,
+    HTTP_PATCH   = 0b00010000,
+    HTTP_HEAD    = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY     = 0b01111111
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, const String& filename, size_t index,
+                           uint8_t* data, size_t len, bool final)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                           size_t index, size_t total)> ArBodyHandlerFunction;
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+// --- Parametry i nagłówki ---
+
+class AsyncWebParameter {
+    private:
+        String paramName;
+        String paramValue;
+        bool post;
+
+    public:
+        AsyncWebParameter(const String& name, const String& value, bool post = false)
+            : paramName(name), paramValue(value), post(post) {}
+        const String& name() const { return paramName; }
+        const String& value() const { return paramValue; }
+        size_t size() const { return paramValue.length(); }
+        bool isPost() const { return post; }
+        bool isFile() const { return false; }
+};
+
+class AsyncWebHeader {
+    private:
+        String headerName;
+        String headerValue;
+
+    public:
+        AsyncWebHeader(const String& name, const String& value) : headerName(name), headerValue(value) {}
+        const String& name() const { return headerName; }
+        const String& value() const { return headerValue; }
+};
+
+// --- Odpowiedzi ---
+
+class AsyncWebServerResponse {
+    protected:
+        int responseCode;
+        String type;
+        std::string content;
+        std::vector<AsyncWebHeader> headers;
+
+    public:
+        AsyncWebServerResponse(int code = 200, const String& contentType = String())
+            : responseCode(code), type(contentType) {}
+        virtual ~AsyncWebServerResponse() {}
+
+        void setCode(int code) { responseCode = code; }
+        void setContentType(const String& contentType) { type = contentType; }
+        void setContentLength(size_t length) { (void)length; }
+        void addHeader(const String& name, const String& value) { headers.push_back(AsyncWebHeader(name, value)); }
+
+        int code() const { return responseCode; }
+        const String& contentType() const { return type; }
+        const std::string& body() const { return content; }
+        const std::vector<AsyncWebHeader>& getHeaders() const { return headers; }
+};
+
+class AsyncBasicResponse : public AsyncWebServerResponse {
+    public:
+        AsyncBasicResponse(int code, const String& contentType, const String& text)
+            : AsyncWebServerResponse(code, contentType) { content = text.c_str(); }
+        AsyncBasicResponse(int code, const String& contentType, const uint8_t* data, size_t length)
+            : AsyncWebServerResponse(code, contentType) { content.assign((const char*)data, length); }
+};
+
+class AsyncFileResponse : public AsyncWebServerResponse {
+    public:
+        AsyncFileResponse(FS& fs, const String& path, const String& contentType, bool download = false);
+};
+
+// Odpowiedź generowana fragmentami - symulator wywołuje callback od razu, aż zwróci 0
+class AsyncChunkedResponse : public AsyncWebServerResponse {
+    public:
+        static const size_t CHUNK_SIZE = 1460;
+
+        AsyncChunkedResponse(const String& contentType, AwsResponseFiller callback)
+            : AsyncWebServerResponse(200, contentType) {
+            uint8_t buffer[CHUNK_SIZE];
+            size_t length;
+            while ((length = callback(buffer, sizeof(buffer), content.size())) > 0) {
+                content.append((const char*)buffer, length);
+            }
+        }
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+    public:
+        AsyncResponseStream(const String& contentType, size_t bufferSize)
+            : AsyncWebServerResponse(200, contentType) { content.reserve(bufferSize); }
+
+        size_t write(uint8_t c) override { content.push_back((char)c); return 1; }
+        size_t write(const uint8_t* data, size_t length) override {
+            content.append((const char*)data, length);
+            return length;
+        }
+        using Print::write;
+};
+
+// --- Żądanie ---
+
+class AsyncWebServerRequest {
+    private:
+        WebRequestMethodComposite requestMethod;
+        String requestUrl;
+        std::vector<AsyncWebParameter> parameters;
+        std::vector<AsyncWebHeader> requestHeaders;
+        AsyncWebServerResponse* response = nullptr;
+
+    public:
+        AsyncWebServerRequest(WebRequestMethodComposite method, const String& url) : requestMethod(method), requestUrl(url) {}
+        ~AsyncWebServerRequest() { delete response; }
+
+        WebRequestMethodComposite method() const { return requestMethod; }
+        const char* methodToString() const;
+        const String& url() const { return requestUrl; }
+        String host() const { return String("192.168.4.1"); }
+
+        size_t params() const { return parameters.size(); }
+        bool hasParam(const String& name, bool post = false, bool file = false) const;
+        AsyncWebParameter* getParam(const String& name, bool post = false, bool file = false);
+        AsyncWebParameter* getParam(size_t index) { return index < parameters.size() ? &parameters[index] : nullptr; }
+        bool hasArg(const char* name) const { return hasParam(name) || hasParam(name, true); }
+        const String& arg(const String& name);
+
+        size_t headers() const { return requestHeaders.size(); }
+        bool hasHeader(const String& name) const;
+        AsyncWebHeader* getHeader(const String& name);
+        const String& header(const char* name);
+        void addInterestingHeader(const String& name) { (void)name; }  // Symulator zachowuje wszystkie nagłówki
+
+        void send(AsyncWebServerResponse* newResponse);
+        void send(int code, const String& contentType = String(), const String& content = String()) {
+            send(beginResponse(code, contentType, content));
+        }
+        void send(FS& fs, const String& path, const String& contentType = String(), bool download = false) {
+            send(beginResponse(fs, path, contentType, download));
+        }
+        void send_P(int code, const String& contentType, const uint8_t* content, size_t length) {
+            send(beginResponse_P(code, contentType, content, length));
+        }
+        void redirect(const String& url);
+
+        AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(), const String& content = String()) {
+            return new AsyncBasicResponse(code, contentType, content);
+        }
+        AsyncWebServerResponse* beginResponse(FS& fs, const String& path, const String& contentType = String(), bool download = false) {
+            return new AsyncFileResponse(fs, path, contentType, download);
+        }
+        AsyncWebServerResponse* beginResponse_P(int code, const String& contentType, const uint8_t* content, size_t length) {
+            return new AsyncBasicResponse(code, contentType, content, length);
+        }
+        AsyncWebServerResponse* beginChunkedResponse(const String& contentType, AwsResponseFiller callback) {
+            return new AsyncChunkedResponse(contentType, callback);
+        }
+        AsyncResponseStream* beginResponseStream(const String& contentType, size_t bufferSize = 1460) {
+            return new AsyncResponseStream(contentType, bufferSize);
+        }
+
+        // Symulator: budowanie żądania i odczyt odpowiedzi
+        void addParam(const String& name, const String& value, bool post) { parameters.push_back(AsyncWebParameter(name, value, post)); }
+        void addHeader(const String& name, const String& value) { requestHeaders.push_back(AsyncWebHeader(name, value)); }
+        AsyncWebServerResponse* getResponse() const { return response; }
+};
+
+// --- Handlery ---
+
+class AsyncWebHandler {
+    public:
+        virtual ~AsyncWebHandler() {}
+        virtual bool canHandle(AsyncWebServerRequest* request) { (void)request; return false; }
+        virtual void handleRequest(AsyncWebServerRequest* request) { (void)request; }
+        virtual void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            (void)request; (void)data; (void)len; (void)index; (void)total;
+        }
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+    private:
+        String uri;
+        WebRequestMethodComposite methods;
+        ArRequestHandlerFunction onRequest;
+        ArUploadHandlerFunction onUpload;
+        ArBodyHandlerFunction onBody;
+
+    public:
+        AsyncCallbackWebHandler(const String& uri, WebRequestMethodComposite methods, ArRequestHandlerFunction onRequest,
+                                ArUploadHandlerFunction onUpload, ArBodyHandlerFunction onBody)
+            : uri(uri), methods(methods), onRequest(onRequest), onUpload(onUpload), onBody(onBody) {}
+
+        bool canHandle(AsyncWebServerRequest* request) override;
+        void handleRequest(AsyncWebServerRequest* request) override { if (onRequest) onRequest(request); }
+        void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) override {
+            if (onBody) onBody(request, data, len, index, total);
+        }
+};
+
+class AsyncStaticWebHandler : public AsyncWebHandler {
+    private:
+        String uri;
+        FS& fs;
+        String path;
+        String defaultFile = "index.html";
+        String cacheControl;
+
+        bool resolve(const String& url, String& file);
+
+    public:
+        AsyncStaticWebHandler(const String& uri, FS& fs, const String& path, const char* cacheControl)
+            : uri(uri), fs(fs), path(path), cacheControl(cacheControl ? cacheControl : "") {}
+
+        AsyncStaticWebHandler& setDefaultFile(const char* filename) { defaultFile = filename; return *this; }
+        AsyncStaticWebHandler& setCacheControl(const char* value) { cacheControl = value; return *this; }
+
+        bool canHandle(AsyncWebServerRequest* request) override;
+        void handleRequest(AsyncWebServerRequest* request) override;
+};
+
+// --- WebSocket ---
+
+typedef enum {
+    WS_EVT_CONNECT,
+    WS_EVT_DISCONNECT,
+    WS_EVT_PONG,
+    WS_EVT_ERROR,
+    WS_EVT_DATA
+} AwsEventType;
+
+typedef enum {
+    WS_CONTINUATION = 0x00,
+    WS_TEXT = 0x01,
+    WS_BINARY = 0x02,
+    WS_DISCONNECT = 0x08,
+    WS_PING = 0x09,
+    WS_PONG = 0x0A
+} AwsFrameType;
+
+typedef struct {
+    uint8_t message_opcode;
+    uint32_t num;
+    uint8_t final;
+    uint8_t masked;
+    uint8_t opcode;
+    uint64_t len;
+    uint8_t mask[4];
+    uint64_t index;
+} AwsFrameInfo;
+
+typedef std::function<void(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type,
+                           void* arg, uint8_t* data, size_t len)> AwsEventHandler;
+
+class AsyncWebSocketClient {
+    private:
+        AsyncWebSocket* socket;
+        uint32_t clientId;
+        bool connected = true;
+
+    public:
+        AsyncWebSocketClient(AsyncWebSocket* socket, uint32_t id) : socket(socket), clientId(id) {}
+
+        uint32_t id() const { return clientId; }
+        IPAddress remoteIP() const { return IPAddress(192, 168, 4, 2); }
+        AsyncWebSocket* server() { return socket; }
+        bool canSend() const { return connected; }
+        bool queueIsFull() const { return false; }
+        bool isConnected() const { return connected; }
+
+        void text(const char* message, size_t length);
+        void text(const char* message) { text(message, strlen(message)); }
+        void text(const String& message) { text(message.c_str(), message.length()); }
+        void binary(const uint8_t* message, size_t length);
+        void close();
+};
+
+class AsyncWebSocket : public AsyncWebHandler {
+    private:
+        String url;
+        AwsEventHandler eventHandler;
+        std::vector<AsyncWebSocketClient*> clients;
+        uint32_t nextId = 1;
+
+    public:
+        explicit AsyncWebSocket(const String& url) : url(url) {}
+        ~AsyncWebSocket();
+
+        void onEvent(AwsEventHandler handler) { eventHandler = handler; }
+        size_t count() const;
+        AsyncWebSocketClient* client(uint32_t id);
+        void cleanupClients(uint16_t maxClients = 8);
+        bool availableForWriteAll() const { return true; }
+
+        void text(uint32_t id, const char* message, size_t length);
+        void text(uint32_t id, const String& message) { text(id, message.c_str(), message.length()); }
+        void textAll(const char* message, size_t length);
+        void textAll(const char* message) { textAll(message, strlen(message)); }
+        void textAll(const String& message) { textAll(message.c_str(), message.length()); }
+        void binary(uint32_t id, const uint8_t* message, size_t length);
+        void binaryAll(const uint8_t* message, size_t length);
+        void binaryAll(const char* message, size_t length) { binaryAll((const uint8_t*)message, length); }
+        void closeAll();
+
+        // Symulator: zdarzenia klientów
+        AsyncWebSocketClient* connectClient();
+        void disconnectClient(AsyncWebSocketClient* client);
+        void receive(AsyncWebSocketClient* client, AwsFrameType type, const uint8_t* data, size_t length);
+        AsyncWebSocketClient* lastClient() { return clients.empty() ? nullptr : clients.back(); }
+        void log(uint32_t id, bool binary, const uint8_t* message, size_t length);
+};
+
+// --- Serwer ---
+
+class AsyncWebServer {
+    private:
+        uint16_t port;
+        std::vector<AsyncWebHandler*> handlers;
+        ArRequestHandlerFunction notFound;
+        bool running = false;
+
+    public:
+        explicit AsyncWebServer(uint16_t port) : port(port) {}
+        ~AsyncWebServer();
+
+        void begin();
+        void end();
+        void reset();
+
+        AsyncWebHandler& addHandler(AsyncWebHandler* handler);
+        bool removeHandler(AsyncWebHandler* handler);
+        AsyncCallbackWebHandler& on(const char* uri, ArRequestHandlerFunction onRequest) {
+            return on(uri, HTTP_ANY, onRequest);
+        }
+        AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                                    ArUploadHandlerFunction onUpload = nullptr, ArBodyHandlerFunction onBody = nullptr);
+        AsyncStaticWebHandler& serveStatic(const char* uri, FS& fs, const char* path, const char* cacheControl = nullptr);
+        void onNotFound(ArRequestHandlerFunction handler) { notFound = handler; }
+
+        // Symulator: obsługa żądania ze scenariusza (zwraca kod odpowiedzi, 0 gdy brak)
+        int handle(AsyncWebServerRequest* request, const std::string& body);
+        std::vector<AsyncWebSocket*> webSockets();
+};
+
+#endif // SIM_ESPASYNCWEBSERVER_H
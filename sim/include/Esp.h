@@ -0,0 +1,26 @@
+#ifndef SIM_ESP_H
+#define SIM_ESP_H
+
+#include <stdint.h>
+
+// Informacje o układzie - wartości odpowiadają modułowi ESP32-WROOM (4 MB flash, bez PSRAM)
+class EspClass {
+    public:
+        uint32_t getHeapSize() { return 327680; }
+        uint32_t getFreeHeap();
+        uint32_t getMinFreeHeap();
+        uint32_t getMaxAllocHeap() { return 110592; }
+        uint32_t getPsramSize() { return 0; }
+        uint32_t getFreePsram() { return 0; }
+        uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+        uint32_t getSketchSize() { return 1024 * 1024; }
+        uint32_t getFreeSketchSpace() { return 0x140000 - getSketchSize(); }
+        uint32_t getCpuFreqMHz() { return 240; }
+        uint32_t getCycleCount();
+        const char* getChipModel() { return "ESP32-SIM"; }
+        void restart();
+};
+
+extern EspClass ESP;
+
+#endif // SIM_ESP_H
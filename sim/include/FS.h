@@ -0,0 +1,88 @@
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+// System plików dla symulatora: pliki w katalogu hosta
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+namespace fs {
+
+    enum SeekMode {
+        SeekSet = 0,
+        SeekCur = 1,
+        SeekEnd = 2
+    };
+
+    struct FileImpl;
+    class FS;
+
+    class File : public Stream {
+        private:
+            std::shared_ptr<FileImpl> impl;
+
+        public:
+            File() {}
+            explicit File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+            size_t write(uint8_t c) override;
+            size_t write(const uint8_t* buffer, size_t size) override;
+            using Print::write;
+            void flush() override;
+
+            int available() override;
+            int read() override;
+            int peek() override;
+            size_t read(uint8_t* buffer, size_t size);
+            size_t readBytes(char* buffer, size_t length) override { return read((uint8_t*)buffer, length); }
+
+            bool seek(uint32_t position, SeekMode mode = SeekSet);
+            size_t position() const;
+            size_t size() const;
+            void close();
+            operator bool() const;
+            time_t getLastWrite();
+
+            const char* path() const;
+            const char* name() const;
+            bool isDirectory();
+            File openNextFile(const char* mode = "r");
+            void rewindDirectory();
+    };
+
+    class FS {
+        protected:
+            std::string root;      // Katalog hosta
+            bool mounted = false;
+
+            std::string hostPath(const char* path) const;
+
+        public:
+            File open(const char* path, const char* mode = "r", bool create = false);
+            File open(const String& path, const char* mode = "r", bool create = false) {
+                return open(path.c_str(), mode, create);
+            }
+
+            bool exists(const char* path);
+            bool exists(const String& path) { return exists(path.c_str()); }
+            bool remove(const char* path);
+            bool remove(const String& path) { return remove(path.c_str()); }
+            bool rename(const char* from, const char* to);
+            bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+            bool mkdir(const char* path);
+            bool mkdir(const String& path) { return mkdir(path.c_str()); }
+            bool rmdir(const char* path);
+            bool rmdir(const String& path) { return rmdir(path.c_str()); }
+    };
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // SIM_FS_H
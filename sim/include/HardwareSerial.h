@@ -0,0 +1,29 @@
+#ifndef SIM_HARDWARE_SERIAL_H
+#define SIM_HARDWARE_SERIAL_H
+
+#include "Stream.h"
+
+// Port szeregowy symulatora: wyjście na stdout, wejście ze stdin (nieblokująco)
+class HardwareSerial : public Stream {
+    private:
+        int peeked = -1;
+        bool inputClosed = false;
+
+    public:
+        void begin(unsigned long baud) { (void)baud; }
+        void end() {}
+        operator bool() const { return true; }
+
+        size_t write(uint8_t c) override;
+        size_t write(const uint8_t* buffer, size_t size) override;
+        using Print::write;
+        void flush() override;
+
+        int available() override;
+        int read() override;
+        int peek() override;
+};
+
+extern HardwareSerial Serial;
+
+#endif // SIM_HARDWARE_SERIAL_H
@@ -0,0 +1,19 @@
+#ifndef SIM_IP_ADDRESS_H
+#define SIM_IP_ADDRESS_H
+
+#include <stdint.h>
+#include "WString.h"
+
+class IPAddress {
+    private:
+        uint8_t octets[4];
+
+    public:
+        IPAddress() : octets{0, 0, 0, 0} {}
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{a, b, c, d} {}
+
+        uint8_t operator[](int index) const { return octets[index]; }
+        String toString() const;
+};
+
+#endif // SIM_IP_ADDRESS_H
@@ -0,0 +1,27 @@
+#ifndef SIM_LITTLEFS_H
+#define SIM_LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+    // LittleFS w katalogu <katalog wyjściowy>/littlefs. Przy pierwszym formatowaniu
+    // katalog jest wypełniany zawartością data/ (jak po "pio run -t uploadfs").
+    class LittleFSFS : public FS {
+        private:
+            static const size_t PARTITION_SIZE = 0x150000;
+
+        public:
+            bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+                       uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+            void end();
+            bool format();
+            size_t totalBytes() { return PARTITION_SIZE; }
+            size_t usedBytes();
+    };
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif // SIM_LITTLEFS_H
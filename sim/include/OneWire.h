@@ -0,0 +1,31 @@
+#ifndef SIM_ONEWIRE_H
+#define SIM_ONEWIRE_H
+
+#include <Arduino.h>
+
+// Magistrala 1-Wire bit po bicie: na każdym pinie symulowany jest jeden
+// czujnik DS18B20 (model w Devices.cpp, ten sam co dla RMT)
+class OneWire {
+    private:
+        uint8_t pin;
+
+        void writeBit(bool value);
+        bool readBit();
+
+    public:
+        explicit OneWire(uint8_t pin) : pin(pin) {}
+
+        uint8_t getPin() const { return pin; }
+        uint8_t reset();
+        void select(const uint8_t rom[8]);
+        void skip();
+        void write(uint8_t value, uint8_t power = 0);
+        uint8_t read();
+        void write_bytes(const uint8_t* data, uint16_t count, bool power = false);
+        void read_bytes(uint8_t* data, uint16_t count);
+        void reset_search() {}
+        bool search(uint8_t* address, bool searchMode = true);
+        static uint8_t crc8(const uint8_t* address, uint8_t length);
+};
+
+#endif // SIM_ONEWIRE_H
@@ -0,0 +1,44 @@
+#ifndef SIM_PRINT_H
+#define SIM_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Zamiennik klasy Print - klasy pochodne implementują write()
+class Print {
+    public:
+        virtual ~Print() {}
+
+        virtual size_t write(uint8_t c) = 0;
+        virtual size_t write(const uint8_t* buffer, size_t size);
+        size_t write(const char* str);
+        size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+        virtual void flush() {}
+
+        size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+        size_t print(const String& value) { return write(value.c_str(), value.length()); }
+        size_t print(const char* value) { return write(value); }
+        size_t print(const __FlashStringHelper* value) { return write(reinterpret_cast<const char*>(value)); }
+        size_t print(char value) { return write((uint8_t)value); }
+        size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+        size_t print(int value, int base = DEC) { return print((long)value, base); }
+        size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+        size_t print(long value, int base = DEC);
+        size_t print(unsigned long value, int base = DEC);
+        size_t print(long long value, int base = DEC);
+        size_t print(unsigned long long value, int base = DEC);
+        size_t print(double value, int digits = 2);
+
+        size_t println() { return write("\r\n"); }
+        template<typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+        template<typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+#endif // SIM_PRINT_H
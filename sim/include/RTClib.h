@@ -0,0 +1,55 @@
+#ifndef SIM_RTCLIB_H
+#define SIM_RTCLIB_H
+
+#include <Arduino.h>
+#include "Wire.h"
+
+// Data i czas (podzbiór RTClib)
+class DateTime {
+    private:
+        uint8_t yOff, m, d, hh, mm, ss;   // Rok od 2000
+
+    public:
+        DateTime(uint32_t unixTime = 946684800UL);   // 2000-01-01 00:00:00
+        DateTime(uint16_t year, uint8_t month, uint8_t day,
+                 uint8_t hour = 0, uint8_t minute = 0, uint8_t second = 0);
+        DateTime(const char* date, const char* time);   // __DATE__, __TIME__
+        DateTime(const __FlashStringHelper* date, const __FlashStringHelper* time);
+
+        uint16_t year() const { return 2000U + yOff; }
+        uint8_t month() const { return m; }
+        uint8_t day() const { return d; }
+        uint8_t hour() const { return hh; }
+        uint8_t minute() const { return mm; }
+        uint8_t second() const { return ss; }
+        uint8_t dayOfTheWeek() const;
+        uint32_t unixtime() const;
+        bool isValid() const;
+        String timestamp() const;
+};
+
+// Tryby wyjścia SQW/INT układu DS3231
+enum Ds3231SqwPinMode {
+    DS3231_OFF = 0x1C,
+    DS3231_SquareWave1Hz = 0x00,
+    DS3231_SquareWave1kHz = 0x08,
+    DS3231_SquareWave4kHz = 0x10,
+    DS3231_SquareWave8kHz = 0x18
+};
+
+// DS3231 - czas hosta przesunięty o korektę z adjust(), płynący w tempie symulacji.
+// adjust() zeruje dzielnik sekund (jak zapis rejestru sekund w układzie).
+// Odczyt czasu to transakcja I2C (czas liczony jak dla wyświetlacza).
+// SQW 1 Hz na pinie z polecenia scenariusza "sqw": zbocze opadające przy
+// zmianie sekundy, narastające po 500 ms.
+class RTC_DS3231 {
+    public:
+        bool begin(TwoWire* wire = &Wire) { (void)wire; return true; }
+        bool lostPower() { return false; }
+        void adjust(const DateTime& dt);
+        DateTime now();
+        void writeSqwPinMode(Ds3231SqwPinMode mode);
+        float getTemperature() { return 25.0f; }
+};
+
+#endif // SIM_RTCLIB_H
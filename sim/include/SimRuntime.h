@@ -0,0 +1,123 @@
+#ifndef SIM_RUNTIME_H
+#define SIM_RUNTIME_H
+
+// Środowisko symulatora (env:native): zegar, piny, katalog wyjściowy, liczniki.
+// Czas symulacji płynie "speed" razy szybciej niż czas rzeczywisty,
+// wszystkie oczekiwania (delay, FreeRTOS) są odpowiednio skracane.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+
+namespace sim {
+
+    // --- Zegar ---
+    uint64_t nowMicros();                     // Czas symulacji od startu [us]
+    void sleepMicros(uint64_t simMicros);     // Uśpienie wątku na czas symulacji
+    double speed();                           // Przyspieszenie czasu
+    void setSpeed(double factor);
+
+    // Oczekiwanie na zmiennej warunkowej z limitem w czasie symulacji.
+    // Zwraca false po przekroczeniu czasu.
+    template<typename Predicate>
+    bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                 uint64_t simMicros, Predicate ready);
+    std::chrono::nanoseconds realDuration(uint64_t simMicros);
+
+    // --- Katalog wyjściowy (.sim/ domyślnie) ---
+    const std::string& outputDir();
+    std::string outputPath(const std::string& name);
+    void setOutputDir(const std::string& path);
+
+    // --- Piny ---
+    void setInputLevel(uint8_t pin, int level);   // Np. wciśnięcie przycisku ze scenariusza
+    void setAnalogValue(uint8_t pin, uint16_t value);
+    void startPulses(uint8_t pin, double periodMs, long count);   // Czujniki prędkości i kadencji
+    int getPinLevel(uint8_t pin);
+    void connectRtcSqw(uint8_t pin);              // Wyjście SQW DS3231 (przebieg po włączeniu 1 Hz)
+    void countPulseEdge(uint8_t pin, bool rising);   // Zbocze dla liczników PCNT (Peripherals.cpp)
+
+    // --- 1-Wire (model DS18B20 w Devices.cpp, jeden czujnik na pinie) ---
+    bool oneWireReset(uint8_t pin);                  // true - impuls obecności
+    bool oneWireSlot(uint8_t pin, bool masterBit);   // Stan linii w slocie zapisu lub odczytu
+    void setOneWireTemperature(uint8_t pin, float celsius);   // NAN - z powrotem przebieg sinusoidalny
+
+    // Przerwania wyłączone (biblioteka OneWire) - przerwanie timera sprzętowego czeka
+    std::mutex& interruptMutex();
+
+    // --- LittleFS ---
+    // Następny zapis do pliku zapisze najwyżej maxBytes bajtów (np. brak miejsca)
+    void limitNextFsWrite(size_t maxBytes);
+
+    // --- BLE (wywołania ze scenariusza) ---
+    // Rozgłoszenie z danymi producenta (hex, z identyfikatorem producenta) - odbierane tylko w oknie skanowania
+    void bleAdvertise(const std::string& address, const std::string& manufacturerHex, int rssi);
+
+    // --- Sieć (wywołania ze scenariusza) ---
+    void httpRequest(const std::string& method, const std::string& uri, const std::string& body);
+    void httpHeader(const std::string& name, const std::string& value);   // Nagłówek następnego żądania
+    void webSocketConnect();
+    void webSocketSend(const std::string& text);   // Wiadomość tekstowa od ostatnio połączonego klienta
+    void printHttpStats();                          // Przydziały i czas obsługi dla każdego endpointu
+
+    // --- Przydziały pamięci (malloc/calloc/realloc bieżącego wątku) ---
+    struct HeapUsage {
+        uint32_t allocations;
+        uint64_t bytes;
+    };
+    HeapUsage threadHeapUsage();
+
+    // --- Liczniki do porównywania przebiegów ---
+    struct Counters {
+        std::atomic<uint32_t> displayFullFrames{0};
+        std::atomic<uint32_t> displayPartialUpdates{0};
+        std::atomic<uint64_t> displayBytes{0};
+        std::atomic<uint64_t> i2cMicros{0};
+        std::atomic<uint32_t> bleWrites{0};
+        std::atomic<uint32_t> bleNotifications{0};
+        std::atomic<uint32_t> bleScans{0};
+        std::atomic<uint32_t> bleAdvertisements{0};       // Wysłane ze scenariusza
+        std::atomic<uint32_t> bleAdvertisementsHeard{0};  // Odebrane w oknie skanowania
+        std::atomic<uint32_t> fsWrites{0};
+        std::atomic<uint64_t> fsBytesWritten{0};
+        std::atomic<uint32_t> nvsCommits{0};
+        std::atomic<uint32_t> flashWrites{0};          // Partycje danych (esp_partition_*)
+        std::atomic<uint64_t> flashBytesWritten{0};
+        std::atomic<uint32_t> flashSectorErases{0};
+        std::atomic<uint32_t> rtcReads{0};             // Odczyty czasu z DS3231 (I2C)
+        std::atomic<uint32_t> rtcWrites{0};
+        std::atomic<uint32_t> rtcSqwEdges{0};
+        std::atomic<uint32_t> httpRequests{0};
+        std::atomic<uint32_t> wsMessages{0};
+    };
+    Counters& counters();
+
+    // Zakończenie symulacji (np. esp_deep_sleep_start, polecenie "quit")
+    void requestExit(int code);
+    void onExit(void (*hook)());   // Np. zapis ostatniej klatki wyświetlacza
+
+    // Przyczyna wybudzenia podana w opcji --wakeup
+    int wakeupCause();
+
+    // Pamięć RTC (zmienne RTC_DATA_ATTR) w pliku rtc_memory.bin katalogu
+    // wyjściowego: zapis w esp_deep_sleep_start(), odczyt przy starcie z --wakeup.
+    // loadRtcMemory() - false przy braku pliku lub innym rozmiarze (inna kompilacja)
+    bool saveRtcMemory();
+    bool loadRtcMemory();
+    void clearRtcMemory();         // Jak po włączeniu zasilania
+
+} // namespace sim
+
+// --- Implementacja szablonu ---
+
+template<typename Predicate>
+bool sim::waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                  uint64_t simMicros, Predicate ready) {
+    return cv.wait_for(lock, realDuration(simMicros), ready);
+}
+
+#endif // SIM_RUNTIME_H
@@ -0,0 +1,23 @@
+#ifndef SIM_STREAM_H
+#define SIM_STREAM_H
+
+#include "Print.h"
+
+// Zamiennik klasy Stream (wymagany przez ArduinoJson przy odczycie z pliku)
+class Stream : public Print {
+    protected:
+        unsigned long timeout = 1000;
+
+    public:
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() = 0;
+
+        void setTimeout(unsigned long timeoutMs) { timeout = timeoutMs; }
+        virtual size_t readBytes(char* buffer, size_t length);
+        size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+        String readString();
+        String readStringUntil(char terminator);
+};
+
+#endif // SIM_STREAM_H
@@ -0,0 +1,106 @@
+#ifndef SIM_U8G2LIB_H
+#define SIM_U8G2LIB_H
+
+// U8g2 dla symulatora: bufor 128x64 w układzie kafelków SSD1306, tekst rysowany
+// wbudowaną czcionką 5x7 (skalowaną według rozmiaru czcionki). Każde wysłanie
+// obrazu zapisuje go do <katalog wyjściowy>/display.png i liczy czas transmisji I2C.
+
+#include <Arduino.h>
+
+#define U8X8_PIN_NONE 255
+
+typedef const struct u8g2_cb_struct* u8g2_cb_t_ptr;
+struct u8g2_cb_struct { uint8_t rotation; };
+extern const struct u8g2_cb_struct u8g2_cb_r0;
+extern const struct u8g2_cb_struct u8g2_cb_r2;
+#define U8G2_R0 (&u8g2_cb_r0)
+#define U8G2_R2 (&u8g2_cb_r2)
+
+// Czcionki: {skala, odstęp znaków w px, wysokość linii w px}
+extern const uint8_t u8g2_font_profont11_mf[];
+extern const uint8_t u8g2_font_profont11_tf[];
+extern const uint8_t u8g2_font_pxplusibmvga9_mf[];
+extern const uint8_t u8g2_font_pxplusibmvga9_tf[];
+extern const uint8_t u8g2_font_fub20_tr[];
+extern const uint8_t u8g2_font_fub14_tr[];
+extern const uint8_t u8g2_font_6x10_tf[];
+extern const uint8_t u8g2_font_ncenB08_tr[];
+
+class U8G2 : public Print {
+    public:
+        static const uint8_t WIDTH = 128;
+        static const uint8_t HEIGHT = 64;
+        static const uint8_t TILE_WIDTH = WIDTH / 8;
+        static const uint8_t TILE_HEIGHT = HEIGHT / 8;
+
+    private:
+        uint8_t buffer[WIDTH * HEIGHT / 8];   // Bufor w RAM (strony po 8 wierszy)
+        uint8_t panel[WIDTH * HEIGHT / 8];    // Zawartość "wyświetlacza"
+        const uint8_t* font = u8g2_font_profont11_mf;
+        uint8_t drawColor = 1;
+        bool powerSave = false;
+        int16_t cursorX = 0;
+        int16_t cursorY = 0;
+
+        void drawGlyph(int16_t x, int16_t y, char c);
+        void transfer(size_t bytes);
+
+    public:
+        explicit U8G2(u8g2_cb_t_ptr rotation = U8G2_R0);
+
+        bool begin();
+        void clearBuffer();
+        void clearDisplay();
+        void sendBuffer();
+        void updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th);
+        void setPowerSave(uint8_t enable);
+        void setContrast(uint8_t value) { (void)value; }
+        void setFlipMode(uint8_t mode) { (void)mode; }
+
+        uint8_t* getBufferPtr() { return buffer; }
+        uint8_t getBufferTileWidth() const { return TILE_WIDTH; }
+        uint8_t getBufferTileHeight() const { return TILE_HEIGHT; }
+        uint16_t getWidth() const { return WIDTH; }
+        uint16_t getHeight() const { return HEIGHT; }
+        uint16_t getDisplayWidth() const { return WIDTH; }
+        uint16_t getDisplayHeight() const { return HEIGHT; }
+
+        // Rysowanie
+        void setDrawColor(uint8_t color) { drawColor = color; }
+        uint8_t getDrawColor() const { return drawColor; }
+        void drawPixel(int16_t x, int16_t y);
+        void drawHLine(int16_t x, int16_t y, int16_t w);
+        void drawVLine(int16_t x, int16_t y, int16_t h);
+        void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+        void drawBox(int16_t x, int16_t y, int16_t w, int16_t h);
+        void drawFrame(int16_t x, int16_t y, int16_t w, int16_t h);
+        void drawRBox(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r) { (void)r; drawBox(x, y, w, h); }
+        void drawRFrame(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r) { (void)r; drawFrame(x, y, w, h); }
+        void drawCircle(int16_t x, int16_t y, int16_t r);
+        void drawDisc(int16_t x, int16_t y, int16_t r);
+        void drawXBM(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* bitmap);
+
+        // Tekst
+        void setFont(const uint8_t* newFont) { font = newFont; }
+        void setFontDirection(uint8_t direction) { (void)direction; }
+        void setFontMode(uint8_t mode) { (void)mode; }
+        uint16_t drawStr(int16_t x, int16_t y, const char* str);
+        uint16_t drawUTF8(int16_t x, int16_t y, const char* str) { return drawStr(x, y, str); }
+        uint16_t getStrWidth(const char* str) const;
+        uint16_t getUTF8Width(const char* str) const { return getStrWidth(str); }
+        int8_t getAscent() const;
+        int8_t getDescent() const { return -(int8_t)font[0]; }
+        int8_t getMaxCharHeight() const { return font[2]; }
+        void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+        size_t write(uint8_t c) override;
+        using Print::write;
+};
+
+class U8G2_SSD1306_128X64_NONAME_F_HW_I2C : public U8G2 {
+    public:
+        U8G2_SSD1306_128X64_NONAME_F_HW_I2C(u8g2_cb_t_ptr rotation, uint8_t reset = U8X8_PIN_NONE,
+                                            uint8_t clock = U8X8_PIN_NONE, uint8_t data = U8X8_PIN_NONE)
+            : U8G2(rotation) { (void)reset; (void)clock; (void)data; }
+};
+
+#endif // SIM_U8G2LIB_H
@@ -0,0 +1,95 @@
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+// Zamiennik klasy String z Arduino oparty na std::string
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <type_traits>
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+class String {
+    private:
+        std::string buffer;
+
+    public:
+        String() {}
+        String(const char* cstr) : buffer(cstr ? cstr : "") {}
+        String(const std::string& str) : buffer(str) {}
+        String(const __FlashStringHelper* str) : buffer(reinterpret_cast<const char*>(str)) {}
+        explicit String(char c) : buffer(1, c) {}
+        explicit String(unsigned char value, unsigned char base = 10);
+        explicit String(int value, unsigned char base = 10);
+        explicit String(unsigned int value, unsigned char base = 10);
+        explicit String(long value, unsigned char base = 10);
+        explicit String(unsigned long value, unsigned char base = 10);
+        explicit String(long long value, unsigned char base = 10);
+        explicit String(unsigned long long value, unsigned char base = 10);
+        explicit String(float value, unsigned int decimals = 2);
+        explicit String(double value, unsigned int decimals = 2);
+
+        // Dostęp
+        const char* c_str() const { return buffer.c_str(); }
+        unsigned int length() const { return buffer.length(); }
+        bool isEmpty() const { return buffer.empty(); }
+        bool reserve(unsigned int size) { buffer.reserve(size); return true; }
+        char charAt(unsigned int index) const { return index < buffer.length() ? buffer[index] : 0; }
+        char operator[](unsigned int index) const { return charAt(index); }
+        char& operator[](unsigned int index) { return buffer[index]; }
+        const std::string& std() const { return buffer; }
+
+        // Łączenie (concat zwraca bool jak w Arduino - wymagane przez ArduinoJson)
+        bool concat(const String& str) { buffer += str.buffer; return true; }
+        bool concat(const char* cstr) { if (cstr) buffer += cstr; return true; }
+        bool concat(const char* cstr, unsigned int length) { if (cstr) buffer.append(cstr, length); return true; }
+        bool concat(char c) { buffer += c; return true; }
+        template<typename T> bool concat(T value) { return concat(String(value)); }
+
+        String& operator+=(const String& str) { concat(str); return *this; }
+        String& operator+=(const char* cstr) { concat(cstr); return *this; }
+        String& operator+=(char c) { concat(c); return *this; }
+        template<typename T> String& operator+=(T value) { concat(String(value)); return *this; }
+
+        // Porównania
+        bool equals(const String& str) const { return buffer == str.buffer; }
+        bool equals(const char* cstr) const { return buffer == (cstr ? cstr : ""); }
+        bool equalsIgnoreCase(const String& str) const;
+        bool operator==(const String& str) const { return equals(str); }
+        bool operator==(const char* cstr) const { return equals(cstr); }
+        bool operator!=(const String& str) const { return !equals(str); }
+        bool operator!=(const char* cstr) const { return !equals(cstr); }
+        bool operator<(const String& str) const { return buffer < str.buffer; }
+        bool startsWith(const String& prefix) const;
+        bool endsWith(const String& suffix) const;
+
+        // Wyszukiwanie i modyfikacja
+        int indexOf(char c, unsigned int from = 0) const;
+        int indexOf(const String& str, unsigned int from = 0) const;
+        int lastIndexOf(char c) const;
+        String substring(unsigned int from) const;
+        String substring(unsigned int from, unsigned int to) const;
+        void replace(const String& find, const String& replacement);
+        void remove(unsigned int index, unsigned int count = (unsigned int)-1);
+        void toLowerCase();
+        void toUpperCase();
+        void trim();
+
+        // Konwersje
+        long toInt() const;
+        float toFloat() const;
+        double toDouble() const;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+
+// Liczby jak w StringSumHelper: String("a") + 5 == "a5"
+template<typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+String operator+(const String& lhs, T rhs) { return lhs + String(rhs); }
+
+#endif // SIM_WSTRING_H
@@ -0,0 +1,37 @@
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+// WiFi dla symulatora - punkt dostępowy jest tylko stanem, żądania HTTP
+// i połączenia WebSocket podaje scenariusz (sim::httpRequest, sim::webSocketConnect)
+
+#include <Arduino.h>
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+class WiFiClass {
+    private:
+        wifi_mode_t currentMode = WIFI_OFF;
+        bool apActive = false;
+
+    public:
+        bool mode(wifi_mode_t newMode) { currentMode = newMode; if (newMode == WIFI_OFF) apActive = false; return true; }
+        wifi_mode_t getMode() const { return currentMode; }
+        bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1,
+                    int hidden = 0, int maxConnections = 4) {
+            (void)ssid; (void)passphrase; (void)channel; (void)hidden; (void)maxConnections;
+            apActive = true;
+            return true;
+        }
+        bool softAPdisconnect(bool wifiOff = false) { apActive = false; if (wifiOff) currentMode = WIFI_OFF; return true; }
+        IPAddress softAPIP() const { return apActive ? IPAddress(192, 168, 4, 1) : IPAddress(); }
+        uint8_t softAPgetStationNum() const { return apActive ? 1 : 0; }
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
@@ -0,0 +1,24 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include <Arduino.h>
+
+// Magistrala I2C - urządzenia symulatora (OLED, RTC) nie używają jej bezpośrednio
+class TwoWire {
+    public:
+        bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+            (void)sda; (void)scl; (void)frequency;
+            return true;
+        }
+        void setClock(uint32_t frequency) { (void)frequency; }
+        void beginTransmission(uint8_t address) { (void)address; }
+        uint8_t endTransmission(bool sendStop = true) { (void)sendStop; return 0; }
+        size_t write(uint8_t value) { (void)value; return 1; }
+        uint8_t requestFrom(uint8_t address, uint8_t quantity) { (void)address; (void)quantity; return 0; }
+        int available() { return 0; }
+        int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
@@ -0,0 +1,33 @@
+#ifndef SIM_DRIVER_GPIO_H
+#define SIM_DRIVER_GPIO_H
+
+#include "esp_err.h"
+
+typedef enum {
+    GPIO_NUM_NC = -1,
+    GPIO_NUM_0 = 0, GPIO_NUM_1, GPIO_NUM_2, GPIO_NUM_3, GPIO_NUM_4, GPIO_NUM_5,
+    GPIO_NUM_6, GPIO_NUM_7, GPIO_NUM_8, GPIO_NUM_9, GPIO_NUM_10, GPIO_NUM_11,
+    GPIO_NUM_12, GPIO_NUM_13, GPIO_NUM_14, GPIO_NUM_15, GPIO_NUM_16, GPIO_NUM_17,
+    GPIO_NUM_18, GPIO_NUM_19, GPIO_NUM_20, GPIO_NUM_21, GPIO_NUM_22, GPIO_NUM_23,
+    GPIO_NUM_25 = 25, GPIO_NUM_26, GPIO_NUM_27,
+    GPIO_NUM_32 = 32, GPIO_NUM_33, GPIO_NUM_34, GPIO_NUM_35, GPIO_NUM_36,
+    GPIO_NUM_37, GPIO_NUM_38, GPIO_NUM_39,
+    GPIO_NUM_MAX
+} gpio_num_t;
+
+typedef enum {
+    GPIO_MODE_DISABLE = 0,
+    GPIO_MODE_INPUT = 1,
+    GPIO_MODE_OUTPUT = 2,
+    GPIO_MODE_INPUT_OUTPUT = 3,
+    GPIO_MODE_OUTPUT_OD = 6,
+    GPIO_MODE_INPUT_OUTPUT_OD = 7
+} gpio_mode_t;
+
+// Kierunek pinu nie wpływa na symulowane urządzenia
+inline esp_err_t gpio_set_direction(gpio_num_t gpio, gpio_mode_t mode) {
+    (void)gpio; (void)mode;
+    return ESP_OK;
+}
+
+#endif // SIM_DRIVER_GPIO_H
@@ -0,0 +1,87 @@
+#ifndef SIM_DRIVER_RMT_H
+#define SIM_DRIVER_RMT_H
+
+// Peryferium RMT (sterownik z ESP-IDF 4.x) dla symulatora: impulsy kanału TX
+// trafiają do urządzeń 1-Wire na pinie (Devices.cpp), a stan linii - do
+// bufora kanału RX na tym samym pinie. Zegar kanału zawsze 1 MHz (clk_div 80).
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "freertos/ringbuf.h"
+
+typedef enum {
+    RMT_CHANNEL_0, RMT_CHANNEL_1, RMT_CHANNEL_2, RMT_CHANNEL_3,
+    RMT_CHANNEL_4, RMT_CHANNEL_5, RMT_CHANNEL_6, RMT_CHANNEL_7,
+    RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef enum {
+    RMT_MODE_TX,
+    RMT_MODE_RX,
+    RMT_MODE_MAX
+} rmt_mode_t;
+
+typedef enum {
+    RMT_IDLE_LEVEL_LOW,
+    RMT_IDLE_LEVEL_HIGH
+} rmt_idle_level_t;
+
+typedef enum {
+    RMT_CARRIER_LEVEL_LOW,
+    RMT_CARRIER_LEVEL_HIGH
+} rmt_carrier_level_t;
+
+typedef struct {
+    union {
+        struct {
+            uint32_t duration0 : 15;
+            uint32_t level0 : 1;
+            uint32_t duration1 : 15;
+            uint32_t level1 : 1;
+        };
+        uint32_t val;
+    };
+} rmt_item32_t;
+
+typedef struct {
+    uint32_t carrier_freq_hz;
+    rmt_carrier_level_t carrier_level;
+    rmt_idle_level_t idle_level;
+    uint8_t carrier_duty_percent;
+    uint32_t loop_count;
+    bool carrier_en;
+    bool loop_en;
+    bool idle_output_en;
+} rmt_tx_config_t;
+
+typedef struct {
+    uint16_t idle_threshold;
+    uint8_t filter_ticks_thresh;
+    bool filter_en;
+} rmt_rx_config_t;
+
+typedef struct {
+    rmt_mode_t rmt_mode;
+    rmt_channel_t channel;
+    gpio_num_t gpio_num;
+    uint8_t clk_div;
+    uint8_t mem_block_num;
+    uint32_t flags;
+    union {
+        rmt_tx_config_t tx_config;
+        rmt_rx_config_t rx_config;
+    };
+} rmt_config_t;
+
+esp_err_t rmt_config(const rmt_config_t* config);
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rxBufferSize, int intrAllocFlags);
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel);
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t* items, int itemCount, bool waitTxDone);
+esp_err_t rmt_rx_start(rmt_channel_t channel, bool resetIndex);
+esp_err_t rmt_rx_stop(rmt_channel_t channel);
+esp_err_t rmt_set_rx_idle_thresh(rmt_channel_t channel, uint16_t threshold);
+esp_err_t rmt_get_ringbuf_handle(rmt_channel_t channel, RingbufHandle_t* handle);
+
+#endif // SIM_DRIVER_RMT_H
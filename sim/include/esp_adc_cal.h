@@ -0,0 +1,27 @@
+#ifndef SIM_ESP_ADC_CAL_H
+#define SIM_ESP_ADC_CAL_H
+
+// Kalibracja ADC dla symulatora: liniowa, kod 4095 = 3300 mV
+// (jak wcześniejsze przeliczanie analogRead w firmware)
+
+#include <stdint.h>
+#include "driver/adc.h"
+
+typedef enum {
+    ESP_ADC_CAL_VAL_EFUSE_VREF = 0,
+    ESP_ADC_CAL_VAL_EFUSE_TP = 1,
+    ESP_ADC_CAL_VAL_DEFAULT_VREF = 2
+} esp_adc_cal_value_t;
+
+typedef struct {
+    adc_unit_t adc_num;
+    adc_atten_t atten;
+    adc_bits_width_t bit_width;
+    uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                             uint32_t defaultVref, esp_adc_cal_characteristics_t* chars);
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars);
+
+#endif // SIM_ESP_ADC_CAL_H
@@ -0,0 +1,50 @@
+#ifndef SIM_ESP_PARTITION_H
+#define SIM_ESP_PARTITION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+    ESP_PARTITION_TYPE_ANY = 0xff
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_APP_FACTORY = 0x00,
+    ESP_PARTITION_SUBTYPE_APP_OTA_0 = 0x10,
+    ESP_PARTITION_SUBTYPE_APP_OTA_1 = 0x11,
+    ESP_PARTITION_SUBTYPE_DATA_OTA = 0x00,
+    ESP_PARTITION_SUBTYPE_DATA_NVS = 0x02,
+    ESP_PARTITION_SUBTYPE_DATA_COREDUMP = 0x03,
+    ESP_PARTITION_SUBTYPE_DATA_SPIFFS = 0x82,
+    ESP_PARTITION_SUBTYPE_ANY = 0xff
+} esp_partition_subtype_t;
+
+typedef struct {
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+    bool encrypted;
+} esp_partition_t;
+
+typedef struct sim_partition_iterator* esp_partition_iterator_t;
+
+// Tablica partycji jak w partitions.csv
+esp_partition_iterator_t esp_partition_find(esp_partition_type_t type,
+                                            esp_partition_subtype_t subtype, const char* label);
+const esp_partition_t* esp_partition_get(esp_partition_iterator_t iterator);
+esp_partition_iterator_t esp_partition_next(esp_partition_iterator_t iterator);
+void esp_partition_iterator_release(esp_partition_iterator_t iterator);
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype, const char* label);
+
+// Odczyt, zapis i kasowanie (po 4 KiB) w pliku <katalog wyjściowy>/flash/<nazwa>.bin
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t srcOffset, void* dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dstOffset, const void* src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size);
+
+#endif // SIM_ESP_PARTITION_H
@@ -0,0 +1,16 @@
+#ifndef SIM_ESP_ROM_GPIO_H
+#define SIM_ESP_ROM_GPIO_H
+
+// Matryca GPIO - w symulatorze peryferia są połączone z pinami przez konfigurację (rmt_config)
+
+#include <stdint.h>
+
+inline void esp_rom_gpio_connect_out_signal(uint32_t gpio, uint32_t signal, bool outInvert, bool enableInvert) {
+    (void)gpio; (void)signal; (void)outInvert; (void)enableInvert;
+}
+
+inline void esp_rom_gpio_connect_in_signal(uint32_t gpio, uint32_t signal, bool invert) {
+    (void)gpio; (void)signal; (void)invert;
+}
+
+#endif // SIM_ESP_ROM_GPIO_H
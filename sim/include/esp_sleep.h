@@ -0,0 +1,28 @@
+#ifndef SIM_ESP_SLEEP_H
+#define SIM_ESP_SLEEP_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART
+} esp_sleep_wakeup_cause_t;
+
+// Przyczyna wybudzenia ustawiana opcją --wakeup symulatora
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t gpio, int level);
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs);
+
+// Głęboki sen kończy symulację
+void esp_deep_sleep_start() __attribute__((noreturn));
+
+#endif // SIM_ESP_SLEEP_H
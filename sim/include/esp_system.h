@@ -0,0 +1,10 @@
+#ifndef SIM_ESP_SYSTEM_H
+#define SIM_ESP_SYSTEM_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+uint32_t esp_random();
+void esp_restart() __attribute__((noreturn));
+
+#endif // SIM_ESP_SYSTEM_H
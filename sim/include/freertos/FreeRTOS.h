@@ -0,0 +1,49 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+// FreeRTOS dla symulatora: zadania to wątki POSIX, tick = 1 ms czasu symulacji
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define pdFALSE   ((BaseType_t)0)
+#define pdTRUE    ((BaseType_t)1)
+#define pdPASS    pdTRUE
+#define pdFAIL    pdFALSE
+#define errQUEUE_EMPTY  ((BaseType_t)0)
+#define errQUEUE_FULL   ((BaseType_t)0)
+
+#define configTICK_RATE_HZ     1000
+#define configMAX_PRIORITIES   25
+#define portTICK_PERIOD_MS     ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY          ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms)      ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define tskNO_AFFINITY         0x7FFFFFFF
+#define tskIDLE_PRIORITY       0
+
+// Sekcje krytyczne: blokada wirująca, jak portMUX na dwóch rdzeniach ESP32
+struct portMUX_TYPE {
+    std::atomic_flag flag;
+};
+#define portMUX_INITIALIZER_UNLOCKED {ATOMIC_FLAG_INIT}
+
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+
+#define portENTER_CRITICAL(mux)      vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)       vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)  vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)   vPortExitCritical(mux)
+#define taskENTER_CRITICAL(mux)      vPortEnterCritical(mux)
+#define taskEXIT_CRITICAL(mux)       vPortExitCritical(mux)
+#define portYIELD_FROM_ISR(...)      ((void)0)
+
+BaseType_t xPortGetCoreID();
+
+#endif // SIM_FREERTOS_H
@@ -0,0 +1,23 @@
+#ifndef SIM_FREERTOS_RINGBUF_H
+#define SIM_FREERTOS_RINGBUF_H
+
+// Bufor pierścieniowy ESP-IDF (elementy bez dzielenia) - używany przez sterownik RMT
+
+#include "FreeRTOS.h"
+
+typedef struct SimRingbuffer* RingbufHandle_t;
+
+typedef enum {
+    RINGBUF_TYPE_NOSPLIT = 0,
+    RINGBUF_TYPE_ALLOWSPLIT,
+    RINGBUF_TYPE_BYTEBUF
+} RingbufferType_t;
+
+RingbufHandle_t xRingbufferCreate(size_t bufferSize, RingbufferType_t type);
+void vRingbufferDelete(RingbufHandle_t ringbuffer);
+BaseType_t xRingbufferSend(RingbufHandle_t ringbuffer, const void* data, size_t size, TickType_t ticksToWait);
+// Element pozostaje w buforze do vRingbufferReturnItem
+void* xRingbufferReceive(RingbufHandle_t ringbuffer, size_t* itemSize, TickType_t ticksToWait);
+void vRingbufferReturnItem(RingbufHandle_t ringbuffer, void* item);
+
+#endif // SIM_FREERTOS_RINGBUF_H
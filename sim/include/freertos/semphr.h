@@ -0,0 +1,22 @@
+#ifndef SIM_FREERTOS_SEMPHR_H
+#define SIM_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+typedef struct SimSemaphore* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount);
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken);
+BaseType_t xSemaphoreTakeFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken);
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore);
+
+#endif // SIM_FREERTOS_SEMPHR_H
@@ -0,0 +1,31 @@
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef struct SimTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* createdTask,
+                                   BaseType_t coreId);
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* createdTask);
+void vTaskDelete(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment);
+TickType_t xTaskGetTickCount();
+TickType_t xTaskGetTickCountFromISR();
+
+TaskHandle_t xTaskGetCurrentTaskHandle();
+char* pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+// Powiadomienia zadań (semafor zliczający w każdym zadaniu)
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken);
+
+#endif // SIM_FREERTOS_TASK_H
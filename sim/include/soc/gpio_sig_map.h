@@ -0,0 +1,8 @@
+#ifndef SIM_SOC_GPIO_SIG_MAP_H
+#define SIM_SOC_GPIO_SIG_MAP_H
+
+// Numery sygnałów peryferiów w matrycy GPIO (ESP32)
+#define RMT_SIG_IN0_IDX   83
+#define RMT_SIG_OUT0_IDX  87
+
+#endif // SIM_SOC_GPIO_SIG_MAP_H
@@ -0,0 +1,650 @@
+// Rdzeń Arduino dla symulatora: String, Print/Stream, Serial, czas, ESP
+
+#include "Arduino.h"
+#include "SimRuntime.h"
+#include "esp_partition.h"
+
+#include <stdarg.h>
+#include <poll.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// --- Czas ---
+
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(sim::nowMicros() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)sim::nowMicros();
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    uint64_t end = sim::nowMicros() + us;
+    if (us > 1000) {
+        sim::sleepMicros(us);
+        return;
+    }
+    // Krótkie opóźnienia aktywnie, jak w rdzeniu ESP32
+    while (sim::nowMicros() < end) {
+        std::this_thread::yield();
+    }
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+// --- Liczby losowe ---
+
+static std::mutex randomMutex;
+static std::mt19937& randomEngine() {
+    static std::mt19937 engine(12345);
+    return engine;
+}
+
+long random(long max) {
+    if (max <= 0) return 0;
+    std::lock_guard<std::mutex> lock(randomMutex);
+    return randomEngine()() % max;
+}
+
+long random(long min, long max) {
+    if (min >= max) return min;
+    return random(max - min) + min;
+}
+
+void randomSeed(unsigned long seed) {
+    std::lock_guard<std::mutex> lock(randomMutex);
+    randomEngine().seed(seed);
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    if (inMax == inMin) return outMin;
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+uint32_t esp_random() {
+    std::lock_guard<std::mutex> lock(randomMutex);
+    return randomEngine()();
+}
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2, const char* server3) {
+    (void)gmtOffsetSec; (void)daylightOffsetSec;
+    (void)server1; (void)server2; (void)server3;
+}
+
+bool getLocalTime(struct tm* info, uint32_t timeoutMs) {
+    (void)timeoutMs;
+    time_t now = time(nullptr);
+    return localtime_r(&now, info) != nullptr;
+}
+
+#ifdef SIM_NEEDS_STRLCPY
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t length = strlen(src);
+    if (size > 0) {
+        size_t copy = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, copy);
+        dst[copy] = '\0';
+    }
+    return length;
+}
+#endif
+
+// --- Uśpienie i restart ---
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+    return (esp_sleep_wakeup_cause_t)sim::wakeupCause();
+}
+
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t gpio, int level) {
+    (void)gpio; (void)level;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+    (void)timeUs;
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start() {
+    // Pamięć RTC przetrwa uśpienie - do następnego uruchomienia z --wakeup
+    sim::saveRtcMemory();
+    fprintf(stderr, "[sim] Głęboki sen - koniec symulacji\n");
+    sim::requestExit(0);
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+}
+
+void esp_restart() {
+    fprintf(stderr, "[sim] Restart - koniec symulacji\n");
+    sim::requestExit(0);
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+}
+
+// --- ESP ---
+
+EspClass ESP;
+
+static size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// Wolna pamięć liczona od stanu przy starcie (przybliża zużycie sterty przez firmware)
+uint32_t EspClass::getFreeHeap() {
+    static const size_t baseline = heapInUse();
+    size_t used = heapInUse();
+    size_t growth = used > baseline ? used - baseline : 0;
+    uint32_t available = 250000;
+    return growth < available ? available - growth : 0;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    static uint32_t minimum = UINT32_MAX;
+    uint32_t current = getFreeHeap();
+    if (current < minimum) minimum = current;
+    return minimum;
+}
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(sim::nowMicros() * getCpuFreqMHz());
+}
+
+void EspClass::restart() {
+    esp_restart();
+}
+
+// --- Przydziały pamięci ---
+
+// Liczniki osobne dla wątku, żeby pomiar handlera HTTP nie obejmował innych zadań
+static thread_local uint32_t threadAllocations = 0;
+static thread_local uint64_t threadAllocatedBytes = 0;
+
+#if defined(__GLIBC__)
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+
+    // Zastępują funkcje glibc w całym programie (także operator new z libstdc++)
+    void* malloc(size_t size) {
+        threadAllocations++;
+        threadAllocatedBytes += size;
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) {
+        threadAllocations++;
+        threadAllocatedBytes += count * size;
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size) {
+        threadAllocations++;
+        threadAllocatedBytes += size;
+        return __libc_realloc(ptr, size);
+    }
+}
+#endif
+
+sim::HeapUsage sim::threadHeapUsage() {
+    HeapUsage usage;
+    usage.allocations = threadAllocations;
+    usage.bytes = threadAllocatedBytes;
+    return usage;
+}
+
+// --- Partycje (jak w partitions.csv) ---
+
+static const esp_partition_t partitionTable[] = {
+    {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, 0x9000, 0x5000, "nvs", false},
+    {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_OTA, 0xe000, 0x2000, "otadata", false},
+    {ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, 0x10000, 0x140000, "app0", false},
+    {ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, 0x150000, 0x140000, "app1", false},
+    {ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x290000, 0x10000, "odometer", false},
+    {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, 0x2A0000, 0x150000, "spiffs", false},
+    {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_COREDUMP, 0x3F0000, 0x10000, "coredump", false},
+};
+static const size_t PARTITION_COUNT = sizeof(partitionTable) / sizeof(partitionTable[0]);
+
+struct sim_partition_iterator {
+    size_t index;
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    std::string label;
+};
+
+static bool partitionMatches(const esp_partition_t& partition, const sim_partition_iterator& it) {
+    if (it.type != ESP_PARTITION_TYPE_ANY && partition.type != it.type) return false;
+    if (it.subtype != ESP_PARTITION_SUBTYPE_ANY && partition.subtype != it.subtype) return false;
+    if (!it.label.empty() && it.label != partition.label) return false;
+    return true;
+}
+
+static esp_partition_iterator_t advance(esp_partition_iterator_t it, size_t from) {
+    for (size_t i = from; i < PARTITION_COUNT; i++) {
+        if (partitionMatches(partitionTable[i], *it)) {
+            it->index = i;
+            return it;
+        }
+    }
+    delete it;
+    return nullptr;
+}
+
+esp_partition_iterator_t esp_partition_find(esp_partition_type_t type,
+                                            esp_partition_subtype_t subtype, const char* label) {
+    sim_partition_iterator* it = new sim_partition_iterator();
+    it->type = type;
+    it->subtype = subtype;
+    it->label = label ? label : "";
+    return advance(it, 0);
+}
+
+const esp_partition_t* esp_partition_get(esp_partition_iterator_t iterator) {
+    return iterator ? &partitionTable[iterator->index] : nullptr;
+}
+
+esp_partition_iterator_t esp_partition_next(esp_partition_iterator_t iterator) {
+    return iterator ? advance(iterator, iterator->index + 1) : nullptr;
+}
+
+void esp_partition_iterator_release(esp_partition_iterator_t iterator) {
+    delete iterator;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype, const char* label) {
+    esp_partition_iterator_t it = esp_partition_find(type, subtype, label);
+    const esp_partition_t* partition = esp_partition_get(it);
+    esp_partition_iterator_release(it);
+    return partition;
+}
+
+// Zawartość partycji w pliku <katalog wyjściowy>/flash/<nazwa>.bin. Jak w NOR flash
+// zapis może tylko zerować bity, a kasowanie działa na całych sektorach.
+static const size_t FLASH_SECTOR_SIZE = 4096;
+static std::mutex flashMutex;
+
+static FILE* openPartition(const esp_partition_t* partition) {
+    std::string path = sim::outputPath(std::string("flash/") + partition->label + ".bin");
+    FILE* file = fopen(path.c_str(), "r+b");
+    if (file == nullptr) {
+        file = fopen(path.c_str(), "w+b");
+        if (file == nullptr) return nullptr;
+        std::vector<uint8_t> erased(partition->size, 0xFF);
+        fwrite(erased.data(), 1, erased.size(), file);
+    }
+    return file;
+}
+
+static bool inPartition(const esp_partition_t* partition, size_t offset, size_t size) {
+    return partition && offset <= partition->size && size <= partition->size - offset;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t srcOffset, void* dst, size_t size) {
+    if (!inPartition(partition, srcOffset, size) || dst == nullptr) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(flashMutex);
+    FILE* file = openPartition(partition);
+    if (file == nullptr) return ESP_FAIL;
+    fseek(file, srcOffset, SEEK_SET);
+    size_t count = fread(dst, 1, size, file);
+    fclose(file);
+    return count == size ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dstOffset, const void* src, size_t size) {
+    if (!inPartition(partition, dstOffset, size) || src == nullptr) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(flashMutex);
+    FILE* file = openPartition(partition);
+    if (file == nullptr) return ESP_FAIL;
+
+    std::vector<uint8_t> data(size);
+    fseek(file, dstOffset, SEEK_SET);
+    size_t count = fread(data.data(), 1, size, file);
+    for (size_t i = 0; i < size; i++) data[i] &= ((const uint8_t*)src)[i];
+    fseek(file, dstOffset, SEEK_SET);
+    count = count == size ? fwrite(data.data(), 1, size, file) : 0;
+    fclose(file);
+
+    sim::counters().flashWrites++;
+    sim::counters().flashBytesWritten += size;
+    return count == size ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+    if (!inPartition(partition, offset, size)) return ESP_ERR_INVALID_ARG;
+    if (offset % FLASH_SECTOR_SIZE != 0 || size % FLASH_SECTOR_SIZE != 0) return ESP_ERR_INVALID_SIZE;
+    std::lock_guard<std::mutex> lock(flashMutex);
+    FILE* file = openPartition(partition);
+    if (file == nullptr) return ESP_FAIL;
+
+    std::vector<uint8_t> erased(size, 0xFF);
+    fseek(file, offset, SEEK_SET);
+    size_t count = fwrite(erased.data(), 1, size, file);
+    fclose(file);
+
+    sim::counters().flashSectorErases += size / FLASH_SECTOR_SIZE;
+    return count == size ? ESP_OK : ESP_FAIL;
+}
+
+// --- String ---
+
+static std::string integerToString(unsigned long long value, bool negative, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char digits[66];
+    int pos = sizeof(digits) - 1;
+    digits[pos] = '\0';
+    do {
+        int digit = value % base;
+        digits[--pos] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value > 0);
+    if (negative) digits[--pos] = '-';
+    return std::string(&digits[pos]);
+}
+
+static std::string signedToString(long long value, unsigned char base) {
+    if (base == 10 && value < 0) {
+        return integerToString(0ULL - (unsigned long long)value, true, base);
+    }
+    return integerToString((unsigned long long)value, false, base);
+}
+
+String::String(unsigned char value, unsigned char base) : buffer(integerToString(value, false, base)) {}
+String::String(int value, unsigned char base) : buffer(signedToString(value, base)) {}
+String::String(unsigned int value, unsigned char base) : buffer(integerToString(value, false, base)) {}
+String::String(long value, unsigned char base) : buffer(signedToString(value, base)) {}
+String::String(unsigned long value, unsigned char base) : buffer(integerToString(value, false, base)) {}
+String::String(long long value, unsigned char base) : buffer(signedToString(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : buffer(integerToString(value, false, base)) {}
+
+String::String(float value, unsigned int decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned int decimals) {
+    char text[64];
+    if (isnan(value)) {
+        buffer = "nan";
+    } else if (isinf(value)) {
+        buffer = "inf";
+    } else {
+        snprintf(text, sizeof(text), "%.*f", decimals, value);
+        buffer = text;
+    }
+}
+
+bool String::equalsIgnoreCase(const String& str) const {
+    if (buffer.length() != str.buffer.length()) return false;
+    for (size_t i = 0; i < buffer.length(); i++) {
+        if (tolower((unsigned char)buffer[i]) != tolower((unsigned char)str.buffer[i])) return false;
+    }
+    return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return buffer.compare(0, prefix.buffer.length(), prefix.buffer) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if (suffix.buffer.length() > buffer.length()) return false;
+    return buffer.compare(buffer.length() - suffix.buffer.length(), suffix.buffer.length(), suffix.buffer) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t pos = buffer.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int from) const {
+    size_t pos = buffer.find(str.buffer, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t pos = buffer.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from) const {
+    if (from >= buffer.length()) return String();
+    return String(buffer.substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= buffer.length()) return String();
+    return String(buffer.substr(from, to - from));
+}
+
+void String::replace(const String& find, const String& replacement) {
+    if (find.buffer.empty()) return;
+    size_t pos = 0;
+    while ((pos = buffer.find(find.buffer, pos)) != std::string::npos) {
+        buffer.replace(pos, find.buffer.length(), replacement.buffer);
+        pos += replacement.buffer.length();
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index >= buffer.length()) return;
+    buffer.erase(index, count);
+}
+
+void String::toLowerCase() {
+    for (char& c : buffer) c = tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+    for (char& c : buffer) c = toupper((unsigned char)c);
+}
+
+void String::trim() {
+    size_t first = buffer.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        buffer.clear();
+        return;
+    }
+    size_t last = buffer.find_last_not_of(" \t\r\n");
+    buffer = buffer.substr(first, last - first + 1);
+}
+
+long String::toInt() const {
+    return atol(buffer.c_str());
+}
+
+float String::toFloat() const {
+    return (float)atof(buffer.c_str());
+}
+
+double String::toDouble() const {
+    return atof(buffer.c_str());
+}
+
+String operator+(const String& lhs, const String& rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const String& lhs, char rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+// --- Print ---
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size--) {
+        if (write(*buffer++) == 0) break;
+        written++;
+    }
+    return written;
+}
+
+size_t Print::write(const char* str) {
+    if (str == nullptr) return 0;
+    return write((const uint8_t*)str, strlen(str));
+}
+
+size_t Print::printf(const char* format, ...) {
+    char stackBuffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+
+    if ((size_t)length < sizeof(stackBuffer)) {
+        return write((const uint8_t*)stackBuffer, length);
+    }
+
+    std::vector<char> heapBuffer(length + 1);
+    va_start(args, format);
+    vsnprintf(heapBuffer.data(), heapBuffer.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)heapBuffer.data(), length);
+}
+
+size_t Print::print(long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(long long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(double value, int digits) {
+    return print(String(value, (unsigned int)digits));
+}
+
+// --- Stream ---
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    unsigned long start = millis();
+    while (count < length) {
+        int c = read();
+        if (c < 0) {
+            if (millis() - start >= timeout) break;
+            yield();
+            continue;
+        }
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+String Stream::readString() {
+    String result;
+    int c;
+    while ((c = read()) >= 0) {
+        result += (char)c;
+    }
+    return result;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) {
+        result += (char)c;
+    }
+    return result;
+}
+
+// --- Serial ---
+
+HardwareSerial Serial;
+static std::mutex serialMutex;
+
+size_t HardwareSerial::write(uint8_t c) {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    if (c != '\r') fputc(c, stdout);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    for (size_t i = 0; i < size; i++) {
+        if (buffer[i] != '\r') fputc(buffer[i], stdout);
+    }
+    return size;
+}
+
+void HardwareSerial::flush() {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    fflush(stdout);
+}
+
+int HardwareSerial::available() {
+    if (peeked >= 0) return 1;
+    if (inputClosed) return 0;
+    struct pollfd descriptor = {STDIN_FILENO, POLLIN, 0};
+    return poll(&descriptor, 1, 0) > 0 && (descriptor.revents & POLLIN) ? 1 : 0;
+}
+
+int HardwareSerial::read() {
+    if (peeked >= 0) {
+        int c = peeked;
+        peeked = -1;
+        return c;
+    }
+    if (!available()) return -1;
+    unsigned char c;
+    if (::read(STDIN_FILENO, &c, 1) == 1) return c;
+    // Koniec stdin (np. /dev/null) - poll() zgłaszałby gotowość bez końca
+    inputClosed = true;
+    return -1;
+}
+
+int HardwareSerial::peek() {
+    if (peeked < 0) peeked = read();
+    return peeked;
+}
+
+// --- IPAddress ---
+
+String IPAddress::toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+    return String(text);
+}
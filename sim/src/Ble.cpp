@@ -0,0 +1,350 @@
+// Klient BLE i symulowany BMS JBD
+
+#include "BLEDevice.h"
+#include "SimRuntime.h"
+
+#include <cctype>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    const char* BMS_SERVICE = "0000ff00-0000-1000-8000-00805f9b34fb";
+    const char* BMS_RX = "0000ff01-0000-1000-8000-00805f9b34fb";
+    const char* BMS_TX = "0000ff02-0000-1000-8000-00805f9b34fb";
+
+    const size_t NOTIFY_PAYLOAD = 20;            // MTU 23 - 3 bajty nagłówka ATT
+    const uint64_t CONNECTION_INTERVAL = 7500;   // Odstęp kolejnych powiadomień [us]
+
+    // Model akumulatora 13S 15 Ah
+    const uint8_t CELL_COUNT = 13;
+    const uint8_t NTC_COUNT = 2;
+    const float CAPACITY_AH = 15.0f;
+
+    std::mutex bmsMutex;
+    bool initialized = false;
+
+    // Skanowanie osobno - callback rozgłoszeń może wywoływać BLEScan
+    std::mutex scanMutex;
+
+    BLEScan& scanner() {
+        static BLEScan scan;
+        return scan;
+    }
+
+    struct BatteryState {
+        float remainingAh = CAPACITY_AH * 0.85f;
+        uint64_t lastUpdate = 0;
+        float current = 0.0f;   // [A], ujemny przy rozładowaniu
+    };
+
+    BatteryState& battery() {
+        static BatteryState state;
+        return state;
+    }
+
+    // Obciążenie zmienne w czasie: jazda 3-11 A z krótkimi przerwami
+    void updateBattery() {
+        BatteryState& state = battery();
+        uint64_t now = sim::nowMicros();
+        float seconds = now / 1e6f;
+        float load = 7.0f + 4.0f * sinf(seconds / 45.0f);
+        if (fmodf(seconds, 180.0f) > 165.0f) load = 0.3f;
+        state.current = -load;
+
+        float hours = (now - state.lastUpdate) / 3.6e9f;
+        state.lastUpdate = now;
+        state.remainingAh += state.current * hours;
+        if (state.remainingAh < 0.0f) state.remainingAh = 0.0f;
+    }
+
+    float cellVoltage(uint8_t cell) {
+        float soc = battery().remainingAh / CAPACITY_AH;
+        float open = 3.3f + 0.85f * soc;
+        float sag = battery().current * 0.004f;   // Rezystancja wewnętrzna ~4 mΩ na celę
+        return open + sag + (cell % 3) * 0.003f;
+    }
+
+    void putU16(std::vector<uint8_t>& data, uint16_t value) {
+        data.push_back(value >> 8);
+        data.push_back(value & 0xFF);
+    }
+
+    uint16_t kelvinTenths(float celsius) {
+        return (uint16_t)lroundf(celsius * 10.0f + 2731.0f);
+    }
+
+    std::vector<uint8_t> buildPayload(uint8_t command) {
+        std::vector<uint8_t> data;
+        float seconds = sim::nowMicros() / 1e6f;
+        float temperature = 24.0f + 3.0f * sinf(seconds / 300.0f);
+
+        switch (command) {
+            case 0x03: {
+                float voltage = 0.0f;
+                for (uint8_t i = 0; i < CELL_COUNT; i++) voltage += cellVoltage(i);
+                uint8_t soc = (uint8_t)lroundf(100.0f * battery().remainingAh / CAPACITY_AH);
+
+                putU16(data, (uint16_t)lroundf(voltage * 100.0f));
+                putU16(data, (uint16_t)(int16_t)lroundf(battery().current * 100.0f));
+                putU16(data, (uint16_t)lroundf(battery().remainingAh * 100.0f));
+                putU16(data, (uint16_t)lroundf(CAPACITY_AH * 100.0f));
+                putU16(data, 42);                 // Cykle
+                putU16(data, 0x2A35);             // Data produkcji
+                putU16(data, 0);                  // Balansowanie 1-16
+                putU16(data, 0);                  // Balansowanie 17-32
+                putU16(data, 0);                  // Zabezpieczenia
+                data.push_back(0x10);             // Wersja
+                data.push_back(soc);
+                data.push_back(0x03);             // MOSFET ładowania i rozładowania
+                data.push_back(CELL_COUNT);
+                data.push_back(NTC_COUNT);
+                for (uint8_t i = 0; i < NTC_COUNT; i++) putU16(data, kelvinTenths(temperature + i));
+                break;
+            }
+            case 0x04:
+                for (uint8_t i = 0; i < CELL_COUNT; i++) {
+                    putU16(data, (uint16_t)lroundf(cellVoltage(i) * 1000.0f));
+                }
+                break;
+            case 0x08:
+                for (uint8_t i = 0; i < NTC_COUNT; i++) putU16(data, kelvinTenths(temperature + i));
+                break;
+        }
+        return data;
+    }
+
+    // 0xDD | rejestr | status | długość | dane | suma (2B) | 0x77
+    std::vector<uint8_t> buildResponse(uint8_t command) {
+        std::vector<uint8_t> payload = buildPayload(command);
+        uint8_t status = payload.empty() ? 0x80 : 0x00;
+
+        std::vector<uint8_t> frame;
+        frame.push_back(0xDD);
+        frame.push_back(command);
+        frame.push_back(status);
+        frame.push_back((uint8_t)payload.size());
+        frame.insert(frame.end(), payload.begin(), payload.end());
+
+        uint16_t sum = 0;
+        for (size_t i = 2; i < frame.size(); i++) sum += frame[i];
+        putU16(frame, (uint16_t)(0x10000 - sum));
+        frame.push_back(0x77);
+        return frame;
+    }
+
+    std::string normalizeUuid(const char* uuid) {
+        std::string value = uuid ? uuid : "";
+        for (char& c : value) c = (char)tolower((unsigned char)c);
+        if (value.size() == 4) value = "0000" + value + "-0000-1000-8000-00805f9b34fb";
+        return value;
+    }
+
+} // namespace
+
+// --- BLEUUID ---
+
+BLEUUID::BLEUUID(const char* uuid) : value(normalizeUuid(uuid)) {}
+
+BLEUUID::BLEUUID(uint16_t uuid) {
+    char text[5];
+    snprintf(text, sizeof(text), "%04x", uuid);
+    value = normalizeUuid(text);
+}
+
+// --- BLERemoteCharacteristic ---
+
+void BLERemoteCharacteristic::registerForNotify(notify_callback newCallback, bool notifications,
+                                                bool descriptorRequiresRegistration) {
+    (void)notifications; (void)descriptorRequiresRegistration;
+    std::lock_guard<std::mutex> lock(bmsMutex);
+    callback = newCallback;
+}
+
+void BLERemoteCharacteristic::deliver(uint8_t* data, size_t length) {
+    notify_callback target;
+    {
+        std::lock_guard<std::mutex> lock(bmsMutex);
+        target = callback;
+    }
+    if (target == nullptr || !service->getClient()->isConnected()) return;
+
+    sim::counters().bleNotifications++;
+    target(this, data, length, true);
+}
+
+void BLERemoteCharacteristic::writeValue(uint8_t* data, size_t length, bool response) {
+    (void)response;
+    if (!service->getClient()->isConnected()) return;
+    sim::counters().bleWrites++;
+
+    // Zapytanie odczytu: 0xDD 0xA5 rejestr 0x00 suma (2B) 0x77
+    if (length < 7 || data[0] != 0xDD || data[1] != 0xA5 || data[length - 1] != 0x77) return;
+    uint8_t command = data[2];
+
+    BLERemoteCharacteristic* rx = service->getCharacteristic(BMS_RX);
+    static std::mt19937 latencyRandom(12345);
+    uint64_t latency;
+    {
+        std::lock_guard<std::mutex> lock(bmsMutex);
+        latency = 30000 + latencyRandom() % 50000;
+    }
+
+    // Odpowiedź z wątku "stosu BT", jak callback powiadomień na ESP32
+    std::thread([rx, command, latency]() {
+        sim::sleepMicros(latency);
+
+        std::vector<uint8_t> frame;
+        {
+            std::lock_guard<std::mutex> lock(bmsMutex);
+            updateBattery();
+            frame = buildResponse(command);
+        }
+
+        for (size_t offset = 0; offset < frame.size(); offset += NOTIFY_PAYLOAD) {
+            if (offset > 0) sim::sleepMicros(CONNECTION_INTERVAL);
+            size_t chunk = frame.size() - offset < NOTIFY_PAYLOAD ? frame.size() - offset : NOTIFY_PAYLOAD;
+            rx->deliver(frame.data() + offset, chunk);
+        }
+    }).detach();
+}
+
+// --- BLERemoteService ---
+
+BLERemoteService::BLERemoteService(const BLEUUID& uuid, BLEClient* client) : uuid(uuid), client(client) {
+    characteristics[BLEUUID(BMS_RX)] = new BLERemoteCharacteristic(BLEUUID(BMS_RX), this, true);
+    characteristics[BLEUUID(BMS_TX)] = new BLERemoteCharacteristic(BLEUUID(BMS_TX), this, false);
+}
+
+BLERemoteService::~BLERemoteService() {
+    for (auto& entry : characteristics) delete entry.second;
+}
+
+BLERemoteCharacteristic* BLERemoteService::getCharacteristic(const BLEUUID& uuid) {
+    auto found = characteristics.find(uuid);
+    return found == characteristics.end() ? nullptr : found->second;
+}
+
+// --- BLEClient ---
+
+BLEClient::~BLEClient() {
+    // Usługa żyje do końca programu - wątki odpowiedzi mogą jeszcze z niej korzystać
+}
+
+bool BLEClient::connect(BLEAddress address, uint8_t type) {
+    (void)address; (void)type;
+    if (!initialized) return false;
+
+    // Nawiązanie połączenia i odkrywanie usług trwa na ESP32 kilkaset ms
+    sim::sleepMicros(400000);
+    if (service == nullptr) service = new BLERemoteService(BLEUUID(BMS_SERVICE), this);
+    connected = true;
+    if (callbacks) callbacks->onConnect(this);
+    return true;
+}
+
+void BLEClient::disconnect() {
+    if (!connected) return;
+    connected = false;
+    if (callbacks) callbacks->onDisconnect(this);
+}
+
+BLERemoteService* BLEClient::getService(const BLEUUID& uuid) {
+    if (!connected || service == nullptr || !(service->getUUID() == uuid)) return nullptr;
+    return service;
+}
+
+// --- BLEScan ---
+
+void BLEScan::setAdvertisedDeviceCallbacks(BLEAdvertisedDeviceCallbacks* newCallbacks, bool wantDuplicates,
+                                           bool shouldParse) {
+    (void)wantDuplicates; (void)shouldParse;
+    std::lock_guard<std::mutex> lock(scanMutex);
+    callbacks = newCallbacks;
+}
+
+bool BLEScan::start(uint32_t duration, void (*scanCompleteCB)(BLEScanResults), bool is_continue) {
+    (void)is_continue;
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(scanMutex);
+        if (scanning || !BLEDevice::getInitialized()) return false;
+        scanning = true;
+        startMicros = sim::nowMicros();
+        id = ++scanId;
+    }
+    sim::counters().bleScans++;
+
+    // Koniec skanowania zgłaszany z wątku "stosu BT"
+    std::thread([this, id, duration, scanCompleteCB]() {
+        sim::sleepMicros((uint64_t)duration * 1000000);
+        {
+            std::lock_guard<std::mutex> lock(scanMutex);
+            if (scanId != id || !scanning) return;
+            scanning = false;
+        }
+        if (scanCompleteCB) scanCompleteCB(BLEScanResults());
+    }).detach();
+    return true;
+}
+
+void BLEScan::stop() {
+    std::lock_guard<std::mutex> lock(scanMutex);
+    scanning = false;
+}
+
+bool BLEScan::deliver(BLEAdvertisedDevice device) {
+    BLEAdvertisedDeviceCallbacks* target;
+    {
+        std::lock_guard<std::mutex> lock(scanMutex);
+        if (!scanning || callbacks == nullptr || intervalMs == 0) return false;
+        // Poza oknem skanowania radio obsługuje połączenie - rozgłoszenie przepada
+        uint64_t phaseMs = (sim::nowMicros() - startMicros) / 1000 % intervalMs;
+        if (phaseMs >= windowMs) return false;
+        target = callbacks;
+    }
+    target->onResult(device);
+    return true;
+}
+
+void sim::bleAdvertise(const std::string& address, const std::string& manufacturerHex, int rssi) {
+    std::string data;
+    for (size_t i = 0; i + 1 < manufacturerHex.size(); i += 2) {
+        data += (char)strtol(manufacturerHex.substr(i, 2).c_str(), nullptr, 16);
+    }
+
+    counters().bleAdvertisements++;
+    if (scanner().deliver(BLEAdvertisedDevice(BLEAddress(address), data, rssi))) {
+        counters().bleAdvertisementsHeard++;
+    }
+}
+
+// --- BLEDevice ---
+
+void BLEDevice::init(const std::string& deviceName) {
+    (void)deviceName;
+    std::lock_guard<std::mutex> lock(bmsMutex);
+    initialized = true;
+    battery().lastUpdate = sim::nowMicros();
+}
+
+BLEClient* BLEDevice::createClient() {
+    return new BLEClient();
+}
+
+BLEScan* BLEDevice::getScan() {
+    return &scanner();
+}
+
+void BLEDevice::deinit(bool releaseMemory) {
+    (void)releaseMemory;
+    std::lock_guard<std::mutex> lock(bmsMutex);
+    initialized = false;
+}
+
+bool BLEDevice::getInitialized() {
+    std::lock_guard<std::mutex> lock(bmsMutex);
+    return initialized;
+}
@@ -0,0 +1,553 @@
+// Urządzenia na magistralach: I2C (RTC DS3231), 1-Wire (DS18B20)
+
+#include "Wire.h"
+#include "RTClib.h"
+#include "OneWire.h"
+#include "SimRuntime.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+TwoWire Wire;
+
+// --- DateTime ---
+
+static const uint32_t SECONDS_FROM_1970_TO_2000 = 946684800UL;
+static const uint8_t DAYS_IN_MONTH[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+static uint16_t date2days(uint16_t y, uint8_t m, uint8_t d) {
+    if (y >= 2000U) y -= 2000U;
+    uint16_t days = d;
+    for (uint8_t i = 1; i < m; ++i) days += DAYS_IN_MONTH[i - 1];
+    if (m > 2 && y % 4 == 0) ++days;
+    return days + 365 * y + (y + 3) / 4 - 1;
+}
+
+static uint8_t conv2d(const char* p) {
+    uint8_t v = 0;
+    if ('0' <= *p && *p <= '9') v = *p - '0';
+    return 10 * v + *++p - '0';
+}
+
+DateTime::DateTime(uint32_t t) {
+    t -= SECONDS_FROM_1970_TO_2000;
+    ss = t % 60;
+    t /= 60;
+    mm = t % 60;
+    t /= 60;
+    hh = t % 24;
+    uint16_t days = t / 24;
+    uint8_t leap;
+    for (yOff = 0;; ++yOff) {
+        leap = yOff % 4 == 0;
+        if (days < 365U + leap) break;
+        days -= 365 + leap;
+    }
+    for (m = 1; m < 12; ++m) {
+        uint8_t daysPerMonth = DAYS_IN_MONTH[m - 1];
+        if (leap && m == 2) ++daysPerMonth;
+        if (days < daysPerMonth) break;
+        days -= daysPerMonth;
+    }
+    d = days + 1;
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second) {
+    if (year >= 2000U) year -= 2000U;
+    yOff = year;
+    m = month;
+    d = day;
+    hh = hour;
+    mm = minute;
+    ss = second;
+}
+
+DateTime::DateTime(const char* date, const char* time) {
+    // "Mmm dd yyyy", "hh:mm:ss"
+    yOff = conv2d(date + 9);
+    switch (date[0]) {
+        case 'J': m = (date[1] == 'a') ? 1 : ((date[2] == 'n') ? 6 : 7); break;
+        case 'F': m = 2; break;
+        case 'A': m = date[2] == 'r' ? 4 : 8; break;
+        case 'M': m = date[2] == 'r' ? 3 : 5; break;
+        case 'S': m = 9; break;
+        case 'O': m = 10; break;
+        case 'N': m = 11; break;
+        case 'D': m = 12; break;
+        default: m = 1; break;
+    }
+    d = conv2d(date + 4);
+    hh = conv2d(time);
+    mm = conv2d(time + 3);
+    ss = conv2d(time + 6);
+}
+
+DateTime::DateTime(const __FlashStringHelper* date, const __FlashStringHelper* time)
+    : DateTime(reinterpret_cast<const char*>(date), reinterpret_cast<const char*>(time)) {}
+
+uint8_t DateTime::dayOfTheWeek() const {
+    uint16_t day = date2days(yOff, m, d);
+    return (day + 6) % 7;   // 01.01.2000 to sobota
+}
+
+uint32_t DateTime::unixtime() const {
+    uint16_t days = date2days(yOff, m, d);
+    return ((days * 24UL + hh) * 60 + mm) * 60 + ss + SECONDS_FROM_1970_TO_2000;
+}
+
+bool DateTime::isValid() const {
+    if (m < 1 || m > 12) return false;
+    DateTime other(unixtime());
+    return yOff == other.yOff && m == other.m && d == other.d &&
+           hh == other.hh && mm == other.mm && ss == other.ss;
+}
+
+String DateTime::timestamp() const {
+    char text[32];
+    snprintf(text, sizeof(text), "%04u-%02u-%02uT%02u:%02u:%02u", year(), m, d, hh, mm, ss);
+    return String(text);
+}
+
+// --- RTC_DS3231 ---
+
+static const double RTC_I2C_MICROS_PER_BYTE = 9.0 * 1e6 / 400000.0;
+static const size_t RTC_READ_BYTES = 10;       // Adres, rejestr, adres, 7 rejestrów czasu
+static const size_t RTC_WRITE_BYTES = 9;
+
+static std::mutex rtcMutex;
+static std::condition_variable rtcEdgeCv;
+static bool rtcAnchored = false;
+static int64_t rtcAnchorSeconds = 0;    // Czas unix przy ostatnim wyzerowaniu dzielnika
+static uint64_t rtcAnchorMicros = 0;    // Czas symulacji tej chwili
+static int rtcSqwPin = -1;
+static bool rtcSqwEnabled = false;
+static uint32_t rtcSqwGeneration = 0;   // Zmiana - wątek SQW kończy pracę
+static uint64_t rtcSqwFired = 0;        // Numer ostatniej zmiany sekundy ze zboczem SQW
+
+static void rtcAnchor() {
+    if (rtcAnchored) return;
+    rtcAnchorSeconds = (int64_t)time(nullptr);
+    rtcAnchorMicros = sim::nowMicros();
+    rtcAnchored = true;
+}
+
+static void rtcTransfer(size_t bytes) {
+    uint64_t duration = (uint64_t)(bytes * RTC_I2C_MICROS_PER_BYTE);
+    sim::counters().i2cMicros += duration;
+    sim::sleepMicros(duration);
+}
+
+// Wątek SQW: zbocze opadające przy każdej zmianie sekundy (przerwanie jak z pinu)
+static void rtcStartSqw() {
+    uint32_t generation = ++rtcSqwGeneration;
+    uint64_t first = (sim::nowMicros() - rtcAnchorMicros) / 1000000ULL;
+    rtcSqwFired = first;
+    if (rtcSqwPin < 0 || !rtcSqwEnabled) return;
+    uint8_t pin = (uint8_t)rtcSqwPin;
+
+    std::thread([pin, generation, first]() {
+        for (uint64_t tick = first + 1;; tick++) {
+            uint64_t edgeMicros;
+            {
+                std::lock_guard<std::mutex> lock(rtcMutex);
+                if (rtcSqwGeneration != generation) return;
+                edgeMicros = rtcAnchorMicros + tick * 1000000ULL;
+            }
+            uint64_t now = sim::nowMicros();
+            if (edgeMicros > now) sim::sleepMicros(edgeMicros - now);
+
+            {
+                std::lock_guard<std::mutex> lock(rtcMutex);
+                if (rtcSqwGeneration != generation) return;
+            }
+            sim::setInputLevel(pin, LOW);
+            sim::counters().rtcSqwEdges++;
+            {
+                std::lock_guard<std::mutex> lock(rtcMutex);
+                rtcSqwFired = tick;
+            }
+            rtcEdgeCv.notify_all();
+
+            sim::sleepMicros(500000);
+            sim::setInputLevel(pin, HIGH);
+        }
+    }).detach();
+}
+
+void sim::connectRtcSqw(uint8_t pin) {
+    std::lock_guard<std::mutex> lock(rtcMutex);
+    rtcAnchor();
+    rtcSqwPin = pin;
+    sim::setInputLevel(pin, HIGH);   // Podciągnięcie, wyjście z otwartym drenem nieaktywne
+    rtcStartSqw();
+}
+
+void RTC_DS3231::adjust(const DateTime& dt) {
+    rtcTransfer(RTC_WRITE_BYTES);
+    sim::counters().rtcWrites++;
+    std::lock_guard<std::mutex> lock(rtcMutex);
+    rtcAnchorSeconds = dt.unixtime();
+    rtcAnchorMicros = sim::nowMicros();
+    rtcAnchored = true;
+    rtcStartSqw();
+}
+
+DateTime RTC_DS3231::now() {
+    rtcTransfer(RTC_READ_BYTES);
+    sim::counters().rtcReads++;
+    std::unique_lock<std::mutex> lock(rtcMutex);
+    rtcAnchor();
+    uint64_t ticks = (sim::nowMicros() - rtcAnchorMicros) / 1000000ULL;
+    if (rtcSqwPin >= 0 && rtcSqwEnabled) {
+        // W układzie zmiana rejestru i zbocze SQW są jednoczesne - odczyt nie wyprzedza zbocza
+        sim::waitFor(rtcEdgeCv, lock, 100000, [ticks]() { return rtcSqwFired >= ticks; });
+    }
+    return DateTime((uint32_t)(rtcAnchorSeconds + (int64_t)ticks));
+}
+
+void RTC_DS3231::writeSqwPinMode(Ds3231SqwPinMode mode) {
+    rtcTransfer(3);
+    sim::counters().rtcWrites++;
+    std::lock_guard<std::mutex> lock(rtcMutex);
+    rtcAnchor();
+    bool enabled = mode == DS3231_SquareWave1Hz;
+    if (enabled == rtcSqwEnabled) return;
+    rtcSqwEnabled = enabled;
+    rtcStartSqw();
+}
+
+// --- DS18B20 ---
+// Jeden czujnik na każdym pinie. Model reaguje na sloty 1-Wire (reset, bity)
+// tak jak układ: polecenia ROM, wyszukiwanie, konwersja, pamięć podręczna.
+
+namespace {
+
+    const uint8_t ONE_WIRE_PINS = 40;
+    const uint8_t FAMILY_DS18B20 = 0x28;
+    const uint8_t SCRATCHPAD_SIZE = 9;
+    const uint8_t CONFIGURATION = 4;
+
+    uint8_t romCrc8(const uint8_t* data, uint8_t length) {
+        uint8_t crc = 0;
+        while (length--) {
+            uint8_t inbyte = *data++;
+            for (uint8_t i = 8; i; i--) {
+                uint8_t mix = (crc ^ inbyte) & 0x01;
+                crc >>= 1;
+                if (mix) crc ^= 0x8C;
+                inbyte >>= 1;
+            }
+        }
+        return crc;
+    }
+
+    void simulatedRom(uint8_t pin, uint8_t* rom) {
+        rom[0] = FAMILY_DS18B20;
+        for (uint8_t i = 1; i < 7; i++) rom[i] = pin + i;
+        rom[7] = romCrc8(rom, 7);
+    }
+
+    struct Ds18b20Model {
+        enum State { IDLE, ROM_COMMAND, MATCH_ROM, SEARCH_ROM, FUNCTION, SEND, RECEIVE, CONVERT };
+
+        bool initialized = false;
+        uint8_t pin = 0;
+        uint8_t rom[8];
+        // Po włączeniu zasilania 85°C, konfiguracja 12 bitów
+        uint8_t scratchPad[SCRATCHPAD_SIZE] = {0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0x00};
+        State state = IDLE;
+
+        // Bieżący bajt (odbierany lub wysyłany) i licznik bitów
+        uint8_t data[SCRATCHPAD_SIZE];
+        uint8_t length = 0;
+        uint8_t index = 0;
+        uint8_t bit = 0;
+        uint8_t incoming = 0;
+        bool matched = true;
+        uint8_t searchPhase = 0;   // Bit adresu, jego negacja, kierunek od mastera
+
+        bool converting = false;
+        uint64_t conversionEnd = 0;
+        float fixedTemperature = NAN;   // Ze scenariusza lub testu
+
+        void init(uint8_t modelPin) {
+            initialized = true;
+            pin = modelPin;
+            simulatedRom(pin, rom);
+            scratchPad[SCRATCHPAD_SIZE - 1] = romCrc8(scratchPad, SCRATCHPAD_SIZE - 1);
+        }
+
+        uint8_t resolution() const {
+            return 9 + ((scratchPad[CONFIGURATION] >> 5) & 0x03);
+        }
+
+        float simulatedTemperature() const {
+            if (!isnan(fixedTemperature)) return fixedTemperature;
+            // Każdy pin ma inną temperaturę bazową, zmiana o ±2°C w cyklu 10 minut
+            float base = 15.0f + (pin % 8) * 3.0f;
+            float seconds = sim::nowMicros() / 1e6f;
+            return base + 2.0f * sinf(2.0f * (float)PI * seconds / 600.0f);
+        }
+
+        void finishConversion() {
+            if (!converting || sim::nowMicros() < conversionEnd) return;
+            converting = false;
+            // Nieużywane najmłodsze bity jak w układzie - nieokreślone (tu zera)
+            int16_t raw = (int16_t)lroundf(simulatedTemperature() * 16.0f);
+            raw &= ~((1 << (12 - resolution())) - 1);
+            scratchPad[0] = raw & 0xFF;
+            scratchPad[1] = (raw >> 8) & 0xFF;
+            scratchPad[SCRATCHPAD_SIZE - 1] = romCrc8(scratchPad, SCRATCHPAD_SIZE - 1);
+        }
+
+        void startSend(const uint8_t* source, uint8_t count) {
+            memcpy(data, source, count);
+            length = count;
+            index = 0;
+            bit = 0;
+            state = SEND;
+        }
+
+        void startReceive(State next, uint8_t count) {
+            length = count;
+            index = 0;
+            bit = 0;
+            incoming = 0;
+            state = next;
+        }
+
+        // Bit od mastera; true po skompletowaniu bajtu (w incoming)
+        bool receiveBit(bool value) {
+            if (value) incoming |= 1 << bit;
+            if (++bit < 8) return false;
+            bit = 0;
+            return true;
+        }
+
+        void functionCommand(uint8_t command) {
+            switch (command) {
+                case 0x44: {   // Konwersja temperatury
+                    static const uint16_t CONVERSION_MS[] = {94, 188, 375, 750};
+                    converting = true;
+                    conversionEnd = sim::nowMicros() + CONVERSION_MS[resolution() - 9] * 1000ULL;
+                    state = CONVERT;
+                    break;
+                }
+                case 0xBE:     // Odczyt pamięci podręcznej
+                    finishConversion();
+                    startSend(scratchPad, SCRATCHPAD_SIZE);
+                    break;
+                case 0x4E:     // Zapis TH, TL, konfiguracji
+                    startReceive(RECEIVE, 3);
+                    break;
+                default:       // Kopiowanie do EEPROM i pozostałe - bez skutku
+                    state = IDLE;
+                    break;
+            }
+        }
+
+        bool reset() {
+            finishConversion();
+            state = ROM_COMMAND;
+            incoming = 0;
+            bit = 0;
+            return true;
+        }
+
+        // Stan linii w slocie: czujnik może tylko zewrzeć linię (zero)
+        bool slot(bool master) {
+            switch (state) {
+                case ROM_COMMAND:
+                    if (!receiveBit(master)) return master;
+                    if (incoming == 0x55) {
+                        matched = true;
+                        startReceive(MATCH_ROM, 8);
+                    } else if (incoming == 0xCC) {
+                        startReceive(FUNCTION, 1);
+                    } else if (incoming == 0xF0) {
+                        index = 0;
+                        searchPhase = 0;
+                        state = SEARCH_ROM;
+                    } else if (incoming == 0x33) {
+                        startSend(rom, 8);
+                    } else {
+                        state = IDLE;
+                    }
+                    incoming = 0;
+                    return master;
+
+                case MATCH_ROM:
+                    if (!receiveBit(master)) return master;
+                    if (incoming != rom[index]) matched = false;
+                    incoming = 0;
+                    if (++index == length) {
+                        if (matched) {
+                            startReceive(FUNCTION, 1);
+                        } else {
+                            state = IDLE;
+                        }
+                    }
+                    return master;
+
+                case SEARCH_ROM: {
+                    bool romBit = (rom[index / 8] >> (index % 8)) & 1;
+                    uint8_t phase = searchPhase;
+                    searchPhase = (searchPhase + 1) % 3;
+                    if (phase == 0) return master && romBit;
+                    if (phase == 1) return master && !romBit;
+                    // Kierunek inny niż bit adresu - czujnik wypada z wyszukiwania
+                    if (master != romBit) {
+                        state = IDLE;
+                    } else if (++index == 64) {
+                        startReceive(FUNCTION, 1);
+                    }
+                    return master;
+                }
+
+                case FUNCTION:
+                    if (receiveBit(master)) {
+                        uint8_t command = incoming;
+                        incoming = 0;
+                        functionCommand(command);
+                    }
+                    return master;
+
+                case SEND: {
+                    bool value = (data[index] >> bit) & 1;
+                    if (++bit == 8) {
+                        bit = 0;
+                        if (++index == length) state = IDLE;
+                    }
+                    return master && value;
+                }
+
+                case RECEIVE:
+                    if (!receiveBit(master)) return master;
+                    scratchPad[2 + index] = incoming;
+                    incoming = 0;
+                    if (++index == length) {
+                        // Zapisywalne tylko bity rozdzielczości
+                        scratchPad[CONFIGURATION] = (scratchPad[CONFIGURATION] & 0x60) | 0x1F;
+                        scratchPad[SCRATCHPAD_SIZE - 1] = romCrc8(scratchPad, SCRATCHPAD_SIZE - 1);
+                        state = IDLE;
+                    }
+                    return master;
+
+                case CONVERT:
+                    // Odczyt w trakcie konwersji: 0, po zakończeniu: 1
+                    finishConversion();
+                    return master && !converting;
+
+                default:
+                    return master;
+            }
+        }
+    };
+
+    std::mutex oneWireMutex;
+    Ds18b20Model oneWireModels[ONE_WIRE_PINS];
+
+    Ds18b20Model* modelFor(uint8_t pin) {
+        if (pin >= ONE_WIRE_PINS) return nullptr;
+        Ds18b20Model& model = oneWireModels[pin];
+        if (!model.initialized) model.init(pin);
+        return &model;
+    }
+
+} // namespace
+
+bool sim::oneWireReset(uint8_t pin) {
+    std::lock_guard<std::mutex> lock(oneWireMutex);
+    Ds18b20Model* model = modelFor(pin);
+    return model != nullptr && model->reset();
+}
+
+bool sim::oneWireSlot(uint8_t pin, bool masterBit) {
+    std::lock_guard<std::mutex> lock(oneWireMutex);
+    Ds18b20Model* model = modelFor(pin);
+    return model != nullptr ? model->slot(masterBit) : masterBit;
+}
+
+void sim::setOneWireTemperature(uint8_t pin, float celsius) {
+    std::lock_guard<std::mutex> lock(oneWireMutex);
+    Ds18b20Model* model = modelFor(pin);
+    if (model != nullptr) model->fixedTemperature = celsius;
+}
+
+// --- OneWire ---
+// Czasy jak w bibliotece: część każdego slotu z wyłączonymi przerwaniami
+// (sim::interruptMutex - timer sprzętowy czeka z przerwaniem).
+
+uint8_t OneWire::reset() {
+    sim::sleepMicros(480);
+    bool presence;
+    {
+        std::lock_guard<std::mutex> lock(sim::interruptMutex());
+        sim::sleepMicros(70);
+        presence = sim::oneWireReset(pin);
+    }
+    sim::sleepMicros(410);
+    return presence ? 1 : 0;
+}
+
+void OneWire::writeBit(bool value) {
+    {
+        std::lock_guard<std::mutex> lock(sim::interruptMutex());
+        sim::sleepMicros(value ? 10 : 65);
+        sim::oneWireSlot(pin, value);
+    }
+    sim::sleepMicros(value ? 55 : 5);
+}
+
+bool OneWire::readBit() {
+    bool value;
+    {
+        std::lock_guard<std::mutex> lock(sim::interruptMutex());
+        sim::sleepMicros(13);
+        value = sim::oneWireSlot(pin, true);
+    }
+    sim::sleepMicros(53);
+    return value;
+}
+
+void OneWire::write(uint8_t value, uint8_t power) {
+    (void)power;
+    for (uint8_t i = 0; i < 8; i++) writeBit((value >> i) & 1);
+}
+
+uint8_t OneWire::read() {
+    uint8_t value = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        if (readBit()) value |= 1 << i;
+    }
+    return value;
+}
+
+void OneWire::write_bytes(const uint8_t* data, uint16_t count, bool power) {
+    for (uint16_t i = 0; i < count; i++) write(data[i], power);
+}
+
+void OneWire::read_bytes(uint8_t* data, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) data[i] = read();
+}
+
+void OneWire::select(const uint8_t rom[8]) {
+    write(0x55);
+    write_bytes(rom, 8);
+}
+
+void OneWire::skip() {
+    write(0xCC);
+}
+
+bool OneWire::search(uint8_t* address, bool searchMode) {
+    // Bez slotów wyszukiwania - jedyny czujnik na pinie
+    (void)searchMode;
+    simulatedRom(pin, address);
+    return true;
+}
+
+uint8_t OneWire::crc8(const uint8_t* address, uint8_t length) {
+    return romCrc8(address, length);
+}
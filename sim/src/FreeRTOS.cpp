@@ -0,0 +1,478 @@
+// FreeRTOS na wątkach POSIX. Priorytety i przypięcie do rdzeni są zapamiętywane
+// (do raportów), ale o przydziale CPU decyduje planista systemu hosta.
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/ringbuf.h"
+#include "SimRuntime.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include <string>
+#include <thread>
+
+struct SimTask {
+    std::string name;
+    TaskFunction_t function = nullptr;
+    void* parameter = nullptr;
+    UBaseType_t priority = 0;
+    BaseType_t core = tskNO_AFFINITY;
+    pthread_t thread;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notifyCount = 0;
+};
+
+struct SimQueue {
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+};
+
+struct SimRingbuffer {
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::deque<std::vector<uint8_t>> items;
+    size_t capacity;
+    size_t used = 0;
+    bool itemOut = false;    // Pierwszy element wydany przez xRingbufferReceive
+};
+
+struct SimSemaphore {
+    enum Kind { BINARY, COUNTING, MUTEX, RECURSIVE_MUTEX };
+
+    Kind kind;
+    std::mutex mutex;
+    std::condition_variable cv;
+    UBaseType_t count;
+    UBaseType_t maxCount;
+    SimTask* owner = nullptr;
+    UBaseType_t recursion = 0;
+};
+
+static thread_local SimTask* currentTask = nullptr;
+static const size_t MIN_HOST_STACK = 256 * 1024;  // Stos hosta jest znacznie bardziej zużywany niż na ESP32
+
+static uint64_t ticksToMicros(TickType_t ticks) {
+    return (uint64_t)ticks * portTICK_PERIOD_MS * 1000ULL;
+}
+
+// Oczekiwanie z limitem w tickach (portMAX_DELAY = bez limitu)
+template<typename Predicate>
+static bool waitTicks(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                      TickType_t ticks, Predicate ready) {
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lock, ready);
+        return true;
+    }
+    if (ticks == 0) return ready();
+    return sim::waitFor(cv, lock, ticksToMicros(ticks), ready);
+}
+
+// --- Sekcje krytyczne ---
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    while (mux->flag.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    mux->flag.clear(std::memory_order_release);
+}
+
+BaseType_t xPortGetCoreID() {
+    SimTask* task = xTaskGetCurrentTaskHandle();
+    return task->core == tskNO_AFFINITY ? 1 : task->core;
+}
+
+// --- Zadania ---
+
+static void* taskTrampoline(void* arg) {
+    SimTask* task = static_cast<SimTask*>(arg);
+    currentTask = task;
+    pthread_setname_np(pthread_self(), task->name.substr(0, 15).c_str());
+    task->function(task->parameter);
+    return nullptr;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* createdTask,
+                                   BaseType_t coreId) {
+    SimTask* task = new SimTask();
+    task->name = name ? name : "";
+    task->function = function;
+    task->parameter = parameter;
+    task->priority = priority;
+    task->core = coreId;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, stackDepth < MIN_HOST_STACK ? MIN_HOST_STACK : stackDepth);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int result = pthread_create(&task->thread, &attr, taskTrampoline, task);
+    pthread_attr_destroy(&attr);
+
+    if (result != 0) {
+        delete task;
+        return pdFAIL;
+    }
+    if (createdTask) *createdTask = task;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* createdTask) {
+    return xTaskCreatePinnedToCore(function, name, stackDepth, parameter, priority,
+                                   createdTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == currentTask) {
+        // Uchwyt zadania zostaje (inne zadania mogą go jeszcze trzymać)
+        pthread_exit(nullptr);
+    }
+    // Usuwanie innego zadania nie jest obsługiwane - wątek nie może być bezpiecznie przerwany
+}
+
+void vTaskDelay(TickType_t ticks) {
+    sim::sleepMicros(ticksToMicros(ticks));
+}
+
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment) {
+    TickType_t wake = *previousWakeTime + increment;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(wake - now) > 0) {
+        vTaskDelay(wake - now);
+    }
+    *previousWakeTime = wake;
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(sim::nowMicros() / (portTICK_PERIOD_MS * 1000ULL));
+}
+
+TickType_t xTaskGetTickCountFromISR() {
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (currentTask == nullptr) {
+        // Wątek utworzony poza FreeRTOS (main, stos BLE) - zadanie tworzone przy pierwszym użyciu
+        currentTask = new SimTask();
+        currentTask->name = "host";
+        currentTask->thread = pthread_self();
+    }
+    return currentTask;
+}
+
+char* pcTaskGetName(TaskHandle_t task) {
+    if (task == nullptr) task = xTaskGetCurrentTaskHandle();
+    return const_cast<char*>(task->name.c_str());
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+    if (task == nullptr) task = xTaskGetCurrentTaskHandle();
+    return task->priority;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 0;  // Brak pomiaru stosu na hoście
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    SimTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    waitTicks(task->cv, lock, ticksToWait, [task] { return task->notifyCount > 0; });
+
+    uint32_t value = task->notifyCount;
+    if (value > 0) {
+        task->notifyCount = clearCountOnExit ? 0 : value - 1;
+    }
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (task == nullptr) return pdFAIL;
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->notifyCount++;
+    }
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+}
+
+// --- Kolejki ---
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if (length == 0) return nullptr;
+    SimQueue* queue = new SimQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+static BaseType_t queueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait, bool front) {
+    if (queue == nullptr) return errQUEUE_FULL;
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitTicks(queue->notFull, lock, ticksToWait,
+                   [queue] { return queue->items.size() < queue->length; })) {
+        return errQUEUE_FULL;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(item);
+    std::vector<uint8_t> copy(bytes, bytes + queue->itemSize);
+    if (front) {
+        queue->items.push_front(std::move(copy));
+    } else {
+        queue->items.push_back(std::move(copy));
+    }
+    lock.unlock();
+    queue->notEmpty.notify_one();
+    return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return queueSend(queue, item, ticksToWait, false);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return queueSend(queue, item, ticksToWait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return queueSend(queue, item, ticksToWait, true);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+    return queueSend(queue, item, 0, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    if (queue == nullptr) return pdFAIL;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        const uint8_t* bytes = static_cast<const uint8_t*>(item);
+        queue->items.clear();
+        queue->items.push_back(std::vector<uint8_t>(bytes, bytes + queue->itemSize));
+    }
+    queue->notEmpty.notify_one();
+    return pdPASS;
+}
+
+static BaseType_t queueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait, bool remove) {
+    if (queue == nullptr) return errQUEUE_EMPTY;
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitTicks(queue->notEmpty, lock, ticksToWait, [queue] { return !queue->items.empty(); })) {
+        return errQUEUE_EMPTY;
+    }
+
+    memcpy(buffer, queue->items.front().data(), queue->itemSize);
+    if (remove) {
+        queue->items.pop_front();
+        lock.unlock();
+        queue->notFull.notify_one();
+    }
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+    return queueReceive(queue, buffer, ticksToWait, true);
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void* buffer, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+    return queueReceive(queue, buffer, 0, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+    return queueReceive(queue, buffer, ticksToWait, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->length - queue->items.size();
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->items.clear();
+    }
+    queue->notFull.notify_all();
+    return pdPASS;
+}
+
+// --- Bufor pierścieniowy ---
+
+RingbufHandle_t xRingbufferCreate(size_t bufferSize, RingbufferType_t type) {
+    (void)type;
+    SimRingbuffer* ringbuffer = new SimRingbuffer();
+    ringbuffer->capacity = bufferSize;
+    return ringbuffer;
+}
+
+void vRingbufferDelete(RingbufHandle_t ringbuffer) {
+    delete ringbuffer;
+}
+
+BaseType_t xRingbufferSend(RingbufHandle_t ringbuffer, const void* data, size_t size, TickType_t ticksToWait) {
+    (void)ticksToWait;   // Pełny bufor - element odrzucony (nadawca to sterownik, nie czeka)
+    if (ringbuffer == nullptr) return pdFALSE;
+    {
+        std::lock_guard<std::mutex> lock(ringbuffer->mutex);
+        if (ringbuffer->used + size > ringbuffer->capacity) return pdFALSE;
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        ringbuffer->items.push_back(std::vector<uint8_t>(bytes, bytes + size));
+        ringbuffer->used += size;
+    }
+    ringbuffer->notEmpty.notify_one();
+    return pdTRUE;
+}
+
+void* xRingbufferReceive(RingbufHandle_t ringbuffer, size_t* itemSize, TickType_t ticksToWait) {
+    if (ringbuffer == nullptr) return nullptr;
+    std::unique_lock<std::mutex> lock(ringbuffer->mutex);
+    // Jeden wydany element naraz (jak w użyciu przez sterownik RMT)
+    if (!waitTicks(ringbuffer->notEmpty, lock, ticksToWait,
+                   [ringbuffer] { return !ringbuffer->itemOut && !ringbuffer->items.empty(); })) {
+        return nullptr;
+    }
+    ringbuffer->itemOut = true;
+    if (itemSize) *itemSize = ringbuffer->items.front().size();
+    return ringbuffer->items.front().data();
+}
+
+void vRingbufferReturnItem(RingbufHandle_t ringbuffer, void* item) {
+    if (ringbuffer == nullptr || item == nullptr) return;
+    {
+        std::lock_guard<std::mutex> lock(ringbuffer->mutex);
+        if (!ringbuffer->itemOut || ringbuffer->items.front().data() != item) return;
+        ringbuffer->used -= ringbuffer->items.front().size();
+        ringbuffer->items.pop_front();
+        ringbuffer->itemOut = false;
+    }
+    ringbuffer->notEmpty.notify_one();
+}
+
+// --- Semafory i muteksy ---
+
+static SemaphoreHandle_t createSemaphore(SimSemaphore::Kind kind, UBaseType_t maxCount, UBaseType_t initial) {
+    SimSemaphore* semaphore = new SimSemaphore();
+    semaphore->kind = kind;
+    semaphore->maxCount = maxCount;
+    semaphore->count = initial;
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return createSemaphore(SimSemaphore::BINARY, 1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    return createSemaphore(SimSemaphore::COUNTING, maxCount, initialCount);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return createSemaphore(SimSemaphore::MUTEX, 1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    return createSemaphore(SimSemaphore::RECURSIVE_MUTEX, 1, 1);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (semaphore == nullptr) return pdFAIL;
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    if (!waitTicks(semaphore->cv, lock, ticksToWait, [semaphore] { return semaphore->count > 0; })) {
+        return pdFAIL;
+    }
+    semaphore->count--;
+    semaphore->owner = xTaskGetCurrentTaskHandle();
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    if (semaphore == nullptr) return pdFAIL;
+    {
+        std::lock_guard<std::mutex> lock(semaphore->mutex);
+        if (semaphore->count >= semaphore->maxCount) return pdFAIL;
+        semaphore->count++;
+        semaphore->owner = nullptr;
+    }
+    semaphore->cv.notify_one();
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (semaphore == nullptr) return pdFAIL;
+    SimTask* self = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    if (semaphore->owner == self) {
+        semaphore->recursion++;
+        return pdPASS;
+    }
+    if (!waitTicks(semaphore->cv, lock, ticksToWait, [semaphore] { return semaphore->count > 0; })) {
+        return pdFAIL;
+    }
+    semaphore->count = 0;
+    semaphore->owner = self;
+    semaphore->recursion = 1;
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+    if (semaphore == nullptr) return pdFAIL;
+    {
+        std::lock_guard<std::mutex> lock(semaphore->mutex);
+        if (semaphore->owner != xTaskGetCurrentTaskHandle()) return pdFAIL;
+        if (--semaphore->recursion > 0) return pdPASS;
+        semaphore->owner = nullptr;
+        semaphore->count = 1;
+    }
+    semaphore->cv.notify_one();
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+    return xSemaphoreGive(semaphore);
+}
+
+BaseType_t xSemaphoreTakeFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+    return xSemaphoreTake(semaphore, 0);
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore) {
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+    return semaphore->count;
+}
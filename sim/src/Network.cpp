@@ -0,0 +1,586 @@
+// WiFi, serwer HTTP i WebSocket symulatora
+
+#include "WiFi.h"
+#include "ESPAsyncWebServer.h"
+#include "SimRuntime.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+WiFiClass WiFi;
+
+namespace {
+
+    // Serwery po begin() (żądania ze scenariusza trafiają do wszystkich)
+    std::recursive_mutex networkMutex;
+
+    std::vector<AsyncWebServer*>& runningServers() {
+        static std::vector<AsyncWebServer*> servers;
+        return servers;
+    }
+
+    // Statystyki obsługi żądań ("GET /api/status" -> liczba, czas hosta, przydziały)
+    struct HttpStats {
+        uint32_t count = 0;
+        uint64_t totalUs = 0;
+        uint32_t maxUs = 0;
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+    };
+
+    std::map<std::string, HttpStats>& httpStats() {
+        static std::map<std::string, HttpStats> stats;
+        return stats;
+    }
+
+    // Nagłówki ze scenariusza (http-header) dla najbliższego żądania
+    std::vector<AsyncWebHeader>& pendingHeaders() {
+        static std::vector<AsyncWebHeader> headers;
+        return headers;
+    }
+
+    // ETag ostatniej odpowiedzi - "@etag" w http-header (ponowne sprawdzenie jak w przeglądarce)
+    String& lastEtag() {
+        static String etag;
+        return etag;
+    }
+
+    String contentTypeFor(const String& path) {
+        const char* extensions[][2] = {
+            {".html", "text/html"}, {".htm", "text/html"}, {".css", "text/css"},
+            {".js", "application/javascript"}, {".json", "application/json"},
+            {".png", "image/png"}, {".jpg", "image/jpeg"}, {".ico", "image/x-icon"},
+            {".svg", "image/svg+xml"}, {".txt", "text/plain"}, {".gz", "application/x-gzip"}
+        };
+        for (auto& entry : extensions) {
+            if (path.endsWith(entry[0])) return entry[1];
+        }
+        return "application/octet-stream";
+    }
+
+    String urlDecode(const std::string& text) {
+        std::string result;
+        for (size_t i = 0; i < text.size(); i++) {
+            if (text[i] == '+') {
+                result += ' ';
+            } else if (text[i] == '%' && i + 2 < text.size()) {
+                result += (char)strtol(text.substr(i + 1, 2).c_str(), nullptr, 16);
+                i += 2;
+            } else {
+                result += text[i];
+            }
+        }
+        return String(result.c_str());
+    }
+
+    void parseParams(AsyncWebServerRequest* request, const std::string& text, bool post) {
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('&', start);
+            if (end == std::string::npos) end = text.size();
+            std::string pair = text.substr(start, end - start);
+            size_t equals = pair.find('=');
+            if (!pair.empty()) {
+                request->addParam(urlDecode(pair.substr(0, equals)),
+                                  equals == std::string::npos ? String() : urlDecode(pair.substr(equals + 1)), post);
+            }
+            start = end + 1;
+        }
+    }
+
+    WebRequestMethodComposite parseMethod(const std::string& method) {
+        if (method == "POST") return HTTP_POST;
+        if (method == "PUT") return HTTP_PUT;
+        if (method == "DELETE") return HTTP_DELETE;
+        if (method == "PATCH") return HTTP_PATCH;
+        if (method == "HEAD") return HTTP_HEAD;
+        if (method == "OPTIONS") return HTTP_OPTIONS;
+        return HTTP_GET;
+    }
+
+    void appendLog(const char* name, const std::string& text) {
+        std::ofstream log(sim::outputPath(name), std::ios::app);
+        log << text;
+    }
+
+} // namespace
+
+// --- Żądanie ---
+
+const char* AsyncWebServerRequest::methodToString() const {
+    switch (requestMethod) {
+        case HTTP_POST: return "POST";
+        case HTTP_PUT: return "PUT";
+        case HTTP_DELETE: return "DELETE";
+        case HTTP_PATCH: return "PATCH";
+        case HTTP_HEAD: return "HEAD";
+        case HTTP_OPTIONS: return "OPTIONS";
+        default: return "GET";
+    }
+}
+
+bool AsyncWebServerRequest::hasParam(const String& name, bool post, bool file) const {
+    (void)file;
+    for (const AsyncWebParameter& param : parameters) {
+        if (param.name() == name && param.isPost() == post) return true;
+    }
+    return false;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const String& name, bool post, bool file) {
+    (void)file;
+    for (AsyncWebParameter& param : parameters) {
+        if (param.name() == name && param.isPost() == post) return &param;
+    }
+    return nullptr;
+}
+
+const String& AsyncWebServerRequest::arg(const String& name) {
+    static const String empty;
+    for (AsyncWebParameter& param : parameters) {
+        if (param.name() == name) return param.value();
+    }
+    return empty;
+}
+
+bool AsyncWebServerRequest::hasHeader(const String& name) const {
+    for (const AsyncWebHeader& entry : requestHeaders) {
+        if (entry.name().equalsIgnoreCase(name)) return true;
+    }
+    return false;
+}
+
+AsyncWebHeader* AsyncWebServerRequest::getHeader(const String& name) {
+    for (AsyncWebHeader& entry : requestHeaders) {
+        if (entry.name().equalsIgnoreCase(name)) return &entry;
+    }
+    return nullptr;
+}
+
+const String& AsyncWebServerRequest::header(const char* name) {
+    static const String empty;
+    AsyncWebHeader* entry = getHeader(name);
+    return entry ? entry->value() : empty;
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* newResponse) {
+    // Jak w bibliotece: obowiązuje pierwsza wysłana odpowiedź
+    if (response) {
+        delete newResponse;
+        return;
+    }
+    response = newResponse;
+}
+
+void AsyncWebServerRequest::redirect(const String& url) {
+    AsyncWebServerResponse* redirectResponse = beginResponse(302);
+    redirectResponse->addHeader("Location", url);
+    send(redirectResponse);
+}
+
+// --- Odpowiedź z pliku ---
+
+AsyncFileResponse::AsyncFileResponse(FS& fs, const String& path, const String& contentType, bool download)
+    : AsyncWebServerResponse(200, contentType.length() ? contentType : contentTypeFor(path)) {
+    String source = path;
+    // Jak w bibliotece: wersja .gz ma pierwszeństwo
+    if (!download && !fs.exists(path) && fs.exists(path + ".gz")) {
+        source = path + ".gz";
+        addHeader("Content-Encoding", "gzip");
+    }
+
+    File file = fs.open(source, "r");
+    if (!file || file.isDirectory()) {
+        responseCode = 404;
+        type = "text/plain";
+        content = "Not found";
+        return;
+    }
+
+    content.resize(file.size());
+    if (!content.empty()) file.read((uint8_t*)&content[0], content.size());
+    if (download) addHeader("Content-Disposition", "attachment");
+}
+
+// --- Handlery ---
+
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest* request) {
+    if (!(methods & request->method())) return false;
+
+    if (uri.length() && uri.endsWith("*")) {
+        return request->url().startsWith(uri.substring(0, uri.length() - 1));
+    }
+    return uri.length() == 0 || request->url() == uri;
+}
+
+bool AsyncStaticWebHandler::resolve(const String& url, String& file) {
+    String relative = url.substring(uri.length());
+    String base = path;
+    if (base.endsWith("/")) base = base.substring(0, base.length() - 1);
+    if (relative.length() && !relative.startsWith("/")) relative = "/" + relative;
+
+    String candidate = base + relative;
+    if (candidate.length() == 0 || candidate.endsWith("/")) {
+        candidate += defaultFile;
+    } else if (fs.exists(candidate)) {
+        File entry = fs.open(candidate, "r");
+        if (entry && entry.isDirectory()) candidate += "/" + defaultFile;
+    }
+
+    file = candidate;
+    return fs.exists(candidate) || fs.exists(candidate + ".gz");
+}
+
+bool AsyncStaticWebHandler::canHandle(AsyncWebServerRequest* request) {
+    if (request->method() != HTTP_GET || !request->url().startsWith(uri)) return false;
+    String file;
+    return resolve(request->url(), file);
+}
+
+void AsyncStaticWebHandler::handleRequest(AsyncWebServerRequest* request) {
+    String file;
+    resolve(request->url(), file);
+    AsyncWebServerResponse* response = request->beginResponse(fs, file);
+    if (cacheControl.length()) response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+}
+
+// --- WebSocket ---
+
+void AsyncWebSocketClient::text(const char* message, size_t length) {
+    if (connected) socket->log(clientId, false, (const uint8_t*)message, length);
+}
+
+void AsyncWebSocketClient::binary(const uint8_t* message, size_t length) {
+    if (connected) socket->log(clientId, true, message, length);
+}
+
+void AsyncWebSocketClient::close() {
+    socket->disconnectClient(this);
+}
+
+AsyncWebSocket::~AsyncWebSocket() {
+    for (AsyncWebSocketClient* entry : clients) delete entry;
+}
+
+size_t AsyncWebSocket::count() const {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    size_t connected = 0;
+    for (AsyncWebSocketClient* entry : clients) {
+        if (entry->isConnected()) connected++;
+    }
+    return connected;
+}
+
+AsyncWebSocketClient* AsyncWebSocket::client(uint32_t id) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    for (AsyncWebSocketClient* entry : clients) {
+        if (entry->id() == id && entry->isConnected()) return entry;
+    }
+    return nullptr;
+}
+
+void AsyncWebSocket::cleanupClients(uint16_t maxClients) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    while (count() > maxClients) {
+        for (AsyncWebSocketClient* entry : clients) {
+            if (entry->isConnected()) {
+                entry->close();
+                break;
+            }
+        }
+    }
+}
+
+void AsyncWebSocket::text(uint32_t id, const char* message, size_t length) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    AsyncWebSocketClient* target = client(id);
+    if (target) target->text(message, length);
+}
+
+void AsyncWebSocket::textAll(const char* message, size_t length) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    for (AsyncWebSocketClient* entry : clients) entry->text(message, length);
+}
+
+void AsyncWebSocket::binary(uint32_t id, const uint8_t* message, size_t length) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    AsyncWebSocketClient* target = client(id);
+    if (target) target->binary(message, length);
+}
+
+void AsyncWebSocket::binaryAll(const uint8_t* message, size_t length) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    for (AsyncWebSocketClient* entry : clients) entry->binary(message, length);
+}
+
+void AsyncWebSocket::closeAll() {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    for (AsyncWebSocketClient* entry : clients) {
+        if (entry->isConnected()) disconnectClient(entry);
+    }
+}
+
+AsyncWebSocketClient* AsyncWebSocket::connectClient() {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    AsyncWebSocketClient* entry = new AsyncWebSocketClient(this, nextId++);
+    clients.push_back(entry);
+    if (eventHandler) eventHandler(this, entry, WS_EVT_CONNECT, nullptr, nullptr, 0);
+    return entry;
+}
+
+void AsyncWebSocket::disconnectClient(AsyncWebSocketClient* entry) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    if (!entry->isConnected()) return;
+    if (eventHandler) eventHandler(this, entry, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+    // Obiekt klienta zostaje (wskaźnik mógł zostać zapamiętany w handlerze)
+    clients.erase(std::remove(clients.begin(), clients.end(), entry), clients.end());
+}
+
+void AsyncWebSocket::receive(AsyncWebSocketClient* entry, AwsFrameType type, const uint8_t* data, size_t length) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    if (!eventHandler) return;
+
+    AwsFrameInfo info = {};
+    info.message_opcode = type;
+    info.opcode = type;
+    info.final = 1;
+    info.len = length;
+
+    // Bufor z miejscem na terminator, który handlery często dopisują
+    std::vector<uint8_t> buffer(data, data + length);
+    buffer.push_back(0);
+    eventHandler(this, entry, WS_EVT_DATA, &info, buffer.data(), length);
+}
+
+void AsyncWebSocket::log(uint32_t id, bool binary, const uint8_t* message, size_t length) {
+    sim::counters().wsMessages++;
+
+    char header[48];
+    snprintf(header, sizeof(header), "%llu #%u %s ", (unsigned long long)(sim::nowMicros() / 1000),
+             id, binary ? "bin" : "txt");
+    std::string line = header;
+    if (binary) {
+        for (size_t i = 0; i < length; i++) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", message[i]);
+            line += hex;
+        }
+    } else {
+        line.append((const char*)message, length);
+    }
+    appendLog("ws.log", line + "\n");
+}
+
+// --- Serwer ---
+
+AsyncWebServer::~AsyncWebServer() {
+    end();
+}
+
+void AsyncWebServer::begin() {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    if (running) return;
+    running = true;
+    runningServers().push_back(this);
+}
+
+void AsyncWebServer::end() {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    running = false;
+    std::vector<AsyncWebServer*>& servers = runningServers();
+    servers.erase(std::remove(servers.begin(), servers.end(), this), servers.end());
+}
+
+void AsyncWebServer::reset() {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    handlers.clear();
+    notFound = nullptr;
+}
+
+AsyncWebHandler& AsyncWebServer::addHandler(AsyncWebHandler* handler) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    handlers.push_back(handler);
+    return *handler;
+}
+
+bool AsyncWebServer::removeHandler(AsyncWebHandler* handler) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    size_t before = handlers.size();
+    handlers.erase(std::remove(handlers.begin(), handlers.end(), handler), handlers.end());
+    return handlers.size() != before;
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest,
+                                            ArUploadHandlerFunction onUpload, ArBodyHandlerFunction onBody) {
+    AsyncCallbackWebHandler* handler = new AsyncCallbackWebHandler(uri, method, onRequest, onUpload, onBody);
+    addHandler(handler);
+    return *handler;
+}
+
+AsyncStaticWebHandler& AsyncWebServer::serveStatic(const char* uri, FS& fs, const char* path, const char* cacheControl) {
+    AsyncStaticWebHandler* handler = new AsyncStaticWebHandler(uri, fs, path, cacheControl);
+    addHandler(handler);
+    return *handler;
+}
+
+int AsyncWebServer::handle(AsyncWebServerRequest* request, const std::string& body) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+
+    // Pierwszy pasujący handler, w kolejności rejestracji
+    AsyncWebHandler* target = nullptr;
+    for (AsyncWebHandler* handler : handlers) {
+        if (handler->canHandle(request)) {
+            target = handler;
+            break;
+        }
+    }
+
+    if (target == nullptr) {
+        if (notFound) notFound(request);
+        else request->send(404);
+    } else {
+        if (!body.empty()) {
+            std::vector<uint8_t> buffer(body.begin(), body.end());
+            buffer.push_back(0);
+            target->handleBody(request, buffer.data(), body.size(), 0, body.size());
+        }
+        target->handleRequest(request);
+    }
+
+    return request->getResponse() ? request->getResponse()->code() : 0;
+}
+
+std::vector<AsyncWebSocket*> AsyncWebServer::webSockets() {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    std::vector<AsyncWebSocket*> sockets;
+    for (AsyncWebHandler* handler : handlers) {
+        AsyncWebSocket* socket = dynamic_cast<AsyncWebSocket*>(handler);
+        if (socket) sockets.push_back(socket);
+    }
+    return sockets;
+}
+
+// --- Wywołania ze scenariusza ---
+
+void sim::httpRequest(const std::string& method, const std::string& uri, const std::string& body) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    counters().httpRequests++;
+
+    size_t query = uri.find('?');
+    std::string path = uri.substr(0, query);
+    AsyncWebServerRequest request(parseMethod(method), String(path.c_str()));
+    if (query != std::string::npos) parseParams(&request, uri.substr(query + 1), false);
+    for (const AsyncWebHeader& header : pendingHeaders()) request.addHeader(header.name(), header.value());
+    pendingHeaders().clear();
+
+    // Treść JSON trafia do handlera treści, pozostała jest formularzem
+    std::string rawBody;
+    if (!body.empty() && (body[0] == '{' || body[0] == '[')) {
+        request.addHeader("Content-Type", "application/json");
+        rawBody = body;
+    } else if (!body.empty()) {
+        request.addHeader("Content-Type", "application/x-www-form-urlencoded");
+        parseParams(&request, body, true);
+    }
+
+    // Pomiar samego handlera (z budową odpowiedzi), bez parsowania żądania
+    HeapUsage heapBefore = threadHeapUsage();
+    auto start = std::chrono::steady_clock::now();
+
+    int code = 0;
+    for (AsyncWebServer* server : runningServers()) {
+        code = server->handle(&request, rawBody);
+        if (code != 0) break;
+    }
+
+    uint32_t elapsedUs = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    HeapUsage heapAfter = threadHeapUsage();
+    uint32_t allocations = heapAfter.allocations - heapBefore.allocations;
+    uint64_t allocatedBytes = heapAfter.bytes - heapBefore.bytes;
+
+    HttpStats& stats = httpStats()[std::string(request.methodToString()) + " " + path];
+    stats.count++;
+    stats.totalUs += elapsedUs;
+    stats.maxUs = std::max(stats.maxUs, elapsedUs);
+    stats.allocations += allocations;
+    stats.allocatedBytes += allocatedBytes;
+
+    AsyncWebServerResponse* response = request.getResponse();
+    lastEtag() = "";
+    if (response) {
+        for (const AsyncWebHeader& header : response->getHeaders()) {
+            if (header.name().equalsIgnoreCase("ETag")) lastEtag() = header.value();
+        }
+    }
+
+    char summary[200];
+    snprintf(summary, sizeof(summary), "%llu %s %s -> %d %s (%u B, przydziały %u/%llu B, %u us)",
+             (unsigned long long)(nowMicros() / 1000), request.methodToString(), uri.c_str(), code,
+             response ? response->contentType().c_str() : "", response ? (unsigned)response->body().size() : 0,
+             allocations, (unsigned long long)allocatedBytes, elapsedUs);
+    printf("[http] %s\n", summary);
+
+    std::string entry = std::string(summary) + "\n";
+    if (response) {
+        for (const AsyncWebHeader& header : response->getHeaders()) {
+            entry += std::string(header.name().c_str()) + ": " + header.value().c_str() + "\n";
+        }
+        // Pliki binarne (np. .gz) tylko z rozmiarem
+        bool encoded = false;
+        for (const AsyncWebHeader& header : response->getHeaders()) {
+            if (header.name().equalsIgnoreCase("Content-Encoding")) encoded = true;
+        }
+        if (!encoded && (response->contentType().startsWith("text/") || response->contentType().endsWith("json") ||
+            response->contentType().endsWith("javascript"))) {
+            entry += response->body() + "\n";
+        }
+    }
+    appendLog("http.log", entry + "\n");
+}
+
+void sim::httpHeader(const std::string& name, const std::string& value) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    String headerValue = value == "@etag" ? lastEtag() : String(value.c_str());
+    pendingHeaders().push_back(AsyncWebHeader(String(name.c_str()), headerValue));
+}
+
+void sim::printHttpStats() {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    if (httpStats().empty()) return;
+
+    // Czas hosta, nie ESP32 - do porównywania przebiegów między sobą
+    fprintf(stderr, "[sim] %-36s %6s %9s %9s %11s %9s\n",
+            "endpoint", "liczba", "śr. us", "maks. us", "przydz./ż.", "B/ż.");
+    for (const auto& entry : httpStats()) {
+        const HttpStats& s = entry.second;
+        fprintf(stderr, "[sim] %-36s %6u %9llu %9u %11.1f %9llu\n",
+                entry.first.c_str(), s.count, (unsigned long long)(s.totalUs / s.count), s.maxUs,
+                (double)s.allocations / s.count, (unsigned long long)(s.allocatedBytes / s.count));
+    }
+}
+
+void sim::webSocketConnect() {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    for (AsyncWebServer* server : runningServers()) {
+        for (AsyncWebSocket* socket : server->webSockets()) {
+            AsyncWebSocketClient* client = socket->connectClient();
+            printf("[ws] klient #%u połączony\n", client->id());
+        }
+    }
+}
+
+void sim::webSocketSend(const std::string& text) {
+    std::lock_guard<std::recursive_mutex> lock(networkMutex);
+    for (AsyncWebServer* server : runningServers()) {
+        for (AsyncWebSocket* socket : server->webSockets()) {
+            AsyncWebSocketClient* client = socket->lastClient();
+            if (client) socket->receive(client, WS_TEXT, (const uint8_t*)text.data(), text.size());
+        }
+    }
+}
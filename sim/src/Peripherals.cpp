@@ -0,0 +1,761 @@
+// Peryferia ESP32: licznik impulsów (PCNT), RMT, ADC (tryb ciągły), LEDC, esp_timer i timer sprzętowy
+
+#include "Arduino.h"
+#include "driver/pcnt.h"
+#include "driver/rmt.h"
+#include "driver/adc.h"
+#include "esp_adc_cal.h"
+#include "driver/ledc.h"
+#include "esp_timer.h"
+#include "SimRuntime.h"
+
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+// --- PCNT ---
+
+namespace {
+
+    struct PulseCounter {
+        bool configured = false;
+        bool running = false;
+        int pin = PCNT_PIN_NOT_USED;
+        pcnt_count_mode_t posMode = PCNT_COUNT_DIS;
+        pcnt_count_mode_t negMode = PCNT_COUNT_DIS;
+        int16_t highLimit = 0;
+        int16_t lowLimit = 0;
+        int16_t value = 0;
+    };
+
+    std::mutex pcntMutex;
+    PulseCounter pulseCounters[PCNT_UNIT_MAX];
+
+    PulseCounter* counterFor(pcnt_unit_t unit) {
+        return (unit >= PCNT_UNIT_0 && unit < PCNT_UNIT_MAX) ? &pulseCounters[unit] : nullptr;
+    }
+
+    void applyMode(PulseCounter& counter, pcnt_count_mode_t mode) {
+        if (mode == PCNT_COUNT_INC) counter.value++;
+        if (mode == PCNT_COUNT_DEC) counter.value--;
+        // Jak w sprzęcie: po osiągnięciu limitu licznik wraca do zera
+        if ((counter.highLimit > 0 && counter.value >= counter.highLimit) ||
+            (counter.lowLimit < 0 && counter.value <= counter.lowLimit)) {
+            counter.value = 0;
+        }
+    }
+
+} // namespace
+
+void sim::countPulseEdge(uint8_t pin, bool rising) {
+    std::lock_guard<std::mutex> lock(pcntMutex);
+    for (PulseCounter& counter : pulseCounters) {
+        if (!counter.configured || !counter.running || counter.pin != pin) continue;
+        applyMode(counter, rising ? counter.posMode : counter.negMode);
+    }
+}
+
+esp_err_t pcnt_unit_config(const pcnt_config_t* config) {
+    if (config == nullptr) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(pcntMutex);
+    PulseCounter* counter = counterFor(config->unit);
+    if (counter == nullptr) return ESP_ERR_INVALID_ARG;
+
+    counter->configured = true;
+    counter->running = true;
+    counter->pin = config->pulse_gpio_num;
+    counter->posMode = config->pos_mode;
+    counter->negMode = config->neg_mode;
+    counter->highLimit = config->counter_h_lim;
+    counter->lowLimit = config->counter_l_lim;
+    counter->value = 0;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_set_filter_value(pcnt_unit_t unit, uint16_t value) {
+    (void)value;   // Scenariusz nie generuje zakłóceń
+    return counterFor(unit) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t pcnt_filter_enable(pcnt_unit_t unit) {
+    return counterFor(unit) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t pcnt_filter_disable(pcnt_unit_t unit) {
+    return counterFor(unit) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t pcnt_counter_pause(pcnt_unit_t unit) {
+    std::lock_guard<std::mutex> lock(pcntMutex);
+    PulseCounter* counter = counterFor(unit);
+    if (counter == nullptr) return ESP_ERR_INVALID_ARG;
+    counter->running = false;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_counter_resume(pcnt_unit_t unit) {
+    std::lock_guard<std::mutex> lock(pcntMutex);
+    PulseCounter* counter = counterFor(unit);
+    if (counter == nullptr) return ESP_ERR_INVALID_ARG;
+    counter->running = true;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_counter_clear(pcnt_unit_t unit) {
+    std::lock_guard<std::mutex> lock(pcntMutex);
+    PulseCounter* counter = counterFor(unit);
+    if (counter == nullptr) return ESP_ERR_INVALID_ARG;
+    counter->value = 0;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_get_counter_value(pcnt_unit_t unit, int16_t* count) {
+    std::lock_guard<std::mutex> lock(pcntMutex);
+    PulseCounter* counter = counterFor(unit);
+    if (counter == nullptr || count == nullptr) return ESP_ERR_INVALID_ARG;
+    *count = counter->value;
+    return ESP_OK;
+}
+
+// --- RMT ---
+
+namespace {
+
+    const uint16_t ONE_WIRE_RESET_MIN_US = 400;    // Dłuższe zwarcie linii - reset
+    const uint16_t ONE_WIRE_SAMPLE_US = 15;        // Krótsze - zapis 1 lub odczyt
+    const uint16_t PRESENCE_DELAY_US = 30;
+    const uint16_t PRESENCE_LOW_US = 120;
+    const uint16_t DEVICE_ZERO_LOW_US = 30;        // Czujnik przedłuża zwarcie (odczytane 0)
+    const uint8_t RMT_MAX_ITEMS = 64;
+
+    struct RmtChannel {
+        bool configured = false;
+        bool installed = false;
+        bool receiving = false;
+        rmt_mode_t mode = RMT_MODE_TX;
+        int gpio = -1;
+        RingbufHandle_t buffer = nullptr;
+    };
+
+    std::mutex rmtMutex;
+    RmtChannel rmtChannels[RMT_CHANNEL_MAX];
+
+    RmtChannel* channelFor(rmt_channel_t channel) {
+        return (channel >= RMT_CHANNEL_0 && channel < RMT_CHANNEL_MAX) ? &rmtChannels[channel] : nullptr;
+    }
+
+    rmt_item32_t makeItem(uint16_t low, uint16_t high) {
+        rmt_item32_t item;
+        item.level0 = 0;
+        item.duration0 = low;
+        item.level1 = 1;
+        item.duration1 = high;
+        return item;
+    }
+
+} // namespace
+
+esp_err_t rmt_config(const rmt_config_t* config) {
+    if (config == nullptr) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(rmtMutex);
+    RmtChannel* channel = channelFor(config->channel);
+    if (channel == nullptr) return ESP_ERR_INVALID_ARG;
+    channel->configured = true;
+    channel->mode = config->rmt_mode;
+    channel->gpio = config->gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rxBufferSize, int intrAllocFlags) {
+    (void)intrAllocFlags;
+    std::lock_guard<std::mutex> lock(rmtMutex);
+    RmtChannel* rmt = channelFor(channel);
+    if (rmt == nullptr || !rmt->configured) return ESP_ERR_INVALID_ARG;
+    if (rmt->installed) return ESP_ERR_INVALID_STATE;
+    if (rmt->mode == RMT_MODE_RX && rxBufferSize > 0) {
+        rmt->buffer = xRingbufferCreate(rxBufferSize, RINGBUF_TYPE_NOSPLIT);
+    }
+    rmt->installed = true;
+    return ESP_OK;
+}
+
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel) {
+    std::lock_guard<std::mutex> lock(rmtMutex);
+    RmtChannel* rmt = channelFor(channel);
+    if (rmt == nullptr || !rmt->installed) return ESP_ERR_INVALID_STATE;
+    if (rmt->buffer != nullptr) vRingbufferDelete(rmt->buffer);
+    rmt->buffer = nullptr;
+    rmt->installed = false;
+    rmt->receiving = false;
+    return ESP_OK;
+}
+
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t* items, int itemCount, bool waitTxDone) {
+    // Nadawanie zawsze synchroniczne (jak waitTxDone = true)
+    (void)waitTxDone;
+    int gpio;
+    {
+        std::lock_guard<std::mutex> lock(rmtMutex);
+        RmtChannel* rmt = channelFor(channel);
+        if (rmt == nullptr || !rmt->installed || rmt->mode != RMT_MODE_TX) return ESP_ERR_INVALID_STATE;
+        gpio = rmt->gpio;
+    }
+    if (items == nullptr || itemCount <= 0 || itemCount > RMT_MAX_ITEMS / 2) return ESP_ERR_INVALID_ARG;
+
+    // Stan linii widziany przez odbiornik: zwarcia mastera i odpowiedzi czujnika 1-Wire
+    rmt_item32_t line[RMT_MAX_ITEMS];
+    int lineCount = 0;
+    uint64_t totalMicros = 0;
+    for (int i = 0; i < itemCount; i++) {
+        uint16_t low = items[i].level0 == 0 ? items[i].duration0 : 0;
+        uint16_t high = items[i].duration0 + items[i].duration1 - low;
+        totalMicros += items[i].duration0 + items[i].duration1;
+
+        if (low >= ONE_WIRE_RESET_MIN_US) {
+            if (sim::oneWireReset(gpio)) {
+                line[lineCount++] = makeItem(low, PRESENCE_DELAY_US);
+                line[lineCount++] = makeItem(PRESENCE_LOW_US, high - PRESENCE_DELAY_US - PRESENCE_LOW_US);
+            } else {
+                line[lineCount++] = makeItem(low, high);
+            }
+        } else if (low > 0) {
+            bool level = sim::oneWireSlot(gpio, low < ONE_WIRE_SAMPLE_US);
+            uint16_t observed = (!level && low < DEVICE_ZERO_LOW_US) ? DEVICE_ZERO_LOW_US : low;
+            line[lineCount++] = makeItem(observed, low + high - observed);
+        }
+    }
+    // Koniec odbioru: linia bez zmian dłużej niż próg bezczynności
+    if (lineCount > 0) line[lineCount - 1].duration1 = 0;
+
+    sim::sleepMicros(totalMicros);
+
+    std::lock_guard<std::mutex> lock(rmtMutex);
+    for (RmtChannel& rx : rmtChannels) {
+        if (rx.installed && rx.receiving && rx.gpio == gpio && rx.buffer != nullptr && lineCount > 0) {
+            xRingbufferSend(rx.buffer, line, lineCount * sizeof(rmt_item32_t), 0);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t rmt_rx_start(rmt_channel_t channel, bool resetIndex) {
+    (void)resetIndex;
+    std::lock_guard<std::mutex> lock(rmtMutex);
+    RmtChannel* rmt = channelFor(channel);
+    if (rmt == nullptr || !rmt->installed || rmt->mode != RMT_MODE_RX) return ESP_ERR_INVALID_STATE;
+    rmt->receiving = true;
+    return ESP_OK;
+}
+
+esp_err_t rmt_rx_stop(rmt_channel_t channel) {
+    std::lock_guard<std::mutex> lock(rmtMutex);
+    RmtChannel* rmt = channelFor(channel);
+    if (rmt == nullptr || !rmt->installed) return ESP_ERR_INVALID_STATE;
+    rmt->receiving = false;
+    return ESP_OK;
+}
+
+esp_err_t rmt_set_rx_idle_thresh(rmt_channel_t channel, uint16_t threshold) {
+    (void)threshold;   // Model kończy odbiór razem z nadawaniem
+    return channelFor(channel) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rmt_get_ringbuf_handle(rmt_channel_t channel, RingbufHandle_t* handle) {
+    std::lock_guard<std::mutex> lock(rmtMutex);
+    RmtChannel* rmt = channelFor(channel);
+    if (rmt == nullptr || handle == nullptr || rmt->buffer == nullptr) return ESP_ERR_INVALID_ARG;
+    *handle = rmt->buffer;
+    return ESP_OK;
+}
+
+// --- ADC (tryb ciągły) ---
+
+namespace {
+
+    const uint8_t ADC1_GPIO[] = {36, 37, 38, 39, 32, 33, 34, 35};
+    const uint8_t ADC_MAX_PATTERN = 16;
+
+    struct ContinuousAdc {
+        bool initialized = false;
+        bool running = false;
+        bool overflow = false;
+        uint32_t bufferSamples = 0;
+        uint32_t sampleRate = 0;
+        adc_digi_pattern_config_t pattern[ADC_MAX_PATTERN];
+        uint32_t patternLength = 0;
+        uint32_t patternIndex = 0;
+        uint64_t consumedMicros = 0;   // Czas próbki następnej do odczytu
+    };
+
+    std::mutex adcMutex;
+    ContinuousAdc continuousAdc;
+
+    // Próbki zebrane od ostatniego odczytu (nadmiar ponad bufor odrzucany)
+    uint32_t pendingSamples(ContinuousAdc& adc) {
+        uint64_t now = sim::nowMicros();
+        uint64_t samples = (now - adc.consumedMicros) * adc.sampleRate / 1000000ULL;
+        if (samples > adc.bufferSamples) {
+            adc.overflow = true;
+            adc.consumedMicros = now - adc.bufferSamples * 1000000ULL / adc.sampleRate;
+            samples = adc.bufferSamples;
+        }
+        return (uint32_t)samples;
+    }
+
+} // namespace
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* initConfig) {
+    if (initConfig == nullptr || initConfig->adc2_chan_mask != 0) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(adcMutex);
+    if (continuousAdc.initialized) return ESP_ERR_INVALID_STATE;
+    continuousAdc = ContinuousAdc();
+    continuousAdc.initialized = true;
+    continuousAdc.bufferSamples = initConfig->max_store_buf_size / sizeof(adc_digi_output_data_t);
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_deinitialize(void) {
+    std::lock_guard<std::mutex> lock(adcMutex);
+    continuousAdc = ContinuousAdc();
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config) {
+    if (config == nullptr || config->adc_pattern == nullptr || config->pattern_num == 0 ||
+        config->pattern_num > ADC_MAX_PATTERN || config->sample_freq_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(adcMutex);
+    if (!continuousAdc.initialized) return ESP_ERR_INVALID_STATE;
+    for (uint32_t i = 0; i < config->pattern_num; i++) {
+        if (config->adc_pattern[i].unit != 0 || config->adc_pattern[i].channel >= sizeof(ADC1_GPIO)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        continuousAdc.pattern[i] = config->adc_pattern[i];
+    }
+    continuousAdc.patternLength = config->pattern_num;
+    continuousAdc.sampleRate = config->sample_freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_start(void) {
+    std::lock_guard<std::mutex> lock(adcMutex);
+    if (!continuousAdc.initialized || continuousAdc.patternLength == 0) return ESP_ERR_INVALID_STATE;
+    continuousAdc.running = true;
+    continuousAdc.consumedMicros = sim::nowMicros();
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_stop(void) {
+    std::lock_guard<std::mutex> lock(adcMutex);
+    continuousAdc.running = false;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_read_bytes(uint8_t* buffer, uint32_t lengthMax, uint32_t* outLength, uint32_t timeoutMs) {
+    if (buffer == nullptr || outLength == nullptr) return ESP_ERR_INVALID_ARG;
+    *outLength = 0;
+
+    uint64_t deadline = sim::nowMicros() + timeoutMs * 1000ULL;
+    std::unique_lock<std::mutex> lock(adcMutex);
+    if (!continuousAdc.running) return ESP_ERR_INVALID_STATE;
+    uint32_t samples;
+    while ((samples = pendingSamples(continuousAdc)) == 0) {
+        if (sim::nowMicros() >= deadline) return ESP_ERR_TIMEOUT;
+        lock.unlock();
+        sim::sleepMicros(1000000ULL / continuousAdc.sampleRate + 1);
+        lock.lock();
+    }
+
+    samples = std::min<uint32_t>(samples, lengthMax / sizeof(adc_digi_output_data_t));
+    adc_digi_output_data_t* out = (adc_digi_output_data_t*)buffer;
+    for (uint32_t i = 0; i < samples; i++) {
+        const adc_digi_pattern_config_t& entry = continuousAdc.pattern[continuousAdc.patternIndex];
+        continuousAdc.patternIndex = (continuousAdc.patternIndex + 1) % continuousAdc.patternLength;
+        out[i].val = 0;
+        out[i].type1.data = std::min<uint16_t>(analogRead(ADC1_GPIO[entry.channel]), 4095);
+        out[i].type1.channel = entry.channel;
+    }
+    continuousAdc.consumedMicros += samples * 1000000ULL / continuousAdc.sampleRate;
+    *outLength = samples * sizeof(adc_digi_output_data_t);
+
+    // Jak w sterowniku: dane poprawne, ale część próbek utracona
+    bool overflow = continuousAdc.overflow;
+    continuousAdc.overflow = false;
+    return overflow ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                             uint32_t defaultVref, esp_adc_cal_characteristics_t* chars) {
+    if (chars != nullptr) {
+        chars->adc_num = unit;
+        chars->atten = atten;
+        chars->bit_width = width;
+        chars->vref = defaultVref;
+    }
+    return ESP_ADC_CAL_VAL_EFUSE_TP;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars) {
+    (void)chars;
+    return (raw * 3300 + 2047) / 4095;
+}
+
+// --- LEDC ---
+
+namespace {
+
+    const uint32_t LEDC_REF_TICK_HZ = 1000000;
+    const uint32_t LEDC_APB_CLK_HZ = 80000000;
+    const uint32_t LEDC_MAX_BITS = 20;
+    const uint32_t LEDC_MIN_DIVIDER = 1 << 8;     // Q10.8: 1,0
+    const uint32_t LEDC_MAX_DIVIDER = 1 << 18;
+
+    struct LedcTimer {
+        bool configured = false;
+        uint32_t bits = 0;
+        uint32_t divider = 0;       // Q10.8
+        uint32_t clockHz = 0;
+    };
+
+    struct LedcChannel {
+        bool configured = false;
+        int pin = -1;
+        ledc_timer_t timer = LEDC_TIMER_0;
+        uint32_t fromDuty = 0;
+        uint32_t toDuty = 0;
+        uint64_t fadeStart = 0;     // Rampa od fromDuty do toDuty [us]
+        uint64_t fadeEnd = 0;
+    };
+
+    std::mutex ledcMutex;
+    bool ledcFadeInstalled = false;
+    LedcTimer ledcTimers[LEDC_SPEED_MODE_MAX][LEDC_TIMER_MAX];
+    LedcChannel ledcChannels[LEDC_SPEED_MODE_MAX][LEDC_CHANNEL_MAX];
+
+    LedcTimer* ledcTimerFor(ledc_mode_t mode, ledc_timer_t timer) {
+        if (mode < 0 || mode >= LEDC_SPEED_MODE_MAX || timer < 0 || timer >= LEDC_TIMER_MAX) return nullptr;
+        return &ledcTimers[mode][timer];
+    }
+
+    LedcChannel* ledcChannelFor(ledc_mode_t mode, ledc_channel_t channel) {
+        if (mode < 0 || mode >= LEDC_SPEED_MODE_MAX || channel < 0 || channel >= LEDC_CHANNEL_MAX) return nullptr;
+        LedcChannel* state = &ledcChannels[mode][channel];
+        return state->configured ? state : nullptr;
+    }
+
+    uint32_t ledcDutyAt(const LedcChannel& channel, uint64_t now) {
+        if (now >= channel.fadeEnd) return channel.toDuty;
+        int64_t span = (int64_t)channel.toDuty - (int64_t)channel.fromDuty;
+        return (uint32_t)((int64_t)channel.fromDuty +
+                          span * (int64_t)(now - channel.fadeStart) / (int64_t)(channel.fadeEnd - channel.fadeStart));
+    }
+
+    // Zmiany wyjść w ledc.log: czas, pin, docelowe wypełnienie, rampa, okres timera
+    void ledcLog(const LedcChannel& channel, const LedcTimer& timer, uint32_t fadeMs) {
+        uint32_t maxDuty = 1UL << timer.bits;
+        double periodMs = (double)timer.divider * maxDuty / 256.0 / timer.clockHz * 1000.0;
+        char line[128];
+        snprintf(line, sizeof(line), "%.3f GPIO %d: wypełnienie %u/%u (%.1f%%), rampa %u ms, okres %.3f ms\n",
+                 sim::nowMicros() / 1e6, channel.pin, (unsigned)channel.toDuty, (unsigned)maxDuty,
+                 100.0 * channel.toDuty / maxDuty, (unsigned)fadeMs, periodMs);
+        std::ofstream log(sim::outputPath("ledc.log"), std::ios::app);
+        log << line;
+    }
+
+    esp_err_t ledcSetDuty(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty, uint32_t fadeMs) {
+        uint64_t waitUntil;
+        {
+            std::lock_guard<std::mutex> lock(ledcMutex);
+            LedcChannel* state = ledcChannelFor(mode, channel);
+            if (state == nullptr || !ledcFadeInstalled) return ESP_ERR_INVALID_STATE;
+            if (duty > (1UL << ledcTimers[mode][state->timer].bits)) return ESP_ERR_INVALID_ARG;
+            waitUntil = state->fadeEnd;
+        }
+        // Jak w sterowniku: nowa zmiana czeka na koniec trwającej rampy
+        uint64_t now = sim::nowMicros();
+        if (waitUntil > now) sim::sleepMicros(waitUntil - now);
+
+        std::lock_guard<std::mutex> lock(ledcMutex);
+        LedcChannel& state = ledcChannels[mode][channel];
+        now = sim::nowMicros();
+        state.fromDuty = ledcDutyAt(state, now);
+        state.toDuty = duty;
+        state.fadeStart = now;
+        state.fadeEnd = now + (uint64_t)fadeMs * 1000;
+        ledcLog(state, ledcTimers[mode][state.timer], fadeMs);
+        return ESP_OK;
+    }
+
+} // namespace
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t* timer_conf) {
+    if (timer_conf == nullptr || timer_conf->freq_hz == 0 || timer_conf->duty_resolution < 1 ||
+        (uint32_t)timer_conf->duty_resolution > LEDC_MAX_BITS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    LedcTimer* timer = ledcTimerFor(timer_conf->speed_mode, timer_conf->timer_num);
+    if (timer == nullptr) return ESP_ERR_INVALID_ARG;
+
+    uint32_t clockHz = timer_conf->clk_cfg == LEDC_USE_REF_TICK ? LEDC_REF_TICK_HZ : LEDC_APB_CLK_HZ;
+    uint64_t divider = ((uint64_t)clockHz << 8) / ((uint64_t)timer_conf->freq_hz << timer_conf->duty_resolution);
+    // Sterownik: "requested frequency and duty resolution can not be achieved"
+    if (divider < LEDC_MIN_DIVIDER || divider >= LEDC_MAX_DIVIDER) return ESP_FAIL;
+
+    timer->configured = true;
+    timer->bits = timer_conf->duty_resolution;
+    timer->divider = (uint32_t)divider;
+    timer->clockHz = clockHz;
+    return ESP_OK;
+}
+
+esp_err_t ledc_timer_set(ledc_mode_t speed_mode, ledc_timer_t timer_sel, uint32_t clock_divider,
+                         uint32_t duty_resolution, ledc_clk_src_t clk_src) {
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    LedcTimer* timer = ledcTimerFor(speed_mode, timer_sel);
+    if (timer == nullptr || clock_divider < LEDC_MIN_DIVIDER || clock_divider >= LEDC_MAX_DIVIDER ||
+        duty_resolution < 1 || duty_resolution > LEDC_MAX_BITS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    timer->configured = true;
+    timer->bits = duty_resolution;
+    timer->divider = clock_divider;
+    timer->clockHz = clk_src == LEDC_REF_TICK ? LEDC_REF_TICK_HZ : LEDC_APB_CLK_HZ;
+    return ESP_OK;
+}
+
+esp_err_t ledc_timer_rst(ledc_mode_t speed_mode, ledc_timer_t timer_sel) {
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    LedcTimer* timer = ledcTimerFor(speed_mode, timer_sel);
+    return timer != nullptr && timer->configured ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t* ledc_conf) {
+    if (ledc_conf == nullptr || ledc_conf->channel < 0 || ledc_conf->channel >= LEDC_CHANNEL_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    LedcTimer* timer = ledcTimerFor(ledc_conf->speed_mode, ledc_conf->timer_sel);
+    if (timer == nullptr || !timer->configured) return ESP_ERR_INVALID_ARG;
+
+    LedcChannel& channel = ledcChannels[ledc_conf->speed_mode][ledc_conf->channel];
+    channel = LedcChannel();
+    channel.configured = true;
+    channel.pin = ledc_conf->gpio_num;
+    channel.timer = ledc_conf->timer_sel;
+    channel.fromDuty = channel.toDuty = ledc_conf->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_bind_channel_timer(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_timer_t timer_sel) {
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    LedcChannel* state = ledcChannelFor(speed_mode, channel);
+    LedcTimer* timer = ledcTimerFor(speed_mode, timer_sel);
+    if (state == nullptr || timer == nullptr || !timer->configured) return ESP_ERR_INVALID_ARG;
+    state->timer = timer_sel;
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags) {
+    (void)intr_alloc_flags;
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    if (ledcFadeInstalled) return ESP_ERR_INVALID_STATE;
+    ledcFadeInstalled = true;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_fade_time_and_start(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty,
+                                       uint32_t max_fade_time_ms, ledc_fade_mode_t fade_mode) {
+    esp_err_t result = ledcSetDuty(speed_mode, channel, target_duty, max_fade_time_ms);
+    if (result == ESP_OK && fade_mode == LEDC_FADE_WAIT_DONE) sim::sleepMicros((uint64_t)max_fade_time_ms * 1000);
+    return result;
+}
+
+esp_err_t ledc_set_duty_and_update(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty, uint32_t hpoint) {
+    (void)hpoint;
+    return ledcSetDuty(speed_mode, channel, duty, 0);
+}
+
+esp_err_t ledc_stop(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t idle_level) {
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    LedcChannel* state = ledcChannelFor(speed_mode, channel);
+    if (state == nullptr) return ESP_ERR_INVALID_ARG;
+    // Bez czekania na rampę; wyjście w stanie spoczynku do następnej zmiany
+    LedcTimer& timer = ledcTimers[speed_mode][state->timer];
+    state->fromDuty = state->toDuty = idle_level ? (1UL << timer.bits) : 0;
+    state->fadeStart = state->fadeEnd = sim::nowMicros();
+    ledcLog(*state, timer, 0);
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel) {
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    LedcChannel* state = ledcChannelFor(speed_mode, channel);
+    return state != nullptr ? ledcDutyAt(*state, sim::nowMicros()) : 0;
+}
+
+// --- esp_timer ---
+
+struct sim_esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    std::mutex mutex;
+    uint32_t generation = 0;   // Zmiana zatrzymuje wątek uruchomionego timera
+};
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    if (args == nullptr || args->callback == nullptr || handle == nullptr) return ESP_ERR_INVALID_ARG;
+    sim_esp_timer* timer = new sim_esp_timer();
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+    *handle = timer;
+    return ESP_OK;
+}
+
+static esp_err_t startTimer(esp_timer_handle_t timer, uint64_t periodUs, bool periodic) {
+    if (timer == nullptr || periodUs == 0) return ESP_ERR_INVALID_ARG;
+
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(timer->mutex);
+        generation = ++timer->generation;
+    }
+
+    std::thread([timer, generation, periodUs, periodic]() {
+        uint64_t next = sim::nowMicros() + periodUs;
+        do {
+            uint64_t now = sim::nowMicros();
+            if (next > now) sim::sleepMicros(next - now);
+            next += periodUs;
+            {
+                std::lock_guard<std::mutex> lock(timer->mutex);
+                if (timer->generation != generation) return;
+            }
+            timer->callback(timer->arg);
+        } while (periodic);
+    }).detach();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+    return startTimer(timer, periodUs, true);
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+    return startTimer(timer, timeoutUs, false);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (timer == nullptr) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    timer->generation++;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    // Pamięć nie jest zwalniana - wątek zatrzymanego timera może jeszcze sprawdzać stan
+    return esp_timer_stop(timer);
+}
+
+int64_t esp_timer_get_time() {
+    return (int64_t)sim::nowMicros();
+}
+
+// --- Timer sprzętowy (esp32-hal-timer) ---
+
+struct sim_hw_timer {
+    std::mutex mutex;
+    uint16_t divider = 80;
+    void (*handler)() = nullptr;
+    uint64_t alarmTicks = 0;
+    bool autoreload = false;
+    uint64_t counterStart = 0;   // Czas wyzerowania licznika [us]
+    uint32_t generation = 0;
+};
+
+std::mutex& sim::interruptMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+hw_timer_t* timerBegin(uint8_t num, uint16_t divider, bool countUp) {
+    (void)num; (void)countUp;
+    hw_timer_t* timer = new hw_timer_t();
+    timer->divider = divider ? divider : 1;
+    timer->counterStart = sim::nowMicros();
+    return timer;
+}
+
+void timerEnd(hw_timer_t* timer) {
+    // Pamięć nie jest zwalniana - wątek alarmu może jeszcze sprawdzać stan
+    timerAlarmDisable(timer);
+}
+
+void timerAttachInterrupt(hw_timer_t* timer, void (*handler)(), bool edge) {
+    (void)edge;
+    if (timer == nullptr) return;
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    timer->handler = handler;
+}
+
+void timerDetachInterrupt(hw_timer_t* timer) {
+    if (timer == nullptr) return;
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    timer->handler = nullptr;
+}
+
+void timerAlarmWrite(hw_timer_t* timer, uint64_t alarmValue, bool autoreload) {
+    if (timer == nullptr) return;
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    timer->alarmTicks = alarmValue;
+    timer->autoreload = autoreload;
+}
+
+void timerAlarmEnable(hw_timer_t* timer) {
+    if (timer == nullptr) return;
+    uint32_t generation;
+    uint64_t periodUs;
+    {
+        std::lock_guard<std::mutex> lock(timer->mutex);
+        generation = ++timer->generation;
+        periodUs = std::max<uint64_t>(1, timer->alarmTicks * timer->divider / 80);
+        timer->counterStart = sim::nowMicros();
+    }
+
+    std::thread([timer, generation, periodUs]() {
+        uint64_t next = sim::nowMicros() + periodUs;
+        bool periodic;
+        do {
+            uint64_t now = sim::nowMicros();
+            if (next > now) sim::sleepMicros(next - now);
+            void (*handler)();
+            {
+                std::lock_guard<std::mutex> lock(timer->mutex);
+                if (timer->generation != generation) return;
+                // Alarm liczony od faktycznego wybudzenia - opóźnienie to tylko czas
+                // z wyłączonymi przerwaniami, bez opóźnień planisty hosta
+                if (timer->autoreload) timer->counterStart = sim::nowMicros();
+                handler = timer->handler;
+                periodic = timer->autoreload;
+            }
+            if (handler != nullptr) {
+                std::lock_guard<std::mutex> lock(sim::interruptMutex());
+                handler();
+            }
+            next = std::max(next + periodUs, sim::nowMicros());
+        } while (periodic);
+    }).detach();
+}
+
+void timerAlarmDisable(hw_timer_t* timer) {
+    if (timer == nullptr) return;
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    timer->generation++;
+}
+
+uint64_t timerRead(hw_timer_t* timer) {
+    if (timer == nullptr) return 0;
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    return (sim::nowMicros() - timer->counterStart) * 80 / timer->divider;
+}
@@ -0,0 +1,551 @@
+// Punkt wejścia symulatora: opcje, zegar, piny, scenariusz i podsumowanie przebiegu
+
+#include "SimRuntime.h"
+#include "Arduino.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <thread>
+
+namespace {
+
+    // Obiekty globalne firmware mogą używać zegara i katalogu już w konstruktorach,
+    // dlatego stan inicjalizowany dynamicznie jest w zmiennych statycznych funkcji
+    std::chrono::steady_clock::time_point startTime() {
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return start;
+    }
+
+    std::string& outDir() {
+        static std::string dir = ".sim";
+        return dir;
+    }
+
+    std::vector<void (*)()>& exitHooks() {
+        static std::vector<void (*)()> hooks;
+        return hooks;
+    }
+
+    double timeScale = 1.0;
+    int wakeupReason = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+    // Piny
+    const uint8_t PIN_COUNT = 40;
+    std::mutex pinMutex;
+    uint8_t pinModes[PIN_COUNT];
+    uint8_t pinLevels[PIN_COUNT];
+    bool pinDriven[PIN_COUNT];             // Poziom z zewnątrz (scenariusz) - ważniejszy niż podciągnięcie
+    uint16_t analogValues[PIN_COUNT];
+    struct InterruptHandler {
+        void (*handler)(void) = nullptr;
+        void (*handlerArg)(void*) = nullptr;
+        void* arg = nullptr;
+        int mode = 0;
+    };
+    InterruptHandler interrupts[PIN_COUNT];
+    uint32_t pulseGeneration[PIN_COUNT];   // Zmiana przerywa działający generator impulsów
+
+    // Zakończenie
+    std::mutex exitMutex;
+    std::condition_variable exitCv;
+    bool exitRequested = false;
+    int exitCode = 0;
+
+    sim::Counters simCounters;
+
+    // Polecenie scenariusza: "<czas_ms> <polecenie> [argumenty]"
+    struct ScriptStep {
+        uint64_t timeMs;
+        std::string command;
+        std::string args;
+    };
+
+    void makeDirectories(const std::string& path) {
+        std::string partial;
+        std::stringstream stream(path);
+        std::string part;
+        if (!path.empty() && path[0] == '/') partial = "/";
+        while (std::getline(stream, part, '/')) {
+            if (part.empty()) continue;
+            partial += part + "/";
+            mkdir(partial.c_str(), 0755);
+        }
+    }
+
+#ifndef PIO_UNIT_TESTING
+    // Punkt wejścia firmware (setup/loop) - w testach jednostkowych main() ma Unity
+
+    bool loadScript(const std::string& path, std::vector<ScriptStep>& steps) {
+        std::ifstream file(path);
+        if (!file) return false;
+
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+
+            std::istringstream stream(line);
+            ScriptStep step;
+            if (!(stream >> step.timeMs >> step.command)) continue;
+            std::getline(stream, step.args);
+            size_t first = step.args.find_first_not_of(' ');
+            step.args = first == std::string::npos ? "" : step.args.substr(first);
+            steps.push_back(step);
+        }
+        return true;
+    }
+
+    void executeStep(const ScriptStep& step) {
+        std::istringstream args(step.args);
+        if (step.command == "press" || step.command == "release") {
+            int pin;
+            if (args >> pin) sim::setInputLevel(pin, step.command == "press" ? LOW : HIGH);
+        } else if (step.command == "level") {
+            int pin, level;
+            if (args >> pin >> level) sim::setInputLevel(pin, level);
+        } else if (step.command == "pulses") {
+            int pin;
+            double periodMs;
+            long count = 0;
+            if (args >> pin >> periodMs) {
+                args >> count;
+                sim::startPulses(pin, periodMs, count);
+            }
+        } else if (step.command == "sqw") {
+            int pin;
+            if (args >> pin) sim::connectRtcSqw(pin);
+        } else if (step.command == "adc") {
+            int pin, value;
+            if (args >> pin >> value) sim::setAnalogValue(pin, value);
+        } else if (step.command == "temp") {
+            int pin;
+            float celsius;
+            if (args >> pin >> celsius) sim::setOneWireTemperature(pin, celsius);
+        } else if (step.command == "ble-adv") {
+            std::string address, data;
+            int rssi = -70;
+            if (args >> address >> data) {
+                args >> rssi;
+                sim::bleAdvertise(address, data, rssi);
+            }
+        } else if (step.command == "http") {
+            std::string method, uri, body;
+            args >> method >> uri;
+            std::getline(args, body);
+            size_t first = body.find_first_not_of(' ');
+            sim::httpRequest(method, uri, first == std::string::npos ? "" : body.substr(first));
+        } else if (step.command == "http-header") {
+            std::string name, value;
+            args >> name;
+            std::getline(args, value);
+            size_t first = value.find_first_not_of(' ');
+            sim::httpHeader(name, first == std::string::npos ? "" : value.substr(first));
+        } else if (step.command == "ws-connect") {
+            sim::webSocketConnect();
+        } else if (step.command == "ws-send") {
+            sim::webSocketSend(step.args);
+        } else if (step.command == "quit") {
+            sim::requestExit(0);
+        } else {
+            fprintf(stderr, "[sim] Nieznane polecenie scenariusza: %s\n", step.command.c_str());
+        }
+    }
+
+    void runScript(std::vector<ScriptStep> steps) {
+        for (const ScriptStep& step : steps) {
+            uint64_t now = sim::nowMicros() / 1000;
+            if (step.timeMs > now) {
+                sim::sleepMicros((step.timeMs - now) * 1000);
+            }
+            executeStep(step);
+        }
+    }
+
+    // Zadanie loopTask jak w rdzeniu Arduino-ESP32
+    void loopTask(void*) {
+        setup();
+        for (;;) {
+            loop();
+            yield();
+        }
+    }
+
+    void printSummary() {
+        sim::Counters& c = simCounters;
+        fprintf(stderr,
+                "[sim] Czas symulacji: %.3f s (x%.1f)\n"
+                "[sim] Wyświetlacz: pełne klatki %u, aktualizacje obszarów %u, %llu B, I2C %.1f ms\n"
+                "[sim] BLE: zapisy %u, powiadomienia %u, skanowania %u, rozgłoszenia odebrane %u/%u\n"
+                "[sim] LittleFS: zapisy %u (%llu B), NVS: zapisy %u\n"
+                "[sim] Flash: zapisy %u (%llu B), kasowania sektorów %u\n"
+                "[sim] RTC: odczyty DS3231 %u, zapisy %u, zbocza SQW %u\n"
+                "[sim] HTTP: żądania %u, WebSocket: wiadomości %u\n",
+                sim::nowMicros() / 1e6, timeScale,
+                c.displayFullFrames.load(), c.displayPartialUpdates.load(),
+                (unsigned long long)c.displayBytes.load(), c.i2cMicros.load() / 1000.0,
+                c.bleWrites.load(), c.bleNotifications.load(),
+                c.bleScans.load(), c.bleAdvertisementsHeard.load(), c.bleAdvertisements.load(),
+                c.fsWrites.load(), (unsigned long long)c.fsBytesWritten.load(), c.nvsCommits.load(),
+                c.flashWrites.load(), (unsigned long long)c.flashBytesWritten.load(), c.flashSectorErases.load(),
+                c.rtcReads.load(), c.rtcWrites.load(), c.rtcSqwEdges.load(),
+                c.httpRequests.load(), c.wsMessages.load());
+        sim::printHttpStats();
+    }
+
+    void printUsage(const char* program) {
+        fprintf(stderr,
+                "Użycie: %s [opcje]\n"
+                "  --speed N       przyspieszenie czasu (domyślnie 1)\n"
+                "  --duration MS   zakończ po MS ms czasu symulacji (domyślnie bez limitu)\n"
+                "  --script PLIK   scenariusz: linie \"<czas_ms> <polecenie> [argumenty]\"\n"
+                "                  press|release <pin>, level <pin> <0|1>, adc <pin> <wartość>,\n"
+                "                  pulses <pin> <okres_ms> [liczba] (0 - stop), sqw <pin> (wyjście SQW DS3231),\n"
+                "                  ble-adv <adres> <dane producenta hex> [rssi],\n"
+                "                  http <metoda> <uri> [treść], http-header <nazwa> <wartość|@etag> (dla następnego http),\n"
+                "                  ws-connect, ws-send <tekst>, quit\n"
+                "  --out KATALOG   katalog na LittleFS, NVS i obraz wyświetlacza (domyślnie .sim)\n"
+                "  --wakeup TRYB   przyczyna wybudzenia: none|ext0|timer (pamięć RTC z uśpienia\n"
+                "                  w tym samym --out)\n"
+                "  --seed N        ziarno generatora liczb losowych\n",
+                program);
+    }
+#endif // PIO_UNIT_TESTING
+
+} // namespace
+
+// --- Zegar ---
+
+uint64_t sim::nowMicros() {
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - startTime();
+    return (uint64_t)(elapsed.count() * timeScale / 1000.0);
+}
+
+std::chrono::nanoseconds sim::realDuration(uint64_t simMicros) {
+    return std::chrono::nanoseconds((int64_t)(simMicros * 1000.0 / timeScale));
+}
+
+void sim::sleepMicros(uint64_t simMicros) {
+    std::this_thread::sleep_for(realDuration(simMicros));
+}
+
+double sim::speed() {
+    return timeScale;
+}
+
+void sim::setSpeed(double factor) {
+    if (factor > 0) timeScale = factor;
+}
+
+// --- Katalog wyjściowy ---
+
+const std::string& sim::outputDir() {
+    return outDir();
+}
+
+std::string sim::outputPath(const std::string& name) {
+    std::string path = outDir() + "/" + name;
+    size_t slash = path.find_last_of('/');
+    makeDirectories(path.substr(0, slash));
+    return path;
+}
+
+void sim::setOutputDir(const std::string& path) {
+    outDir() = path;
+    makeDirectories(path);
+}
+
+// --- Piny ---
+
+void sim::setInputLevel(uint8_t pin, int level) {
+    if (pin >= PIN_COUNT) return;
+
+    InterruptHandler handler;
+    bool fire = false;
+    bool rising = false;
+    bool falling = false;
+    {
+        std::lock_guard<std::mutex> lock(pinMutex);
+        uint8_t previous = pinLevels[pin];
+        pinLevels[pin] = level ? HIGH : LOW;
+        pinDriven[pin] = true;
+
+        handler = interrupts[pin];
+        rising = previous == LOW && level;
+        falling = previous == HIGH && !level;
+        fire = (handler.mode == RISING && rising) || (handler.mode == FALLING && falling) ||
+               (handler.mode == CHANGE && (rising || falling));
+    }
+
+    if (rising || falling) sim::countPulseEdge(pin, rising);
+
+    // Przerwanie wykonywane w wątku zmieniającym stan pinu (jak ISR)
+    if (fire) {
+        if (handler.handler) handler.handler();
+        if (handler.handlerArg) handler.handlerArg(handler.arg);
+    }
+}
+
+void sim::startPulses(uint8_t pin, double periodMs, long count) {
+    if (pin >= PIN_COUNT) return;
+
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(pinMutex);
+        generation = ++pulseGeneration[pin];
+    }
+    if (periodMs <= 0.0) return;
+
+    // Impulsy w osobnym wątku: stan niski przez 5 ms (najwyżej pół okresu), potem wysoki
+    uint64_t periodUs = (uint64_t)(periodMs * 1000.0);
+    uint64_t widthUs = periodUs / 2 < 5000 ? periodUs / 2 : 5000;
+    std::thread([pin, generation, periodUs, widthUs, count]() {
+        for (long i = 0; count <= 0 || i < count; i++) {
+            {
+                std::lock_guard<std::mutex> lock(pinMutex);
+                if (pulseGeneration[pin] != generation) return;
+            }
+            sim::setInputLevel(pin, LOW);
+            sim::sleepMicros(widthUs);
+            sim::setInputLevel(pin, HIGH);
+            sim::sleepMicros(periodUs - widthUs);
+        }
+    }).detach();
+}
+
+void sim::setAnalogValue(uint8_t pin, uint16_t value) {
+    if (pin >= PIN_COUNT) return;
+    std::lock_guard<std::mutex> lock(pinMutex);
+    analogValues[pin] = value;
+}
+
+int sim::getPinLevel(uint8_t pin) {
+    if (pin >= PIN_COUNT) return LOW;
+    std::lock_guard<std::mutex> lock(pinMutex);
+    return pinLevels[pin];
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= PIN_COUNT) return;
+    std::lock_guard<std::mutex> lock(pinMutex);
+    pinModes[pin] = mode;
+    if (pinDriven[pin]) return;     // Np. przycisk wciśnięty przed setup()
+    if (mode == INPUT_PULLUP) pinLevels[pin] = HIGH;
+    if (mode == INPUT_PULLDOWN) pinLevels[pin] = LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin >= PIN_COUNT) return;
+    std::lock_guard<std::mutex> lock(pinMutex);
+    pinLevels[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return sim::getPinLevel(pin);
+}
+
+uint16_t analogRead(uint8_t pin) {
+    if (pin >= PIN_COUNT) return 0;
+    std::lock_guard<std::mutex> lock(pinMutex);
+    return analogValues[pin];
+}
+
+int8_t digitalPinToAnalogChannel(uint8_t pin) {
+    static const int8_t ADC1_PINS[] = {36, 37, 38, 39, 32, 33, 34, 35};
+    static const int8_t ADC2_PINS[] = {4, 0, 2, 15, 13, 12, 14, 27, 25, 26};
+    for (int8_t i = 0; i < 8; i++) {
+        if (ADC1_PINS[i] == pin) return i;
+    }
+    for (int8_t i = 0; i < 10; i++) {
+        if (ADC2_PINS[i] == pin) return 10 + i;
+    }
+    return -1;
+}
+
+void analogWrite(uint8_t pin, int value) {
+    digitalWrite(pin, value > 0 ? HIGH : LOW);
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+    if (pin >= PIN_COUNT) return;
+    std::lock_guard<std::mutex> lock(pinMutex);
+    interrupts[pin] = InterruptHandler();
+    interrupts[pin].handler = handler;
+    interrupts[pin].mode = mode;
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+    if (pin >= PIN_COUNT) return;
+    std::lock_guard<std::mutex> lock(pinMutex);
+    interrupts[pin] = InterruptHandler();
+    interrupts[pin].handlerArg = handler;
+    interrupts[pin].arg = arg;
+    interrupts[pin].mode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin >= PIN_COUNT) return;
+    std::lock_guard<std::mutex> lock(pinMutex);
+    interrupts[pin] = InterruptHandler();
+}
+
+// --- Liczniki i zakończenie ---
+
+sim::Counters& sim::counters() {
+    return simCounters;
+}
+
+void sim::requestExit(int code) {
+    {
+        std::lock_guard<std::mutex> lock(exitMutex);
+        if (exitRequested) return;
+        exitRequested = true;
+        exitCode = code;
+    }
+    exitCv.notify_all();
+}
+
+void sim::onExit(void (*hook)()) {
+    std::lock_guard<std::mutex> lock(exitMutex);
+    exitHooks().push_back(hook);
+}
+
+int sim::wakeupCause() {
+    return wakeupReason;
+}
+
+// --- Pamięć RTC ---
+
+// Granice sekcji sim_rtc (RTC_DATA_ATTR) wyznacza linker; bez takich zmiennych
+// lub poza ELF symbole są puste
+extern "C" {
+    extern char __start_sim_rtc[] __attribute__((weak));
+    extern char __stop_sim_rtc[] __attribute__((weak));
+}
+
+namespace {
+
+    size_t rtcMemorySize() {
+        return __start_sim_rtc != nullptr ? (size_t)(__stop_sim_rtc - __start_sim_rtc) : 0;
+    }
+
+    const char* const RTC_MEMORY_FILE = "rtc_memory.bin";
+
+}
+
+bool sim::saveRtcMemory() {
+    if (rtcMemorySize() == 0) return false;
+    std::ofstream file(sim::outputPath(RTC_MEMORY_FILE), std::ios::binary | std::ios::trunc);
+    file.write(__start_sim_rtc, rtcMemorySize());
+    return (bool)file;
+}
+
+bool sim::loadRtcMemory() {
+    if (rtcMemorySize() == 0) return false;
+    std::ifstream file(sim::outputPath(RTC_MEMORY_FILE), std::ios::binary);
+    if (!file) return false;
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() != rtcMemorySize()) return false;
+    memcpy(__start_sim_rtc, data.data(), data.size());
+    return true;
+}
+
+void sim::clearRtcMemory() {
+    if (rtcMemorySize() > 0) memset(__start_sim_rtc, 0, rtcMemorySize());
+}
+
+// --- main ---
+
+#ifndef PIO_UNIT_TESTING
+int main(int argc, char** argv) {
+    uint64_t durationMs = 0;
+    std::vector<ScriptStep> script;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (option == "--help" || option == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (value == nullptr) {
+            printUsage(argv[0]);
+            return 2;
+        }
+        i++;
+
+        if (option == "--speed") {
+            sim::setSpeed(atof(value));
+        } else if (option == "--duration") {
+            durationMs = strtoull(value, nullptr, 10);
+        } else if (option == "--script") {
+            if (!loadScript(value, script)) {
+                fprintf(stderr, "[sim] Nie można wczytać scenariusza %s\n", value);
+                return 2;
+            }
+        } else if (option == "--out") {
+            outDir() = value;
+        } else if (option == "--wakeup") {
+            std::string cause = value;
+            wakeupReason = cause == "ext0" ? ESP_SLEEP_WAKEUP_EXT0 :
+                           cause == "timer" ? ESP_SLEEP_WAKEUP_TIMER : ESP_SLEEP_WAKEUP_UNDEFINED;
+        } else if (option == "--seed") {
+            randomSeed(strtoul(value, nullptr, 10));
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    sim::setOutputDir(outDir());
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    fprintf(stderr, "[sim] Start: x%.1f, katalog %s\n", timeScale, outDir().c_str());
+
+    // Pamięć RTC z zapisu przed uśpieniem; po włączeniu zasilania zapis nieważny
+    if (wakeupReason == ESP_SLEEP_WAKEUP_UNDEFINED) {
+        unlink(sim::outputPath(RTC_MEMORY_FILE).c_str());
+    } else if (!sim::loadRtcMemory()) {
+        fprintf(stderr, "[sim] Brak zapisu pamięci RTC z uśpienia (%s/%s)\n", outDir().c_str(), RTC_MEMORY_FILE);
+    }
+
+    // Kroki z czasem 0 przed setup() - stan wejść przy starcie (np. SET
+    // przytrzymany przy wybudzeniu)
+    size_t firstTimed = 0;
+    while (firstTimed < script.size() && script[firstTimed].timeMs == 0) {
+        executeStep(script[firstTimed++]);
+    }
+
+    xTaskCreatePinnedToCore(loopTask, "loopTask", 8192, nullptr, 1, nullptr, 1);
+
+    if (firstTimed < script.size()) {
+        std::thread(runScript, std::vector<ScriptStep>(script.begin() + firstTimed, script.end())).detach();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(exitMutex);
+        if (durationMs > 0) {
+            sim::waitFor(exitCv, lock, durationMs * 1000, [] { return exitRequested; });
+        } else {
+            exitCv.wait(lock, [] { return exitRequested; });
+        }
+    }
+
+    std::vector<void (*)()> hooks;
+    {
+        std::lock_guard<std::mutex> lock(exitMutex);
+        hooks = exitHooks();
+    }
+    for (void (*hook)() : hooks) hook();
+    printSummary();
+
+    // Zadania nadal działają - kończymy proces bez destruktorów obiektów globalnych
+    fflush(stdout);
+    fflush(stderr);
+    _exit(exitCode);
+}
+#endif // PIO_UNIT_TESTING
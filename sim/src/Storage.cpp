@@ -0,0 +1,477 @@
+// Pamięć trwała symulatora: LittleFS (katalog hosta) i Preferences (pliki NVS)
+
+#include "FS.h"
+#include "LittleFS.h"
+#include "Preferences.h"
+#include "SimRuntime.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace fs {
+
+    struct FileImpl {
+        std::string path;        // Ścieżka w systemie plików urządzenia
+        std::string name;        // Ostatni człon ścieżki
+        std::string hostPath;
+        FILE* handle = nullptr;
+        bool directory = false;
+        bool writable = false;
+        std::vector<std::string> entries;   // Zawartość katalogu
+        size_t nextEntry = 0;
+        FS* owner = nullptr;
+
+        ~FileImpl() {
+            if (handle) fclose(handle);
+        }
+    };
+
+} // namespace fs
+
+fs::LittleFSFS LittleFS;
+
+// --- Pomocnicze ---
+
+static bool isDirectoryPath(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+static bool pathExists(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+}
+
+static void removeTree(const std::string& path) {
+    DIR* dir = opendir(path.c_str());
+    if (dir) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..") continue;
+            removeTree(path + "/" + name);
+        }
+        closedir(dir);
+        rmdir(path.c_str());
+    } else {
+        unlink(path.c_str());
+    }
+}
+
+static void copyTree(const std::string& from, const std::string& to) {
+    DIR* dir = opendir(from.c_str());
+    if (dir == nullptr) return;
+    ::mkdir(to.c_str(), 0755);
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") continue;
+        std::string source = from + "/" + name;
+        std::string target = to + "/" + name;
+        if (isDirectoryPath(source)) {
+            copyTree(source, target);
+        } else {
+            std::ifstream in(source, std::ios::binary);
+            std::ofstream out(target, std::ios::binary);
+            out << in.rdbuf();
+        }
+    }
+    closedir(dir);
+}
+
+static size_t treeSize(const std::string& path) {
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        struct stat info;
+        return stat(path.c_str(), &info) == 0 ? info.st_size : 0;
+    }
+    size_t total = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") continue;
+        total += treeSize(path + "/" + name);
+    }
+    closedir(dir);
+    return total;
+}
+
+// --- fs::File ---
+
+size_t fs::File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+static std::atomic<size_t> nextWriteLimit{SIZE_MAX};
+
+void sim::limitNextFsWrite(size_t maxBytes) {
+    nextWriteLimit = maxBytes;
+}
+
+size_t fs::File::write(const uint8_t* buffer, size_t size) {
+    if (!impl || !impl->handle || !impl->writable) return 0;
+    size_t limit = nextWriteLimit.exchange(SIZE_MAX);
+    if (size > limit) size = limit;
+    size_t written = fwrite(buffer, 1, size, impl->handle);
+    sim::counters().fsWrites++;
+    sim::counters().fsBytesWritten += written;
+    return written;
+}
+
+void fs::File::flush() {
+    if (impl && impl->handle) fflush(impl->handle);
+}
+
+int fs::File::available() {
+    if (!impl || !impl->handle) return 0;
+    return (int)(size() - position());
+}
+
+int fs::File::read() {
+    if (!impl || !impl->handle) return -1;
+    int c = fgetc(impl->handle);
+    return c == EOF ? -1 : c;
+}
+
+int fs::File::peek() {
+    if (!impl || !impl->handle) return -1;
+    int c = fgetc(impl->handle);
+    if (c == EOF) return -1;
+    ungetc(c, impl->handle);
+    return c;
+}
+
+size_t fs::File::read(uint8_t* buffer, size_t size) {
+    if (!impl || !impl->handle) return 0;
+    return fread(buffer, 1, size, impl->handle);
+}
+
+bool fs::File::seek(uint32_t position, SeekMode mode) {
+    if (!impl || !impl->handle) return false;
+    int whence = mode == SeekCur ? SEEK_CUR : mode == SeekEnd ? SEEK_END : SEEK_SET;
+    return fseek(impl->handle, position, whence) == 0;
+}
+
+size_t fs::File::position() const {
+    if (!impl || !impl->handle) return 0;
+    long pos = ftell(impl->handle);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t fs::File::size() const {
+    if (!impl) return 0;
+    if (impl->handle) fflush(impl->handle);
+    struct stat info;
+    return stat(impl->hostPath.c_str(), &info) == 0 ? info.st_size : 0;
+}
+
+void fs::File::close() {
+    impl.reset();
+}
+
+fs::File::operator bool() const {
+    return impl && (impl->handle || impl->directory);
+}
+
+time_t fs::File::getLastWrite() {
+    if (!impl) return 0;
+    struct stat info;
+    return stat(impl->hostPath.c_str(), &info) == 0 ? info.st_mtime : 0;
+}
+
+const char* fs::File::path() const {
+    return impl ? impl->path.c_str() : nullptr;
+}
+
+const char* fs::File::name() const {
+    return impl ? impl->name.c_str() : nullptr;
+}
+
+bool fs::File::isDirectory() {
+    return impl && impl->directory;
+}
+
+fs::File fs::File::openNextFile(const char* mode) {
+    if (!impl || !impl->directory || impl->nextEntry >= impl->entries.size()) return File();
+
+    std::string child = impl->path;
+    if (child.empty() || child.back() != '/') child += "/";
+    child += impl->entries[impl->nextEntry++];
+    return impl->owner->open(child.c_str(), mode);
+}
+
+void fs::File::rewindDirectory() {
+    if (impl) impl->nextEntry = 0;
+}
+
+// --- fs::FS ---
+
+std::string fs::FS::hostPath(const char* path) const {
+    std::string relative = path ? path : "/";
+    if (relative.empty() || relative[0] != '/') relative = "/" + relative;
+    return root + relative;
+}
+
+fs::File fs::FS::open(const char* path, const char* mode, bool create) {
+    if (!mounted || path == nullptr) return File();
+
+    std::shared_ptr<FileImpl> impl = std::make_shared<FileImpl>();
+    impl->path = path[0] == '/' ? path : std::string("/") + path;
+    impl->hostPath = hostPath(path);
+    impl->owner = this;
+    size_t slash = impl->path.find_last_of('/');
+    impl->name = impl->path.substr(slash + 1);
+
+    if (isDirectoryPath(impl->hostPath)) {
+        impl->directory = true;
+        DIR* dir = opendir(impl->hostPath.c_str());
+        struct dirent* entry;
+        while (dir && (entry = readdir(dir)) != nullptr) {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..") impl->entries.push_back(name);
+        }
+        if (dir) closedir(dir);
+        std::sort(impl->entries.begin(), impl->entries.end());
+        return File(impl);
+    }
+
+    std::string fileMode = mode ? mode : "r";
+    impl->writable = fileMode[0] == 'w' || fileMode[0] == 'a' || fileMode.find('+') != std::string::npos;
+
+    if (impl->writable || create) {
+        // Katalogi nadrzędne jak w LittleFS (tworzone automatycznie)
+        std::string parent = impl->hostPath.substr(0, impl->hostPath.find_last_of('/'));
+        std::string partial;
+        std::stringstream stream(parent);
+        std::string part;
+        if (!parent.empty() && parent[0] == '/') partial = "/";
+        while (std::getline(stream, part, '/')) {
+            if (part.empty()) continue;
+            partial += part + "/";
+            ::mkdir(partial.c_str(), 0755);
+        }
+    }
+
+    impl->handle = fopen(impl->hostPath.c_str(), (fileMode + "b").c_str());
+    if (impl->handle == nullptr) return File();
+    return File(impl);
+}
+
+bool fs::FS::exists(const char* path) {
+    return mounted && pathExists(hostPath(path));
+}
+
+bool fs::FS::remove(const char* path) {
+    return mounted && unlink(hostPath(path).c_str()) == 0;
+}
+
+bool fs::FS::rename(const char* from, const char* to) {
+    return mounted && ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool fs::FS::mkdir(const char* path) {
+    return mounted && (::mkdir(hostPath(path).c_str(), 0755) == 0 || isDirectoryPath(hostPath(path)));
+}
+
+bool fs::FS::rmdir(const char* path) {
+    return mounted && ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+// --- fs::LittleFSFS ---
+
+bool fs::LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles,
+                           const char* partitionLabel) {
+    (void)basePath; (void)maxOpenFiles; (void)partitionLabel;
+    if (mounted) return true;
+
+    root = sim::outputDir() + "/littlefs";
+    if (!isDirectoryPath(root)) {
+        // Niesformatowana partycja
+        if (!formatOnFail) return false;
+        if (!format()) return false;
+    }
+    mounted = true;
+    return true;
+}
+
+void fs::LittleFSFS::end() {
+    mounted = false;
+}
+
+bool fs::LittleFSFS::format() {
+    root = sim::outputDir() + "/littlefs";
+    removeTree(root);
+    if (::mkdir(root.c_str(), 0755) != 0) return false;
+
+    // Obraz systemu plików z data/ (katalog projektu)
+    copyTree("data", root);
+    return true;
+}
+
+size_t fs::LittleFSFS::usedBytes() {
+    return mounted ? treeSize(root) : 0;
+}
+
+// --- Preferences ---
+
+namespace {
+
+    typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+
+    std::mutex nvsMutex;
+
+    std::map<std::string, Namespace>& nvsStore() {
+        static std::map<std::string, Namespace> store;
+        return store;
+    }
+
+    std::string nvsFile(const std::string& name) {
+        return sim::outputPath("nvs/" + name + ".nvs");
+    }
+
+    // Plik tekstowy: "<klucz> <bajty w hex>" w każdej linii
+    Namespace& loadNamespace(const std::string& name) {
+        std::map<std::string, Namespace>& store = nvsStore();
+        std::map<std::string, Namespace>::iterator found = store.find(name);
+        if (found != store.end()) return found->second;
+
+        Namespace& entries = store[name];
+        std::ifstream file(nvsFile(name));
+        std::string key, hex;
+        while (file >> key >> hex) {
+            std::vector<uint8_t> value;
+            for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+                value.push_back((uint8_t)strtoul(hex.substr(i, 2).c_str(), nullptr, 16));
+            }
+            entries[key] = value;
+        }
+        return entries;
+    }
+
+    void commitNamespace(const std::string& name, const Namespace& entries) {
+        std::string path = nvsFile(name);
+        std::string temporary = path + ".tmp";
+        std::ofstream file(temporary);
+        for (Namespace::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+            file << it->first << ' ';
+            if (it->second.empty()) file << "-";
+            for (uint8_t byte : it->second) {
+                char text[3];
+                snprintf(text, sizeof(text), "%02x", byte);
+                file << text;
+            }
+            file << '\n';
+        }
+        file.close();
+        ::rename(temporary.c_str(), path.c_str());
+        sim::counters().nvsCommits++;
+    }
+
+} // namespace
+
+bool Preferences::begin(const char* nvsName, bool readOnlyMode, const char* partitionLabel) {
+    (void)partitionLabel;
+    if (nvsName == nullptr || strlen(nvsName) > 15) return false;
+    // Plik przestrzeni nazw wczytywany leniwie - begin() bywa wołane z konstruktorów globalnych
+    name = nvsName;
+    readOnly = readOnlyMode;
+    started = true;
+    return true;
+}
+
+void Preferences::end() {
+    started = false;
+}
+
+bool Preferences::clear() {
+    if (!started || readOnly) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace& entries = loadNamespace(name);
+    entries.clear();
+    commitNamespace(name, entries);
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!started || readOnly || key == nullptr) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace& entries = loadNamespace(name);
+    if (entries.erase(key) == 0) return false;
+    commitNamespace(name, entries);
+    return true;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!started || key == nullptr) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace& entries = loadNamespace(name);
+    return entries.count(key) > 0;
+}
+
+size_t Preferences::putRaw(const char* key, const void* value, size_t length) {
+    if (!started || readOnly || key == nullptr || strlen(key) > 15) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace& entries = loadNamespace(name);
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    entries[key] = std::vector<uint8_t>(bytes, bytes + length);
+    commitNamespace(name, entries);
+    return length;
+}
+
+size_t Preferences::getRaw(const char* key, void* value, size_t length) {
+    if (!started || key == nullptr) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace& entries = loadNamespace(name);
+    Namespace::iterator found = entries.find(key);
+    if (found == entries.end() || found->second.size() != length) return 0;
+    memcpy(value, found->second.data(), length);
+    return length;
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    if (value == nullptr) return 0;
+    return putRaw(key, value, strlen(value) + 1) ? strlen(value) : 0;
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLength) {
+    size_t length = getBytesLength(key);
+    if (length == 0 || length > maxLength) return 0;
+    return getBytes(key, value, maxLength);
+}
+
+String Preferences::getString(const char* key, String defaultValue) {
+    size_t length = getBytesLength(key);
+    if (length == 0) return defaultValue;
+    std::vector<char> buffer(length);
+    getBytes(key, buffer.data(), length);
+    buffer.back() = '\0';
+    return String(buffer.data());
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!started || key == nullptr) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace& entries = loadNamespace(name);
+    Namespace::iterator found = entries.find(key);
+    return found == entries.end() ? 0 : found->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+    if (!started || key == nullptr) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace& entries = loadNamespace(name);
+    Namespace::iterator found = entries.find(key);
+    if (found == entries.end() || found->second.size() > maxLength) return 0;
+    memcpy(buffer, found->second.data(), found->second.size());
+    return found->second.size();
+}
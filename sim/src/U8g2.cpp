@@ -0,0 +1,359 @@
+// Wyświetlacz OLED dla symulatora (bufor, czcionka 5x7, zapis PNG)
+
+#include "U8g2lib.h"
+#include "SimRuntime.h"
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+const struct u8g2_cb_struct u8g2_cb_r0 = {0};
+const struct u8g2_cb_struct u8g2_cb_r2 = {2};
+
+// {skala, odstęp znaków, wysokość linii}
+const uint8_t u8g2_font_profont11_mf[] = {1, 6, 11};
+const uint8_t u8g2_font_profont11_tf[] = {1, 6, 11};
+const uint8_t u8g2_font_pxplusibmvga9_mf[] = {1, 8, 12};
+const uint8_t u8g2_font_pxplusibmvga9_tf[] = {1, 8, 12};
+const uint8_t u8g2_font_fub20_tr[] = {2, 12, 20};
+const uint8_t u8g2_font_fub14_tr[] = {2, 11, 14};
+const uint8_t u8g2_font_6x10_tf[] = {1, 6, 10};
+const uint8_t u8g2_font_ncenB08_tr[] = {1, 6, 8};
+
+// Klasyczna czcionka 5x7 (ASCII 0x20-0x7E), kolumny od lewej, bit 0 = górny wiersz
+static const uint8_t FONT_5X7[][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x56, 0x20, 0x50}, {0x00, 0x08, 0x07, 0x03, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+    {0x00, 0x80, 0x70, 0x30, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x00, 0x60, 0x60, 0x00},
+    {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x72, 0x49, 0x49, 0x49, 0x46}, {0x21, 0x41, 0x49, 0x4D, 0x33}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+    {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x31}, {0x41, 0x21, 0x11, 0x09, 0x07},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x46, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x00, 0x14, 0x00, 0x00},
+    {0x00, 0x40, 0x34, 0x00, 0x00}, {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x59, 0x09, 0x06}, {0x3E, 0x41, 0x5D, 0x59, 0x4E},
+    {0x7C, 0x12, 0x11, 0x12, 0x7C}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+    {0x7F, 0x41, 0x41, 0x41, 0x3E}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01},
+    {0x3E, 0x41, 0x41, 0x51, 0x73}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+    {0x7F, 0x02, 0x1C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+    {0x26, 0x49, 0x49, 0x49, 0x32}, {0x03, 0x01, 0x7F, 0x01, 0x03}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+    {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x59, 0x49, 0x4D, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x41},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x41, 0x7F}, {0x04, 0x02, 0x01, 0x02, 0x04},
+    {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x03, 0x07, 0x08, 0x00}, {0x20, 0x54, 0x54, 0x78, 0x40},
+    {0x7F, 0x28, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x28}, {0x38, 0x44, 0x44, 0x28, 0x7F},
+    {0x38, 0x54, 0x54, 0x54, 0x18}, {0x00, 0x08, 0x7E, 0x09, 0x02}, {0x18, 0xA4, 0xA4, 0x9C, 0x78},
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x40, 0x3D, 0x00},
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x78, 0x04, 0x78},
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0xFC, 0x18, 0x24, 0x24, 0x18},
+    {0x18, 0x24, 0x24, 0x18, 0xFC}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x24},
+    {0x04, 0x04, 0x3F, 0x44, 0x24}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x4C, 0x90, 0x90, 0x90, 0x7C},
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x77, 0x00, 0x00},
+    {0x00, 0x41, 0x36, 0x08, 0x00}, {0x02, 0x01, 0x02, 0x04, 0x02},
+};
+
+// Magistrala I2C 400 kHz: 9 bitów na bajt
+static const double I2C_MICROS_PER_BYTE = 9.0 * 1e6 / 400000.0;
+static const size_t I2C_AREA_OVERHEAD = 6;   // Polecenia adresowania strony i kolumn
+
+static const int PNG_SCALE = 4;
+static const std::chrono::milliseconds PNG_MIN_INTERVAL(100);   // Czas rzeczywisty
+
+static std::mutex panelMutex;
+static const uint8_t* activePanel = nullptr;   // Panel zapisywany przy zakończeniu symulacji
+
+// --- PNG (1 bit, kompresja "stored" - bez zależności od zlib) ---
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t length) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        tableReady = true;
+    }
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+static void writeChunk(FILE* file, const char* type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> chunk;
+    putU32(chunk, data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    uint32_t crc = crc32Update(0xFFFFFFFFUL, chunk.data() + 4, chunk.size() - 4) ^ 0xFFFFFFFFUL;
+    putU32(chunk, crc);
+    fwrite(chunk.data(), 1, chunk.size(), file);
+}
+
+static void writePng(const std::string& path, const uint8_t* panel) {
+    const uint32_t width = U8G2::WIDTH * PNG_SCALE;
+    const uint32_t height = U8G2::HEIGHT * PNG_SCALE;
+    const size_t rowBytes = 1 + width / 8;
+
+    // Wiersze obrazu: bajt filtra (0) + piksele, 1 = świecący
+    std::vector<uint8_t> raw(rowBytes * height, 0);
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t* row = &raw[y * rowBytes + 1];
+        uint32_t sy = y / PNG_SCALE;
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t sx = x / PNG_SCALE;
+            if (panel[(sy / 8) * U8G2::WIDTH + sx] & (1 << (sy % 8))) {
+                row[x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+    }
+
+    // Strumień zlib z blokami "stored" (maks. 65535 B każdy)
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    size_t offset = 0;
+    while (offset < raw.size()) {
+        size_t blockLength = std::min<size_t>(65535, raw.size() - offset);
+        bool last = offset + blockLength == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(blockLength & 0xFF);
+        zlib.push_back(blockLength >> 8);
+        zlib.push_back(~blockLength & 0xFF);
+        zlib.push_back((~blockLength >> 8) & 0xFF);
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockLength);
+        offset += blockLength;
+    }
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    putU32(zlib, (b << 16) | a);
+
+    std::vector<uint8_t> header;
+    putU32(header, width);
+    putU32(header, height);
+    header.push_back(1);   // Głębia bitowa
+    header.push_back(0);   // Skala szarości
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+
+    std::string temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (file == nullptr) return;
+    static const uint8_t SIGNATURE[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(SIGNATURE, 1, sizeof(SIGNATURE), file);
+    writeChunk(file, "IHDR", header);
+    writeChunk(file, "IDAT", zlib);
+    writeChunk(file, "IEND", std::vector<uint8_t>());
+    fclose(file);
+    rename(temporary.c_str(), path.c_str());   // Podgląd nigdy nie widzi niepełnego pliku
+}
+
+static void savePanel(const uint8_t* panel, bool force) {
+    static std::chrono::steady_clock::time_point lastWrite;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!force && now - lastWrite < PNG_MIN_INTERVAL) return;
+    lastWrite = now;
+    writePng(sim::outputPath("display.png"), panel);
+}
+
+static void saveOnExit() {
+    std::lock_guard<std::mutex> lock(panelMutex);
+    if (activePanel) savePanel(activePanel, true);
+}
+
+// --- U8G2 ---
+
+U8G2::U8G2(u8g2_cb_t_ptr rotation) {
+    (void)rotation;
+    memset(buffer, 0, sizeof(buffer));
+    memset(panel, 0, sizeof(panel));
+}
+
+bool U8G2::begin() {
+    if (activePanel == nullptr) {
+        activePanel = panel;
+        sim::onExit(saveOnExit);
+    }
+    clearDisplay();
+    return true;
+}
+
+void U8G2::clearBuffer() {
+    memset(buffer, 0, sizeof(buffer));
+}
+
+void U8G2::clearDisplay() {
+    clearBuffer();
+    sendBuffer();
+}
+
+void U8G2::transfer(size_t bytes) {
+    uint64_t duration = (uint64_t)(bytes * I2C_MICROS_PER_BYTE);
+    sim::counters().displayBytes += bytes;
+    sim::counters().i2cMicros += duration;
+    sim::sleepMicros(duration);   // Transmisja blokuje wywołującego jak na sprzęcie
+}
+
+void U8G2::sendBuffer() {
+    {
+        std::lock_guard<std::mutex> lock(panelMutex);
+        memcpy(panel, buffer, sizeof(panel));
+        if (!powerSave) savePanel(panel, false);
+    }
+    sim::counters().displayFullFrames++;
+    transfer(sizeof(buffer) + I2C_AREA_OVERHEAD * TILE_HEIGHT);
+}
+
+void U8G2::updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th) {
+    if (tx >= TILE_WIDTH || ty >= TILE_HEIGHT) return;
+    if (tx + tw > TILE_WIDTH) tw = TILE_WIDTH - tx;
+    if (ty + th > TILE_HEIGHT) th = TILE_HEIGHT - ty;
+
+    {
+        std::lock_guard<std::mutex> lock(panelMutex);
+        for (uint8_t row = ty; row < ty + th; row++) {
+            memcpy(&panel[row * WIDTH + tx * 8], &buffer[row * WIDTH + tx * 8], tw * 8);
+        }
+        if (!powerSave) savePanel(panel, false);
+    }
+    sim::counters().displayPartialUpdates++;
+    transfer((size_t)tw * th * 8 + I2C_AREA_OVERHEAD * th);
+}
+
+void U8G2::setPowerSave(uint8_t enable) {
+    powerSave = enable;
+    std::lock_guard<std::mutex> lock(panelMutex);
+    if (powerSave) {
+        uint8_t dark[sizeof(panel)] = {0};
+        savePanel(dark, true);
+    } else {
+        savePanel(panel, true);
+    }
+}
+
+void U8G2::drawPixel(int16_t x, int16_t y) {
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return;
+    uint8_t& cell = buffer[(y / 8) * WIDTH + x];
+    uint8_t mask = 1 << (y % 8);
+    switch (drawColor) {
+        case 0: cell &= ~mask; break;
+        case 2: cell ^= mask; break;
+        default: cell |= mask; break;
+    }
+}
+
+void U8G2::drawHLine(int16_t x, int16_t y, int16_t w) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y);
+}
+
+void U8G2::drawVLine(int16_t x, int16_t y, int16_t h) {
+    for (int16_t i = 0; i < h; i++) drawPixel(x, y + i);
+}
+
+void U8G2::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int16_t error = dx + dy;
+    for (;;) {
+        drawPixel(x0, y0);
+        if (x0 == x1 && y0 == y1) break;
+        int16_t e2 = 2 * error;
+        if (e2 >= dy) { error += dy; x0 += sx; }
+        if (e2 <= dx) { error += dx; y0 += sy; }
+    }
+}
+
+void U8G2::drawBox(int16_t x, int16_t y, int16_t w, int16_t h) {
+    for (int16_t i = 0; i < h; i++) drawHLine(x, y + i, w);
+}
+
+void U8G2::drawFrame(int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (w <= 0 || h <= 0) return;
+    drawHLine(x, y, w);
+    drawHLine(x, y + h - 1, w);
+    drawVLine(x, y, h);
+    drawVLine(x + w - 1, y, h);
+}
+
+void U8G2::drawCircle(int16_t x0, int16_t y0, int16_t r) {
+    for (int16_t y = -r; y <= r; y++) {
+        for (int16_t x = -r; x <= r; x++) {
+            int16_t d = x * x + y * y;
+            if (d <= r * r && d > (r - 1) * (r - 1)) drawPixel(x0 + x, y0 + y);
+        }
+    }
+}
+
+void U8G2::drawDisc(int16_t x0, int16_t y0, int16_t r) {
+    for (int16_t y = -r; y <= r; y++) {
+        for (int16_t x = -r; x <= r; x++) {
+            if (x * x + y * y <= r * r) drawPixel(x0 + x, y0 + y);
+        }
+    }
+}
+
+void U8G2::drawXBM(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* bitmap) {
+    int16_t rowBytes = (w + 7) / 8;
+    for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++) {
+            if (bitmap[j * rowBytes + i / 8] & (1 << (i % 8))) drawPixel(x + i, y + j);
+        }
+    }
+}
+
+void U8G2::drawGlyph(int16_t x, int16_t y, char c) {
+    if (c < 0x20 || c > 0x7E) c = '?';
+    const uint8_t* glyph = FONT_5X7[c - 0x20];
+    uint8_t scale = font[0];
+    int16_t top = y - 7 * scale;   // Wiersz 7 (ogonki) leży pod linią bazową
+
+    for (uint8_t column = 0; column < 5; column++) {
+        for (uint8_t row = 0; row < 8; row++) {
+            if (!(glyph[column] & (1 << row))) continue;
+            for (uint8_t dy = 0; dy < scale; dy++) {
+                for (uint8_t dx = 0; dx < scale; dx++) {
+                    drawPixel(x + column * scale + dx, top + row * scale + dy);
+                }
+            }
+        }
+    }
+}
+
+uint16_t U8G2::drawStr(int16_t x, int16_t y, const char* str) {
+    if (str == nullptr) return 0;
+    int16_t start = x;
+    for (const char* p = str; *p; p++) {
+        drawGlyph(x, y, *p);
+        x += font[1];
+    }
+    return x - start;
+}
+
+uint16_t U8G2::getStrWidth(const char* str) const {
+    return str ? strlen(str) * font[1] : 0;
+}
+
+int8_t U8G2::getAscent() const {
+    return 7 * font[0];
+}
+
+size_t U8G2::write(uint8_t c) {
+    if (c == '\n' || c == '\r') return 1;
+    drawGlyph(cursorX, cursorY, (char)c);
+    cursorX += font[1];
+    return 1;
+}
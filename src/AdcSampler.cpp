@@ -0,0 +1,109 @@
+#include "AdcSampler.h"
+
+namespace {
+    const uint8_t ADC1_CHANNELS = 8;
+    const uint8_t BIT_WIDTH = 12;
+    const uint8_t FRACTION_BITS = 4;    // Średnia w 1/16 LSB
+    const uint8_t MAX_READS = 24;       // Odczyty z bufora na update() (pełny bufor)
+}
+
+int8_t AdcSampler::addChannel(uint8_t pin) {
+    int8_t adcChannel = digitalPinToAnalogChannel(pin);
+    // ADC2 (kanały od 10) niedostępny w trybie ciągłym i przy włączonym WiFi
+    if (running || channelCount >= MAX_CHANNELS || adcChannel < 0 || adcChannel >= ADC1_CHANNELS) return -1;
+    Channel& channel = channels[channelCount];
+    channel.pin = pin;
+    channel.adcChannel = adcChannel;
+    return channelCount++;
+}
+
+bool AdcSampler::begin() {
+    if (running || channelCount == 0) return running;
+
+    uint32_t channelMask = 0;
+    adc_digi_pattern_config_t pattern[MAX_CHANNELS] = {};
+    for (uint8_t i = 0; i < channelCount; i++) {
+        channelMask |= 1UL << channels[i].adcChannel;
+        pattern[i].atten = ADC_ATTEN_DB_11;             // Zakres do ok. 3,1 V
+        pattern[i].channel = channels[i].adcChannel;
+        pattern[i].unit = 0;                            // ADC1
+        pattern[i].bit_width = BIT_WIDTH;
+    }
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = BUFFER_BYTES;
+    init.conv_num_each_intr = FRAME_BYTES;
+    init.adc1_chan_mask = channelMask;
+    init.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = true;                        // Wymagane na ESP32 (DMA przez I2S)
+    config.conv_limit_num = 250;
+    config.pattern_num = channelCount;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = SAMPLE_RATE_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK) {
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, DEFAULT_VREF_MV, &calibration);
+    running = true;
+    return true;
+}
+
+void AdcSampler::update() {
+    if (!running) return;
+
+    for (uint8_t i = 0; i < channelCount; i++) {
+        channels[i].rawSum = 0;
+        channels[i].samples = 0;
+    }
+
+    uint8_t frame[FRAME_BYTES];
+    for (uint8_t read = 0; read < MAX_READS; read++) {
+        uint32_t length = 0;
+        esp_err_t result = adc_digi_read_bytes(frame, sizeof(frame), &length, 0);
+        // Pełny bufor (sterownik odrzucał nowsze próbki) - odebrane dane są poprawne
+        if (result == ESP_ERR_INVALID_STATE) {
+            overflows++;
+        } else if (result != ESP_OK) {
+            break;
+        }
+
+        for (uint32_t offset = 0; offset + sizeof(adc_digi_output_data_t) <= length;
+             offset += sizeof(adc_digi_output_data_t)) {
+            const adc_digi_output_data_t* sample = (const adc_digi_output_data_t*)&frame[offset];
+            for (uint8_t i = 0; i < channelCount; i++) {
+                if (channels[i].adcChannel == sample->type1.channel) {
+                    channels[i].rawSum += sample->type1.data;
+                    channels[i].samples++;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < channelCount; i++) {
+        if (channels[i].samples > 0) channels[i].millivolts = toMillivolts(channels[i].rawSum, channels[i].samples);
+    }
+}
+
+float AdcSampler::toMillivolts(uint32_t rawSum, uint16_t samples) const {
+    // Kalibracja przyjmuje całe kody - ułamek średniej przez interpolację
+    uint32_t average = ((rawSum << FRACTION_BITS) + samples / 2) / samples;
+    uint32_t code = average >> FRACTION_BITS;
+    float fraction = (average & ((1 << FRACTION_BITS) - 1)) / (float)(1 << FRACTION_BITS);
+    uint32_t low = esp_adc_cal_raw_to_voltage(code, &calibration);
+    uint32_t high = esp_adc_cal_raw_to_voltage(code + 1, &calibration);
+    return low + (float)(high - low) * fraction;
+}
+
+bool AdcSampler::getMillivolts(uint8_t channel, float& millivolts) const {
+    if (channel >= channelCount || channels[channel].samples == 0) return false;
+    millivolts = channels[channel].millivolts;
+    return true;
+}
@@ -0,0 +1,119 @@
+#include "BmsRequestPipeline.h"
+
+BmsRequestPipeline::BmsRequestPipeline(SendFunction send, unsigned long cycleIntervalMs, unsigned long responseTimeoutMs)
+    : sendFunction(send),
+      cycleInterval(cycleIntervalMs),
+      responseTimeout(responseTimeoutMs) {
+    memset(commands, 0, sizeof(commands));
+}
+
+bool BmsRequestPipeline::addCommand(const uint8_t* command, size_t length) {
+    if (commandCount >= MAX_COMMANDS || command == nullptr || length < 3) {
+        return false;
+    }
+
+    Command& cmd = commands[commandCount++];
+    cmd.data = command;
+    cmd.length = length;
+    cmd.code = command[2];
+    memset(&cmd.stats, 0, sizeof(cmd.stats));
+    return true;
+}
+
+void BmsRequestPipeline::update(unsigned long now) {
+    if (commandCount == 0) return;
+
+    switch (state) {
+        case IDLE:
+            if (!cycleStarted || now - cycleStartTime >= cycleInterval) {
+                cycleStarted = true;
+                cycleStartTime = now;
+                current = 0;
+                sendCurrent(now);
+            }
+            break;
+
+        case WAITING:
+            if (now - sentTime >= responseTimeout) {
+                commands[current].stats.timeouts++;
+                advance(now);
+            }
+            break;
+    }
+}
+
+void BmsRequestPipeline::onResponse(uint8_t code, unsigned long now) {
+    if (state != WAITING || commands[current].code != code) {
+        return;  // Odpowiedź spóźniona lub na inne zapytanie
+    }
+
+    BmsCommandStats& stats = commands[current].stats;
+    uint32_t latency = now - sentTime;
+
+    stats.received++;
+    stats.lastLatencyMs = latency;
+    stats.totalLatencyMs += latency;
+    if (stats.received == 1 || latency < stats.minLatencyMs) {
+        stats.minLatencyMs = latency;
+    }
+    if (latency > stats.maxLatencyMs) {
+        stats.maxLatencyMs = latency;
+    }
+
+    advance(now);
+}
+
+void BmsRequestPipeline::reset() {
+    state = IDLE;
+    current = 0;
+    cycleStarted = false;
+}
+
+void BmsRequestPipeline::sendCurrent(unsigned long now) {
+    Command& cmd = commands[current];
+
+    if (!sendFunction(cmd.data, cmd.length)) {
+        // Brak połączenia - spróbuj ponownie w następnym cyklu
+        state = IDLE;
+        return;
+    }
+
+    cmd.stats.sent++;
+    sentTime = now;
+    state = WAITING;
+}
+
+void BmsRequestPipeline::advance(unsigned long now) {
+    current++;
+    if (current < commandCount) {
+        sendCurrent(now);
+    } else {
+        state = IDLE;
+        completedCycles++;
+    }
+}
+
+bool BmsRequestPipeline::isBusy() const {
+    return state == WAITING;
+}
+
+uint32_t BmsRequestPipeline::getCompletedCycles() const {
+    return completedCycles;
+}
+
+uint8_t BmsRequestPipeline::getCommandCount() const {
+    return commandCount;
+}
+
+uint8_t BmsRequestPipeline::getCommandCode(uint8_t index) const {
+    return index < commandCount ? commands[index].code : 0;
+}
+
+BmsCommandStats BmsRequestPipeline::getStats(uint8_t index) const {
+    BmsCommandStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (index < commandCount) {
+        stats = commands[index].stats;
+    }
+    return stats;
+}
@@ -0,0 +1,41 @@
+#include "BootProfile.h"
+#include <esp_timer.h>
+
+static const char* const PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    "display", "rtc", "restore", "buttonHold", "firstFrame",
+    "tempSensors", "storage", "sensors", "ble", "ready"
+};
+
+BootProfile::BootProfile() {
+    for (uint8_t i = 0; i < BOOT_PHASE_COUNT; i++) {
+        phaseUs[i] = 0;
+    }
+}
+
+void BootProfile::mark(BootPhase phase) {
+    if (phase >= BOOT_PHASE_COUNT || phaseUs[phase] != 0) return;
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    phaseUs[phase] = now > 0 ? now : 1;
+}
+
+const char* BootProfile::getPhaseName(BootPhase phase) {
+    return phase < BOOT_PHASE_COUNT ? PHASE_NAMES[phase] : "";
+}
+
+void BootProfile::printReport(Print& out) const {
+    out.printf("Start: %s\n", fastResume ? "szybkie wznowienie" : "pełny");
+    out.printf("%-12s %10s\n", "faza", "koniec [us]");
+    for (uint8_t i = 0; i < BOOT_PHASE_COUNT; i++) {
+        if (phaseUs[i] == 0) {
+            out.printf("%-12s %10s\n", PHASE_NAMES[i], "-");
+        } else {
+            out.printf("%-12s %10u\n", PHASE_NAMES[i], (unsigned)phaseUs[i]);
+        }
+    }
+
+    // Przytrzymanie SET zależy od użytkownika - podawane osobno
+    if (phaseUs[BOOT_FIRST_FRAME] != 0 && phaseUs[BOOT_BUTTON_HOLD] != 0) {
+        out.printf("Pierwsza klatka %u us po potwierdzeniu przyciskiem\n",
+                   (unsigned)(phaseUs[BOOT_FIRST_FRAME] - phaseUs[BOOT_BUTTON_HOLD]));
+    }
+}
@@ -0,0 +1,181 @@
+#include "ButtonEngine.h"
+
+// Automat jednego przycisku. Kliknięcie zgłaszane jest dopiero po upływie
+// czasu na drugie kliknięcie (dla przycisków bez podwójnego kliknięcia ten
+// czas wynosi 0, więc od razu po puszczeniu).
+const ButtonEngine::Transition ButtonEngine::TRANSITIONS[] = {
+    // z                  wejście         do                  licznik       gest
+    { STATE_IDLE,         INPUT_PRESS,    STATE_PRESSED,      TIMER_LONG,   GESTURE_PRESS },
+    { STATE_PRESSED,      INPUT_RELEASE,  STATE_RELEASED,     TIMER_DOUBLE, GESTURE_NONE },
+    { STATE_PRESSED,      INPUT_TIMEOUT,  STATE_HELD,         TIMER_NONE,   GESTURE_LONG_PRESS },
+    { STATE_PRESSED,      INPUT_CANCEL,   STATE_SUPPRESSED,   TIMER_NONE,   GESTURE_NONE },
+    { STATE_RELEASED,     INPUT_PRESS,    STATE_SECOND_PRESS, TIMER_NONE,   GESTURE_PRESS },
+    { STATE_RELEASED,     INPUT_TIMEOUT,  STATE_IDLE,         TIMER_NONE,   GESTURE_CLICK },
+    { STATE_RELEASED,     INPUT_CANCEL,   STATE_IDLE,         TIMER_NONE,   GESTURE_NONE },
+    { STATE_SECOND_PRESS, INPUT_RELEASE,  STATE_IDLE,         TIMER_NONE,   GESTURE_DOUBLE_CLICK },
+    { STATE_SECOND_PRESS, INPUT_CANCEL,   STATE_SUPPRESSED,   TIMER_NONE,   GESTURE_NONE },
+    { STATE_HELD,         INPUT_RELEASE,  STATE_IDLE,         TIMER_NONE,   GESTURE_NONE },
+    { STATE_HELD,         INPUT_CANCEL,   STATE_SUPPRESSED,   TIMER_NONE,   GESTURE_NONE },
+    { STATE_SUPPRESSED,   INPUT_RELEASE,  STATE_IDLE,         TIMER_NONE,   GESTURE_NONE },
+};
+
+void IRAM_ATTR ButtonEngine::handleEdge(void* arg) {
+    IsrContext* context = (IsrContext*)arg;
+    ButtonEngine* engine = context->engine;
+    Edge edge = { context->button, (uint32_t)millis() };
+
+    BaseType_t higherPriorityWoken = pdFALSE;
+    if (xQueueSendFromISR(engine->edgeQueue, &edge, &higherPriorityWoken) != pdTRUE) {
+        // Pełna kolejka - process() odczyta stan wszystkich pinów
+        engine->edgesLost = true;
+    }
+    if (engine->wake) engine->wake();
+    if (higherPriorityWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+bool ButtonEngine::begin(EventHandler eventHandler, WakeCallback wakeCallback) {
+    handler = eventHandler;
+    wake = wakeCallback;
+    if (edgeQueue == nullptr) {
+        edgeQueue = xQueueCreate(QUEUE_LENGTH, sizeof(Edge));
+    }
+    return edgeQueue != nullptr;
+}
+
+int8_t ButtonEngine::addButton(uint8_t pin, uint16_t longPressMs, uint16_t doubleClickMs) {
+    if (edgeQueue == nullptr || buttonCount >= MAX_BUTTONS) return -1;
+
+    uint8_t index = buttonCount++;
+    Button& button = buttons[index];
+    memset(&button, 0, sizeof(button));
+    button.pin = pin;
+    button.longPressMs = longPressMs;
+    button.doubleClickMs = doubleClickMs;
+    button.state = STATE_IDLE;
+
+    pinMode(pin, INPUT_PULLUP);
+
+    // Przycisk wciśnięty przy starcie (np. po wybudzeniu) zaczyna jako anulowany
+    if (digitalRead(pin) == LOW) {
+        button.pressed = true;
+        button.state = STATE_SUPPRESSED;
+        pressedMask |= 1 << index;
+    }
+
+    isrContexts[index].engine = this;
+    isrContexts[index].button = index;
+    attachInterruptArg(pin, handleEdge, &isrContexts[index], CHANGE);
+    return index;
+}
+
+void ButtonEngine::process(uint32_t now) {
+    Edge edge;
+    while (xQueueReceive(edgeQueue, &edge, 0) == pdTRUE) {
+        if (edge.button >= buttonCount) continue;
+        // Zbocza w czasie blokady to drgania - stan sprawdzany na jej końcu
+        if (!buttons[edge.button].settling) {
+            sample(edge.button, edge.time);
+        }
+    }
+
+    if (edgesLost) {
+        edgesLost = false;
+        for (uint8_t i = 0; i < buttonCount; i++) {
+            if (!buttons[i].settling) sample(i, now);
+        }
+    }
+
+    for (uint8_t i = 0; i < buttonCount; i++) {
+        Button& button = buttons[i];
+
+        if (button.settling && (int32_t)(now - button.settleUntil) >= 0) {
+            button.settling = false;
+            bool pressed = digitalRead(button.pin) == LOW;
+            if (pressed != button.pressed) sample(i, now);
+        }
+
+        if (button.timerActive && (int32_t)(now - button.deadline) >= 0) {
+            button.timerActive = false;
+            feed(i, INPUT_TIMEOUT, button.deadline);
+        }
+    }
+
+    if (chordMask != 0 && !chordReported && (int32_t)(now - chordStart) >= (int32_t)CHORD_MS) {
+        chordReported = true;
+        emit(GESTURE_CHORD, chordMask, now);
+    }
+}
+
+void ButtonEngine::suppress(uint32_t now) {
+    for (uint8_t i = 0; i < buttonCount; i++) {
+        feed(i, INPUT_CANCEL, now);
+    }
+    chordReported = true;
+}
+
+// Odczyt pinu po zboczu (pierwsze zbocze od razu zmienia stan) i start blokady
+void ButtonEngine::sample(uint8_t index, uint32_t time) {
+    Button& button = buttons[index];
+    button.settling = true;
+    button.settleUntil = time + DEBOUNCE_MS;
+
+    bool pressed = digitalRead(button.pin) == LOW;
+    if (pressed != button.pressed) {
+        setPressed(index, pressed, time);
+    }
+}
+
+void ButtonEngine::setPressed(uint8_t index, bool pressed, uint32_t time) {
+    buttons[index].pressed = pressed;
+    feed(index, pressed ? INPUT_PRESS : INPUT_RELEASE, time);
+
+    if (pressed) {
+        pressedMask |= 1 << index;
+    } else {
+        pressedMask &= ~(1 << index);
+    }
+
+    // Kombinacja: każda zmiana zestawu wciśniętych przycisków zaczyna odliczanie od nowa
+    if (__builtin_popcount(pressedMask) >= 2) {
+        if (pressedMask != chordMask) {
+            chordMask = pressedMask;
+            chordStart = time;
+            chordReported = false;
+            for (uint8_t i = 0; i < buttonCount; i++) {
+                if (pressedMask & (1 << i)) feed(i, INPUT_CANCEL, time);
+            }
+        }
+    } else {
+        chordMask = 0;
+    }
+}
+
+void ButtonEngine::feed(uint8_t index, Input input, uint32_t time) {
+    Button& button = buttons[index];
+
+    for (const Transition& transition : TRANSITIONS) {
+        if (transition.from != button.state || transition.input != input) continue;
+
+        button.state = transition.to;
+        button.timerActive = transition.timer != TIMER_NONE;
+        if (transition.timer == TIMER_LONG) {
+            button.deadline = time + button.longPressMs;
+        } else if (transition.timer == TIMER_DOUBLE) {
+            button.deadline = time + button.doubleClickMs;
+        }
+
+        if (transition.gesture != GESTURE_NONE) {
+            emit(transition.gesture, 1 << index, time);
+        }
+        return;
+    }
+    // Brak przejścia - wejście bez znaczenia w tym stanie
+}
+
+void ButtonEngine::emit(ButtonGesture gesture, uint8_t mask, uint32_t time) {
+    if (handler == nullptr) return;
+    ButtonEvent event = { gesture, mask, time };
+    handler(event);
+}
@@ -0,0 +1,137 @@
+#include "CadenceSensor.h"
+
+void IRAM_ATTR CadenceSensor::handleEdge(void* arg) {
+    CadenceSensor* sensor = (CadenceSensor*)arg;
+    uint32_t now = micros();
+
+    portENTER_CRITICAL_ISR(&sensor->lock);
+    sensor->previousEdgeUs = sensor->lastEdgeUs;
+    sensor->lastEdgeUs = now;
+    sensor->edgeCount++;
+    portEXIT_CRITICAL_ISR(&sensor->lock);
+}
+
+void CadenceSensor::handleTimer(void* arg) {
+    ((CadenceSensor*)arg)->publish();
+}
+
+bool CadenceSensor::begin(uint8_t sensorPin, uint8_t magnetCount, pcnt_unit_t counterUnit) {
+    pin = sensorPin;
+    magnets = magnetCount > 0 ? magnetCount : 1;
+    unit = counterUnit;
+
+    pinMode(pin, INPUT_PULLUP);
+
+    // Zliczanie zboczy opadających, filtr odrzuca zakłócenia krótsze niż 1023 cykle APB (~13 us)
+    pcnt_config_t config = {};
+    config.pulse_gpio_num = pin;
+    config.ctrl_gpio_num = PCNT_PIN_NOT_USED;
+    config.lctrl_mode = PCNT_MODE_KEEP;
+    config.hctrl_mode = PCNT_MODE_KEEP;
+    config.pos_mode = PCNT_COUNT_DIS;
+    config.neg_mode = PCNT_COUNT_INC;
+    config.counter_h_lim = COUNTER_LIMIT;
+    config.counter_l_lim = 0;
+    config.unit = unit;
+    config.channel = PCNT_CHANNEL_0;
+    if (pcnt_unit_config(&config) != ESP_OK) return false;
+
+    pcnt_set_filter_value(unit, 1023);
+    pcnt_filter_enable(unit);
+    pcnt_counter_pause(unit);
+    pcnt_counter_clear(unit);
+    pcnt_counter_resume(unit);
+
+    setCountingMode(false);
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = handleTimer;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "cadence";
+    if (esp_timer_create(&timerArgs, &timer) != ESP_OK) return false;
+    return esp_timer_start_periodic(timer, PUBLISH_INTERVAL_MS * 1000ULL) == ESP_OK;
+}
+
+void CadenceSensor::setCountingMode(bool enabled) {
+    countingMode = enabled;
+    if (enabled) {
+        detachInterrupt(pin);
+        return;
+    }
+
+    portENTER_CRITICAL(&lock);
+    edgeCount = 0;
+    portEXIT_CRITICAL(&lock);
+    attachInterruptArg(pin, handleEdge, this, FALLING);
+}
+
+// Kadencja z okresu między dwoma ostatnimi impulsami
+uint16_t CadenceSensor::measurePeriod(uint32_t nowUs) {
+    portENTER_CRITICAL(&lock);
+    uint32_t lastEdge = lastEdgeUs;
+    uint32_t previousEdge = previousEdgeUs;
+    uint32_t edges = edgeCount;
+    portEXIT_CRITICAL(&lock);
+
+    uint32_t timeoutUs = 60000000UL / ((uint32_t)magnets * MIN_RPM);
+    uint32_t sinceEdge = nowUs - lastEdge;
+    if (edges < 2 || sinceEdge > timeoutUs) return 0;
+
+    // Bez kolejnego impulsu korba obraca się co najwyżej tak szybko, jak wynika z czasu od impulsu
+    uint32_t period = lastEdge - previousEdge;
+    if (sinceEdge > period) period = sinceEdge;
+    if (period == 0) return 0;
+    return (uint16_t)((60000000UL / magnets + period / 2) / period);
+}
+
+void CadenceSensor::publish() {
+    int16_t counter = 0;
+    pcnt_get_counter_value(unit, &counter);
+    int32_t pulses = (int32_t)counter - lastCounter;
+    if (pulses < 0) pulses += COUNTER_LIMIT;
+    lastCounter = counter;
+
+    windowPulses[windowIndex] = pulses;
+    windowIndex = (windowIndex + 1) % COUNT_WINDOW;
+    uint32_t windowSum = 0;
+    for (uint8_t i = 0; i < COUNT_WINDOW; i++) windowSum += windowPulses[i];
+    uint32_t windowMs = COUNT_WINDOW * PUBLISH_INTERVAL_MS;
+    uint32_t pulseHz = windowSum * 1000UL / windowMs;
+
+    uint16_t rpm;
+    if (countingMode) {
+        rpm = (uint16_t)((windowSum * 60000UL / magnets + windowMs / 2) / windowMs);
+        if (pulseHz < COUNTING_EXIT_HZ) setCountingMode(false);
+    } else {
+        rpm = measurePeriod(micros());
+        if (pulseHz >= COUNTING_ENTER_HZ) setCountingMode(true);
+    }
+
+    cadence = rpm;
+    addToAverage(rpm);
+}
+
+// Średnia krocząca w przedziałach po 5 s - stała pamięć, bez przepełnienia sumy
+void CadenceSensor::addToAverage(uint16_t rpm) {
+    AverageBucket& bucket = buckets[bucketIndex];
+    if (rpm > 0) {
+        bucket.sum += rpm;
+        bucket.samples++;
+    }
+
+    if (++bucketSamples >= AVERAGE_BUCKET_SAMPLES) {
+        bucketSamples = 0;
+        bucketIndex = (bucketIndex + 1) % AVERAGE_BUCKETS;
+        buckets[bucketIndex].sum = 0;
+        buckets[bucketIndex].samples = 0;
+    }
+
+    uint32_t sum = 0;
+    uint32_t samples = 0;
+    for (uint8_t i = 0; i < AVERAGE_BUCKETS; i++) {
+        sum += buckets[i].sum;
+        samples += buckets[i].samples;
+    }
+    averageCadence = samples > 0 ? (uint16_t)((sum + samples / 2) / samples) : 0;
+}
@@ -0,0 +1,102 @@
+#include "ConfigStore.h"
+#include "Crc32.h"
+
+const char* const ConfigStore::PATH = "/config.bin";
+const char* const ConfigStore::TEMP_PATH = "/config.tmp";
+
+const char* const PARAM_KEYS[] = {
+    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10",
+    "11", "12", "13", "14", "15", "16", "17", "18", "19", "20"
+};
+
+ConfigStore::ConfigStore() {
+    setDefaults();
+}
+
+void ConfigStore::setDefaults() {
+    memset(&data, 0, sizeof(data));
+
+    data.lights.dayLights = LIGHTS_FRONT;
+    data.lights.nightLights = LIGHTS_BOTH;
+    data.lights.blinkFrequency = 500;
+    data.lightLevels.dayBrightness = 100;
+    data.lightLevels.nightBrightness = 100;
+    data.lightLevels.rampMs = 300;
+
+    data.backlight.dayBrightness = 100;
+    data.backlight.nightBrightness = 50;
+
+    data.controller.type = CONTROLLER_KT_LCD;
+    data.general.wheelSize = 26;
+}
+
+bool ConfigStore::begin(fs::FS& fileSystem) {
+    fs = &fileSystem;
+    loaded = false;
+    corrupted = false;
+    setDefaults();
+
+    uint32_t start = micros();
+    File file = fs->open(PATH, "r");
+    if (!file) return false;
+
+    // Nagłówek i dane jednym odczytem
+    uint8_t buffer[sizeof(ConfigHeader) + sizeof(ConfigData)];
+    size_t length = file.read(buffer, sizeof(buffer));
+    file.close();
+
+    ConfigHeader header;
+    if (length >= sizeof(header)) memcpy(&header, buffer, sizeof(header));
+
+    if (length < sizeof(header) || header.magic != MAGIC || header.version > VERSION ||
+        header.length > length - sizeof(header) ||
+        crc32(buffer + sizeof(header), header.length) != header.crc) {
+        corrupted = true;
+        return false;
+    }
+
+    // Starszy (krótszy) obraz zostawia domyślne wartości nowych pól
+    memcpy(&data, buffer + sizeof(header), min((size_t)header.length, sizeof(data)));
+    loaded = true;
+    loadTimeUs = micros() - start;
+    return true;
+}
+
+uint32_t ConfigStore::getCrc() const {
+    return crc32(&data, sizeof(data));
+}
+
+bool ConfigStore::save() {
+    if (fs == nullptr) return false;
+
+    ConfigHeader header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.length = sizeof(data);
+    header.crc = crc32(&data, sizeof(data));
+
+    uint8_t buffer[sizeof(ConfigHeader) + sizeof(ConfigData)];
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), &data, sizeof(data));
+
+    File file = fs->open(TEMP_PATH, "w");
+    if (!file) {
+        saveErrors++;
+        return false;
+    }
+    size_t written = file.write(buffer, sizeof(buffer));
+    file.close();
+
+    if (written != sizeof(buffer)) {
+        fs->remove(TEMP_PATH);
+        saveErrors++;
+        return false;
+    }
+
+    // Zmiana nazwy w LittleFS zastępuje stary plik atomowo
+    if (!fs->rename(TEMP_PATH, PATH)) {
+        saveErrors++;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,82 @@
+#include "Ds18b20Bus.h"
+
+namespace {
+    const uint8_t CMD_CONVERT_T = 0x44;
+    const uint8_t CMD_READ_SCRATCHPAD = 0xBE;
+    const uint8_t CMD_WRITE_SCRATCHPAD = 0x4E;
+
+    // Pamięć podręczna: temperatura (2 B), TH, TL, konfiguracja, 3 B zarezerwowane, CRC
+    const uint8_t SCRATCHPAD_SIZE = 9;
+    const uint8_t TEMP_LSB = 0;
+    const uint8_t TEMP_MSB = 1;
+    const uint8_t HIGH_ALARM = 2;
+    const uint8_t LOW_ALARM = 3;
+    const uint8_t CONFIGURATION = 4;
+    const uint8_t SCRATCHPAD_CRC = 8;
+}
+
+bool Ds18b20Bus::getAddress(uint8_t* address, uint8_t index) {
+    wire->reset_search();
+    for (uint8_t found = 0; wire->search(address); found++) {
+        if (found == index) return validAddress(address);
+    }
+    return false;
+}
+
+bool Ds18b20Bus::validAddress(const uint8_t* address) const {
+    return RmtOneWire::crc8(address, 7) == address[7];
+}
+
+bool Ds18b20Bus::readScratchPad(const uint8_t* address, uint8_t* scratchPad) {
+    if (!wire->reset()) return false;
+    wire->select(address);
+    wire->write(CMD_READ_SCRATCHPAD);
+    wire->read_bytes(scratchPad, SCRATCHPAD_SIZE);
+
+    // Same zera mają poprawne CRC - linia zwarta do masy
+    bool allZeros = true;
+    for (uint8_t i = 0; i < SCRATCHPAD_SIZE; i++) {
+        if (scratchPad[i] != 0) allZeros = false;
+    }
+    return !allZeros && RmtOneWire::crc8(scratchPad, SCRATCHPAD_CRC) == scratchPad[SCRATCHPAD_CRC];
+}
+
+uint8_t Ds18b20Bus::getResolution(const uint8_t* address) {
+    uint8_t scratchPad[SCRATCHPAD_SIZE];
+    if (!readScratchPad(address, scratchPad)) return 0;
+    // Bity 5-6 rejestru konfiguracji: 0 - 9 bitów ... 3 - 12 bitów
+    return 9 + ((scratchPad[CONFIGURATION] >> 5) & 0x03);
+}
+
+bool Ds18b20Bus::setResolution(const uint8_t* address, uint8_t bits) {
+    uint8_t scratchPad[SCRATCHPAD_SIZE];
+    if (!readScratchPad(address, scratchPad)) return false;
+
+    bits = constrain(bits, 9, 12);
+    if (!wire->reset()) return false;
+    wire->select(address);
+    wire->write(CMD_WRITE_SCRATCHPAD);
+    // Progi alarmów bez zmian
+    wire->write(scratchPad[HIGH_ALARM]);
+    wire->write(scratchPad[LOW_ALARM]);
+    wire->write(((bits - 9) << 5) | 0x1F);
+    return getResolution(address) == bits;
+}
+
+bool Ds18b20Bus::requestTemperaturesByAddress(const uint8_t* address) {
+    if (!wire->reset()) return false;
+    wire->select(address);
+    wire->write(CMD_CONVERT_T);
+    return true;
+}
+
+float Ds18b20Bus::getTempC(const uint8_t* address) {
+    uint8_t scratchPad[SCRATCHPAD_SIZE];
+    if (!readScratchPad(address, scratchPad)) return DEVICE_DISCONNECTED_C;
+
+    // Przy mniejszej rozdzielczości najmłodsze bity są nieokreślone
+    int16_t raw = (int16_t)((scratchPad[TEMP_MSB] << 8) | scratchPad[TEMP_LSB]);
+    uint8_t unusedBits = 3 - ((scratchPad[CONFIGURATION] >> 5) & 0x03);
+    raw &= ~((1 << unusedBits) - 1);
+    return raw / 16.0f;
+}
@@ -0,0 +1,238 @@
+#include "JbdParser.h"
+
+// --- JbdRingBuffer ---
+
+size_t JbdRingBuffer::push(const uint8_t* data, size_t length) {
+    uint16_t h = head.load(std::memory_order_relaxed);
+    uint16_t t = tail.load(std::memory_order_acquire);
+    size_t freeSpace = CAPACITY - (uint16_t)(h - t);
+    size_t count = length < freeSpace ? length : freeSpace;
+
+    for (size_t i = 0; i < count; i++) {
+        buffer[(uint16_t)(h + i) & MASK] = data[i];
+    }
+
+    head.store((uint16_t)(h + count), std::memory_order_release);
+    return count;
+}
+
+size_t JbdRingBuffer::available() const {
+    uint16_t h = head.load(std::memory_order_acquire);
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    return (uint16_t)(h - t);
+}
+
+uint8_t JbdRingBuffer::peek(size_t offset) const {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    return buffer[(uint16_t)(t + offset) & MASK];
+}
+
+void JbdRingBuffer::consume(size_t count) {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    tail.store((uint16_t)(t + count), std::memory_order_release);
+}
+
+void JbdRingBuffer::clear() {
+    tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+// --- JbdParser ---
+
+JbdParser::JbdParser(unsigned long partialTimeoutMs)
+    : overflowCount(0),
+      partialTimeout(partialTimeoutMs) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void JbdParser::push(const uint8_t* data, size_t length) {
+    size_t accepted = ring.push(data, length);
+    if (accepted < length) {
+        overflowCount.fetch_add(length - accepted, std::memory_order_relaxed);
+    }
+}
+
+bool JbdParser::poll(BmsData& bms, uint8_t& command, unsigned long now) {
+    for (;;) {
+        size_t available = ring.available();
+        if (available == 0) {
+            partialPending = false;
+            return false;
+        }
+
+        // Synchronizacja na bajcie startu
+        if (ring.peek(0) != FRAME_START) {
+            ring.consume(1);
+            stats.skippedBytes++;
+            continue;
+        }
+
+        size_t frameLength = 0;
+        if (available >= HEADER_SIZE) {
+            uint8_t dataLength = ring.peek(3);
+            if (dataLength > MAX_DATA_LENGTH) {
+                // Fałszywy bajt startu - szukaj dalej
+                stats.lengthErrors++;
+                ring.consume(1);
+                continue;
+            }
+            frameLength = HEADER_SIZE + dataLength + TRAILER_SIZE;
+        }
+
+        if (frameLength == 0 || available < frameLength) {
+            // Niekompletna ramka - czekaj na kolejne fragmenty, ale nie w nieskończoność
+            if (!partialPending) {
+                partialPending = true;
+                partialSince = now;
+            } else if (now - partialSince >= partialTimeout) {
+                stats.timeouts++;
+                ring.consume(1);
+                partialPending = false;
+                continue;
+            }
+            return false;
+        }
+        partialPending = false;
+
+        if (ring.peek(frameLength - 1) != FRAME_END) {
+            stats.endByteErrors++;
+            ring.consume(1);
+            continue;
+        }
+
+        // Suma kontrolna: 0x10000 - suma bajtów od statusu do końca danych
+        uint8_t dataLength = ring.peek(3);
+        uint16_t sum = 0;
+        for (size_t i = 2; i < (size_t)HEADER_SIZE + dataLength; i++) {
+            sum += ring.peek(i);
+        }
+        uint16_t expected = (uint16_t)(0x10000 - sum);
+        if (readU16(HEADER_SIZE + dataLength) != expected) {
+            stats.checksumErrors++;
+            ring.consume(1);
+            continue;
+        }
+
+        uint8_t frameCommand = ring.peek(1);
+        uint8_t status = ring.peek(2);
+        bool decoded = false;
+
+        if (status != 0x00) {
+            stats.statusErrors++;
+        } else {
+            decoded = decode(frameCommand, dataLength, bms);
+        }
+
+        ring.consume(frameLength);
+
+        if (decoded) {
+            stats.framesOk++;
+            command = frameCommand;
+            return true;
+        }
+    }
+}
+
+void JbdParser::reset() {
+    ring.clear();
+    partialPending = false;
+}
+
+JbdParserStats JbdParser::getStats() const {
+    JbdParserStats result = stats;
+    result.overflows = overflowCount.load(std::memory_order_relaxed);
+    return result;
+}
+
+uint16_t JbdParser::readU16(size_t offset) const {
+    return ((uint16_t)ring.peek(offset) << 8) | ring.peek(offset + 1);
+}
+
+bool JbdParser::decode(uint8_t command, uint8_t length, BmsData& bms) {
+    switch (command) {
+        case 0x03: return decodeBasicInfo(length, bms);
+        case 0x04: return decodeCellInfo(length, bms);
+        case 0x08: return decodeTemperatures(length, bms);
+        default:
+            stats.unknownCommands++;
+            return false;
+    }
+}
+
+// Rejestr 0x03 - informacje podstawowe
+bool JbdParser::decodeBasicInfo(uint8_t length, BmsData& bms) {
+    const size_t d = HEADER_SIZE;  // Początek danych w ramce
+    const uint8_t FIXED_LENGTH = 23;
+
+    if (length < FIXED_LENGTH) {
+        stats.lengthErrors++;
+        return false;
+    }
+
+    uint8_t ntcCount = ring.peek(d + 22);
+    if (length < FIXED_LENGTH + ntcCount * 2) {
+        stats.lengthErrors++;
+        return false;
+    }
+
+    bms.voltage = readU16(d + 0) / 100.0f;                    // 10 mV
+    bms.current = (int16_t)readU16(d + 2) / 100.0f;           // 10 mA, ze znakiem
+    bms.remainingCapacity = readU16(d + 4) / 100.0f;          // 10 mAh
+    bms.totalCapacity = readU16(d + 6) / 100.0f;              // 10 mAh
+    bms.cycles = readU16(d + 8);
+    bms.protectionStatus = readU16(d + 16);
+    bms.soc = ring.peek(d + 19);
+
+    uint8_t fetStatus = ring.peek(d + 20);
+    bms.charging = (fetStatus & 0x01);
+    bms.discharging = (fetStatus & 0x02);
+
+    bms.cellCount = ring.peek(d + 21);
+
+    bms.ntcCount = ntcCount < BMS_MAX_NTC ? ntcCount : BMS_MAX_NTC;
+    for (uint8_t i = 0; i < bms.ntcCount; i++) {
+        // 0.1 K -> °C
+        bms.temperatures[i] = ((int32_t)readU16(d + FIXED_LENGTH + i * 2) - 2731) / 10.0f;
+    }
+
+    return true;
+}
+
+// Rejestr 0x04 - napięcia cel
+bool JbdParser::decodeCellInfo(uint8_t length, BmsData& bms) {
+    const size_t d = HEADER_SIZE;
+
+    if (length == 0 || (length & 1)) {
+        stats.lengthErrors++;
+        return false;
+    }
+
+    uint8_t cells = length / 2;
+    if (cells > BMS_MAX_CELLS) cells = BMS_MAX_CELLS;
+
+    for (uint8_t i = 0; i < cells; i++) {
+        bms.cellVoltages[i] = readU16(d + i * 2) / 1000.0f;  // mV
+    }
+    bms.cellCount = cells;
+
+    return true;
+}
+
+// Rejestr 0x08 - lista temperatur (0.1 K)
+bool JbdParser::decodeTemperatures(uint8_t length, BmsData& bms) {
+    const size_t d = HEADER_SIZE;
+
+    if (length == 0 || (length & 1)) {
+        stats.lengthErrors++;
+        return false;
+    }
+
+    uint8_t count = length / 2;
+    if (count > BMS_MAX_NTC) count = BMS_MAX_NTC;
+
+    for (uint8_t i = 0; i < count; i++) {
+        bms.temperatures[i] = ((int32_t)readU16(d + i * 2) - 2731) / 10.0f;
+    }
+    bms.ntcCount = count;
+
+    return true;
+}
@@ -0,0 +1,161 @@
+#include "LegacyConfig.h"
+#include <ArduinoJson.h>
+
+const char* const LegacyConfig::FILES[] = {
+    "/config.json",
+    "/lights.json",
+    "/display_config.json",
+    "/general_config.json",
+    "/bluetooth_config.json"
+};
+const size_t LegacyConfig::FILE_COUNT = sizeof(FILES) / sizeof(FILES[0]);
+
+namespace {
+
+    // Tryb świateł: liczba w config.json, nazwa w lights.json
+    uint8_t parseLightMode(JsonVariantConst value, uint8_t fallback) {
+        if (value.is<const char*>()) {
+            const char* name = value.as<const char*>();
+            if (strcmp(name, "FRONT") == 0) return LIGHTS_FRONT;
+            if (strcmp(name, "REAR") == 0) return LIGHTS_REAR;
+            if (strcmp(name, "BOTH") == 0) return LIGHTS_BOTH;
+            return LIGHTS_NONE;
+        }
+        if (value.is<int>()) {
+            int mode = value.as<int>();
+            if (mode >= LIGHTS_NONE && mode <= LIGHTS_BOTH) return (uint8_t)mode;
+        }
+        return fallback;
+    }
+
+    uint8_t percent(int value) {
+        return (uint8_t)constrain(value, 0, 100);
+    }
+
+    bool readJson(fs::FS& fs, const char* path, JsonDocument& doc) {
+        File file = fs.open(path, "r");
+        if (!file) return false;
+
+        DeserializationError error = deserializeJson(doc, file);
+        file.close();
+
+        // Uszkodzony plik pomijany - reszta ustawień przenoszona
+        return !error;
+    }
+
+}
+
+bool LegacyConfig::read(fs::FS& fs, ConfigStore& store) {
+    bool found = false;
+    StaticJsonDocument<1024> doc;
+
+    if (readJson(fs, FILES[0], doc)) {
+        found = true;
+
+        JsonObjectConst light = doc["light"];
+        if (!light.isNull()) {
+            ConfigLights lights = store.lights();
+            lights.dayLights = parseLightMode(light["dayLights"], LIGHTS_NONE);
+            lights.nightLights = parseLightMode(light["nightLights"], LIGHTS_NONE);
+            lights.dayBlink = light["dayBlink"] | false;
+            lights.nightBlink = light["nightBlink"] | false;
+            lights.blinkFrequency = light["blinkFrequency"] | 500;
+            store.setLights(lights);
+        }
+
+        JsonObjectConst backlight = doc["backlight"];
+        if (!backlight.isNull()) {
+            ConfigBacklight value;
+            value.dayBrightness = percent(backlight["dayBrightness"] | 100);
+            value.nightBrightness = percent(backlight["nightBrightness"] | 50);
+            value.autoMode = backlight["autoMode"] | false;
+            store.setBacklight(value);
+        }
+
+        JsonObjectConst wifi = doc["wifi"];
+        if (!wifi.isNull()) {
+            ConfigWifi value;
+            memset(&value, 0, sizeof(value));
+            strlcpy(value.ssid, wifi["ssid"] | "", sizeof(value.ssid));
+            strlcpy(value.password, wifi["password"] | "", sizeof(value.password));
+            store.setWifi(value);
+        }
+
+        ConfigGeneral general = store.general();
+        general.ntpEnabled = doc["time"]["ntpEnabled"] | false;
+        store.setGeneral(general);
+
+        JsonObjectConst controller = doc["controller"];
+        if (!controller.isNull()) {
+            ConfigController value = store.controller();
+            const char* type = controller["type"] | "kt-lcd";
+            value.type = strcmp(type, "s866") == 0 ? CONTROLLER_S866 : CONTROLLER_KT_LCD;
+
+            // Dawny zapis umieszczał parametry w "params", dawny odczyt szukał ich w "controller"
+            JsonObjectConst params = controller["params"];
+            if (params.isNull()) params = controller;
+            if (strcmp(type, "kt-lcd") == 0) {
+                for (int i = 1; i <= 5; i++) {
+                    value.ktParams[i-1] = params["p"][PARAM_KEYS[i]] | 0;
+                }
+                for (int i = 1; i <= 15; i++) {
+                    value.ktParams[i+4] = params["c"][PARAM_KEYS[i]] | 0;
+                }
+                for (int i = 1; i <= 3; i++) {
+                    value.ktParams[i+19] = params["l"][PARAM_KEYS[i]] | 0;
+                }
+            } else {
+                for (int i = 1; i <= 20; i++) {
+                    value.s866Params[i-1] = params["p"][PARAM_KEYS[i]] | 0;
+                }
+            }
+            store.setController(value);
+        }
+    }
+
+    if (readJson(fs, FILES[1], doc)) {
+        found = true;
+        ConfigLights lights = store.lights();
+        lights.dayLights = parseLightMode(doc["dayLights"], LIGHTS_FRONT);
+        lights.nightLights = parseLightMode(doc["nightLights"], LIGHTS_BOTH);
+        lights.dayBlink = doc["dayBlink"] | false;
+        lights.nightBlink = doc["nightBlink"] | false;
+        lights.blinkFrequency = doc["blinkFrequency"] | 500;
+        store.setLights(lights);
+    }
+
+    if (readJson(fs, FILES[2], doc)) {
+        found = true;
+        ConfigBacklight backlight;
+        backlight.dayBrightness = percent(doc["dayBrightness"] | 100);
+        backlight.nightBrightness = percent(doc["nightBrightness"] | 50);
+        backlight.autoMode = doc["autoMode"] | false;
+        store.setBacklight(backlight);
+    }
+
+    if (readJson(fs, FILES[3], doc)) {
+        found = true;
+        ConfigGeneral general = store.general();
+        general.wheelSize = doc["wheelSize"] | 26;
+        store.setGeneral(general);
+    }
+
+    if (readJson(fs, FILES[4], doc)) {
+        found = true;
+        ConfigBluetooth bluetooth;
+        bluetooth.bmsEnabled = doc["bmsEnabled"] | false;
+        bluetooth.tpmsEnabled = doc["tpmsEnabled"] | false;
+        store.setBluetooth(bluetooth);
+    }
+
+    return found;
+}
+
+bool LegacyConfig::commit(fs::FS& fs, ConfigStore& store) {
+    if (!store.save() || !store.begin(fs)) return false;
+
+    for (size_t i = 0; i < FILE_COUNT; i++) {
+        fs.remove(FILES[i]);
+    }
+    return true;
+}
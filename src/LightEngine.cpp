@@ -0,0 +1,137 @@
+#include "LightEngine.h"
+
+namespace {
+    const uint16_t DEFAULT_BLINK_PERIOD_MS = 500;
+    const uint32_t REF_TICK_HZ = 1000000;
+    const uint8_t DIVIDER_FRACTION_BITS = 8;    // Dzielnik timera LEDC w formacie Q10.8
+}
+
+bool LightEngine::begin(uint8_t frontDayPin, uint8_t frontPin, uint8_t rearPin) {
+    if (started) return true;
+
+    ledc_timer_config_t timer = {};
+    timer.speed_mode = SPEED_MODE;
+    timer.duty_resolution = (ledc_timer_bit_t)PWM_RESOLUTION_BITS;
+    timer.timer_num = PWM_TIMER;
+    timer.freq_hz = PWM_FREQUENCY_HZ;
+    timer.clk_cfg = LEDC_AUTO_CLK;
+    if (ledc_timer_config(&timer) != ESP_OK) return false;
+
+    const uint8_t pins[OUTPUT_COUNT] = {frontDayPin, frontPin, rearPin};
+    for (uint8_t i = 0; i < OUTPUT_COUNT; i++) {
+        ledc_channel_config_t channel = {};
+        channel.gpio_num = pins[i];
+        channel.speed_mode = SPEED_MODE;
+        channel.channel = (ledc_channel_t)(LEDC_CHANNEL_0 + i);
+        channel.intr_type = LEDC_INTR_DISABLE;
+        channel.timer_sel = PWM_TIMER;
+        channel.duty = 0;
+        channel.hpoint = 0;
+        if (ledc_channel_config(&channel) != ESP_OK) return false;
+        outputs[i].channel = channel.channel;
+    }
+
+    // Rampy i bezpieczne wątkowo ustawianie wypełnienia (ledc_set_duty_and_update)
+    if (ledc_fade_func_install(0) != ESP_OK) return false;
+    if (!configureBlinkTimer(DEFAULT_BLINK_PERIOD_MS)) return false;
+
+    mutex = xSemaphoreCreateMutex();
+    started = mutex != nullptr;
+    return started;
+}
+
+bool LightEngine::configureBlinkTimer(uint16_t periodMs) {
+    // Rozdzielczość tak, by dzielnik zegara 1 MHz wypadł w zakresie 256..512
+    // (mieści się w 10 bitach części całkowitej) - okres z dokładnością 1/256 us
+    uint32_t periodUs = (uint32_t)periodMs * 1000;
+    uint8_t bits = 31 - __builtin_clz(periodUs) - DIVIDER_FRACTION_BITS;
+    uint32_t divider = (uint32_t)(((uint64_t)periodUs << DIVIDER_FRACTION_BITS) >> bits);
+
+    // Pełna konfiguracja (zegar REF_TICK), potem dokładny dzielnik ułamkowy
+    ledc_timer_config_t timer = {};
+    timer.speed_mode = SPEED_MODE;
+    timer.duty_resolution = (ledc_timer_bit_t)bits;
+    timer.timer_num = BLINK_TIMER;
+    timer.freq_hz = max((uint32_t)1, (uint32_t)(REF_TICK_HZ / periodUs));
+    timer.clk_cfg = LEDC_USE_REF_TICK;
+    if (ledc_timer_config(&timer) != ESP_OK ||
+        ledc_timer_set(SPEED_MODE, BLINK_TIMER, divider, bits, LEDC_REF_TICK) != ESP_OK) {
+        return false;
+    }
+    ledc_timer_rst(SPEED_MODE, BLINK_TIMER);
+
+    blinkPeriodMs = periodMs;
+    blinkResolutionBits = bits;
+    return true;
+}
+
+void LightEngine::setBlinkPeriod(uint16_t periodMs) {
+    if (!started) return;
+    periodMs = constrain(periodMs, MIN_BLINK_PERIOD_MS, MAX_BLINK_PERIOD_MS);
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    if (periodMs != blinkPeriodMs && configureBlinkTimer(periodMs)) {
+        // Inna rozdzielczość timera - wypełnienie 50% od nowa
+        for (uint8_t i = 0; i < OUTPUT_COUNT; i++) {
+            if (outputs[i].blink) {
+                ledc_set_duty_and_update(SPEED_MODE, outputs[i].channel, 1UL << (blinkResolutionBits - 1), 0);
+            }
+        }
+    }
+    xSemaphoreGive(mutex);
+}
+
+void LightEngine::set(Output output, uint8_t brightness, bool blink) {
+    if (!started || output >= OUTPUT_COUNT) return;
+    if (brightness > 100) brightness = 100;
+    blink = blink && brightness > 0;
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    OutputState& state = outputs[output];
+    if (state.brightness == brightness && state.blink == blink) {
+        xSemaphoreGive(mutex);
+        return;
+    }
+
+    if (blink) {
+        if (!state.blink) ledc_bind_channel_timer(SPEED_MODE, state.channel, BLINK_TIMER);
+        ledc_set_duty_and_update(SPEED_MODE, state.channel, 1UL << (blinkResolutionBits - 1), 0);
+    } else {
+        if (state.blink) {
+            // Powrót na timer PWM - rampa od zera
+            ledc_set_duty_and_update(SPEED_MODE, state.channel, 0, 0);
+            ledc_bind_channel_timer(SPEED_MODE, state.channel, PWM_TIMER);
+        }
+        uint32_t duty = dutyFor(brightness);
+        if (rampMs > 0) {
+            ledc_set_fade_time_and_start(SPEED_MODE, state.channel, duty, rampMs, LEDC_FADE_NO_WAIT);
+        } else {
+            ledc_set_duty_and_update(SPEED_MODE, state.channel, duty, 0);
+        }
+    }
+
+    state.brightness = brightness;
+    state.blink = blink;
+    xSemaphoreGive(mutex);
+}
+
+void LightEngine::off() {
+    if (!started) return;
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (uint8_t i = 0; i < OUTPUT_COUNT; i++) {
+        // Bez czekania na trwającą rampę - wyjście od razu w stan niski
+        ledc_stop(SPEED_MODE, outputs[i].channel, 0);
+        if (outputs[i].blink) ledc_bind_channel_timer(SPEED_MODE, outputs[i].channel, PWM_TIMER);
+        outputs[i].brightness = 0;
+        outputs[i].blink = false;
+    }
+    xSemaphoreGive(mutex);
+}
+
+uint32_t LightEngine::dutyFor(uint8_t brightness) {
+    // Wypełnienie ~ kwadrat jasności (skala bliższa odczuwanej); 100% - stan wysoki bez przerw
+    const uint32_t fullDuty = 1UL << PWM_RESOLUTION_BITS;
+    if (brightness == 0) return 0;
+    return max((uint32_t)1, fullDuty * brightness * brightness / 10000);
+}
@@ -0,0 +1,112 @@
+#include "OdometerJournal.h"
+#include "Crc32.h"
+
+static const uint16_t READ_CHUNK = 16;   // Wpisy czytane naraz (256 B na stosie)
+
+OdometerJournal::OdometerJournal()
+    : partition(nullptr), sectorCount(0), sector(0), slot(0), empty(true),
+      sectorErases(0), entriesWritten(0) {
+    memset(&last, 0, sizeof(last));
+}
+
+bool OdometerJournal::isValid(const OdometerEntry& entry) {
+    return entry.sequence != 0xFFFFFFFF && entry.crc == crc32(&entry, offsetof(OdometerEntry, crc));
+}
+
+bool OdometerJournal::isErased(const OdometerEntry& entry) {
+    const uint8_t* bytes = (const uint8_t*)&entry;
+    for (size_t i = 0; i < sizeof(entry); i++) {
+        if (bytes[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+bool OdometerJournal::readEntries(uint16_t sector, uint16_t first, OdometerEntry* entries, uint16_t count) {
+    size_t offset = (size_t)sector * SECTOR_SIZE + (size_t)first * sizeof(OdometerEntry);
+    return esp_partition_read(partition, offset, entries, count * sizeof(OdometerEntry)) == ESP_OK;
+}
+
+bool OdometerJournal::begin(const char* label) {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (partition == nullptr || partition->size < 2 * SECTOR_SIZE) {
+        partition = nullptr;    // Zgłaszane przez OdometerManager (isJournalReady)
+        return false;
+    }
+    sectorCount = partition->size / SECTOR_SIZE;
+
+    // Sektor bieżący: ten, którego pierwszy wpis ma najwyższy numer
+    empty = true;
+    for (uint16_t s = 0; s < sectorCount; s++) {
+        OdometerEntry entry;
+        if (!readEntries(s, 0, &entry, 1) || !isValid(entry)) continue;
+        if (empty || entry.sequence > last.sequence) {
+            last = entry;
+            sector = s;
+            empty = false;
+        }
+    }
+
+    if (empty) {
+        sector = 0;
+        slot = 0;
+        return true;
+    }
+
+    // Ostatni poprawny wpis w sektorze bieżącym, zapis od pierwszej pustej pozycji
+    slot = ENTRIES_PER_SECTOR;
+    OdometerEntry entries[READ_CHUNK];
+    for (uint16_t first = 0; first < ENTRIES_PER_SECTOR && slot == ENTRIES_PER_SECTOR; first += READ_CHUNK) {
+        if (!readEntries(sector, first, entries, READ_CHUNK)) break;
+        for (uint16_t i = 0; i < READ_CHUNK; i++) {
+            if (isErased(entries[i])) {
+                slot = first + i;
+                break;
+            }
+            if (isValid(entries[i]) && entries[i].sequence > last.sequence) last = entries[i];
+        }
+    }
+    return true;
+}
+
+bool OdometerJournal::append(uint32_t totalMeters, uint32_t tripMeters) {
+    if (partition == nullptr) return false;
+
+    OdometerEntry entry;
+    entry.sequence = empty ? 0 : last.sequence + 1;
+    entry.totalMeters = totalMeters;
+    entry.tripMeters = tripMeters;
+    entry.crc = crc32(&entry, offsetof(OdometerEntry, crc));
+
+    // Druga próba na kolejnej pozycji, jeśli wpis nie zapisał się poprawnie
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+        if (slot >= ENTRIES_PER_SECTOR) {
+            sector = (sector + 1) % sectorCount;
+            slot = 0;
+        }
+        if (slot == 0) {
+            // Nowy sektor: skasowanie (także po przerwanym wcześniej kasowaniu)
+            if (esp_partition_erase_range(partition, (size_t)sector * SECTOR_SIZE, SECTOR_SIZE) != ESP_OK) {
+                return false;
+            }
+            sectorErases++;
+        }
+
+        size_t offset = (size_t)sector * SECTOR_SIZE + (size_t)slot * sizeof(OdometerEntry);
+        bool firstInSector = slot == 0;
+        slot++;
+        entriesWritten++;
+
+        OdometerEntry written;
+        if (esp_partition_write(partition, offset, &entry, sizeof(entry)) == ESP_OK &&
+            esp_partition_read(partition, offset, &written, sizeof(written)) == ESP_OK &&
+            memcmp(&written, &entry, sizeof(entry)) == 0) {
+            last = entry;
+            empty = false;
+            return true;
+        }
+
+        // Sektor jest rozpoznawany po pierwszym wpisie - bez niego przejście do następnego
+        if (firstInSector) slot = ENTRIES_PER_SECTOR;
+    }
+    return false;
+}
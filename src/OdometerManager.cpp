@@ -1,98 +1,136 @@
-#include "OdometerManager.h"
-
-OdometerManager::OdometerManager() {
-    odometer = new Odometer();
-    preferences.begin(PREF_NAMESPACE, false);
-}
-
-OdometerManager::~OdometerManager() {
-    delete odometer;
-}
-
-void OdometerManager::begin() {
-    assert(odometer != nullptr);  // Dodaj asercję dla bezpieczeństwa
-    loadFromPreferences();
-    
-    // Inicjalizacja ostatnich zapisanych wartości
-    lastSavedTotal = odometer->getTotalDistance();
-    lastSavedTrip = odometer->getTripDistance();
-    lastSaveTime = millis();
-}
-
-void OdometerManager::update() {
-    assert(odometer != nullptr);
-    
-    odometer->update();
-    
-    float currentTotal = odometer->getTotalDistance();
-    float currentTrip = odometer->getTripDistance();
-    unsigned long currentTime = millis();
-    
-    bool shouldSave = false;
-    
-    if (currentTime - lastSaveTime >= SAVE_INTERVAL) {
-        shouldSave = true;
-    }
-    
-    if (abs(currentTotal - lastSavedTotal) >= DISTANCE_THRESHOLD ||
-        abs(currentTrip - lastSavedTrip) >= DISTANCE_THRESHOLD) {
-        shouldSave = true;
-    }
-    
-    if (shouldSave) {
-        saveToPreferences();
-        lastSaveTime = currentTime;
-        lastSavedTotal = currentTotal;
-        lastSavedTrip = currentTrip;
-    }
-}
-
-float OdometerManager::getTotalDistance() const {
-    assert(odometer != nullptr);
-    return odometer->getTotalDistance();
-}
-
-float OdometerManager::getTripDistance() const {
-    assert(odometer != nullptr);
-    return odometer->getTripDistance();
-}
-
-void OdometerManager::resetTrip() {
-    assert(odometer != nullptr);
-    odometer->resetTrip();
-    saveToPreferences();
-    lastSavedTrip = 0.0f;
-    lastSaveTime = millis();
-}
-
-void OdometerManager::calibrate(float actualDistance) {
-    assert(odometer != nullptr);
-    odometer->calibrate(actualDistance);
-    saveToPreferences();
-    lastSavedTotal = odometer->getTotalDistance();
-    lastSavedTrip = odometer->getTripDistance();
-    lastSaveTime = millis();
-}
-
-void OdometerManager::saveToPreferences() {
-    assert(odometer != nullptr);
-    preferences.putFloat(TOTAL_DISTANCE_KEY, odometer->getTotalDistance());
-    preferences.putFloat(TRIP_DISTANCE_KEY, odometer->getTripDistance());
-}
-
-void OdometerManager::loadFromPreferences() {
-    assert(odometer != nullptr);
-    float totalDistance = preferences.getFloat(TOTAL_DISTANCE_KEY, 0.0f);
-    float tripDistance = preferences.getFloat(TRIP_DISTANCE_KEY, 0.0f);
-    
-    odometer->setTotalDistance(totalDistance);
-    odometer->setTripDistance(tripDistance);
-}
-
-void OdometerManager::forceSave() {
-    assert(odometer != nullptr);
-    saveToPreferences();
-    lastSavedTotal = odometer->getTotalDistance();
-    lastSavedTrip = odometer->getTripDistance();
-    lastSaveTime = millis();
-}
\ No newline at end of file
+#include "OdometerManager.h"
+
+void OdometerManager::lock() {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void OdometerManager::unlock() {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+void OdometerManager::begin() {
+    if (mutex == nullptr) mutex = xSemaphoreCreateMutex();
+    preferences.begin(PREF_NAMESPACE, false);
+
+    lock();
+    journalReady = journal.begin(PARTITION_LABEL);
+    if (journalReady && !journal.isEmpty()) {
+        totalMeters = journal.getTotalMeters();
+        tripMeters = journal.getTripMeters();
+    } else {
+        loadFromPreferences();
+
+        // Przeniesienie stanu do dziennika, potem klucze NVS nie są już potrzebne
+        if (journalReady && journal.append(totalMeters, tripMeters)) {
+            preferences.remove(TOTAL_DISTANCE_KEY);
+            preferences.remove(TRIP_DISTANCE_KEY);
+            preferences.remove(TOTAL_METERS_KEY);
+            preferences.remove(TRIP_METERS_KEY);
+        }
+    }
+
+    // Inicjalizacja ostatnich zapisanych wartości
+    savedTotal = totalMeters;
+    savedTrip = tripMeters;
+    lastSaveTime = millis();
+    unlock();
+}
+
+void OdometerManager::update() {
+    uint32_t total = totalMeters;
+    uint32_t trip = tripMeters;
+    if (total == savedTotal && trip == savedTrip) return;
+
+    unsigned long currentTime = millis();
+    if (total - savedTotal >= SAVE_DISTANCE || currentTime - lastSaveTime >= SAVE_INTERVAL) {
+        lock();
+        save();
+        unlock();
+    }
+}
+
+void OdometerManager::shutdown() {
+    lock();
+    if (totalMeters != savedTotal || tripMeters != savedTrip) save();
+    unlock();
+}
+
+void OdometerManager::addDistance(uint32_t meters) {
+    // Blokada, bo resetTrip i setTotalDistance są wywoływane z obsługi HTTP
+    lock();
+    totalMeters = totalMeters + meters;
+    tripMeters = tripMeters + meters;
+    unlock();
+}
+
+float OdometerManager::getTotalDistance() const {
+    return totalMeters / 1000.0f;
+}
+
+float OdometerManager::getTripDistance() const {
+    return tripMeters / 1000.0f;
+}
+
+bool OdometerManager::resetTrip() {
+    lock();
+    tripMeters = 0;
+    bool saved = save();
+    unlock();
+    return saved;
+}
+
+OdometerSetResult OdometerManager::setTotalDistance(float kilometers) {
+    if (isnan(kilometers) || kilometers < 0.0f || kilometers >= UINT32_MAX / 1000.0f) return ODOMETER_SET_INVALID;
+
+    lock();
+    totalMeters = (uint32_t)lroundf(kilometers * 1000.0f);
+    bool saved = save();
+    unlock();
+    return saved ? ODOMETER_SET_OK : ODOMETER_SET_SAVE_FAILED;
+}
+
+bool OdometerManager::save() {
+    uint32_t total = totalMeters;
+    uint32_t trip = tripMeters;
+
+    bool saved;
+    if (journalReady) {
+        saved = journal.append(total, trip);
+    } else {
+        saved = preferences.putUInt(TOTAL_METERS_KEY, total) > 0 &&
+                preferences.putUInt(TRIP_METERS_KEY, trip) > 0;
+    }
+
+    // Po błędzie kolejna próba dopiero po SAVE_INTERVAL lub SAVE_DISTANCE
+    lastSaveTime = millis();
+    savedTotal = total;
+    savedTrip = trip;
+
+    if (!saved) saveErrors++;
+    return saved;
+}
+
+void OdometerManager::printReport(Print& out) const {
+    out.printf("Licznik: %lu m, podróż %lu m\n", (unsigned long)totalMeters, (unsigned long)tripMeters);
+    if (journalReady) {
+        out.printf("  dziennik: %lu wpisów, %lu kasowań sektorów, błędy zapisu: %lu\n",
+                   (unsigned long)journal.getEntriesWritten(), (unsigned long)journal.getSectorErases(),
+                   (unsigned long)saveErrors);
+    } else {
+        out.printf("  NVS (brak partycji \"%s\"), błędy zapisu: %lu\n", PARTITION_LABEL, (unsigned long)saveErrors);
+    }
+}
+
+void OdometerManager::loadFromPreferences() {
+    if (preferences.isKey(TOTAL_METERS_KEY)) {
+        totalMeters = preferences.getUInt(TOTAL_METERS_KEY, 0);
+        tripMeters = preferences.getUInt(TRIP_METERS_KEY, 0);
+        return;
+    }
+
+    // Dawny zapis w km jako float
+    float totalDistance = preferences.getFloat(TOTAL_DISTANCE_KEY, 0.0f);
+    float tripDistance = preferences.getFloat(TRIP_DISTANCE_KEY, 0.0f);
+    totalMeters = (isnan(totalDistance) || totalDistance < 0.0f) ? 0 : (uint32_t)lroundf(totalDistance * 1000.0f);
+    tripMeters = (isnan(tripDistance) || tripDistance < 0.0f) ? 0 : (uint32_t)lroundf(tripDistance * 1000.0f);
+}
@@ -0,0 +1,101 @@
+#include "OneWireBench.h"
+#include <OneWire.h>
+
+namespace {
+    const uint8_t CMD_READ_SCRATCHPAD = 0xBE;
+    const uint8_t SCRATCHPAD_SIZE = 9;
+
+    // Górne granice przedziałów opóźnienia [us], ostatni przedział bez granicy
+    const uint16_t BUCKET_LIMITS_US[OneWireBench::BUCKETS - 1] = {2, 5, 10, 20, 50};
+
+    hw_timer_t* benchTimer = nullptr;
+    volatile uint32_t interruptCount = 0;
+    volatile uint32_t maxLatencyUs = 0;
+    volatile uint32_t histogram[OneWireBench::BUCKETS];
+
+    void IRAM_ATTR onBenchTimer() {
+        // Licznik zerowany przy alarmie (autoreload), 1 takt = 1 us
+        uint32_t latency = (uint32_t)timerRead(benchTimer);
+        uint8_t bucket = 0;
+        while (bucket < OneWireBench::BUCKETS - 1 && latency >= BUCKET_LIMITS_US[bucket]) bucket++;
+        histogram[bucket]++;
+        if (latency > maxLatencyUs) maxLatencyUs = latency;
+        interruptCount++;
+    }
+
+    template<typename Wire>
+    bool readScratchPad(Wire& wire, const uint8_t* rom, uint8_t* data) {
+        if (!wire.reset()) return false;
+        wire.select(rom);
+        wire.write(CMD_READ_SCRATCHPAD);
+        wire.read_bytes(data, SCRATCHPAD_SIZE);
+        return Wire::crc8(data, SCRATCHPAD_SIZE - 1) == data[SCRATCHPAD_SIZE - 1];
+    }
+}
+
+template<typename Wire>
+void OneWireBench::runPhase(Wire& wire, const uint8_t* rom, Result& result) {
+    memset(&result, 0, sizeof(result));
+    interruptCount = 0;
+    maxLatencyUs = 0;
+    for (uint8_t i = 0; i < BUCKETS; i++) histogram[i] = 0;
+
+    benchTimer = timerBegin(TIMER_NUMBER, 80, true);
+    timerAttachInterrupt(benchTimer, onBenchTimer, true);
+    timerAlarmWrite(benchTimer, PERIOD_US, true);
+    timerAlarmEnable(benchTimer);
+
+    uint32_t start = millis();
+    while (millis() - start < PHASE_MS) {
+        uint8_t data[SCRATCHPAD_SIZE];
+        uint32_t readStart = micros();
+        if (!readScratchPad(wire, rom, data)) result.readErrors++;
+        result.readMicros += micros() - readStart;
+        result.reads++;
+    }
+
+    timerAlarmDisable(benchTimer);
+    timerDetachInterrupt(benchTimer);
+    timerEnd(benchTimer);
+    benchTimer = nullptr;
+
+    result.interrupts = interruptCount;
+    result.maxLatencyUs = maxLatencyUs;
+    for (uint8_t i = 0; i < BUCKETS; i++) result.histogram[i] = histogram[i];
+}
+
+bool OneWireBench::measure(RmtOneWire& wire, const uint8_t* rom, Result& bitBang, Result& rmt) {
+    if (rom == nullptr) return false;
+    {
+        // Biblioteka OneWire przejmuje pin (pinMode) - potem z powrotem do RMT
+        OneWire library(wire.getPin());
+        runPhase(library, rom, bitBang);
+    }
+    wire.begin();
+    runPhase(wire, rom, rmt);
+    return true;
+}
+
+void OneWireBench::run(RmtOneWire& wire, const uint8_t* rom, Print& out) {
+    Result bitBang, rmt;
+    if (!measure(wire, rom, bitBang, rmt)) {
+        out.println("owbench: brak czujnika na magistrali");
+        return;
+    }
+
+    out.printf("owbench: przerwanie co %u us, %u ms na wariant, GPIO %u\n",
+               (unsigned)PERIOD_US, (unsigned)PHASE_MS, wire.getPin());
+    printResult("OneWire (bit po bicie)", bitBang, out);
+    printResult("RMT", rmt, out);
+}
+
+void OneWireBench::printResult(const char* name, const Result& result, Print& out) {
+    out.printf("  %s: odczyty %u (błędy %u), śr. %u us/odczyt\n", name, (unsigned)result.reads,
+               (unsigned)result.readErrors, (unsigned)(result.reads ? result.readMicros / result.reads : 0));
+    out.printf("    opóźnienie przerwania: maks. %u us, przerwania %u (", (unsigned)result.maxLatencyUs,
+               (unsigned)result.interrupts);
+    for (uint8_t i = 0; i < BUCKETS - 1; i++) {
+        out.printf("<%u us: %u, ", BUCKET_LIMITS_US[i], (unsigned)result.histogram[i]);
+    }
+    out.printf(">=%u us: %u)\n", BUCKET_LIMITS_US[BUCKETS - 2], (unsigned)result.histogram[BUCKETS - 1]);
+}
@@ -0,0 +1,116 @@
+#include "PerfMonitor.h"
+
+#if PERF_ENABLED
+
+PerfMonitor perfMonitor;
+
+static const char* const SECTION_NAMES[PERF_SECTION_COUNT] = {
+    "display", "render", "buttons", "temperature", "odometer", "bms", "websocket"
+};
+
+PerfMonitor::PerfMonitor() {
+    reset();
+}
+
+void PerfMonitor::begin() {
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    if (mhz > 0) cyclesPerUs = mhz;
+}
+
+void PerfMonitor::record(PerfSection section, uint32_t cycles) {
+    if (section >= PERF_SECTION_COUNT) return;
+    uint8_t bucket = bucketFor(cycles / cyclesPerUs);
+
+    portENTER_CRITICAL(&lock);
+    Section& s = sections[section];
+    s.count++;
+    s.lastCycles = cycles;
+    if (cycles < s.minCycles) s.minCycles = cycles;
+    if (cycles > s.maxCycles) s.maxCycles = cycles;
+    s.totalCycles += cycles;
+    s.buckets[bucket]++;
+    portEXIT_CRITICAL(&lock);
+}
+
+void PerfMonitor::reset() {
+    portENTER_CRITICAL(&lock);
+    memset(sections, 0, sizeof(sections));
+    for (uint8_t i = 0; i < PERF_SECTION_COUNT; i++) {
+        sections[i].minCycles = UINT32_MAX;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+PerfStats PerfMonitor::getStats(PerfSection section) const {
+    PerfStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (section >= PERF_SECTION_COUNT) return stats;
+
+    // Kopia pod blokadą, przeliczenia już poza nią
+    portENTER_CRITICAL(&lock);
+    Section s = sections[section];
+    portEXIT_CRITICAL(&lock);
+
+    if (s.count == 0) return stats;
+
+    stats.count = s.count;
+    stats.lastUs = s.lastCycles / cyclesPerUs;
+    stats.minUs = s.minCycles / cyclesPerUs;
+    stats.maxUs = s.maxCycles / cyclesPerUs;
+    stats.avgUs = (uint32_t)(s.totalCycles / s.count / cyclesPerUs);
+    memcpy(stats.buckets, s.buckets, sizeof(stats.buckets));
+
+    stats.p50Us = percentile(s.buckets, s.count, 50, stats.maxUs);
+    stats.p90Us = percentile(s.buckets, s.count, 90, stats.maxUs);
+    stats.p99Us = percentile(s.buckets, s.count, 99, stats.maxUs);
+    return stats;
+}
+
+void PerfMonitor::printReport(Print& out) const {
+    out.println("sekcja        liczba   ost.   min    śr.    p50    p90    p99    max [us]");
+    for (uint8_t i = 0; i < PERF_SECTION_COUNT; i++) {
+        PerfStats s = getStats((PerfSection)i);
+        out.printf("%-12s %7u %6u %6u %6u %6u %6u %6u %6u\n",
+                   SECTION_NAMES[i], s.count, s.lastUs, s.minUs, s.avgUs,
+                   s.p50Us, s.p90Us, s.p99Us, s.maxUs);
+    }
+}
+
+const char* PerfMonitor::getSectionName(PerfSection section) {
+    return section < PERF_SECTION_COUNT ? SECTION_NAMES[section] : "";
+}
+
+uint32_t PerfMonitor::getBucketLowerBound(uint8_t bucket) {
+    return bucket == 0 ? 0 : 1UL << bucket;
+}
+
+uint8_t PerfMonitor::bucketFor(uint32_t us) {
+    // Indeks najstarszego ustawionego bitu
+    uint8_t bucket = 0;
+    while (us > 1 && bucket < PERF_BUCKET_COUNT - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+uint32_t PerfMonitor::bucketUpperBound(uint8_t bucket) {
+    return 1UL << (bucket + 1);
+}
+
+uint32_t PerfMonitor::percentile(const uint32_t* buckets, uint32_t count, uint8_t percent, uint32_t maxUs) {
+    uint32_t target = ((uint64_t)count * percent + 99) / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < PERF_BUCKET_COUNT; i++) {
+        cumulative += buckets[i];
+        if (cumulative >= target) {
+            // Ostatni przedział jest otwarty - jego granicą jest maksimum
+            if (i == PERF_BUCKET_COUNT - 1) return maxUs;
+            uint32_t bound = bucketUpperBound(i);
+            return bound < maxUs ? bound : maxUs;
+        }
+    }
+    return maxUs;
+}
+
+#endif // PERF_ENABLED
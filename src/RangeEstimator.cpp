@@ -0,0 +1,118 @@
+#include "RangeEstimator.h"
+#include "Crc32.h"
+
+// Od braku wspomagania (tylko elektronika i światła) do najwyższego poziomu
+const float RangeEstimator::DEFAULT_WH_PER_KM[RangeEstimator::LEVELS] = {1.0f, 6.0f, 8.0f, 10.0f, 13.0f, 16.0f};
+
+// Pamięć RTC slow nie jest zerowana przy wybudzeniu z głębokiego uśpienia
+struct RangeSlot {
+    uint32_t magic;
+    float whPerKm[RangeEstimator::LEVELS];
+    uint16_t segments[RangeEstimator::LEVELS];
+    uint32_t crc;
+};
+
+static const uint32_t RANGE_SLOT_MAGIC = 0x45574D50;  // "PMWE"
+
+RTC_DATA_ATTR static RangeSlot rangeSlot;
+
+RangeEstimator::RangeEstimator() : pendingMwh(0) {
+    for (uint8_t i = 0; i < LEVELS; i++) {
+        whPerKm[i] = DEFAULT_WH_PER_KM[i];
+        segments[i] = 0;
+    }
+}
+
+void RangeEstimator::addPowerSample(float voltage, float current, uint32_t nowMs) {
+    float powerW = -voltage * current;
+
+    // Całkowanie metodą trapezów między kolejnymi ramkami BMS
+    if (hasSample && nowMs - lastSampleMs <= MAX_SAMPLE_GAP_MS) {
+        // W * ms / 3600 = mWh
+        residualMwh += (lastPowerW + powerW) * 0.5f * (float)(nowMs - lastSampleMs) / 3600.0f;
+        int32_t whole = (int32_t)residualMwh;
+        if (whole != 0) {
+            residualMwh -= whole;
+            pendingMwh.fetch_add(whole, std::memory_order_relaxed);
+        }
+    }
+
+    lastPowerW = powerW;
+    lastSampleMs = nowMs;
+    hasSample = true;
+}
+
+void RangeEstimator::update(uint32_t meters, uint8_t assistLevel, uint32_t nowMs) {
+    int32_t energyMwh = pendingMwh.exchange(0, std::memory_order_relaxed);
+    if (assistLevel >= LEVELS) assistLevel = LEVELS - 1;
+
+    if (meters > 0) {
+        lastMoveMs = nowMs;
+    } else if (nowMs - lastMoveMs > STANDSTILL_MS) {
+        return;
+    }
+
+    // Zmiana poziomu - niepełny odcinek jest porzucany
+    if (assistLevel != segmentLevel) {
+        segmentLevel = assistLevel;
+        segmentMwh = 0;
+        segmentMeters = 0;
+    }
+
+    segmentMwh += energyMwh;
+    segmentMeters += meters;
+    if (segmentMeters >= SEGMENT_METERS) closeSegment();
+}
+
+void RangeEstimator::closeSegment() {
+    // mWh / m = Wh/km
+    float sample = (float)segmentMwh / (float)segmentMeters;
+    segmentMwh = 0;
+    segmentMeters = 0;
+
+    // Odzysk energii z górki - najmniejsze zużycie; nierealnie duże - błąd danych
+    if (sample > MAX_WH_PER_KM) return;
+    if (sample < MIN_WH_PER_KM) sample = MIN_WH_PER_KM;
+
+    uint16_t& count = segments[segmentLevel];
+    if (count < 0xFFFF) count++;
+    uint16_t weight = count < WARMUP_SEGMENTS ? count : WARMUP_SEGMENTS;
+    whPerKm[segmentLevel] += (sample - whPerKm[segmentLevel]) / weight;
+}
+
+float RangeEstimator::estimateKm(float remainingWh, uint8_t assistLevel) const {
+    if (remainingWh <= 0) return 0;
+    return remainingWh / getWhPerKm(assistLevel);
+}
+
+float RangeEstimator::getWhPerKm(uint8_t assistLevel) const {
+    return whPerKm[assistLevel < LEVELS ? assistLevel : LEVELS - 1];
+}
+
+uint16_t RangeEstimator::getSegments(uint8_t assistLevel) const {
+    return segments[assistLevel < LEVELS ? assistLevel : LEVELS - 1];
+}
+
+void RangeEstimator::printReport(Print& out) const {
+    out.printf("Zużycie energii (poziom wspomagania: Wh/km, liczba odcinków po %u m):\n", (unsigned)SEGMENT_METERS);
+    for (uint8_t i = 0; i < LEVELS; i++) {
+        out.printf("  %u: %5.1f Wh/km (%u)\n", i, whPerKm[i], segments[i]);
+    }
+}
+
+void RangeEstimator::store() const {
+    rangeSlot.magic = RANGE_SLOT_MAGIC;
+    memcpy(rangeSlot.whPerKm, whPerKm, sizeof(whPerKm));
+    memcpy(rangeSlot.segments, segments, sizeof(segments));
+    rangeSlot.crc = crc32(&rangeSlot, offsetof(RangeSlot, crc));
+}
+
+bool RangeEstimator::restore() {
+    // Po włączeniu zasilania pamięć RTC zawiera przypadkowe dane
+    if (rangeSlot.magic != RANGE_SLOT_MAGIC || crc32(&rangeSlot, offsetof(RangeSlot, crc)) != rangeSlot.crc) {
+        return false;
+    }
+    memcpy(whPerKm, rangeSlot.whPerKm, sizeof(whPerKm));
+    memcpy(segments, rangeSlot.segments, sizeof(segments));
+    return true;
+}
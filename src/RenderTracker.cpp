@@ -0,0 +1,143 @@
+#include "RenderTracker.h"
+
+// Parametry FNV-1a
+static const uint32_t FNV_OFFSET = 2166136261UL;
+static const uint32_t FNV_PRIME = 16777619UL;
+
+RenderTracker::RenderTracker(const TileRect* widgetAreas, unsigned long minFrameIntervalMs)
+    : minFrameInterval(minFrameIntervalMs) {
+    memcpy(areas, widgetAreas, sizeof(areas));
+    memset(sent, 0, sizeof(sent));
+    memset(&stats, 0, sizeof(stats));
+    beginFrame();
+}
+
+void RenderTracker::beginFrame() {
+    for (uint8_t i = 0; i < WIDGET_COUNT; i++) {
+        current[i] = FNV_OFFSET;
+    }
+}
+
+void RenderTracker::touch(DisplayWidget widget, const char* text) {
+    if (widget >= WIDGET_COUNT || text == nullptr) return;
+    // Separator, aby "ab"+"c" różniło się od "a"+"bc"
+    current[widget] = hashBytes(current[widget], (const uint8_t*)text, strlen(text) + 1);
+}
+
+void RenderTracker::touch(DisplayWidget widget, uint32_t value) {
+    if (widget >= WIDGET_COUNT) return;
+    current[widget] = hashBytes(current[widget], (const uint8_t*)&value, sizeof(value));
+}
+
+bool RenderTracker::flush(U8G2& display, unsigned long now) {
+    updateWindow(now);
+
+    // Ograniczenie liczby klatek - zmiany poczekają do następnego wywołania
+    if (lastFlushTime != 0 && now - lastFlushTime < minFrameInterval) {
+        return false;
+    }
+
+    if (fullRefresh) {
+        uint32_t start = micros();
+        display.sendBuffer();
+        uint32_t elapsed = micros() - start;
+
+        uint32_t bytes = (uint32_t)TILE_COLUMNS * TILE_ROWS * BYTES_PER_TILE;
+        stats.frames++;
+        stats.fullFrames++;
+        stats.bytesSent += bytes;
+        stats.i2cTimeUs += elapsed;
+        windowFrames++;
+        windowBytes += bytes;
+        windowI2cUs += elapsed;
+
+        memcpy(sent, current, sizeof(sent));
+        fullRefresh = false;
+        lastFlushTime = now;
+        return true;
+    }
+
+    // Mapa zmienionych kafelków: bit x w wierszu y
+    uint16_t dirtyRows[TILE_ROWS] = {0};
+    bool anyDirty = false;
+
+    for (uint8_t i = 0; i < WIDGET_COUNT; i++) {
+        if (current[i] == sent[i]) continue;
+
+        const TileRect& area = areas[i];
+        uint16_t columns = (uint16_t)(((1UL << area.w) - 1) << area.x);
+        for (uint8_t y = area.y; y < area.y + area.h && y < TILE_ROWS; y++) {
+            dirtyRows[y] |= columns;
+        }
+        sent[i] = current[i];
+        anyDirty = true;
+    }
+
+    if (!anyDirty) {
+        stats.skippedFrames++;
+        return false;
+    }
+
+    // Wysyłaj jeden ciągły zakres kafelków na wiersz
+    uint32_t bytes = 0;
+    uint32_t start = micros();
+    for (uint8_t y = 0; y < TILE_ROWS; y++) {
+        uint16_t row = dirtyRows[y];
+        if (row == 0) continue;
+
+        uint8_t first = 0;
+        while (!(row & (1 << first))) first++;
+        uint8_t last = TILE_COLUMNS - 1;
+        while (!(row & (1 << last))) last--;
+
+        uint8_t width = last - first + 1;
+        display.updateDisplayArea(first, y, width, 1);
+        bytes += (uint32_t)width * BYTES_PER_TILE;
+    }
+    uint32_t elapsed = micros() - start;
+
+    stats.frames++;
+    stats.bytesSent += bytes;
+    stats.i2cTimeUs += elapsed;
+    windowFrames++;
+    windowBytes += bytes;
+    windowI2cUs += elapsed;
+
+    lastFlushTime = now;
+    return true;
+}
+
+void RenderTracker::invalidate() {
+    fullRefresh = true;
+}
+
+RenderStats RenderTracker::getStats() const {
+    return stats;
+}
+
+uint32_t RenderTracker::hashBytes(uint32_t hash, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+void RenderTracker::updateWindow(unsigned long now) {
+    if (windowStart == 0) {
+        windowStart = now;
+        return;
+    }
+
+    unsigned long elapsed = now - windowStart;
+    if (elapsed < STATS_WINDOW_MS) return;
+
+    stats.framesPerSecond = windowFrames * 1000.0f / elapsed;
+    stats.bytesPerSecond = (uint32_t)((uint64_t)windowBytes * 1000 / elapsed);
+    stats.i2cUsPerSecond = (uint32_t)((uint64_t)windowI2cUs * 1000 / elapsed);
+
+    windowStart = now;
+    windowFrames = 0;
+    windowBytes = 0;
+    windowI2cUs = 0;
+}
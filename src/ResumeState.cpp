@@ -0,0 +1,31 @@
+#include "ResumeState.h"
+#include "Crc32.h"
+
+// Pamięć RTC slow nie jest zerowana przy wybudzeniu z głębokiego uśpienia
+struct ResumeSlot {
+    uint32_t magic;
+    ResumeData data;
+    uint32_t crc;
+};
+
+RTC_DATA_ATTR static ResumeSlot resumeSlot;
+
+void ResumeState::store(const ResumeData& data) {
+    resumeSlot.magic = MAGIC;
+    resumeSlot.data = data;
+    resumeSlot.crc = crc32(&resumeSlot.data, sizeof(resumeSlot.data));
+}
+
+bool ResumeState::restore(ResumeData& data) {
+    // Po włączeniu zasilania pamięć RTC zawiera przypadkowe dane
+    if (resumeSlot.magic != MAGIC ||
+        crc32(&resumeSlot.data, sizeof(resumeSlot.data)) != resumeSlot.crc) {
+        return false;
+    }
+    data = resumeSlot.data;
+    return true;
+}
+
+void ResumeState::invalidate() {
+    resumeSlot.magic = 0;
+}
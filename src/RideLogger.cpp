@@ -0,0 +1,258 @@
+#include "RideLogger.h"
+#include "Crc32.h"
+
+static const char* const RIDES_DIR = "/rides";
+
+// Zaokrąglenie z obcięciem do zakresu typu docelowego
+static int32_t scaled(float value, float scale, int32_t minValue, int32_t maxValue) {
+    if (isnan(value)) return 0;
+    float result = roundf(value * scale);
+    if (result < minValue) return minValue;
+    if (result > maxValue) return maxValue;
+    return (int32_t)result;
+}
+
+// Numer segmentu z nazwy "NNNNN.bin" (false dla innych plików)
+static bool parseSegmentName(const char* name, uint32_t& segment) {
+    const char* slash = strrchr(name, '/');
+    if (slash) name = slash + 1;
+
+    uint32_t value = 0;
+    uint8_t digits = 0;
+    while (*name >= '0' && *name <= '9') {
+        value = value * 10 + (*name - '0');
+        name++;
+        digits++;
+    }
+    if (digits == 0 || strcmp(name, ".bin") != 0) return false;
+    segment = value;
+    return true;
+}
+
+RideLogger::RideLogger()
+    : fs(nullptr), mutex(nullptr), head(0), count(0), firstSegment(0), lastSegment(0),
+      segmentRecords(0), sequence(0), startPending(true), timeBase(0), timeBaseMillis(0),
+      lastSample(0), lastFlush(0), recordsWritten(0), recordsDropped(0) {
+}
+
+void RideLogger::lock() {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+}
+
+void RideLogger::unlock() {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+bool RideLogger::isValid(const RideRecord& record) {
+    return record.crc == crc32(&record, offsetof(RideRecord, crc));
+}
+
+void RideLogger::getSegmentPath(uint32_t segment, char* path, size_t length) {
+    snprintf(path, length, "%s/%05lu.bin", RIDES_DIR, (unsigned long)segment);
+}
+
+bool RideLogger::begin(fs::FS& fileSystem) {
+    fs = &fileSystem;
+    if (mutex == nullptr) mutex = xSemaphoreCreateMutex();
+
+    if (!fs->exists(RIDES_DIR)) fs->mkdir(RIDES_DIR);
+    File dir = fs->open(RIDES_DIR);
+    if (!dir || !dir.isDirectory()) {
+        fs = nullptr;       // Zapis wyłączony - isReady()
+        return false;
+    }
+
+    // Zakres segmentów i zajętość ostatniego
+    bool found = false;
+    size_t lastSize = 0;
+    File entry = dir.openNextFile();
+    while (entry) {
+        uint32_t segment;
+        if (!entry.isDirectory() && parseSegmentName(entry.name(), segment)) {
+            if (!found || segment < firstSegment) firstSegment = segment;
+            if (!found || segment >= lastSegment) {
+                lastSegment = segment;
+                lastSize = entry.size();
+            }
+            found = true;
+        }
+        entry = dir.openNextFile();
+    }
+
+    if (!found) {
+        firstSegment = lastSegment = 0;
+        segmentRecords = 0;
+    } else if (lastSize % sizeof(RideRecord) != 0 || lastSize >= SEGMENT_RECORDS * sizeof(RideRecord)) {
+        // Przerwany zapis lub pełny segment - dalsze próbki w nowym pliku
+        lastSegment++;
+        segmentRecords = 0;
+    } else {
+        segmentRecords = lastSize / sizeof(RideRecord);
+    }
+
+    lock();
+    removeOldSegments();
+    unlock();
+    return true;
+}
+
+void RideLogger::setTime(uint32_t unixTime, unsigned long now) {
+    lock();
+    timeBase = unixTime;
+    timeBaseMillis = now;
+    unlock();
+}
+
+void RideLogger::quantize(const TelemetrySnapshot& t, RideRecord& record) {
+    record.speed = scaled(t.speed_kmh, 10.0f, 0, UINT16_MAX);
+    record.cadence = scaled(t.cadence_rpm, 1.0f, 0, UINT16_MAX);
+    record.power = scaled(t.power_w, 1.0f, INT16_MIN, INT16_MAX);
+    record.voltage = scaled(t.battery_voltage, 100.0f, 0, UINT16_MAX);
+    record.current = scaled(t.battery_current, 100.0f, INT16_MIN, INT16_MAX);
+    record.tempAir = scaled(t.temp_air, 10.0f, INT16_MIN, INT16_MAX);
+    record.tempController = scaled(t.temp_controller, 10.0f, INT16_MIN, INT16_MAX);
+    record.tempMotor = scaled(t.temp_motor, 10.0f, INT16_MIN, INT16_MAX);
+    record.pressureFront = scaled(t.pressure_bar, 100.0f, 0, UINT16_MAX);
+    record.pressureRear = scaled(t.pressure_rear_bar, 100.0f, 0, UINT16_MAX);
+    record.battery = scaled(t.battery_capacity_percent, 1.0f, 0, 100);
+}
+
+void RideLogger::sample(const TelemetrySnapshot& t, unsigned long now) {
+    if (fs == nullptr) return;
+    if (!startPending && now - lastSample < SAMPLE_INTERVAL_MS) return;
+    lastSample = now;
+
+    lock();
+    if (count == BUFFER_RECORDS) {
+        // Bufor pełny (zapis się nie udaje) - tracimy najstarszą próbkę
+        head = (head + 1) % BUFFER_RECORDS;
+        count--;
+        recordsDropped++;
+    }
+
+    RideRecord& record = buffer[(head + count) % BUFFER_RECORDS];
+    memset(&record, 0, sizeof(record));
+    record.timestamp = timeBase + (now - timeBaseMillis) / 1000;
+    quantize(t, record);
+    record.flags = startPending ? RIDE_FLAG_START : 0;
+    record.sequence = sequence++;
+    record.crc = crc32(&record, offsetof(RideRecord, crc));
+    count++;
+    startPending = false;
+
+    bool flushDue = count >= FLUSH_RECORDS || now - lastFlush >= FLUSH_INTERVAL_MS;
+    unlock();
+
+    if (flushDue) flush();
+}
+
+bool RideLogger::flush() {
+    if (fs == nullptr) return false;
+
+    lock();
+    bool ok = writeBuffered();
+    lastFlush = millis();
+    unlock();
+    return ok;
+}
+
+// Dopisanie bufora do segmentów (wywoływane pod blokadą)
+bool RideLogger::writeBuffered() {
+    while (count > 0) {
+        if (segmentRecords >= SEGMENT_RECORDS) {
+            lastSegment++;
+            segmentRecords = 0;
+            removeOldSegments();
+        }
+
+        char path[24];
+        getSegmentPath(lastSegment, path, sizeof(path));
+        File file = fs->open(path, "a");
+        if (!file) return false;
+
+        // Jeden plik otwierany raz na partię, zapis ciągłymi fragmentami bufora
+        while (count > 0 && segmentRecords < SEGMENT_RECORDS) {
+            uint16_t records = BUFFER_RECORDS - head;
+            if (records > count) records = count;
+            if (records > SEGMENT_RECORDS - segmentRecords) records = SEGMENT_RECORDS - segmentRecords;
+
+            size_t length = records * sizeof(RideRecord);
+            size_t written = file.write((const uint8_t*)&buffer[head], length);
+            if (written != length) records = written / sizeof(RideRecord);
+
+            // Rekordy zapisane w całości nie zostają w buforze (bez duplikatów)
+            head = (head + records) % BUFFER_RECORDS;
+            count -= records;
+            segmentRecords += records;
+            recordsWritten += records;
+
+            if (written != length) {
+                // Niepełny rekord na końcu pliku (pomijany przy odczycie) - reszta
+                // bufora w kolejnej partii, w nowym segmencie
+                file.close();
+                segmentRecords = SEGMENT_RECORDS;
+                return false;
+            }
+        }
+        file.close();
+    }
+    return true;
+}
+
+// Usunięcie najstarszych segmentów ponad limit (wywoływane pod blokadą)
+void RideLogger::removeOldSegments() {
+    char path[24];
+    while (lastSegment - firstSegment >= MAX_SEGMENTS) {
+        getSegmentPath(firstSegment, path, sizeof(path));
+        fs->remove(path);
+        firstSegment++;
+    }
+}
+
+RideDownload RideLogger::beginDownload() {
+    lock();
+    RideDownload download = {firstSegment, lastSegment, 0};
+    unlock();
+    return download;
+}
+
+size_t RideLogger::read(RideDownload& download, uint8_t* data, size_t maxLength) {
+    if (fs == nullptr) return 0;
+
+    lock();
+    size_t length = 0;
+    while (length == 0 && download.segment <= download.lastSegment) {
+        if (download.segment < firstSegment) {
+            // Segment usunięty w trakcie pobierania
+            download.segment = firstSegment;
+            download.offset = 0;
+            continue;
+        }
+
+        char path[24];
+        getSegmentPath(download.segment, path, sizeof(path));
+        File file = fs->open(path, "r");
+        // Tylko pełne rekordy, żeby kolejne segmenty w odpowiedzi zaczynały się od granicy rekordu
+        size_t size = file ? file.size() - file.size() % sizeof(RideRecord) : 0;
+        if (download.offset < size && file.seek(download.offset)) {
+            if (maxLength > size - download.offset) maxLength = size - download.offset;
+            length = file.read(data, maxLength);
+            download.offset += length;
+        }
+        if (file) file.close();
+
+        if (length == 0) {
+            download.segment++;
+            download.offset = 0;
+        }
+    }
+    unlock();
+    return length;
+}
+
+RideLoggerStats RideLogger::getStats() {
+    lock();
+    RideLoggerStats stats = {firstSegment, lastSegment, segmentRecords, count, recordsWritten, recordsDropped};
+    unlock();
+    return stats;
+}
@@ -0,0 +1,250 @@
+#include "RmtOneWire.h"
+#include <driver/gpio.h>
+#include <esp_rom_gpio.h>
+#include <soc/gpio_sig_map.h>
+
+namespace {
+    const uint8_t RMT_CLOCK_DIVIDER = 80;               // 80 MHz / 80 = 1 tick na us
+    const uint8_t RX_FILTER_TICKS = 30;                 // Zakłócenia krótsze niż 30 taktów APB (0,4 us)
+    const size_t RX_BUFFER_SIZE = 512;
+    const uint8_t MAX_SLOTS = 16;                       // Bajt (8) lub krok wyszukiwania (2 + 1)
+    const uint8_t CMD_MATCH_ROM = 0x55;
+    const uint8_t CMD_SKIP_ROM = 0xCC;
+    const uint8_t CMD_SEARCH_ROM = 0xF0;
+}
+
+RmtOneWire::RmtOneWire(uint8_t pin, rmt_channel_t txChannel, rmt_channel_t rxChannel)
+    : pin(pin), txChannel(txChannel), rxChannel(rxChannel) {}
+
+bool RmtOneWire::begin() {
+    if (!installed) {
+        rmt_config_t rx = {};
+        rx.rmt_mode = RMT_MODE_RX;
+        rx.channel = rxChannel;
+        rx.gpio_num = (gpio_num_t)pin;
+        rx.clk_div = RMT_CLOCK_DIVIDER;
+        rx.mem_block_num = 1;
+        rx.rx_config.filter_en = true;
+        rx.rx_config.filter_ticks_thresh = RX_FILTER_TICKS;
+        // Koniec odbioru: linia bez zmian dłużej niż slot
+        rx.rx_config.idle_threshold = SLOT_US + 10;
+        if (rmt_config(&rx) != ESP_OK || rmt_driver_install(rxChannel, RX_BUFFER_SIZE, 0) != ESP_OK) {
+            return false;
+        }
+
+        rmt_config_t tx = {};
+        tx.rmt_mode = RMT_MODE_TX;
+        tx.channel = txChannel;
+        tx.gpio_num = (gpio_num_t)pin;
+        tx.clk_div = RMT_CLOCK_DIVIDER;
+        tx.mem_block_num = 1;
+        tx.tx_config.idle_output_en = true;
+        tx.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;  // Linia zwolniona między transakcjami
+        tx.tx_config.carrier_en = false;
+        tx.tx_config.loop_en = false;
+        if (rmt_config(&tx) != ESP_OK || rmt_driver_install(txChannel, 0, 0) != ESP_OK) {
+            rmt_driver_uninstall(rxChannel);
+            return false;
+        }
+
+        rmt_get_ringbuf_handle(rxChannel, &rxBuffer);
+        installed = true;
+    }
+
+    attachPin();
+    return true;
+}
+
+void RmtOneWire::attachPin() {
+    // Otwarty dren z wejściem, potem wyjście TX i wejście RX przez matrycę GPIO
+    // (gpio_set_direction przełącza wyjście z powrotem na zwykły GPIO)
+    gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT_OUTPUT_OD);
+    esp_rom_gpio_connect_out_signal(pin, RMT_SIG_OUT0_IDX + txChannel, false, false);
+    esp_rom_gpio_connect_in_signal(pin, RMT_SIG_IN0_IDX + rxChannel, false);
+}
+
+void RmtOneWire::startReceive() {
+    size_t size;
+    void* stale;
+    // Pozostałości po przerwanej transakcji
+    while ((stale = xRingbufferReceive(rxBuffer, &size, 0)) != nullptr) {
+        vRingbufferReturnItem(rxBuffer, stale);
+    }
+    rmt_rx_start(rxChannel, true);
+}
+
+uint8_t RmtOneWire::capture(uint16_t* lowDurations, uint8_t maxPulses) {
+    size_t size;
+    transactions++;
+    rmt_item32_t* received = (rmt_item32_t*)xRingbufferReceive(rxBuffer, &size, pdMS_TO_TICKS(RX_TIMEOUT_MS));
+    rmt_rx_stop(rxChannel);
+    if (received == nullptr) {
+        errors++;
+        return 0;
+    }
+
+    // Czasy kolejnych zwarć linii (poziom 0), bez czasów poziomu wysokiego
+    uint8_t pulses = 0;
+    for (size_t i = 0; i < size / sizeof(rmt_item32_t); i++) {
+        if (received[i].level0 == 0 && received[i].duration0 > 0 && pulses < maxPulses) {
+            lowDurations[pulses++] = received[i].duration0;
+        }
+        if (received[i].level1 == 0 && received[i].duration1 > 0 && pulses < maxPulses) {
+            lowDurations[pulses++] = received[i].duration1;
+        }
+    }
+    vRingbufferReturnItem(rxBuffer, received);
+    return pulses;
+}
+
+bool RmtOneWire::transfer(uint32_t bits, uint8_t count, uint32_t* lineBits) {
+    if (!installed || count == 0 || count > MAX_SLOTS) return false;
+
+    // Zapis 1 i odczyt to ten sam krótki impuls - czujnik może przedłużyć zwarcie (odczytane 0)
+    rmt_item32_t items[MAX_SLOTS];
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t low = (bits >> i) & 1 ? WRITE_1_LOW_US : WRITE_0_LOW_US;
+        items[i].level0 = 0;
+        items[i].duration0 = low;
+        items[i].level1 = 1;
+        items[i].duration1 = SLOT_US - low;
+    }
+
+    startReceive();
+    rmt_write_items(txChannel, items, count, true);
+
+    uint16_t lows[MAX_SLOTS];
+    uint8_t pulses = capture(lows, MAX_SLOTS);
+    if (pulses != count) {
+        if (pulses > 0) errors++;   // Brak odbioru policzony w capture()
+        return false;
+    }
+    if (lineBits != nullptr) {
+        *lineBits = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (lows[i] < READ_SAMPLE_US) *lineBits |= 1UL << i;
+        }
+    }
+    return true;
+}
+
+uint8_t RmtOneWire::reset() {
+    if (!installed) return 0;
+
+    // Odbiór nie może się skończyć w trakcie impulsu resetu (480 us bez zmian linii)
+    rmt_set_rx_idle_thresh(rxChannel, RESET_LOW_US + 20);
+    rmt_item32_t item;
+    item.level0 = 0;
+    item.duration0 = RESET_LOW_US;
+    item.level1 = 1;
+    item.duration1 = RESET_WAIT_US;
+
+    startReceive();
+    rmt_write_items(txChannel, &item, 1, true);
+
+    // Reset mastera i impuls obecności czujnika
+    uint16_t lows[2];
+    uint8_t pulses = capture(lows, 2);
+    rmt_set_rx_idle_thresh(rxChannel, SLOT_US + 10);
+    return pulses == 2 ? 1 : 0;
+}
+
+void RmtOneWire::write(uint8_t value) {
+    transfer(value, 8, nullptr);
+}
+
+uint8_t RmtOneWire::read() {
+    uint32_t line;
+    // Błąd transmisji - jak linia bez czujnika (same jedynki)
+    return transfer(0xFF, 8, &line) ? (uint8_t)line : 0xFF;
+}
+
+void RmtOneWire::write_bytes(const uint8_t* data, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) write(data[i]);
+}
+
+void RmtOneWire::read_bytes(uint8_t* data, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) data[i] = read();
+}
+
+void RmtOneWire::select(const uint8_t rom[8]) {
+    write(CMD_MATCH_ROM);
+    write_bytes(rom, 8);
+}
+
+void RmtOneWire::skip() {
+    write(CMD_SKIP_ROM);
+}
+
+void RmtOneWire::reset_search() {
+    memset(searchRom, 0, sizeof(searchRom));
+    lastDiscrepancy = -1;
+    lastDevice = false;
+}
+
+bool RmtOneWire::search(uint8_t* address) {
+    if (lastDevice || !reset()) {
+        reset_search();
+        return false;
+    }
+    write(CMD_SEARCH_ROM);
+
+    int8_t discrepancy = -1;
+    for (uint8_t bit = 0; bit < 64; bit++) {
+        // Bit adresu i jego negacja od wszystkich czujników naraz
+        uint32_t line;
+        if (!transfer(0x3, 2, &line) || line == 0x3) {
+            reset_search();
+            return false;
+        }
+
+        uint8_t& romByte = searchRom[bit / 8];
+        uint8_t mask = 1 << (bit % 8);
+        bool direction;
+        if (line != 0) {
+            direction = line & 1;
+        } else {
+            // Czujniki różnią się tym bitem: przed ostatnią rozbieżnością jak poprzednio,
+            // na niej 1, dalej 0 (zapamiętane jako nowa rozbieżność)
+            if (bit < lastDiscrepancy) {
+                direction = romByte & mask;
+            } else {
+                direction = bit == lastDiscrepancy;
+            }
+            if (!direction) discrepancy = bit;
+        }
+
+        if (direction) {
+            romByte |= mask;
+        } else {
+            romByte &= ~mask;
+        }
+        if (!transfer(direction ? 1 : 0, 1, nullptr)) {
+            reset_search();
+            return false;
+        }
+    }
+
+    lastDiscrepancy = discrepancy;
+    lastDevice = discrepancy < 0;
+    if (crc8(searchRom, 7) != searchRom[7]) {
+        reset_search();
+        return false;
+    }
+    memcpy(address, searchRom, sizeof(searchRom));
+    return true;
+}
+
+uint8_t RmtOneWire::crc8(const uint8_t* data, uint8_t length) {
+    uint8_t crc = 0;
+    while (length--) {
+        uint8_t byte = *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            uint8_t mix = (crc ^ byte) & 0x01;
+            crc >>= 1;
+            if (mix) crc ^= 0x8C;
+            byte >>= 1;
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,91 @@
+#include "SocEstimator.h"
+
+// Napięcie spoczynkowe celi NMC -> stan naładowania
+struct OcvPoint {
+    float voltage;
+    float soc;
+};
+
+static const OcvPoint OCV_TABLE[] = {
+    {3.00f, 0.0f}, {3.30f, 5.0f}, {3.45f, 10.0f}, {3.55f, 20.0f}, {3.62f, 30.0f}, {3.68f, 40.0f},
+    {3.74f, 50.0f}, {3.80f, 60.0f}, {3.88f, 70.0f}, {3.96f, 80.0f}, {4.06f, 90.0f}, {4.20f, 100.0f}
+};
+static const uint8_t OCV_POINTS = sizeof(OCV_TABLE) / sizeof(OCV_TABLE[0]);
+
+SocEstimator::SocEstimator(uint8_t defaultCells, float defaultCapacityAh)
+    : cells(defaultCells), capacityAh(defaultCapacityAh) {}
+
+float SocEstimator::socFromCellVoltage(float cellVoltage) {
+    if (cellVoltage <= OCV_TABLE[0].voltage) return 0.0f;
+    for (uint8_t i = 1; i < OCV_POINTS; i++) {
+        if (cellVoltage < OCV_TABLE[i].voltage) {
+            const OcvPoint& low = OCV_TABLE[i - 1];
+            const OcvPoint& high = OCV_TABLE[i];
+            return low.soc + (cellVoltage - low.voltage) * (high.soc - low.soc) / (high.voltage - low.voltage);
+        }
+    }
+    return 100.0f;
+}
+
+void SocEstimator::correct(float target, float gain) {
+    soc += (target - soc) * gain;
+}
+
+void SocEstimator::addBmsSample(const BmsData& bms, uint32_t nowMs) {
+    if (bms.cellCount > 0) cells = bms.cellCount;
+    if (bms.totalCapacity > 0) capacityAh = bms.totalCapacity;
+    current = bms.current;
+    voltage = bms.voltage;
+
+    float bmsSoc = bms.totalCapacity > 0 ? 100.0f * bms.remainingCapacity / bms.totalCapacity : (float)bms.soc;
+    if (source != SOURCE_BMS) {
+        // Pierwsza ramka (także po powrocie z samego napięcia) - bez wygładzania
+        soc = bmsSoc;
+        source = SOURCE_BMS;
+    } else {
+        correct(bmsSoc, BMS_GAIN);
+    }
+
+    // Spoczynek: napięcie pakietu bliskie OCV, korekta dryfu zliczania i BMS
+    if (fabsf(current) < REST_CURRENT_A) {
+        if (!resting) {
+            resting = true;
+            restStartMs = nowMs;
+        } else if (nowMs - restStartMs >= REST_TIME_MS) {
+            correct(socFromCellVoltage(voltage / cells), OCV_GAIN);
+        }
+    } else {
+        resting = false;
+    }
+
+    hasBms = true;
+    lastBmsMs = nowMs;
+    soc = constrain(soc, 0.0f, 100.0f);
+}
+
+void SocEstimator::addVoltageSample(float packVoltage, uint32_t nowMs) {
+    if (isBmsOnline(nowMs) || packVoltage < cells * MIN_CELL_VOLTAGE) return;
+
+    // Filtr od pierwszego odczytu (także po utracie BMS)
+    if (source != SOURCE_VOLTAGE) filteredVoltage = packVoltage;
+    else filteredVoltage += (packVoltage - filteredVoltage) * VOLTAGE_GAIN;
+
+    float target = socFromCellVoltage(filteredVoltage / cells);
+    if (source == SOURCE_NONE) soc = target;     // Brak wcześniejszego wyniku
+    else correct(target, VOLTAGE_GAIN);          // Płynne przejście z wyniku BMS
+
+    source = SOURCE_VOLTAGE;
+    voltage = filteredVoltage;
+    current = 0;
+}
+
+void SocEstimator::update(uint32_t nowMs) {
+    uint32_t elapsedMs = nowMs - lastUpdateMs;
+    lastUpdateMs = nowMs;
+
+    if (source != SOURCE_BMS || !isBmsOnline(nowMs) || elapsedMs > MAX_STEP_MS) return;
+
+    // Prąd z ostatniej ramki BMS; A * ms -> Ah: / 3 600 000
+    soc += current * (float)elapsedMs / 3600000.0f / capacityAh * 100.0f;
+    soc = constrain(soc, 0.0f, 100.0f);
+}
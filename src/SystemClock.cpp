@@ -0,0 +1,199 @@
+#include "SystemClock.h"
+#include "Crc32.h"
+#include <sys/time.h>
+
+// Pamięć RTC slow nie jest zerowana przy wybudzeniu z głębokiego uśpienia
+struct ClockSlot {
+    uint32_t magic;
+    uint64_t unixMicros;       // Czas zegara w chwili zapisu
+    int64_t systemMicros;      // Czas systemowy (timer RTC, liczy także w uśpieniu)
+    uint32_t crc;
+};
+
+RTC_DATA_ATTR static ClockSlot clockSlot;
+
+static int64_t systemMicros() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static uint32_t slotCrc() {
+    return crc32(&clockSlot.unixMicros, sizeof(clockSlot.unixMicros) + sizeof(clockSlot.systemMicros));
+}
+
+void SystemClock::begin(RTC_DS3231& clockRtc, int8_t pin, bool restoreFromSleep) {
+    rtc = &clockRtc;
+    sqwPin = pin;
+
+    // Po uśpieniu DS3231 zachowuje konfigurację SQW - bez zapisu I2C
+    bool fromSleep = restoreFromSleep && restore();
+    if (sqwPin >= 0) {
+        if (!fromSleep) rtc->writeSqwPinMode(DS3231_SquareWave1Hz);
+        // Wyjście SQW z otwartym drenem; zbocze opadające = zmiana sekundy
+        pinMode(sqwPin, INPUT_PULLUP);
+        attachInterruptArg(sqwPin, handleSqw, this, FALLING);
+    }
+
+    if (fromSleep) {
+        syncPending = true;    // Korekta z DS3231 w pierwszym update()
+    } else {
+        sync(millis());
+    }
+}
+
+bool SystemClock::restore() {
+    // Po włączeniu zasilania pamięć RTC zawiera przypadkowe dane
+    if (clockSlot.magic != MAGIC || slotCrc() != clockSlot.crc) return false;
+    int64_t slept = systemMicros() - clockSlot.systemMicros;
+    if (slept < 0) return false;
+
+    uint64_t unixMicros = clockSlot.unixMicros + (uint64_t)slept;
+    int64_t nowUs = esp_timer_get_time();
+    portENTER_CRITICAL(&lock);
+    baseSeconds = (uint32_t)(unixMicros / 1000000ULL);
+    baseUs = nowUs - (int64_t)(unixMicros % 1000000ULL);
+    edgeSeconds = 0;
+    portEXIT_CRITICAL(&lock);
+
+    anchored = true;
+    restored = true;
+    return true;
+}
+
+void SystemClock::store() const {
+    clockSlot.magic = MAGIC;
+    clockSlot.unixMicros = nowMicros();
+    clockSlot.systemMicros = systemMicros();
+    clockSlot.crc = slotCrc();
+}
+
+uint32_t SystemClock::edgeCount() const {
+    portENTER_CRITICAL(&lock);
+    uint32_t count = edges;
+    portEXIT_CRITICAL(&lock);
+    return count;
+}
+
+bool SystemClock::sync(uint32_t nowMs) {
+    if (rtc == nullptr) return false;
+
+    // Odczyt bez zbocza SQW w trakcie - inaczej nie wiadomo, którą sekundę odczytano
+    DateTime time;
+    int64_t readUs = 0;
+    bool edgeDuringRead = true;
+    for (uint8_t attempt = 0; attempt < SYNC_ATTEMPTS && edgeDuringRead; attempt++) {
+        uint32_t edgesBefore = edgeCount();
+        time = rtc->now();
+        readUs = esp_timer_get_time();
+        rtcReads++;
+        edgeDuringRead = edgeCount() != edgesBefore;
+    }
+    lastSyncMs = nowMs;
+    if (!time.isValid()) return false;
+
+    uint32_t seconds = time.unixtime();
+    int64_t secondStartUs = (int64_t)seconds * 1000000;
+
+    portENTER_CRITICAL(&lock);
+    int64_t estimateUs = (int64_t)baseSeconds * 1000000 + (readUs - baseUs);
+    bool sqwActive = edges > 0 && readUs - lastEdgeUs < SQW_TIMEOUT_US;
+    if (sqwActive && !edgeDuringRead) {
+        // Odczytana sekunda zaczęła się przy ostatnim zboczu - dokładnie
+        baseSeconds = seconds;
+        baseUs = lastEdgeUs;
+        edgeSeconds = 0;
+    } else {
+        if (!synced || estimateUs < secondStartUs) {
+            // Początek odczytanej sekundy (ułamek nieznany, zegar nie cofa się w niej)
+            baseSeconds = seconds;
+            baseUs = readUs;
+        } else if (estimateUs >= secondStartUs + 1000000) {
+            // Zegar się spieszy - koniec odczytanej sekundy
+            baseSeconds = seconds;
+            baseUs = readUs - 999999;
+        }
+        // Najbliższe zbocze (jeśli SQW podłączone) zaczyna następną sekundę
+        if (sqwPin >= 0 && !edgeDuringRead) edgeSeconds = seconds + 1;
+    }
+    int64_t correctedUs = (int64_t)baseSeconds * 1000000 + (readUs - baseUs);
+    portEXIT_CRITICAL(&lock);
+
+    lastCorrectionMs = anchored ? (int32_t)((correctedUs - estimateUs) / 1000) : 0;
+    anchored = true;
+    synced = true;
+    syncPending = false;
+    syncs++;
+    return true;
+}
+
+void SystemClock::update(uint32_t nowMs) {
+    if (rtc == nullptr) return;
+    if (syncPending || (!isSqwActive() && nowMs - lastSyncMs >= RESYNC_INTERVAL_MS)) {
+        sync(nowMs);
+    }
+}
+
+void SystemClock::adjust(uint32_t unixTime) {
+    if (rtc == nullptr) return;
+    rtc->adjust(DateTime(unixTime));
+
+    int64_t nowUs = esp_timer_get_time();
+    portENTER_CRITICAL(&lock);
+    baseSeconds = unixTime;
+    baseUs = nowUs;
+    // Zapis sekund zeruje dzielnik DS3231 - następne zbocze za sekundę
+    edgeSeconds = sqwPin >= 0 ? unixTime + 1 : 0;
+    portEXIT_CRITICAL(&lock);
+
+    anchored = true;
+    synced = true;
+    syncPending = false;
+    lastSyncMs = millis();
+}
+
+uint64_t SystemClock::nowMicros() const {
+    portENTER_CRITICAL(&lock);
+    uint32_t seconds = baseSeconds;
+    int64_t anchorUs = baseUs;
+    portEXIT_CRITICAL(&lock);
+    return (uint64_t)seconds * 1000000ULL + (uint64_t)(esp_timer_get_time() - anchorUs);
+}
+
+bool SystemClock::isSqwActive() const {
+    portENTER_CRITICAL(&lock);
+    uint32_t count = edges;
+    int64_t lastUs = lastEdgeUs;
+    portEXIT_CRITICAL(&lock);
+    return count > 0 && esp_timer_get_time() - lastUs < SQW_TIMEOUT_US;
+}
+
+void IRAM_ATTR SystemClock::handleSqw(void* arg) {
+    SystemClock* clock = static_cast<SystemClock*>(arg);
+    int64_t nowUs = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&clock->lock);
+    if (clock->edgeSeconds != 0) {
+        clock->baseSeconds = clock->edgeSeconds;
+        clock->edgeSeconds = 0;
+    } else {
+        // Najbliższa pełna sekunda (pominięte zbocze lub zakłócenie - bez skoku)
+        int64_t elapsedUs = nowUs - clock->baseUs;
+        clock->baseSeconds += (uint32_t)((elapsedUs + 500000) / 1000000);
+    }
+    clock->baseUs = nowUs;
+    clock->lastEdgeUs = nowUs;
+    clock->edges++;
+    portEXIT_CRITICAL_ISR(&clock->lock);
+}
+
+void SystemClock::printReport(Print& out) const {
+    DateTime time(now());
+    const char* source = isSqwActive() ? "SQW 1 Hz" :
+                         sqwPin >= 0 ? "korekta co 10 min (brak zboczy SQW)" : "korekta co 10 min";
+    out.printf("Zegar: %04u-%02u-%02u %02u:%02u:%02u, źródło: %s\n",
+               time.year(), time.month(), time.day(), time.hour(), time.minute(), time.second(), source);
+    out.printf("  odczyty DS3231: %u, korekty: %u (ostatnia %d ms), zbocza SQW: %u%s\n",
+               (unsigned)rtcReads, (unsigned)syncs, (int)lastCorrectionMs, (unsigned)edgeCount(),
+               restored ? ", czas z pamięci RTC po uśpieniu" : "");
+}
@@ -0,0 +1,121 @@
+#include "TaskScheduler.h"
+
+TaskScheduler::TaskScheduler() {
+    memset(tasks, 0, sizeof(tasks));
+}
+
+int8_t TaskScheduler::addTask(const TaskConfig& config) {
+    if (started || taskCount >= MAX_TASKS || config.step == nullptr || config.periodMs == 0) {
+        return -1;
+    }
+
+    TaskSlot& slot = tasks[taskCount];
+    slot.config = config;
+    memset(&slot.stats, 0, sizeof(slot.stats));
+    slot.handle = nullptr;
+
+    return taskCount++;
+}
+
+bool TaskScheduler::begin() {
+    if (started) return false;
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        TaskSlot& slot = tasks[i];
+        BaseType_t result = xTaskCreatePinnedToCore(
+            taskEntry,
+            slot.config.name,
+            slot.config.stackSize,
+            &slot,
+            slot.config.priority,
+            &slot.handle,
+            slot.config.core
+        );
+
+        if (result != pdPASS) return false;   // Błąd zgłasza wywołujący
+    }
+
+    started = true;
+    return true;
+}
+
+void TaskScheduler::notify(int8_t taskId) {
+    if (taskId < 0 || taskId >= taskCount || tasks[taskId].handle == nullptr) return;
+    xTaskNotifyGive(tasks[taskId].handle);
+}
+
+void IRAM_ATTR TaskScheduler::notifyFromISR(int8_t taskId) {
+    if (taskId < 0 || taskId >= taskCount || tasks[taskId].handle == nullptr) return;
+    BaseType_t higherPriorityWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(tasks[taskId].handle, &higherPriorityWoken);
+    if (higherPriorityWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+uint8_t TaskScheduler::getTaskCount() const {
+    return taskCount;
+}
+
+const char* TaskScheduler::getTaskName(uint8_t index) const {
+    return index < taskCount ? tasks[index].config.name : "";
+}
+
+TaskStats TaskScheduler::getStats(uint8_t index) const {
+    TaskStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (index < taskCount) {
+        stats = tasks[index].stats;
+    }
+    return stats;
+}
+
+void TaskScheduler::taskEntry(void* param) {
+    runTask(*static_cast<TaskSlot*>(param));
+}
+
+void TaskScheduler::runTask(TaskSlot& slot) {
+    const TickType_t period = pdMS_TO_TICKS(slot.config.periodMs) > 0 ? pdMS_TO_TICKS(slot.config.periodMs) : 1;
+    TickType_t deadline = xTaskGetTickCount();
+
+    for (;;) {
+        // Czekaj do terminu lub do wybudzenia przez notify()
+        TickType_t now = xTaskGetTickCount();
+        bool early = false;
+        if ((int32_t)(deadline - now) > 0) {
+            early = ulTaskNotifyTake(pdTRUE, deadline - now) > 0;
+        } else {
+            // Termin minął - wyczyść zaległe powiadomienia bez czekania
+            ulTaskNotifyTake(pdTRUE, 0);
+        }
+
+        now = xTaskGetTickCount();
+        bool scheduled = (int32_t)(now - deadline) >= 0;
+
+        if (scheduled) {
+            uint32_t lateness = (now - deadline) * portTICK_PERIOD_MS * 1000UL;
+            if (lateness > slot.stats.maxLatenessUs) {
+                slot.stats.maxLatenessUs = lateness;
+            }
+
+            // Wyznacz kolejny termin, przy dużym opóźnieniu synchronizuj się od nowa
+            deadline += period;
+            if ((int32_t)(now - deadline) >= 0) {
+                slot.stats.overruns++;
+                deadline = now + period;
+            }
+        } else if (early) {
+            slot.stats.wakeups++;
+        }
+
+        uint32_t start = micros();
+        slot.config.step();
+        uint32_t duration = micros() - start;
+
+        slot.stats.runs++;
+        slot.stats.lastRunUs = duration;
+        if (duration > slot.stats.maxRunUs) {
+            slot.stats.maxRunUs = duration;
+        }
+    }
+}
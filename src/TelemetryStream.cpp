@@ -0,0 +1,247 @@
+#include "TelemetryStream.h"
+
+static const char* const FIELD_NAMES[FIELD_COUNT] = {
+    "speed", "cadence", "power", "voltage", "current", "battery", "temperature",
+    "tempController", "tempMotor", "range", "distance", "cells", "bmsTemps", "pressure", "time"
+};
+
+// Zaokrąglenie z obcięciem do zakresu typu docelowego
+static int32_t scaled(float value, float scale, int32_t minValue, int32_t maxValue) {
+    if (isnan(value)) return 0;
+    float result = roundf(value * scale);
+    if (result < minValue) return minValue;
+    if (result > maxValue) return maxValue;
+    return (int32_t)result;
+}
+
+TelemetryStream::TelemetryStream() {
+    memset(clients, 0, sizeof(clients));
+}
+
+TelemetryStream::Client* TelemetryStream::find(uint32_t clientId) {
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i].active && clients[i].id == clientId) return &clients[i];
+    }
+    return nullptr;
+}
+
+bool TelemetryStream::apply(const TelemetrySubscription& subscription) {
+    Client* client = find(subscription.clientId);
+
+    if (subscription.fieldMask == 0) {
+        if (client) client->active = false;
+        return true;
+    }
+
+    if (client == nullptr) {
+        for (uint8_t i = 0; i < MAX_CLIENTS && client == nullptr; i++) {
+            if (!clients[i].active) client = &clients[i];
+        }
+        if (client == nullptr) return false;
+        memset(client, 0, sizeof(Client));
+        client->id = subscription.clientId;
+        client->active = true;
+    }
+
+    uint8_t rate = subscription.rateHz;
+    if (rate < MIN_RATE_HZ) rate = MIN_RATE_HZ;
+    if (rate > MAX_RATE_HZ) rate = MAX_RATE_HZ;
+
+    client->fieldMask = subscription.fieldMask & ((1UL << FIELD_COUNT) - 1);
+    client->intervalMs = 1000 / rate;
+    client->format = subscription.format;
+    client->keyframePending = true;
+    return true;
+}
+
+uint32_t TelemetryStream::fieldMaskFromName(const char* name) {
+    if (name == nullptr) return 0;
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if (strcmp(name, FIELD_NAMES[i]) == 0) return 1UL << i;
+    }
+    return 0;
+}
+
+const char* TelemetryStream::getFieldName(uint8_t field) {
+    return field < FIELD_COUNT ? FIELD_NAMES[field] : "";
+}
+
+void TelemetryStream::quantize(const TelemetrySnapshot& t, uint32_t unixTime, TelemetryValues& values) {
+    memset(&values, 0, sizeof(values));
+    values.speed = scaled(t.speed_kmh, 10.0f, 0, UINT16_MAX);
+    values.cadence = scaled(t.cadence_rpm, 1.0f, 0, UINT16_MAX);
+    values.power = scaled(t.power_w, 1.0f, INT16_MIN, INT16_MAX);
+    values.voltage = scaled(t.battery_voltage, 100.0f, 0, UINT16_MAX);
+    values.current = scaled(t.battery_current, 100.0f, INT16_MIN, INT16_MAX);
+    values.battery = scaled(t.battery_capacity_percent, 1.0f, 0, 100);
+    values.tempAir = scaled(t.temp_air, 10.0f, INT16_MIN, INT16_MAX);
+    values.tempController = scaled(t.temp_controller, 10.0f, INT16_MIN, INT16_MAX);
+    values.tempMotor = scaled(t.temp_motor, 10.0f, INT16_MIN, INT16_MAX);
+    values.range = scaled(t.range_km, 10.0f, 0, UINT16_MAX);
+    values.distance = (uint32_t)scaled(t.distance_km, 1000.0f, 0, INT32_MAX);
+
+    values.cellCount = t.bms.cellCount < BMS_MAX_CELLS ? t.bms.cellCount : BMS_MAX_CELLS;
+    for (uint8_t i = 0; i < values.cellCount; i++) {
+        values.cells[i] = scaled(t.bms.cellVoltages[i], 1000.0f, 0, UINT16_MAX);
+    }
+    values.bmsTempCount = t.bms.ntcCount < BMS_MAX_NTC ? t.bms.ntcCount : BMS_MAX_NTC;
+    for (uint8_t i = 0; i < values.bmsTempCount; i++) {
+        values.bmsTemps[i] = scaled(t.bms.temperatures[i], 10.0f, INT16_MIN, INT16_MAX);
+    }
+
+    values.pressure[0] = scaled(t.pressure_bar, 100.0f, 0, UINT16_MAX);
+    values.pressure[1] = scaled(t.pressure_rear_bar, 100.0f, 0, UINT16_MAX);
+    values.time = unixTime;
+}
+
+const uint8_t* TelemetryStream::fieldData(const TelemetryValues& values, uint8_t field) {
+    const uint8_t* base = (const uint8_t*)&values;
+    switch (field) {
+        case FIELD_SPEED: return base + offsetof(TelemetryValues, speed);
+        case FIELD_CADENCE: return base + offsetof(TelemetryValues, cadence);
+        case FIELD_POWER: return base + offsetof(TelemetryValues, power);
+        case FIELD_VOLTAGE: return base + offsetof(TelemetryValues, voltage);
+        case FIELD_CURRENT: return base + offsetof(TelemetryValues, current);
+        case FIELD_BATTERY: return base + offsetof(TelemetryValues, battery);
+        case FIELD_TEMP_AIR: return base + offsetof(TelemetryValues, tempAir);
+        case FIELD_TEMP_CONTROLLER: return base + offsetof(TelemetryValues, tempController);
+        case FIELD_TEMP_MOTOR: return base + offsetof(TelemetryValues, tempMotor);
+        case FIELD_RANGE: return base + offsetof(TelemetryValues, range);
+        case FIELD_DISTANCE: return base + offsetof(TelemetryValues, distance);
+        case FIELD_CELLS: return base + offsetof(TelemetryValues, cellCount);
+        case FIELD_BMS_TEMPS: return base + offsetof(TelemetryValues, bmsTempCount);
+        case FIELD_PRESSURE: return base + offsetof(TelemetryValues, pressure);
+        default: return base + offsetof(TelemetryValues, time);
+    }
+}
+
+size_t TelemetryStream::fieldSize(uint8_t field) {
+    switch (field) {
+        case FIELD_BATTERY: return 1;
+        case FIELD_DISTANCE: return 4;
+        case FIELD_CELLS: return 1 + BMS_MAX_CELLS * 2;
+        case FIELD_BMS_TEMPS: return 1 + BMS_MAX_NTC * 2;
+        case FIELD_PRESSURE: return 4;
+        case FIELD_TIME: return 4;
+        default: return 2;
+    }
+}
+
+size_t TelemetryStream::encodeBinary(Client& client, const TelemetryValues& values, bool keyframe) {
+    // Maska pól zmienionych od ostatniej ramki klienta
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if (!(client.fieldMask & (1UL << i))) continue;
+        if (keyframe || memcmp(fieldData(values, i), fieldData(client.sent, i), fieldSize(i)) != 0) {
+            mask |= 1UL << i;
+        }
+    }
+    if (mask == 0) return 0;
+
+    TelemetryFrameHeader header;
+    header.magic = TELEMETRY_FRAME_MAGIC;
+    header.flags = keyframe ? TELEMETRY_FLAG_KEYFRAME : 0;
+    header.sequence = client.sequence;
+    header.fieldMask = mask;
+    memcpy(frame, &header, sizeof(header));
+
+    size_t length = sizeof(header);
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if (!(mask & (1UL << i))) continue;
+        memcpy(frame + length, fieldData(values, i), fieldSize(i));
+        length += fieldSize(i);
+    }
+    return length;
+}
+
+size_t TelemetryStream::encodeJson(Client& client, const TelemetryValues& values) {
+    size_t length = snprintf(text, sizeof(text), "{\"seq\":%u", client.sequence);
+
+    for (uint8_t i = 0; i < FIELD_COUNT && length < sizeof(text); i++) {
+        if (!(client.fieldMask & (1UL << i))) continue;
+        size_t left = sizeof(text) - length;
+        char* out = text + length;
+
+        switch (i) {
+            case FIELD_SPEED: length += snprintf(out, left, ",\"speed\":%.1f", values.speed / 10.0f); break;
+            case FIELD_CADENCE: length += snprintf(out, left, ",\"cadence\":%u", values.cadence); break;
+            case FIELD_POWER: length += snprintf(out, left, ",\"power\":%d", values.power); break;
+            case FIELD_VOLTAGE: length += snprintf(out, left, ",\"voltage\":%.2f", values.voltage / 100.0f); break;
+            case FIELD_CURRENT: length += snprintf(out, left, ",\"current\":%.2f", values.current / 100.0f); break;
+            case FIELD_BATTERY: length += snprintf(out, left, ",\"battery\":%u", values.battery); break;
+            case FIELD_TEMP_AIR: length += snprintf(out, left, ",\"temperature\":%.1f", values.tempAir / 10.0f); break;
+            case FIELD_TEMP_CONTROLLER: length += snprintf(out, left, ",\"tempController\":%.1f", values.tempController / 10.0f); break;
+            case FIELD_TEMP_MOTOR: length += snprintf(out, left, ",\"tempMotor\":%.1f", values.tempMotor / 10.0f); break;
+            case FIELD_RANGE: length += snprintf(out, left, ",\"range\":%.1f", values.range / 10.0f); break;
+            case FIELD_DISTANCE: length += snprintf(out, left, ",\"distance\":%.3f", values.distance / 1000.0f); break;
+            case FIELD_CELLS:
+                length += snprintf(out, left, ",\"cells\":[");
+                for (uint8_t c = 0; c < values.cellCount && length < sizeof(text); c++) {
+                    length += snprintf(text + length, sizeof(text) - length, c ? ",%.3f" : "%.3f", values.cells[c] / 1000.0f);
+                }
+                if (length < sizeof(text)) length += snprintf(text + length, sizeof(text) - length, "]");
+                break;
+            case FIELD_BMS_TEMPS:
+                length += snprintf(out, left, ",\"bmsTemps\":[");
+                for (uint8_t n = 0; n < values.bmsTempCount && length < sizeof(text); n++) {
+                    length += snprintf(text + length, sizeof(text) - length, n ? ",%.1f" : "%.1f", values.bmsTemps[n] / 10.0f);
+                }
+                if (length < sizeof(text)) length += snprintf(text + length, sizeof(text) - length, "]");
+                break;
+            case FIELD_PRESSURE:
+                length += snprintf(out, left, ",\"pressure\":[%.2f,%.2f]", values.pressure[0] / 100.0f, values.pressure[1] / 100.0f);
+                break;
+            case FIELD_TIME: length += snprintf(out, left, ",\"time\":%u", (unsigned)values.time); break;
+        }
+    }
+
+    if (length + 2 > sizeof(text)) return 0;  // Nie zmieściło się - pomiń ramkę
+    text[length++] = '}';
+    text[length] = '\0';
+    return length;
+}
+
+void TelemetryStream::update(const TelemetrySnapshot& t, uint32_t unixTime, unsigned long now, AsyncWebSocket& ws) {
+    bool quantized = false;
+    TelemetryValues values;
+
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        Client& client = clients[i];
+        if (!client.active) continue;
+        if (!client.keyframePending && now - client.lastSent < client.intervalMs) continue;
+
+        if (ws.client(client.id) == nullptr) {
+            // Klient rozłączony bez zdarzenia (np. po cleanupClients)
+            client.active = false;
+            continue;
+        }
+
+        if (!quantized) {
+            quantize(t, unixTime, values);
+            quantized = true;
+        }
+        client.lastSent = now;
+
+        if (client.format == TELEMETRY_FORMAT_JSON) {
+            size_t length = encodeJson(client, values);
+            if (length > 0) {
+                ws.text(client.id, text, length);
+                client.sequence++;
+            }
+            client.keyframePending = false;
+            continue;
+        }
+
+        bool keyframe = client.keyframePending || now - client.lastKeyframe >= KEYFRAME_INTERVAL_MS;
+        size_t length = encodeBinary(client, values, keyframe);
+        if (length > 0) {
+            ws.binary(client.id, frame, length);
+            client.sequence++;
+            client.sent = values;
+        }
+        if (keyframe) {
+            client.lastKeyframe = now;
+            client.keyframePending = false;
+        }
+    }
+}
@@ -0,0 +1,185 @@
+#include "TemperatureEngine.h"
+
+namespace {
+    const uint8_t FAMILY_DS18B20 = 0x28;
+    const uint16_t MAX_CONSECUTIVE_ERRORS = 10;   // Potem ponowne wyszukanie (np. wymieniony czujnik)
+}
+
+uint8_t TemperatureEngine::addChannel(Ds18b20Bus* bus) {
+    if (channelCount >= MAX_CHANNELS) return MAX_CHANNELS;
+    buses[channelCount] = bus;
+    return channelCount++;
+}
+
+void TemperatureEngine::begin(uint32_t nowMs) {
+    for (uint8_t channel = 0; channel < channelCount; channel++) {
+        // Błąd konfiguracji RMT - kanał bez czujnika
+        if (buses[channel]->begin()) {
+            discover(channel, nowMs);
+        } else {
+            sensors[channel].lastDiscoveryMs = nowMs;
+        }
+    }
+    // Pierwsza konwersja w pierwszym update()
+    lastRequestMs = nowMs - REQUEST_INTERVAL_MS;
+}
+
+bool TemperatureEngine::discover(uint8_t channel, uint32_t nowMs) {
+    Sensor& sensor = sensors[channel];
+    Ds18b20Bus* bus = buses[channel];
+    sensor.lastDiscoveryMs = nowMs;
+
+    // Jedyne przeszukanie magistrali - dalej tylko adresowanie po ROM
+    DeviceAddress rom;
+    if (!bus->getAddress(rom, 0) || !bus->validAddress(rom) || rom[0] != FAMILY_DS18B20) {
+        sensor.present = false;
+        return false;
+    }
+
+    memcpy(sensor.rom, rom, sizeof(rom));
+    sensor.present = true;
+    sensor.consecutiveErrors = 0;
+    sensor.rate = 0;
+    sensor.rateBaseMs = 0;
+    sensor.lastResolutionChangeMs = nowMs;
+
+    if (bus->getResolution(sensor.rom) != MAX_RESOLUTION) {
+        bus->setResolution(sensor.rom, MAX_RESOLUTION);
+    }
+    sensor.resolution = MAX_RESOLUTION;
+    return true;
+}
+
+uint32_t TemperatureEngine::conversionMs(uint8_t resolution) {
+    // 750 ms dla 12 bitów, każdy bit mniej - połowa czasu
+    return 750UL >> (MAX_RESOLUTION - resolution);
+}
+
+float TemperatureEngine::stepC(uint8_t resolution) {
+    return 0.0625f * (1 << (MAX_RESOLUTION - resolution));
+}
+
+uint32_t TemperatureEngine::getRequestIntervalMs() const {
+    // Konwersje naraz - odstęp dla najwolniejszego czujnika
+    uint8_t resolution = MIN_RESOLUTION;
+    bool any = false;
+    for (uint8_t channel = 0; channel < channelCount; channel++) {
+        if (!sensors[channel].present) continue;
+        resolution = max(resolution, sensors[channel].resolution);
+        any = true;
+    }
+    return any ? REQUEST_INTERVAL_MS >> (MAX_RESOLUTION - resolution) : REQUEST_INTERVAL_MS;
+}
+
+void TemperatureEngine::update(uint32_t nowMs) {
+    if (conversionPending) {
+        if (nowMs - conversionStartMs < conversionTimeMs) return;
+        conversionPending = false;
+        for (uint8_t channel = 0; channel < channelCount; channel++) {
+            if (!sensors[channel].present || !(requestedMask & (1 << channel))) continue;
+            readResult(channel, nowMs);
+            adaptResolution(channel, nowMs);
+        }
+    }
+
+    if (nowMs - lastRequestMs < getRequestIntervalMs()) return;
+    lastRequestMs = nowMs;
+
+    // Konwersja na wszystkich magistralach naraz - czas najwolniejszego czujnika
+    conversionTimeMs = 0;
+    requestedMask = 0;
+    for (uint8_t channel = 0; channel < channelCount; channel++) {
+        Sensor& sensor = sensors[channel];
+        if (!sensor.present) {
+            if (nowMs - sensor.lastDiscoveryMs < DISCOVERY_RETRY_MS || !discover(channel, nowMs)) continue;
+        }
+        if (buses[channel]->requestTemperaturesByAddress(sensor.rom)) {
+            conversionTimeMs = max(conversionTimeMs, conversionMs(sensor.resolution));
+            requestedMask |= 1 << channel;
+        } else {
+            sensor.errors++;
+            sensor.consecutiveErrors++;
+        }
+    }
+
+    if (conversionTimeMs > 0) {
+        conversionPending = true;
+        conversionStartMs = nowMs;
+    }
+}
+
+void TemperatureEngine::readResult(uint8_t channel, uint32_t nowMs) {
+    Sensor& sensor = sensors[channel];
+    float value = buses[channel]->getTempC(sensor.rom);
+    sensor.reads++;
+
+    if (value == DEVICE_DISCONNECTED_C || value < MIN_VALID_C || value > MAX_VALID_C) {
+        sensor.errors++;
+        if (++sensor.consecutiveErrors >= MAX_CONSECUTIVE_ERRORS) {
+            sensor.present = false;
+        }
+        return;
+    }
+
+    // Tempo z okna, nie z sąsiednich odczytów: przy 10 bitach 1 LSB (0,25 °C)
+    // w 1 s to więcej niż FAST_RATE_C_PER_S - odczyt migający na granicy
+    // kwantyzacji trzymałby niską rozdzielczość bez końca
+    if (sensor.rateBaseMs == 0) {
+        sensor.rateBaseValue = value;
+        sensor.rateBaseMs = nowMs;
+    } else if (nowMs - sensor.rateBaseMs >= RATE_WINDOW_MS) {
+        float change = fabsf(value - sensor.rateBaseValue);
+        if (change < 1.5f * stepC(sensor.resolution)) change = 0;
+        sensor.rate = change * 1000.0f / (nowMs - sensor.rateBaseMs);
+        sensor.rateBaseValue = value;
+        sensor.rateBaseMs = nowMs;
+    }
+    sensor.value = value;
+    sensor.lastValidMs = nowMs;
+    sensor.consecutiveErrors = 0;
+}
+
+void TemperatureEngine::adaptResolution(uint8_t channel, uint32_t nowMs) {
+    Sensor& sensor = sensors[channel];
+    if (nowMs - sensor.lastResolutionChangeMs < RESOLUTION_HOLD_MS) return;
+
+    // Szybka zmiana - od razu najkrótsza konwersja, uspokojenie - stopniowo w górę
+    uint8_t target = sensor.resolution;
+    if (sensor.rate >= FAST_RATE_C_PER_S) {
+        target = MIN_RESOLUTION;
+    } else if (sensor.rate < SLOW_RATE_C_PER_S && sensor.resolution < MAX_RESOLUTION) {
+        target = sensor.resolution + 1;
+    }
+    if (target == sensor.resolution) return;
+
+    if (buses[channel]->setResolution(sensor.rom, target)) {
+        sensor.resolution = target;
+        sensor.lastResolutionChangeMs = nowMs;
+        sensor.rateBaseMs = 0;   // Nowe okno - odczyty o innej kwantyzacji
+    }
+}
+
+bool TemperatureEngine::getTemperature(uint8_t channel, float& value, uint32_t nowMs) const {
+    if (channel >= channelCount) return false;
+    const Sensor& sensor = sensors[channel];
+    if (sensor.lastValidMs == 0 || nowMs - sensor.lastValidMs > STALE_MS) return false;
+    value = sensor.value;
+    return true;
+}
+
+void TemperatureEngine::printReport(Print& out, uint32_t nowMs) const {
+    out.println("Czujniki temperatury (kanał: ROM, °C, rozdzielczość, °C/s, odczyty, błędy, wiek odczytu):");
+    for (uint8_t channel = 0; channel < channelCount; channel++) {
+        const Sensor& sensor = sensors[channel];
+        if (!sensor.present && sensor.lastValidMs == 0) {
+            out.printf("  %u: brak czujnika (błędy %u)\n", channel, (unsigned)sensor.errors);
+            continue;
+        }
+        out.printf("  %u: %02X%02X%02X%02X%02X%02X%02X%02X %6.2f °C %u bit %5.3f °C/s, %u/%u, %u ms%s\n", channel,
+                   sensor.rom[0], sensor.rom[1], sensor.rom[2], sensor.rom[3],
+                   sensor.rom[4], sensor.rom[5], sensor.rom[6], sensor.rom[7],
+                   sensor.value, sensor.resolution, sensor.rate, (unsigned)sensor.reads, (unsigned)sensor.errors,
+                   (unsigned)(sensor.lastValidMs == 0 ? 0 : nowMs - sensor.lastValidMs),
+                   sensor.present ? "" : " (ponowne wyszukiwanie)");
+    }
+}
@@ -0,0 +1,34 @@
+#include "TpmsDecoder.h"
+
+namespace {
+
+    uint32_t readU32(const uint8_t* data) {
+        return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+    }
+
+    bool decodeFormat0001(const uint8_t* data, size_t length, TpmsReading& reading) {
+        const size_t FRAME_LENGTH = 18;
+        if (length != FRAME_LENGTH || data[0] != 0x00 || data[1] != 0x01) return false;
+        if ((data[2] & 0xF0) != 0x80) return false;
+
+        uint32_t pressurePa = readU32(data + 8);
+        int32_t temperature = (int32_t)readU32(data + 12);
+
+        // Ponad 10 bar, poza -40..125 °C lub bateria > 100% - to nie jest ten format
+        if (pressurePa > 1000000 || temperature < -4000 || temperature > 12500 || data[16] > 100) return false;
+
+        reading.format = TPMS_FORMAT_0001;
+        reading.position = data[2] & 0x0F;
+        reading.pressureBar = pressurePa / 100000.0f;
+        reading.temperatureC = temperature / 100.0f;
+        reading.batteryPercent = data[16];
+        reading.alarm = data[17] != 0;
+        return true;
+    }
+
+} // namespace
+
+bool decodeTpmsAdvertisement(const uint8_t* manufacturerData, size_t length, TpmsReading& reading) {
+    if (manufacturerData == nullptr) return false;
+    return decodeFormat0001(manufacturerData, length, reading);
+}
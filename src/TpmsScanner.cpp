@@ -0,0 +1,121 @@
+#include "TpmsScanner.h"
+
+TpmsScanner* TpmsScanner::instance = nullptr;
+
+TpmsScanner::TpmsScanner() {
+    instance = this;
+}
+
+void TpmsScanner::begin() {
+    scan = BLEDevice::getScan();
+    // Pasywnie: bez zapytań o odpowiedź skanowania, czujniki nadają same
+    scan->setActiveScan(false);
+    // Duplikaty potrzebne - kolejne rozgłoszenia tego samego czujnika niosą nowe pomiary
+    scan->setAdvertisedDeviceCallbacks(this, true);
+    scan->setInterval(SCAN_INTERVAL_MS);
+    scan->setWindow(SCAN_WINDOW_SHARED_MS);
+    currentWindowMs = SCAN_WINDOW_SHARED_MS;
+}
+
+void TpmsScanner::update(uint32_t nowMs, bool bmsConnected) {
+    if (scan == nullptr || scanning) return;
+    if (scans > 0 && nowMs - lastScanMs < SCAN_PERIOD_MS) return;
+
+    uint16_t window = bmsConnected ? SCAN_WINDOW_SHARED_MS : SCAN_WINDOW_ALONE_MS;
+    if (window != currentWindowMs) {
+        scan->setWindow(window);
+        currentWindowMs = window;
+    }
+
+    lastScanMs = nowMs;
+    scanning = true;
+    if (scan->start(SCAN_DURATION_S, onScanComplete, false)) {
+        scans++;
+    } else {
+        scanning = false;
+    }
+}
+
+void TpmsScanner::stop() {
+    if (scan != nullptr && scanning) {
+        scan->stop();
+        scan->clearResults();
+        scanning = false;
+    }
+}
+
+void TpmsScanner::onScanComplete(BLEScanResults results) {
+    (void)results;
+    if (instance == nullptr) return;
+    // Wyniki nie są potrzebne (wszystko w onResult) - bez gromadzenia w pamięci
+    instance->scan->clearResults();
+    instance->scanning = false;
+}
+
+bool TpmsScanner::parseMac(const std::string& text, uint8_t mac[6]) {
+    unsigned int bytes[6];
+    if (sscanf(text.c_str(), "%2x:%2x:%2x:%2x:%2x:%2x", &bytes[0], &bytes[1], &bytes[2], &bytes[3],
+               &bytes[4], &bytes[5]) != 6) {
+        return false;
+    }
+    for (uint8_t i = 0; i < 6; i++) mac[i] = (uint8_t)bytes[i];
+    return true;
+}
+
+void TpmsScanner::onResult(BLEAdvertisedDevice advertisedDevice) {
+    if (!advertisedDevice.haveManufacturerData()) return;
+
+    std::string data = advertisedDevice.getManufacturerData();
+    TpmsReading reading;
+    if (!decodeTpmsAdvertisement((const uint8_t*)data.data(), data.size(), reading)) return;
+
+    uint8_t mac[6];
+    if (!parseMac(advertisedDevice.getAddress().toString(), mac)) return;
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&lock);
+    // Wpis tego czujnika, wolny lub najdawniej widziany
+    uint8_t slot = sensorCount;
+    for (uint8_t i = 0; i < sensorCount; i++) {
+        if (memcmp(sensors[i].mac, mac, sizeof(mac)) == 0) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot == MAX_SENSORS) {
+        slot = 0;
+        for (uint8_t i = 1; i < MAX_SENSORS; i++) {
+            if (now - sensors[i].lastSeenMs > now - sensors[slot].lastSeenMs) slot = i;
+        }
+        sensors[slot].frames = 0;
+    } else if (slot == sensorCount) {
+        sensorCount++;
+        sensors[slot].frames = 0;
+    }
+
+    TpmsSensor& sensor = sensors[slot];
+    memcpy(sensor.mac, mac, sizeof(mac));
+    sensor.reading = reading;
+    sensor.rssi = (int8_t)advertisedDevice.getRSSI();
+    sensor.lastSeenMs = now;
+    sensor.frames++;
+    updates++;
+    portEXIT_CRITICAL(&lock);
+}
+
+bool TpmsScanner::getSensor(uint8_t position, TpmsSensor& sensor, uint32_t nowMs) {
+    bool found = false;
+
+    portENTER_CRITICAL(&lock);
+    // Kilka czujników z tym samym numerem (np. po wymianie) - najnowszy
+    for (uint8_t i = 0; i < sensorCount; i++) {
+        const TpmsSensor& entry = sensors[i];
+        if (entry.reading.position != position || nowMs - entry.lastSeenMs > STALE_MS) continue;
+        if (!found || (int32_t)(entry.lastSeenMs - sensor.lastSeenMs) > 0) {
+            sensor = entry;
+            found = true;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+    return found;
+}
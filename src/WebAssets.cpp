@@ -0,0 +1,67 @@
+#include "WebAssets.h"
+
+bool WebAssets::begin(FS& fileSystem, const char* manifestPath) {
+    fs = &fileSystem;
+    assetCount = 0;
+
+    File manifest = fileSystem.open(manifestPath, "r");
+    if (!manifest) return false;
+
+    // Linia: <uri> <plik> <skrót> <max-age> <typ>
+    while (manifest.available() && assetCount < MAX_ASSETS) {
+        String line = manifest.readStringUntil('\n');
+        Asset& asset = assets[assetCount];
+        char etag[9];
+        unsigned long maxAge;
+        if (sscanf(line.c_str(), "%47s %55s %8s %lu %31s", asset.uri, asset.file, etag, &maxAge,
+                   asset.contentType) != 5) {
+            continue;
+        }
+        snprintf(asset.etag, sizeof(asset.etag), "\"%s\"", etag);
+        asset.maxAge = maxAge;
+        assetCount++;
+    }
+    manifest.close();
+    return assetCount > 0;
+}
+
+const WebAssets::Asset* WebAssets::find(const String& uri) const {
+    for (uint8_t i = 0; i < assetCount; i++) {
+        if (uri == assets[i].uri) return &assets[i];
+    }
+    return nullptr;
+}
+
+bool WebAssets::canHandle(AsyncWebServerRequest* request) {
+    if (request->method() != HTTP_GET || find(request->url()) == nullptr) return false;
+    // Biblioteka zachowuje tylko nagłówki zgłoszone przez handler
+    request->addInterestingHeader("If-None-Match");
+    return true;
+}
+
+void WebAssets::handleRequest(AsyncWebServerRequest* request) {
+    const Asset* asset = find(request->url());
+    if (asset == nullptr) {
+        request->send(404);
+        return;
+    }
+
+    AsyncWebServerResponse* response;
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match").indexOf(asset->etag) >= 0) {
+        // Przeglądarka ma aktualną wersję - bez treści
+        response = request->beginResponse(304);
+    } else {
+        response = request->beginResponse(*fs, asset->file, asset->contentType);
+        response->addHeader("Content-Encoding", "gzip");
+    }
+
+    char cacheControl[48];
+    if (asset->maxAge > 0) {
+        snprintf(cacheControl, sizeof(cacheControl), "public, max-age=%lu, immutable", (unsigned long)asset->maxAge);
+    } else {
+        strcpy(cacheControl, "no-cache");
+    }
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+}
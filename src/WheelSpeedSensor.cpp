@@ -0,0 +1,93 @@
+#include "WheelSpeedSensor.h"
+
+void IRAM_ATTR WheelSpeedSensor::handlePulse(void* arg) {
+    WheelSpeedSensor* sensor = (WheelSpeedSensor*)arg;
+    uint32_t now = micros();
+
+    portENTER_CRITICAL_ISR(&sensor->lock);
+    uint32_t interval = now - sensor->lastPulseUs;
+    if (sensor->pulseCount == 0 || interval >= sensor->minIntervalUs) {
+        // Po postoju okres jest nieznany - prędkość dopiero od drugiego impulsu
+        bool afterStandstill = sensor->pulseCount == 0 || interval > STANDSTILL_TIMEOUT_MS * 1000UL;
+        sensor->periodUs = afterStandstill ? 0 : interval;
+        sensor->lastPulseUs = now;
+        sensor->pulseCount++;
+    }
+    portEXIT_CRITICAL_ISR(&sensor->lock);
+}
+
+uint16_t WheelSpeedSensor::circumferenceForWheelSize(uint8_t wheelSize) {
+    // 700C: obręcz 622 mm + opona ok. 30 mm; dla rozmiarów w calach
+    // zewnętrzna średnica opony jest bliska rozmiarowi nominalnemu
+    if (wheelSize == 0) return 2136;
+    return (uint16_t)lroundf(wheelSize * 25.4f * PI);
+}
+
+void WheelSpeedSensor::begin(uint8_t sensorPin, uint16_t wheelCircumferenceMm) {
+    pin = sensorPin;
+    setCircumference(wheelCircumferenceMm);
+    lastUpdate = millis();
+
+    pinMode(pin, INPUT_PULLUP);
+    attachInterruptArg(pin, handlePulse, this, FALLING);
+}
+
+void WheelSpeedSensor::setCircumference(uint16_t wheelCircumferenceMm) {
+    if (wheelCircumferenceMm == 0) return;
+
+    // Okres obrotu przy MAX_SPEED_KMH: obwód [mm] * 3600 / prędkość [km/h] = [us]
+    portENTER_CRITICAL(&lock);
+    circumferenceMm = wheelCircumferenceMm;
+    minIntervalUs = (uint32_t)wheelCircumferenceMm * 3600UL / MAX_SPEED_KMH;
+    portEXIT_CRITICAL(&lock);
+}
+
+void WheelSpeedSensor::update(unsigned long now) {
+    portENTER_CRITICAL(&lock);
+    uint32_t count = pulseCount;
+    uint32_t lastPulse = lastPulseUs;
+    uint32_t period = periodUs;
+    uint16_t circumference = circumferenceMm;
+    portEXIT_CRITICAL(&lock);
+
+    uint32_t newPulses = count - countedPulses;
+    countedPulses = count;
+    pendingMm += newPulses * circumference;
+    rideMm += newPulses * circumference;
+
+    uint32_t sincePulse = micros() - lastPulse;
+    if (period == 0 || sincePulse > STANDSTILL_TIMEOUT_MS * 1000UL) {
+        speed = 0.0f;
+    } else {
+        // Bez kolejnego impulsu koło obraca się co najwyżej z prędkością obwód / czas od impulsu
+        if (sincePulse > period) period = sincePulse;
+        speed = circumference * 3.6f / (period / 1000.0f);
+    }
+
+    if (speed > maxSpeed) maxSpeed = speed;
+    if (speed > 0.0f) movingMs += now - lastUpdate;
+    lastUpdate = now;
+}
+
+uint32_t WheelSpeedSensor::takeMeters() {
+    uint32_t meters = pendingMm / 1000;
+    pendingMm -= meters * 1000;
+    return meters;
+}
+
+void WheelSpeedSensor::getTripStats(uint32_t& rideMillimeters, uint32_t& movingMillis, float& maxKmh) const {
+    rideMillimeters = rideMm;
+    movingMillis = movingMs;
+    maxKmh = maxSpeed;
+}
+
+void WheelSpeedSensor::restoreTripStats(uint32_t rideMillimeters, uint32_t movingMillis, float maxKmh) {
+    rideMm = rideMillimeters;
+    movingMs = movingMillis;
+    maxSpeed = maxKmh;
+}
+
+float WheelSpeedSensor::getAverageSpeed() const {
+    if (movingMs == 0) return 0.0f;
+    return rideMm * 3.6f / movingMs;
+}
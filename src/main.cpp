@@ -42,10 +42,6 @@
 #include <RTClib.h>             // Biblioteka do obsługi zegara czasu rzeczywistego (RTC)
 //#include <TimeLib.h>            // Biblioteka do obsługi funkcji czasowych
 
-// --- Biblioteki czujników temperatury ---
-#include <OneWire.h>            // Biblioteka do komunikacji z czujnikami OneWire
-#include <DallasTemperature.h>  // Biblioteka do obsługi czujników temperatury DS18B20
-
 // --- Biblioteki Bluetooth ---
 #include <BLEDevice.h>          // Główna biblioteka BLE
 //#include <BLEServer.h>          // Biblioteka do tworzenia serwera BLE
@@ -66,9 +62,38 @@
 #include <esp_partition.h>    // Biblioteka do obsługi partycji ESP32
 #include <Preferences.h>      // Biblioteka do stałej pamięci ESP32
 
+// --- Biblioteki FreeRTOS ---
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>   // Kolejki między zadaniami
+#include <freertos/semphr.h>  // Muteksy
+
 // --- Biblioteki własne ---
-#include "Odometer.h"         // Własna biblioteka do obsługi licznika kilometrów
-#include "OdometerManager.h"
+#include "OdometerManager.h"  // Licznik kilometrów (dziennik na partycji flash)
+#include "TaskScheduler.h"    // Harmonogram zadań FreeRTOS
+#include "Telemetry.h"        // Współdzielone dane pomiarowe (seqlock)
+#include "BmsRequestPipeline.h" // Nieblokujące zapytania do BMS
+#include "JbdParser.h"        // Parser ramek JBD BMS
+#include "RenderTracker.h"    // Odświeżanie tylko zmienionych obszarów OLED
+#include "PerfMonitor.h"      // Pomiar czasu wykonania podsystemów
+#include "TelemetryStream.h"  // Dane pomiarowe przez WebSocket (binarnie lub JSON)
+#include "RideLogger.h"       // Zapis przejazdu w LittleFS
+#include "WheelSpeedSensor.h" // Prędkość z czujnika koła (przerwanie)
+#include "CadenceSensor.h"    // Kadencja z czujnika PAS (licznik PCNT)
+#include "ButtonEngine.h"     // Przyciski na przerwaniach, rozpoznawanie gestów
+#include "ConfigStore.h"      // Konfiguracja w jednym pliku binarnym
+#include "LegacyConfig.h"     // Przeniesienie ustawień ze starych plików JSON
+#include "ResumeState.h"      // Stan w pamięci RTC (szybkie wznowienie po uśpieniu)
+#include "BootProfile.h"      // Czasy faz startu
+#include "WebAssets.h"        // Skompresowane pliki interfejsu webowego
+#include "RangeEstimator.h"   // Zasięg z modelu zużycia energii
+#include "SocEstimator.h"     // Stan naładowania baterii (BMS, zliczanie ładunku, OCV)
+#include "TpmsScanner.h"      // Czujniki ciśnienia w oponach (pasywne skanowanie BLE)
+#include "TemperatureEngine.h" // Czujniki DS18B20 adresowane po ROM
+#include "OneWireBench.h"     // Opóźnienie przerwań: OneWire bit po bicie vs RMT
+#include "AdcSampler.h"       // Kanały ADC1 w trybie ciągłym (DMA), kalibracja
+#include "NtcTable.h"         // Temperatura NTC z tablicy liczonej przy kompilacji
+#include "LightEngine.h"      // Światła na LEDC (jasność, rampy, miganie sprzętowe)
+#include "SystemClock.h"      // Czas z pamięci, korekta z DS3231 (SQW 1 Hz)
 
 /********************************************************************
  * DEFINICJE I STAŁE GLOBALNE
@@ -79,9 +104,8 @@
 // Wersja oprogramowania
 const char* VERSION = "20.1.25";
 
-// Nazwy plików konfiguracyjnych
-const char* CONFIG_FILE = "/display_config.json";
-const char* LIGHT_CONFIG_FILE = "/light_config.json";
+// Odpowiedzi REST: pojemność wspólnego dokumentu JSON (największa odpowiedź - /api/perf)
+const size_t WEB_JSON_CAPACITY = 7168;
 
 // Definicje pinów
 // przyciski
@@ -97,22 +121,70 @@ const char* LIGHT_CONFIG_FILE = "/light_config.json";
 // czujniki temperatury
 #define TEMP_AIR_PIN 15        // temperatutra powietrza (DS18B20)
 #define TEMP_CONTROLLER_PIN 4  // temperatura sterownika (DS18B20)
+// czujnik prędkości
+#define WHEEL_SENSOR_PIN 27    // kontaktron/hallotron koła (zwiera do GND)
+// czujnik kadencji
+#define CADENCE_SENSOR_PIN 26  // czujnik PAS (wyjście open collector)
+const uint8_t CADENCE_MAGNETS = 12;  // liczba magnesów tarczy PAS
+// napięcie baterii bez BMS (opcjonalny dzielnik, ADC1 - działa przy włączonym WiFi)
+#define BATTERY_ADC_PIN 34
+// temperatura silnika (NTC 10k do GND, 4,7k do 3,3 V, ADC1)
+#define MOTOR_NTC_PIN 35
+// wyjście SQW zegara DS3231 (1 Hz, otwarty dren)
+#define RTC_SQW_PIN 25
+const float BATTERY_ADC_RATIO = 21.0f;              // dzielnik 200k/10k
+const uint8_t BATTERY_DEFAULT_CELLS = 13;           // do pierwszej ramki BMS
+const float BATTERY_DEFAULT_CAPACITY_AH = 15.0f;    // do pierwszej ramki BMS
 
 // Stałe czasowe
-const unsigned long DEBOUNCE_DELAY = 25;
-const unsigned long BUTTON_DELAY = 200;
 const unsigned long LONG_PRESS_TIME = 1000;
 const unsigned long DOUBLE_CLICK_TIME = 300;
 const unsigned long GOODBYE_DELAY = 3000;
 const unsigned long SET_LONG_PRESS = 2000;
-const unsigned long TEMP_REQUEST_INTERVAL = 1000;
-const unsigned long DS18B20_CONVERSION_DELAY_MS = 750;
+const unsigned long LEGAL_MESSAGE_TIME = 1500;        // Komunikat o zmianie trybu legalnego
+const unsigned long BMS_UPDATE_INTERVAL = 1000;       // Cykl zapytań do BMS
+const unsigned long BMS_RESPONSE_TIMEOUT = 300;       // Maksymalny czas oczekiwania na odpowiedź
+const unsigned long BMS_RECONNECT_INTERVAL = 10000;   // Odstęp między próbami połączenia
+const uint32_t BMS_STATS_REPORT_CYCLES = 30;          // Raport opóźnień co N cykli (DEBUG)
+const unsigned long RENDER_MIN_FRAME_INTERVAL = 33;   // Limit klatek wysyłanych do OLED (~30/s)
+const unsigned long RENDER_STATS_INTERVAL = 10000;    // Raport statystyk wyświetlacza (DEBUG)
+const unsigned long MOTOR_TEMP_INTERVAL = 500;        // Publikacja temperatury silnika (NTC)
+
+// Zadania FreeRTOS - okresy [ms]
+const uint32_t INPUT_TASK_PERIOD = 20;     // przyciski (zbocze budzi zadanie od razu)
+const uint32_t SENSOR_TASK_PERIOD = 100;   // czujniki i licznik
+const uint32_t BLE_TASK_PERIOD = 50;       // komunikacja z BMS
+const uint32_t RENDER_TASK_PERIOD = 40;    // wyświetlacz (maks. 25 klatek/s)
+const uint32_t NETWORK_TASK_PERIOD = 50;   // WebSocket (subskrypcje do 20 Hz)
+
+// Zadania FreeRTOS - priorytety (wyższa wartość = ważniejsze)
+const UBaseType_t INPUT_TASK_PRIORITY = 4;
+const UBaseType_t SENSOR_TASK_PRIORITY = 3;
+const UBaseType_t BLE_TASK_PRIORITY = 2;
+const UBaseType_t RENDER_TASK_PRIORITY = 2;
+const UBaseType_t NETWORK_TASK_PRIORITY = 1;
+
+// Rozmiary kolejek
+const UBaseType_t DISPLAY_EVENT_QUEUE_LENGTH = 8;
+const UBaseType_t WS_SUBSCRIPTION_QUEUE_LENGTH = 8;
 
 // Stałe wyświetlacza
 // #define PRESSURE_LEFT_MARGIN 70
 // #define PRESSURE_TOP_LINE 62
 // #define PRESSURE_BOTTOM_LINE 62
-#define TEMP_ERROR -999.0
+
+// Obszary elementów ekranu głównego w kafelkach 8x8 px (kolejność jak DisplayWidget)
+const TileRect MAIN_SCREEN_AREAS[WIDGET_COUNT] = {
+    {0, 0, 6, 2},    // WIDGET_CLOCK
+    {7, 0, 5, 2},    // WIDGET_BATTERY
+    {12, 0, 4, 2},   // WIDGET_VOLTAGE
+    {0, 2, 3, 4},    // WIDGET_ASSIST
+    {3, 1, 4, 4},    // WIDGET_ASSIST_MODE
+    {3, 4, 5, 2},    // WIDGET_LIGHTS
+    {9, 1, 7, 4},    // WIDGET_SPEED
+    {0, 6, 16, 2},   // WIDGET_VALUE
+    {0, 6, 10, 2}    // WIDGET_DESCRIPTION
+};
 
 /********************************************************************
  * STRUKTURY I TYPY WYLICZENIOWE
@@ -143,6 +215,9 @@ struct LightSettings {
     bool dayBlink;            // Miganie w trybie dziennym
     bool nightBlink;          // Miganie w trybie nocnym
     uint16_t blinkFrequency;  // Częstotliwość migania
+    uint8_t dayBrightness;    // Jasność świateł w trybie dziennym [%]
+    uint8_t nightBrightness;  // Jasność świateł w trybie nocnym [%]
+    uint16_t rampMs;          // Czas płynnego włączania/wyłączania [ms]
 };
 
 struct BacklightSettings {
@@ -177,19 +252,6 @@ struct BluetoothConfig {
     BluetoothConfig() : bmsEnabled(false), tpmsEnabled(false) {}
 };
 
-struct BmsData {
-    float voltage;            // Napięcie całkowite [V]
-    float current;            // Prąd [A]
-    float remainingCapacity;  // Pozostała pojemność [Ah]
-    float totalCapacity;      // Całkowita pojemność [Ah]
-    uint8_t soc;              // Stan naładowania [%]
-    uint8_t cycles;           // Liczba cykli
-    float cellVoltages[16];   // Napięcia cel [V]
-    float temperatures[4];    // Temperatury [°C]
-    bool charging;            // Status ładowania
-    bool discharging;         // Status rozładowania
-};
-
 /********************************************************************
  * TYPY WYLICZENIOWE
  ********************************************************************/
@@ -253,11 +315,17 @@ enum PowerSubScreen {
 
 enum PressureSubScreen {
     PRESSURE_BAR,
-    PRESSURE_VOLTAGE,
+    PRESSURE_BATTERY,
     PRESSURE_TEMP,
     PRESSURE_SUB_COUNT
 };
 
+// Zdarzenia dla zadania wyświetlacza
+enum DisplayEvent : uint8_t {
+    DISPLAY_EVT_REDRAW,  // Zmiana stanu interfejsu - odśwież od razu
+    DISPLAY_EVT_CLEAR    // Wyczyść ekran (np. po wyjściu z konfiguracji)
+};
+
 /********************************************************************
  * ZMIENNE GLOBALNE
  ********************************************************************/
@@ -267,8 +335,44 @@ OdometerManager odometerManager;
 Preferences preferences;
 AsyncWebServer server(80);
 AsyncWebSocket ws("/ws");
+DynamicJsonDocument* webJson = nullptr;  // Wspólny dokument odpowiedzi REST (przydzielany raz)
+#if PERF_ENABLED
+// Sterta zajęta przez odpowiedź REST do jej wysłania (obiekt odpowiedzi i bufor
+// strumienia) - pomiar ESP.getFreeHeap() w handlerze, osobno dla każdego endpointu
+struct HttpHeapStats {
+    char uri[24];
+    uint32_t requests;
+    uint32_t totalBytes;
+    uint32_t maxBytes;
+};
+const uint8_t HTTP_HEAP_ENDPOINTS = 16;
+HttpHeapStats httpHeapStats[HTTP_HEAP_ENDPOINTS];
+uint32_t httpHeapBefore = 0;
+uint32_t httpMinMaxAlloc = UINT32_MAX;   // Najmniejszy największy wolny blok (fragmentacja)
+#endif
+WebAssets webAssets;                     // index.html, CSS i JS z data/www
+TelemetryStream telemetryStream;
+RideLogger rideLogger;
+WheelSpeedSensor wheelSensor;
+CadenceSensor cadenceSensor;
+RangeEstimator rangeEstimator;
+SocEstimator socEstimator(BATTERY_DEFAULT_CELLS, BATTERY_DEFAULT_CAPACITY_AH);
+TpmsScanner tpmsScanner;
+std::atomic<uint32_t> bmsBasicFrames(0);  // Licznik ramek 0x03 (zadanie BLE -> zadanie czujników)
+ButtonEngine buttons;
 //AsyncEventSource events("/events");
 
+// Zadania i kolejki FreeRTOS
+TaskScheduler scheduler;
+QueueHandle_t displayEventQueue = nullptr;  // wejście -> wyświetlacz
+QueueHandle_t wsSubscriptionQueue = nullptr; // obsługa WebSocket -> zadanie sieciowe
+SemaphoreHandle_t displayMutex = nullptr;   // dostęp do wyświetlacza
+int8_t inputTaskId = -1;
+int8_t sensorTaskId = -1;
+int8_t bleTaskId = -1;
+int8_t renderTaskId = -1;
+int8_t networkTaskId = -1;
+
 // Zmienne stanu systemu
 bool configModeActive = false;
 bool legalMode = false;
@@ -282,53 +386,20 @@ int currentSubScreen = 0;
 bool inSubScreen = false;
 uint8_t displayBrightness = 16;  // Wartość od 0 do 255 (jasność wyświetlacza)
 
-// Zmienne pomiarowe
-float speed_kmh;
-int cadence_rpm;
-float temp_air;
-float temp_controller;
-float temp_motor;
-float range_km;
-float distance_km;
-float battery_voltage;
-float battery_current;
-float battery_capacity_wh;
-float battery_capacity_ah;
-int battery_capacity_percent;
-int power_w;
-int power_avg_w;
-int power_max_w;
-float speed_avg_kmh;
-float speed_max_kmh;
-int cadence_avg_rpm;
-
-// Zmienne dla czujników ciśnienia kół
-float pressure_bar;           // przednie koło
-float pressure_rear_bar;      // tylne koło
-float pressure_voltage;       // napięcie przedniego czujnika
-float pressure_rear_voltage;  // napięcie tylnego czujnika
-float pressure_temp;          // temperatura przedniego czujnika
-float pressure_rear_temp;     // temperatura tylnego czujnika
-
-// Zmienne dla czujnika temperatury
-float currentTemp = DEVICE_DISCONNECTED_C;
-//bool temperatureReady = false;
-bool conversionRequested = false;
-unsigned long lastTempRequest = 0;
-unsigned long ds18b20RequestTime;
-
-// Zmienne dla przycisków
-unsigned long lastClickTime = 0;
-unsigned long lastButtonPress = 0;
-unsigned long lastDebounceTime = 0;
-unsigned long upPressStartTime = 0;
-unsigned long downPressStartTime = 0;
-unsigned long setPressStartTime = 0;
-unsigned long messageStartTime = 0;
-//bool firstClick = false;
-bool upLongPressExecuted = false;
-bool downLongPressExecuted = false;
-bool setLongPressExecuted = false;
+// Zmienne pomiarowe (zapis: zadania czujników i BLE, odczyt: wyświetlacz i WebSocket)
+Telemetry telemetry;
+
+// Przyciski (indeksy w ButtonEngine, kolejność addButton w setup)
+enum ButtonIndex : uint8_t {
+    BUTTON_UP,
+    BUTTON_DOWN,
+    BUTTON_SET
+};
+#define BUTTON_MASK(index) (1 << (index))
+
+// Komunikaty na ekranie
+unsigned long messageStartTime = 0;       // Powitanie/pożegnanie (po pożegnaniu - uśpienie)
+volatile unsigned long overlayUntil = 0;  // Krótki komunikat zasłaniający ekran główny
 
 // Zmienne konfiguracyjne
 int assistLevel = 3;
@@ -353,11 +424,25 @@ const uint8_t BMS_TEMP_INFO[] = {0xDD, 0xA5, 0x08, 0x00, 0xFF, 0xF8, 0x77};
 
 // Instancje obiektów globalnych
 U8G2_SSD1306_128X64_NONAME_F_HW_I2C display(U8G2_R0, U8X8_PIN_NONE);
+RenderTracker renderTracker(MAIN_SCREEN_AREAS, RENDER_MIN_FRAME_INTERVAL);
 RTC_DS3231 rtc;
-OneWire oneWireAir(TEMP_AIR_PIN);
-OneWire oneWireController(TEMP_CONTROLLER_PIN);
-DallasTemperature sensorsAir(&oneWireAir);
-DallasTemperature sensorsController(&oneWireController);
+SystemClock systemClock;
+RmtOneWire oneWireAir(TEMP_AIR_PIN, RMT_CHANNEL_0, RMT_CHANNEL_1);
+RmtOneWire oneWireController(TEMP_CONTROLLER_PIN, RMT_CHANNEL_2, RMT_CHANNEL_3);
+Ds18b20Bus sensorsAir(&oneWireAir);
+Ds18b20Bus sensorsController(&oneWireController);
+std::atomic<bool> oneWireBenchRequested(false);  // Polecenie "owbench" (wejście -> zadanie czujników)
+AdcSampler adcSampler;
+int8_t batteryAdcChannel = -1;   // Kanały AdcSampler (-1 - pin bez ADC1)
+int8_t motorNtcChannel = -1;
+TemperatureEngine temperatureEngine;
+LightEngine lightEngine;
+
+// Kanały TemperatureEngine (kolejność addChannel w initSystem)
+enum TempChannel : uint8_t {
+    TEMP_CHANNEL_AIR,
+    TEMP_CHANNEL_CONTROLLER
+};
 
 // Obiekty BLE
 BLEClient* bleClient;
@@ -366,6 +451,13 @@ BLERemoteService* bleService;
 BLERemoteCharacteristic* bleCharacteristicTx;
 BLERemoteCharacteristic* bleCharacteristicRx;
 
+// Parser odpowiedzi BMS (callback BLE -> zadanie BLE)
+JbdParser bmsParser(BMS_RESPONSE_TIMEOUT);
+
+// Kolejka zapytań do BMS
+bool requestBmsData(const uint8_t* command, size_t length);
+BmsRequestPipeline bmsPipeline(requestBmsData, BMS_UPDATE_INTERVAL, BMS_RESPONSE_TIMEOUT);
+
 // Instancje struktur konfiguracyjnych
 ControllerSettings controllerSettings;
 TimeSettings timeSettings;
@@ -374,7 +466,17 @@ BacklightSettings backlightSettings;
 WiFiSettings wifiSettings;
 GeneralSettings generalSettings;
 BluetoothConfig bluetoothConfig;
-BmsData bmsData;
+
+// Obraz konfiguracji w LittleFS i czas jego wczytania przy starcie
+ConfigStore configStore;
+uint32_t configLoadUs = 0;
+const char* configSource = "defaults";  // "bin", "json" (migracja) lub "defaults"
+
+// Start systemu: czasy faz i koniec inicjalizacji (po szybkim wznowieniu kończy się w tle)
+BootProfile bootProfile;
+volatile bool systemReady = false;
+uint32_t bootUnixTime = 0;              // Odczyt RTC przy starcie (czas próbek przejazdu)
+unsigned long bootMillis = 0;
 
 /********************************************************************
  * KLASY POMOCNICZE
@@ -414,143 +516,192 @@ class TimeoutHandler {
       }
 };
 
-// Klasa obsługująca czujnik temperatury
-class TemperatureSensor {
-    private:
-        static constexpr float INVALID_TEMP = -999.0f;
-        static constexpr float MIN_VALID_TEMP = -50.0f;
-        static constexpr float MAX_VALID_TEMP = 100.0f;
-        bool conversionRequested = false;
-        unsigned long lastRequestTime = 0;
-        DallasTemperature* airSensor;
-        DallasTemperature* controllerSensor;
-
+// Blokada wyświetlacza (RAII) - wyświetlacz jest używany przez kilka zadań
+class DisplayLock {
     public:
-        TemperatureSensor(DallasTemperature* air, DallasTemperature* controller) 
-            : airSensor(air), controllerSensor(controller) {}
-
-        void requestTemperature() {
-            if (millis() - lastRequestTime >= TEMP_REQUEST_INTERVAL) {
-                airSensor->requestTemperatures();
-                controllerSensor->requestTemperatures();
-                conversionRequested = true;
-                lastRequestTime = millis();
-            }
-        }
-
-        bool isValidTemperature(float temp) {
-            return temp >= MIN_VALID_TEMP && temp <= MAX_VALID_TEMP;
+        DisplayLock() {
+            if (displayMutex) xSemaphoreTakeRecursive(displayMutex, portMAX_DELAY);
         }
 
-        float readAirTemperature() {
-            if (!conversionRequested) return INVALID_TEMP;
-
-            if (millis() - lastRequestTime < DS18B20_CONVERSION_DELAY_MS) {
-                return INVALID_TEMP;  // Konwersja jeszcze trwa
-            }
-
-            float temp = airSensor->getTempCByIndex(0);
-            return isValidTemperature(temp) ? temp : INVALID_TEMP;
+        ~DisplayLock() {
+            if (displayMutex) xSemaphoreGiveRecursive(displayMutex);
         }
 
-        float readControllerTemperature() {
-            if (!conversionRequested) return INVALID_TEMP;
-
-            if (millis() - lastRequestTime < DS18B20_CONVERSION_DELAY_MS) {
-                return INVALID_TEMP;  // Konwersja jeszcze trwa
-            }
-
-            float temp = controllerSensor->getTempCByIndex(0);
-            return isValidTemperature(temp) ? temp : INVALID_TEMP;
-        }
+        DisplayLock(const DisplayLock&) = delete;
+        DisplayLock& operator=(const DisplayLock&) = delete;
 };
 
 /********************************************************************
  * DEKLARACJE I IMPLEMENTACJE FUNKCJI
  ********************************************************************/
 
+// Funkcje używane przed ich definicją
+void connectToBms();
+void updateTpms();
+void updateMotorTemperature(uint32_t now);
+void setLights(bool applyBacklight = true);
+void toggleLegalMode();
+bool hasSubScreens(MainScreen screen);
+int getSubScreenCount(MainScreen screen);
+void goToSleep();
+void waitForSystemReady();
+void activateConfigMode();
+void deactivateConfigMode();
+void setupWebServer();
+void applyBacklightSettings();
+
+// --- Komunikacja między zadaniami ---
+
+// wysłanie zdarzenia do zadania wyświetlacza
+void postDisplayEvent(DisplayEvent event) {
+    if (displayEventQueue == nullptr) return;
+    if (xQueueSend(displayEventQueue, &event, 0) == pdTRUE) {
+        scheduler.notify(renderTaskId);
+    }
+}
+
 // --- Funkcje BLE ---
 
-// callback dla BLE
+// callback dla BLE (wywoływany w zadaniu stosu BT - tylko kopiuje dane do bufora parsera)
 void notificationCallback(BLERemoteCharacteristic* pBLERemoteCharacteristic, 
                         uint8_t* pData, size_t length, bool isNotify) {
-    if (length < 2) return;  // Sprawdzenie minimalnej długości pakietu
+    if (length == 0) return;
 
-    switch (pData[1]) {  // Sprawdź typ pakietu
-        case 0x03:  // Basic info
-            if (length >= 34) {
-                // Napięcie całkowite (0.1V)
-                bmsData.voltage = (float)((pData[4] << 8) | pData[5]) / 10.0;
-                
-                // Prąd (0.1A, wartość ze znakiem)
-                int16_t current = (pData[6] << 8) | pData[7];
-                bmsData.current = (float)current / 10.0;
-                
-                // Pozostała pojemność (0.1Ah)
-                bmsData.remainingCapacity = (float)((pData[8] << 8) | pData[9]) / 10.0;
-                
-                // SOC (%)
-                bmsData.soc = pData[23];
-                
-                // Status ładowania/rozładowania
-                uint8_t status = pData[22];
-                bmsData.charging = (status & 0x01);
-                bmsData.discharging = (status & 0x02);
-                
-                #ifdef DEBUG
-                Serial.printf("Voltage: %.1fV, Current: %.1fA, SOC: %d%%\n", 
-                            bmsData.voltage, bmsData.current, bmsData.soc);
-                #endif
-            }
-            break;
+    // Powiadomienie może zawierać tylko fragment ramki (ograniczenie MTU)
+    bmsParser.push(pData, length);
+    scheduler.notify(bleTaskId);
+}
 
-        case 0x04:  // Cell info
-            if (length >= 34) {  // Sprawdź czy mamy kompletny pakiet
-                for (int i = 0; i < 16; i++) {
-                    bmsData.cellVoltages[i] = (float)((pData[4 + i*2] << 8) | pData[5 + i*2]) / 1000.0;
-                }
-                #ifdef DEBUG
-                Serial.println("Cell voltages updated");
-                #endif
-            }
-            break;
+// dekodowanie odebranych ramek BMS (w zadaniu BLE)
+void processBmsFrames() {
+    PERF_SCOPE(PERF_BMS);
 
-        case 0x08:  // Temperature info
-            if (length >= 12) {
-                for (int i = 0; i < 4; i++) {
-                    // Konwersja z K na °C
-                    int16_t temp = ((pData[4 + i*2] << 8) | pData[5 + i*2]) - 2731;
-                    bmsData.temperatures[i] = (float)temp / 10.0;
-                }
-                #ifdef DEBUG
-                Serial.println("Temperatures updated");
-                #endif
-            }
-            break;
+    // Tylko zadanie BLE zapisuje dane BMS, więc odczyt-modyfikacja-zapis jest bezpieczny
+    BmsData bms = telemetry.read().bms;
+    uint8_t command;
+    bool updated = false;
+    bool basicInfo = false;
+
+    while (bmsParser.poll(bms, command, millis())) {
+        updated = true;
+        bmsPipeline.onResponse(command, millis());
+
+        // Napięcie i prąd (ramka 0x03) - energia do modelu zasięgu
+        if (command == 0x03) {
+            basicInfo = true;
+            rangeEstimator.addPowerSample(bms.voltage, bms.current, millis());
+        }
+
+        #ifdef DEBUG
+        switch (command) {
+            case 0x03:
+                Serial.printf("Voltage: %.2fV, Current: %.2fA, SOC: %d%%\n", 
+                            bms.voltage, bms.current, bms.soc);
+                break;
+            case 0x04:
+                Serial.printf("Cell voltages updated (%d)\n", bms.cellCount);
+                break;
+            case 0x08:
+                Serial.printf("Temperatures updated (%d)\n", bms.ntcCount);
+                break;
+        }
+        #endif
+    }
+
+    if (updated) {
+        telemetry.update([&](TelemetrySnapshot& t) {
+            t.bms = bms;
+        });
+        // Po publikacji - zadanie czujników czyta już nowe dane
+        if (basicInfo) bmsBasicFrames.fetch_add(1);
     }
 }
 
+// skanowanie czujników TPMS i publikacja odczytów (w zadaniu BLE)
+void updateTpms() {
+    if (!bluetoothConfig.tpmsEnabled || bleClient == nullptr) return;
+
+    uint32_t now = millis();
+    tpmsScanner.update(now, bleClient->isConnected());
+
+    // Publikacja po nowym rozgłoszeniu, a co sekundę także bez niego (czujnik może się zestarzeć)
+    static uint32_t publishedUpdates = 0;
+    static uint32_t lastPublish = 0;
+    uint32_t updates = tpmsScanner.getUpdateCount();
+    if (updates == publishedUpdates && now - lastPublish < 1000) return;
+    publishedUpdates = updates;
+    lastPublish = now;
+
+    TpmsSensor front, rear;
+    bool hasFront = tpmsScanner.getSensor(0, front, now);
+    bool hasRear = tpmsScanner.getSensor(1, rear, now);
+
+    telemetry.update([&](TelemetrySnapshot& t) {
+        t.pressure_bar = hasFront ? front.reading.pressureBar : 0;
+        t.pressure_temp = hasFront ? front.reading.temperatureC : 0;
+        t.pressure_battery = hasFront ? front.reading.batteryPercent : 0;
+        t.pressure_rear_bar = hasRear ? rear.reading.pressureBar : 0;
+        t.pressure_rear_temp = hasRear ? rear.reading.temperatureC : 0;
+        t.pressure_rear_battery = hasRear ? rear.reading.batteryPercent : 0;
+    });
+}
+
 // wysyłanie zapytania do BMS
-void requestBmsData(const uint8_t* command, size_t length) {
+bool requestBmsData(const uint8_t* command, size_t length) {
     if (bleClient && bleClient->isConnected() && bleCharacteristicTx) {
-//        bleCharacteristicTx->writeValue(command, length);
+        bleCharacteristicTx->writeValue(const_cast<uint8_t*>(command), length, false);
+        return true;
     }
+    return false;
+}
+
+// raport czasów odpowiedzi BMS
+void printBmsStats() {
+    #ifdef DEBUG
+    for (uint8_t i = 0; i < bmsPipeline.getCommandCount(); i++) {
+        BmsCommandStats stats = bmsPipeline.getStats(i);
+        Serial.printf("BMS 0x%02X: wysłane %u, odebrane %u, timeout %u, RTT ost. %u ms, min %u ms, śr. %u ms, max %u ms\n",
+                      bmsPipeline.getCommandCode(i), stats.sent, stats.received, stats.timeouts,
+                      stats.lastLatencyMs, stats.minLatencyMs,
+                      stats.received ? stats.totalLatencyMs / stats.received : 0,
+                      stats.maxLatencyMs);
+    }
+
+    JbdParserStats parserStats = bmsParser.getStats();
+    Serial.printf("Parser JBD: ramki %u, suma kontr. %u, długość %u, koniec %u, status %u, nieznane %u, timeout %u, pominięte %u, przepełnienie %u\n",
+                  parserStats.framesOk, parserStats.checksumErrors, parserStats.lengthErrors,
+                  parserStats.endByteErrors, parserStats.statusErrors, parserStats.unknownCommands,
+                  parserStats.timeouts, parserStats.skippedBytes, parserStats.overflows);
+    #endif
 }
 
-// aktualizacja danych BMS
+// aktualizacja danych BMS (nieblokująca - wywoływana cyklicznie z zadania BLE)
 void updateBmsData() {
-    static unsigned long lastBmsUpdate = 0;
-    const unsigned long BMS_UPDATE_INTERVAL = 1000; // Aktualizuj co 1 sekundę
-
-    if (millis() - lastBmsUpdate >= BMS_UPDATE_INTERVAL) {
-        if (bleClient && bleClient->isConnected()) {
-            requestBmsData(BMS_BASIC_INFO, sizeof(BMS_BASIC_INFO));
-            delay(100);  // Krótkie opóźnienie między zapytaniami
-            requestBmsData(BMS_CELL_INFO, sizeof(BMS_CELL_INFO));
-            delay(100);
-            requestBmsData(BMS_TEMP_INFO, sizeof(BMS_TEMP_INFO));
-            lastBmsUpdate = millis();
+    unsigned long now = millis();
+
+    if (!bleClient || !bleClient->isConnected()) {
+        bmsPipeline.reset();
+        bmsParser.reset();
+
+        // Połączenie nawiązywane w tle, z ograniczoną częstotliwością prób
+        static bool connectAttempted = false;
+        static unsigned long lastConnectAttempt = 0;
+        // Nawiązywanie połączenia w trakcie skanowania TPMS często się nie udaje - po skanowaniu
+        if (bleClient && bluetoothConfig.bmsEnabled && !tpmsScanner.isScanning() &&
+            (!connectAttempted || now - lastConnectAttempt >= BMS_RECONNECT_INTERVAL)) {
+            connectAttempted = true;
+            lastConnectAttempt = now;
+            connectToBms();
         }
+        return;
+    }
+
+    uint32_t cyclesBefore = bmsPipeline.getCompletedCycles();
+    bmsPipeline.update(now);
+
+    uint32_t cycles = bmsPipeline.getCompletedCycles();
+    if (cycles != cyclesBefore && cycles % BMS_STATS_REPORT_CYCLES == 0) {
+        printBmsStats();
     }
 }
 
@@ -616,272 +767,139 @@ void connectToBms() {
 
 // --- Funkcje konfiguracji ---
 
-// zapis ustawień świateł
-void saveLightSettings() {
-    #ifdef DEBUG
-    Serial.println("Zapisywanie ustawień świateł");
-    #endif
-
-    // Przygotuj dokument JSON
-    StaticJsonDocument<256> doc;
-    
-    // Zapisz ustawienia
-    doc["dayLights"] = lightSettings.dayLights;
-    doc["nightLights"] = lightSettings.nightLights;
-    doc["dayBlink"] = lightSettings.dayBlink;
-    doc["nightBlink"] = lightSettings.nightBlink;
-    doc["blinkFrequency"] = lightSettings.blinkFrequency;
-
-    // Otwórz plik do zapisu
-    File file = LittleFS.open("/lights.json", "w");
-    if (!file) {
-        #ifdef DEBUG
-        Serial.println("Błąd otwarcia pliku do zapisu");
-        #endif
-        return;
-    }
-
-    // Zapisz JSON do pliku
-    if (serializeJson(doc, file) == 0) {
-        #ifdef DEBUG
-        Serial.println("Błąd podczas zapisu do pliku");
-        #endif
-    }
-
-    file.close();
-
-    #ifdef DEBUG
-    Serial.println("Ustawienia świateł zapisane");
-    Serial.print("dayLights: "); Serial.println(lightSettings.dayLights);
-    Serial.print("nightLights: "); Serial.println(lightSettings.nightLights);
-    #endif
-
-    // Od razu zastosuj nowe ustawienia
-    setLights();
-}
-
-// wczytywanie ustawień świateł
-void loadLightSettings() {
-    #ifdef DEBUG
-    Serial.println("Wczytywanie ustawień świateł");
-    #endif
-
-    if (LittleFS.exists("/lights.json")) {
-        File file = LittleFS.open("/lights.json", "r");
-        if (file) {
-            StaticJsonDocument<512> doc;
-            DeserializationError error = deserializeJson(doc, file);
-            file.close();
-
-            if (!error) {
-                const char* dayLightsStr = doc["dayLights"] | "FRONT";
-                const char* nightLightsStr = doc["nightLights"] | "BOTH";
-
-                // Konwersja stringów na enum
-                if (strcmp(dayLightsStr, "FRONT") == 0) 
-                    lightSettings.dayLights = LightSettings::FRONT;
-                else if (strcmp(dayLightsStr, "REAR") == 0) 
-                    lightSettings.dayLights = LightSettings::REAR;
-                else if (strcmp(dayLightsStr, "BOTH") == 0) 
-                    lightSettings.dayLights = LightSettings::BOTH;
-                else 
-                    lightSettings.dayLights = LightSettings::NONE;
-
-                if (strcmp(nightLightsStr, "FRONT") == 0) 
-                    lightSettings.nightLights = LightSettings::FRONT;
-                else if (strcmp(nightLightsStr, "REAR") == 0) 
-                    lightSettings.nightLights = LightSettings::REAR;
-                else if (strcmp(nightLightsStr, "BOTH") == 0) 
-                    lightSettings.nightLights = LightSettings::BOTH;
-                else 
-                    lightSettings.nightLights = LightSettings::NONE;
-
-                lightSettings.dayBlink = doc["dayBlink"] | false;
-                lightSettings.nightBlink = doc["nightBlink"] | false;
-                lightSettings.blinkFrequency = doc["blinkFrequency"] | 500;
-            }
-        }
-    } else {
-        // Ustawienia domyślne
-        lightSettings.dayLights = LightSettings::FRONT;
-        lightSettings.nightLights = LightSettings::BOTH;
-        lightSettings.dayBlink = false;
-        lightSettings.nightBlink = false;
-        lightSettings.blinkFrequency = 500;
-    }
-}
-
-// ustawianie jasności wyświetlacza
-void setDisplayBrightness(uint8_t brightness) {
-    displayBrightness = brightness;
-    display.setContrast(displayBrightness);
+// przepisanie obrazu konfiguracji do struktur roboczych
+void applyConfig() {
+    const ConfigLights& lights = configStore.lights();
+    lightSettings.dayLights = static_cast<LightSettings::LightMode>(lights.dayLights);
+    lightSettings.nightLights = static_cast<LightSettings::LightMode>(lights.nightLights);
+    lightSettings.dayBlink = lights.dayBlink;
+    lightSettings.nightBlink = lights.nightBlink;
+    lightSettings.blinkFrequency = lights.blinkFrequency;
+    lightSettings.dayBrightness = configStore.lightLevels().dayBrightness;
+    lightSettings.nightBrightness = configStore.lightLevels().nightBrightness;
+    lightSettings.rampMs = configStore.lightLevels().rampMs;
+
+    const ConfigBacklight& backlight = configStore.backlight();
+    backlightSettings.dayBrightness = backlight.dayBrightness;
+    backlightSettings.nightBrightness = backlight.nightBrightness;
+    backlightSettings.autoMode = backlight.autoMode;
+
+    const ConfigWifi& wifi = configStore.wifi();
+    strlcpy(wifiSettings.ssid, wifi.ssid, sizeof(wifiSettings.ssid));
+    strlcpy(wifiSettings.password, wifi.password, sizeof(wifiSettings.password));
+
+    const ConfigController& controller = configStore.controller();
+    controllerSettings.type = controller.type == CONTROLLER_S866 ? "s866" : "kt-lcd";
+    for (int i = 0; i < 23; i++) {
+        controllerSettings.ktParams[i] = controller.ktParams[i];
+    }
+    for (int i = 0; i < 20; i++) {
+        controllerSettings.s866Params[i] = controller.s866Params[i];
+    }
+
+    generalSettings.wheelSize = configStore.general().wheelSize;
+    timeSettings.ntpEnabled = configStore.general().ntpEnabled;
+
+    bluetoothConfig.bmsEnabled = configStore.bluetooth().bmsEnabled;
+    bluetoothConfig.tpmsEnabled = configStore.bluetooth().tpmsEnabled;
 }
 
-// zapis ustawień podświetlenia
-void saveBacklightSettingsToFile() {
-    File file = LittleFS.open(CONFIG_FILE, "w");
-    if (!file) {
-        #ifdef DEBUG
-        Serial.println("Nie można otworzyć pliku do zapisu");
-        #endif
-        return;
-    }
-
-    StaticJsonDocument<200> doc;
-    doc["dayBrightness"] = backlightSettings.dayBrightness;
-    doc["nightBrightness"] = backlightSettings.nightBrightness;
-    doc["autoMode"] = backlightSettings.autoMode;
-
-    // Zapisz JSON do pliku
-    if (serializeJson(doc, file)) {
+// zapis wszystkich ustawień do /config.bin
+void saveConfig() {
+    ConfigLights lights;
+    lights.dayLights = lightSettings.dayLights;
+    lights.nightLights = lightSettings.nightLights;
+    lights.dayBlink = lightSettings.dayBlink;
+    lights.nightBlink = lightSettings.nightBlink;
+    lights.blinkFrequency = lightSettings.blinkFrequency;
+    configStore.setLights(lights);
+
+    ConfigLightLevels lightLevels;
+    lightLevels.dayBrightness = constrain(lightSettings.dayBrightness, 0, 100);
+    lightLevels.nightBrightness = constrain(lightSettings.nightBrightness, 0, 100);
+    lightLevels.rampMs = lightSettings.rampMs;
+    configStore.setLightLevels(lightLevels);
+
+    ConfigBacklight backlight;
+    backlight.dayBrightness = constrain(backlightSettings.dayBrightness, 0, 100);
+    backlight.nightBrightness = constrain(backlightSettings.nightBrightness, 0, 100);
+    backlight.autoMode = backlightSettings.autoMode;
+    configStore.setBacklight(backlight);
+
+    ConfigWifi wifi;
+    memset(&wifi, 0, sizeof(wifi));
+    strlcpy(wifi.ssid, wifiSettings.ssid, sizeof(wifi.ssid));
+    strlcpy(wifi.password, wifiSettings.password, sizeof(wifi.password));
+    configStore.setWifi(wifi);
+
+    ConfigController controller;
+    controller.type = controllerSettings.type == "s866" ? CONTROLLER_S866 : CONTROLLER_KT_LCD;
+    for (int i = 0; i < 23; i++) {
+        controller.ktParams[i] = controllerSettings.ktParams[i];
+    }
+    for (int i = 0; i < 20; i++) {
+        controller.s866Params[i] = controllerSettings.s866Params[i];
+    }
+    configStore.setController(controller);
+
+    ConfigGeneral general;
+    general.wheelSize = generalSettings.wheelSize;
+    general.ntpEnabled = timeSettings.ntpEnabled;
+    configStore.setGeneral(general);
+
+    ConfigBluetooth bluetooth;
+    bluetooth.bmsEnabled = bluetoothConfig.bmsEnabled;
+    bluetooth.tpmsEnabled = bluetoothConfig.tpmsEnabled;
+    configStore.setBluetooth(bluetooth);
+
+    if (!configStore.save()) {
         #ifdef DEBUG
-        Serial.println("Zapisano ustawienia do pliku");
-        #endif
-    } else {
-        #ifdef DEBUG
-        Serial.println("Błąd podczas zapisu do pliku");
+        Serial.println("Błąd zapisu konfiguracji");
         #endif
     }
-    
-    file.close();
 }
 
-// wczytywanie ustawień podświetlenia
-void loadBacklightSettingsFromFile() {
-    File file = LittleFS.open(CONFIG_FILE, "r");
-    if (!file) {
+// wczytanie konfiguracji przy starcie
+void loadConfig() {
+    uint32_t start = micros();
+
+    if (configStore.begin(LittleFS)) {
+        applyConfig();
+        configLoadUs = micros() - start;
+        configSource = "bin";
         #ifdef DEBUG
-        Serial.println("Brak pliku konfiguracyjnego, używam ustawień domyślnych");
+        Serial.printf("Konfiguracja wczytana z /config.bin (%u B) w %u us\n",
+                      (unsigned)ConfigStore::getImageSize(), (unsigned)configLoadUs);
         #endif
-        // Ustaw wartości domyślne
-        backlightSettings.dayBrightness = 100;
-        backlightSettings.nightBrightness = 50;
-        backlightSettings.autoMode = false;
-        // Zapisz domyślne ustawienia do pliku
-        saveBacklightSettingsToFile();
         return;
     }
 
-    StaticJsonDocument<200> doc;
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
+    // Brak obrazu: wartości domyślne, nadpisywane ustawieniami ze starych plików
+    if (!LegacyConfig::read(LittleFS, configStore)) {
+        applyConfig();
+        configLoadUs = micros() - start;
         #ifdef DEBUG
-        Serial.println("Błąd podczas parsowania JSON, używam ustawień domyślnych");
+        Serial.println("Brak pliku konfiguracji, używam ustawień domyślnych");
         #endif
-        // Ustaw wartości domyślne
-        backlightSettings.dayBrightness = 100;
-        backlightSettings.nightBrightness = 50;
-        backlightSettings.autoMode = false;
         return;
     }
 
-    // Wczytaj ustawienia
-    backlightSettings.dayBrightness = doc["dayBrightness"] | 100;
-    backlightSettings.nightBrightness = doc["nightBrightness"] | 50;
-    backlightSettings.autoMode = doc["autoMode"] | false;
+    // Czas odczytu starych plików (bez zapisu obrazu) - odpowiada dawnemu startowi
+    applyConfig();
+    configLoadUs = micros() - start;
+    configSource = "json";
+    LegacyConfig::commit(LittleFS, configStore);
 
     #ifdef DEBUG
-    Serial.println("Wczytano ustawienia z pliku:");
-    Serial.print("Day Brightness: "); Serial.println(backlightSettings.dayBrightness);
-    Serial.print("Night Brightness: "); Serial.println(backlightSettings.nightBrightness);
-    Serial.print("Auto Mode: "); Serial.println(backlightSettings.autoMode);
+    Serial.printf("Konfiguracja przeniesiona z plików JSON (odczyt %u us)\n", (unsigned)configLoadUs);
     #endif
 }
 
-// zapis ustawień ogólnych
-void saveGeneralSettingsToFile() {
-    File file = LittleFS.open("/general_config.json", "w");
-    if (!file) {
-        #ifdef DEBUG
-        Serial.println("Nie można otworzyć pliku ustawień ogólnych do zapisu");
-        #endif
-        return;
-    }
-
-    StaticJsonDocument<64> doc;
-    doc["wheelSize"] = generalSettings.wheelSize;
-
-    if (serializeJson(doc, file) == 0) {
-        #ifdef DEBUG
-        Serial.println("Błąd podczas zapisu ustawień ogólnych");
-        #endif
-    }
-
-    file.close();
-}
-
-// zapis konfiguracji Bluetooth
-void saveBluetoothConfigToFile() {
-    File file = LittleFS.open("/bluetooth_config.json", "w");
-    if (!file) {
-        #ifdef DEBUG
-        Serial.println("Nie można otworzyć pliku konfiguracji Bluetooth");
-        #endif
-        return;
-    }
-
-    StaticJsonDocument<64> doc;
-    doc["bmsEnabled"] = bluetoothConfig.bmsEnabled;
-    doc["tpmsEnabled"] = bluetoothConfig.tpmsEnabled;
-
-    serializeJson(doc, file);
-    file.close();
-}
-
-// wczytywanie konfiguracji Bluetooth
-void loadBluetoothConfigFromFile() {
-    File file = LittleFS.open("/bluetooth_config.json", "r");
-    if (!file) {
-        #ifdef DEBUG
-        Serial.println("Nie znaleziono pliku konfiguracji Bluetooth, używam domyślnych");
-        #endif
-        return;
-    }
-
-    StaticJsonDocument<64> doc;
-    DeserializationError error = deserializeJson(doc, file);
-    
-    if (!error) {
-        bluetoothConfig.bmsEnabled = doc["bmsEnabled"] | false;
-        bluetoothConfig.tpmsEnabled = doc["tpmsEnabled"] | false;
-    }
-    
-    file.close();
-}
-
-// wczytywanie ustawień ogólnych
-void loadGeneralSettingsFromFile() {
-    File file = LittleFS.open("/general_config.json", "r");
-    if (!file) {
-        #ifdef DEBUG
-        Serial.println("Nie znaleziono pliku ustawień ogólnych, używam domyślnych");
-        #endif
-        generalSettings.wheelSize = 26; // Wartość domyślna
-        saveGeneralSettingsToFile(); // Zapisz domyślne ustawienia
-        return;
-    }
-
-    StaticJsonDocument<64> doc;
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
-        #ifdef DEBUG
-        Serial.println("Błąd podczas parsowania JSON ustawień ogólnych");
-        #endif
-        generalSettings.wheelSize = 26; // Wartość domyślna
-        saveGeneralSettingsToFile(); // Zapisz domyślne ustawienia
-        return;
-    }
-
-    generalSettings.wheelSize = doc["wheelSize"] | 26; // Domyślnie 26 cali jeśli nie znaleziono
-
-    #ifdef DEBUG
-    Serial.print("Loaded wheel size: ");
-    Serial.println(generalSettings.wheelSize);
-    #endif
+// ustawianie jasności wyświetlacza
+void setDisplayBrightness(uint8_t brightness) {
+    displayBrightness = brightness;
+    DisplayLock lock;   // Magistrala I2C wspólna z zadaniem rysowania
+    display.setContrast(displayBrightness);
 }
 
 // --- Funkcje wyświetlacza ---
@@ -899,15 +917,15 @@ void drawVerticalLine() {
 }
 
 // rysowanie górnego paska
-void drawTopBar() {
+void drawTopBar(const TelemetrySnapshot& t) {
     static bool colonVisible = true;
     static unsigned long lastColonToggle = 0;
     const unsigned long COLON_TOGGLE_INTERVAL = 500;  // Miganie co 500ms (pół sekundy)
 
     display.setFont(czcionka_srednia);
 
-    // Pobierz aktualny czas z RTC
-    DateTime now = rtc.now();
+    // Czas z pamięci (bez transakcji I2C)
+    DateTime now(systemClock.now());
 
     // Czas z migającym dwukropkiem
     char timeStr[6];
@@ -917,6 +935,7 @@ void drawTopBar() {
         sprintf(timeStr, "%02d %02d", now.hour(), now.minute());
     }
     display.drawStr(0, 10, timeStr);
+    renderTracker.touch(WIDGET_CLOCK, timeStr);
 
     // Przełącz stan dwukropka co COLON_TOGGLE_INTERVAL
     if (millis() - lastColonToggle >= COLON_TOGGLE_INTERVAL) {
@@ -926,18 +945,21 @@ void drawTopBar() {
 
     // Bateria
     char battStr[5];
-    sprintf(battStr, "%d%%", battery_capacity_percent);
+    sprintf(battStr, "%d%%", t.battery_capacity_percent);
     display.drawStr(58, 10, battStr);
+    renderTracker.touch(WIDGET_BATTERY, battStr);
 
     // Napięcie
     char voltStr[6];
-    sprintf(voltStr, "%.0fV", battery_voltage);
+    sprintf(voltStr, "%.0fV", t.battery_voltage);
     display.drawStr(100, 10, voltStr);
+    renderTracker.touch(WIDGET_VOLTAGE, voltStr);
 }
 
 // wyświetlanie statusu świateł
 void drawLightStatus() {
     display.setFont(czcionka_mala);
+    renderTracker.touch(WIDGET_LIGHTS, (uint32_t)lightMode);
 
     switch (lightMode) {
         case 1:
@@ -952,6 +974,7 @@ void drawLightStatus() {
 // wyświetlanie poziomu wspomagania
 void drawAssistLevel() {
     display.setFont(czcionka_duza);
+    renderTracker.touch(WIDGET_ASSIST, (uint32_t)assistLevel | (legalMode << 8) | (assistLevelAsText << 9));
 
     if (assistLevelAsText) {
          display.drawStr(2, 40, "T");
@@ -1020,6 +1043,7 @@ void drawAssistLevel() {
     }
     display.drawStr(30, 23, modeText);  // wyświetl rodzaj sterowania
     display.drawStr(30, 34, modeText2);  // wyświetl STOP przy hamowaniu
+    renderTracker.touch(WIDGET_ASSIST_MODE, (uint32_t)assistMode);
 }
 
 // wyświetlanie wartości i jednostki
@@ -1048,10 +1072,15 @@ void drawValueAndUnit(const char* valueStr, const char* unitStr) {
     // Rysowanie jednostki małą czcionką
     display.setFont(czcionka_mala);
     display.drawStr(xPosUnit, 62, unitStr);
+
+    renderTracker.touch(WIDGET_VALUE, valueStr);
+    renderTracker.touch(WIDGET_VALUE, unitStr);
 }
 
 // Implementacja głównego ekranu
-void drawMainDisplay() {
+void drawMainDisplay(const TelemetrySnapshot& t) {
+    PERF_SCOPE(PERF_DISPLAY);
+
     display.setFont(czcionka_mala);
     char valueStr[10];
     const char* unitStr;
@@ -1064,17 +1093,17 @@ void drawMainDisplay() {
             case SPEED_SCREEN:
                 switch (currentSubScreen) {
                     case SPEED_KMH:
-                        sprintf(valueStr, "%4.1f", speed_kmh);
+                        sprintf(valueStr, "%4.1f", t.speed_kmh);
                         unitStr = "km/h";
                         descText = ">Predkosc";
                         break;
                     case SPEED_AVG_KMH:
-                        sprintf(valueStr, "%4.1f", speed_avg_kmh);
+                        sprintf(valueStr, "%4.1f", t.speed_avg_kmh);
                         unitStr = "km/h";
                         descText = ">Pred. AVG";
                         break;
                     case SPEED_MAX_KMH:
-                        sprintf(valueStr, "%4.1f", speed_max_kmh);
+                        sprintf(valueStr, "%4.1f", t.speed_max_kmh);
                         unitStr = "km/h";
                         descText = ">Pred. MAX";
                         break;
@@ -1084,12 +1113,12 @@ void drawMainDisplay() {
             case CADENCE_SCREEN:
                 switch (currentSubScreen) {
                     case CADENCE_RPM:
-                        sprintf(valueStr, "%4d", cadence_rpm);
+                        sprintf(valueStr, "%4d", t.cadence_rpm);
                         unitStr = "RPM";
                         descText = ">Kadencja";
                         break;
                     case CADENCE_AVG_RPM:
-                        sprintf(valueStr, "%4d", cadence_avg_rpm);
+                        sprintf(valueStr, "%4d", t.cadence_avg_rpm);
                         unitStr = "RPM";
                         descText = ">Kadencja AVG";
                         break;
@@ -1099,8 +1128,8 @@ void drawMainDisplay() {
             case TEMP_SCREEN:
                 switch (currentSubScreen) {
                     case TEMP_AIR:
-                        if (currentTemp != TEMP_ERROR && currentTemp != DEVICE_DISCONNECTED_C) {
-                            sprintf(valueStr, "%4.1f", currentTemp);
+                        if (t.temp_air != DEVICE_DISCONNECTED_C) {
+                            sprintf(valueStr, "%4.1f", t.temp_air);
                         } else {
                             strcpy(valueStr, "---");
                         }
@@ -1108,12 +1137,20 @@ void drawMainDisplay() {
                         descText = ">Powietrze";
                         break;
                     case TEMP_CONTROLLER:
-                        sprintf(valueStr, "%4.1f", temp_controller);
+                        if (t.temp_controller != DEVICE_DISCONNECTED_C) {
+                            sprintf(valueStr, "%4.1f", t.temp_controller);
+                        } else {
+                            strcpy(valueStr, "---");
+                        }
                         unitStr = "C";
                         descText = ">Sterownik";
                         break;
                     case TEMP_MOTOR:
-                        sprintf(valueStr, "%4.1f", temp_motor);
+                        if (t.temp_motor != DEVICE_DISCONNECTED_C) {
+                            sprintf(valueStr, "%4.1f", t.temp_motor);
+                        } else {
+                            strcpy(valueStr, "---");
+                        }
                         unitStr = "C";
                         descText = ">Silnik";
                         break;
@@ -1123,17 +1160,17 @@ void drawMainDisplay() {
             case RANGE_SCREEN:
                 switch (currentSubScreen) {
                     case RANGE_KM:
-                        sprintf(valueStr, "%4.1f", range_km);
+                        sprintf(valueStr, "%4.1f", t.range_km);
                         unitStr = "km";
                         descText = ">Zasieg";
                         break;
                     case DISTANCE_KM:
-                        sprintf(valueStr, "%4.1f", distance_km);
+                        sprintf(valueStr, "%4.1f", t.distance_km);
                         unitStr = "km";
                         descText = ">Dystans";
                         break;
                     case ODOMETER_KM:
-                        sprintf(valueStr, "%4.0f", odometerManager.getRawTotal());
+                        sprintf(valueStr, "%4.0f", odometerManager.getTotalDistance());
                         unitStr = "km";
                         descText = ">Przebieg";
                         break;
@@ -1143,27 +1180,27 @@ void drawMainDisplay() {
             case BATTERY_SCREEN:
                 switch (currentSubScreen) {
                     case BATTERY_VOLTAGE:
-                        sprintf(valueStr, "%4.1f", battery_voltage);
+                        sprintf(valueStr, "%4.1f", t.battery_voltage);
                         unitStr = "V";
                         descText = ">Napiecie";
                         break;
                     case BATTERY_CURRENT:
-                        sprintf(valueStr, "%4.1f", battery_current);
+                        sprintf(valueStr, "%4.1f", t.battery_current);
                         unitStr = "A";
                         descText = ">Natezenie";
                         break;
                     case BATTERY_CAPACITY_WH:
-                        sprintf(valueStr, "%4.0f", battery_capacity_wh);
+                        sprintf(valueStr, "%4.0f", t.battery_capacity_wh);
                         unitStr = "Wh";
                         descText = ">Energia";
                         break;
                     case BATTERY_CAPACITY_AH:
-                        sprintf(valueStr, "%4.1f", battery_capacity_wh);
+                        sprintf(valueStr, "%4.1f", t.battery_capacity_ah);
                         unitStr = "Ah";
                         descText = ">Pojemnosc";
                         break;
                     case BATTERY_CAPACITY_PERCENT:
-                        sprintf(valueStr, "%3d", battery_capacity_percent);
+                        sprintf(valueStr, "%5.1f", t.battery_soc);
                         unitStr = "%";
                         descText = ">Bateria";
                         break;
@@ -1173,17 +1210,17 @@ void drawMainDisplay() {
             case POWER_SCREEN:
                 switch (currentSubScreen) {
                     case POWER_W:
-                        sprintf(valueStr, "%4d", power_w);
+                        sprintf(valueStr, "%4d", t.power_w);
                         unitStr = "W";
                         descText = ">Moc";
                         break;
                     case POWER_AVG_W:
-                        sprintf(valueStr, "%4d", power_avg_w);
+                        sprintf(valueStr, "%4d", t.power_avg_w);
                         unitStr = "W";
                         descText = ">Moc AVG";
                         break;
                     case POWER_MAX_W:
-                        sprintf(valueStr, "%4d", power_max_w);
+                        sprintf(valueStr, "%4d", t.power_max_w);
                         unitStr = "W";
                         descText = ">Moc MAX";
                         break;
@@ -1194,19 +1231,19 @@ void drawMainDisplay() {
                 char combinedStr[16];
                 switch (currentSubScreen) {
                     case PRESSURE_BAR:
-                        sprintf(combinedStr, "%.2f|%.2f", pressure_bar, pressure_rear_bar);
+                        sprintf(combinedStr, "%.2f|%.2f", t.pressure_bar, t.pressure_rear_bar);
                         strcpy(valueStr, combinedStr);
                         unitStr = "bar";
                         descText = ">Cis";
                         break;
-                    case PRESSURE_VOLTAGE:
-                        sprintf(combinedStr, "%.2f|%.2f", pressure_voltage, pressure_rear_voltage);
+                    case PRESSURE_BATTERY:
+                        sprintf(combinedStr, "%d|%d", t.pressure_battery, t.pressure_rear_battery);
                         strcpy(valueStr, combinedStr);
-                        unitStr = "V";
+                        unitStr = "%";
                         descText = ">Bat";
                         break;
                     case PRESSURE_TEMP:
-                        sprintf(combinedStr, "%.1f|%.1f", pressure_temp, pressure_rear_temp);
+                        sprintf(combinedStr, "%.1f|%.1f", t.pressure_temp, t.pressure_rear_temp);
                         strcpy(valueStr, combinedStr);
                         unitStr = "C";
                         descText = ">Temp";
@@ -1220,20 +1257,20 @@ void drawMainDisplay() {
         switch (currentMainScreen) {
 
             case SPEED_SCREEN:
-                sprintf(valueStr, "%4.1f", speed_kmh);
+                sprintf(valueStr, "%4.1f", t.speed_kmh);
                 unitStr = "km/h";
                 descText = " Predkosc";
                 break;
           
             case CADENCE_SCREEN:
-                sprintf(valueStr, "%4d", cadence_rpm);
+                sprintf(valueStr, "%4d", t.cadence_rpm);
                 unitStr = "RPM";
                 descText = " Kadencja";
                 break;
 
             case TEMP_SCREEN:
-                if (currentTemp != TEMP_ERROR && currentTemp != DEVICE_DISCONNECTED_C) {
-                    sprintf(valueStr, "%4.1f", currentTemp);
+                if (t.temp_air != DEVICE_DISCONNECTED_C) {
+                    sprintf(valueStr, "%4.1f", t.temp_air);
                 } else {
                     strcpy(valueStr, "---");
                 }
@@ -1242,25 +1279,25 @@ void drawMainDisplay() {
                 break;
 
             case RANGE_SCREEN:
-                sprintf(valueStr, "%4.1f", range_km);
+                sprintf(valueStr, "%4.1f", t.range_km);
                 unitStr = "km";
                 descText = " Zasieg";
                 break;
 
             case BATTERY_SCREEN:
-                sprintf(valueStr, "%3d", battery_capacity_percent);
+                sprintf(valueStr, "%3d", t.battery_capacity_percent);
                 unitStr = "%";
                 descText = " Bateria";
                 break;
 
             case POWER_SCREEN:
-                sprintf(valueStr, "%4d", power_w);
+                sprintf(valueStr, "%4d", t.power_w);
                 unitStr = "W";
                 descText = " Moc";
                 break;
 
             case PRESSURE_SCREEN:
-                sprintf(valueStr, "%.1f/%.1f", pressure_bar, pressure_rear_bar);
+                sprintf(valueStr, "%.1f/%.1f", t.pressure_bar, t.pressure_rear_bar);
                 unitStr = "bar";
                 descText = " Kola";
                 break;
@@ -1268,21 +1305,23 @@ void drawMainDisplay() {
             case USB_SCREEN:
                 display.setFont(czcionka_srednia);
                 display.drawStr(48, 61, usbEnabled ? "Wlaczone" : "Wylaczone");
+                renderTracker.touch(WIDGET_VALUE, usbEnabled ? "Wlaczone" : "Wylaczone");
                 descText = " USB";
                 break;
         }
     }
    
     char speedStr[10]; // Bufor na sformatowaną prędkość
-    if (speed_kmh < 10.0) {
-        sprintf(speedStr, "  %2.1f", speed_kmh);  // Dodaj spację przed liczbą
+    if (t.speed_kmh < 10.0) {
+        sprintf(speedStr, "  %2.1f", t.speed_kmh);  // Dodaj spację przed liczbą
     } else {
-        sprintf(speedStr, "%2.1f", speed_kmh);   // Bez spacji
+        sprintf(speedStr, "%2.1f", t.speed_kmh);   // Bez spacji
     }
 
     // Wyświetl prędkość dużą czcionką
     display.setFont(czcionka_duza);
     display.drawStr(72, 35, speedStr);
+    renderTracker.touch(WIDGET_SPEED, speedStr);
 
     // Wyświetl jednostkę małą czcionką pod prędkością
     display.setFont(czcionka_mala);
@@ -1295,6 +1334,7 @@ void drawMainDisplay() {
 
     display.setFont(czcionka_mala);
     display.drawStr(0, 62, descText);
+    renderTracker.touch(WIDGET_DESCRIPTION, descText);
 }
 
 // wyświetlanie wycentrowanego tekstu
@@ -1318,6 +1358,7 @@ void drawCenteredText(const char* text, int y, const uint8_t* font) {
 
 // wyświetlanie wiadomości powitalnej
 void showWelcomeMessage() {
+    DisplayLock lock;
     display.clearBuffer();
     display.setFont(czcionka_srednia); // Ustaw domyślną czcionkę na początku
 
@@ -1363,183 +1404,159 @@ void showWelcomeMessage() {
         }
     }
 
+    renderTracker.invalidate();
     welcomeAnimationDone = true;
 }
 
 // --- Funkcje obsługi przycisków ---
 
-// obsługa przycisków
-void handleButtons() {
-    if (configModeActive) {
-        return; // W trybie konfiguracji nie obsługuj normalnych funkcji przycisków
-    }
+// Konteksty, w których obowiązuje przypisanie gestu
+enum ButtonContext : uint8_t {
+    BUTTON_CTX_OFF = 0x01,      // Wyświetlacz wyłączony
+    BUTTON_CTX_ACTIVE = 0x02,   // Ekran główny
+    BUTTON_CTX_CONFIG = 0x04    // Tryb konfiguracji
+};
 
-    unsigned long currentTime = millis();
-    bool setState = digitalRead(BTN_SET);
-    bool upState = digitalRead(BTN_UP);
-    bool downState = digitalRead(BTN_DOWN);
-
-    static unsigned long lastButtonCheck = 0;
-    static unsigned long bothPressStart = 0;
-    static bool upPressed = false;
-    static bool downPressed = false;
-    static unsigned long upPressTime = 0;
-    static unsigned long downPressTime = 0;
-    const unsigned long buttonDebounce = 50;
-    static unsigned long legalModeStart = 0;
-
-    // Obsługa włączania/wyłączania wyświetlacza
-    if (!displayActive) {
-        if (!setState && (currentTime - lastDebounceTime) > DEBOUNCE_DELAY) {
-            if (!setPressStartTime) {
-                setPressStartTime = currentTime;
-            } else if (!setLongPressExecuted && (currentTime - setPressStartTime) > SET_LONG_PRESS) {
-                if (!welcomeAnimationDone) {
-                    showWelcomeMessage();  // Pokaż animację powitania
-                } 
-                messageStartTime = currentTime;
-                setLongPressExecuted = true;
-                showingWelcome = true;
-                displayActive = true;
-            }
-        } else if (setState && setPressStartTime) {
-            setPressStartTime = 0;
-            setLongPressExecuted = false;
-            lastDebounceTime = currentTime;
-        }
-        return;
+// Przypisanie gestu do akcji
+struct ButtonBinding {
+    ButtonGesture gesture;
+    uint8_t buttons;            // Maska przycisków
+    uint8_t contexts;           // Maska ButtonContext
+    void (*action)();
+};
+
+// włączenie wyświetlacza (długie przytrzymanie SET)
+void buttonPowerOn() {
+    if (!welcomeAnimationDone) {
+        showWelcomeMessage();  // Pokaż animację powitania
     }
+    messageStartTime = millis();
+    showingWelcome = true;
+    displayActive = true;
+}
 
-    // Obsługa przycisków gdy wyświetlacz jest aktywny
-    if (!showingWelcome) {
+// pożegnanie i uśpienie po GOODBYE_DELAY (długie przytrzymanie SET)
+void buttonPowerOff() {
+    DisplayLock lock;
+    display.clearBuffer();
+    display.setFont(czcionka_srednia);
+    display.drawStr(5, 32, "Do widzenia ;)");
+    display.sendBuffer();
+    renderTracker.invalidate();
+    messageStartTime = millis();
+}
 
-        // Sprawdzanie trybu legal (UP + SET) - przełączanie trybu legalnego
-        if (displayActive && !showingWelcome && !upState && !setState) {
-            if (legalModeStart == 0) {
-                legalModeStart = currentTime;
-            } else if ((currentTime - legalModeStart) > 500) { // 2 sekundy  przytrzymania
-                toggleLegalMode();
-                while (!digitalRead(BTN_UP) || !digitalRead(BTN_SET)) {
-                    delay(10); // Czekaj na puszczenie przycisków
-                }
-                legalModeStart = 0;
-                return;
-            }
-        } else {
-            legalModeStart = 0;
-        }
+void buttonAssistUp() {
+    if (assistLevel < 5) assistLevel++;
+}
 
-        // Obsługa przycisku UP (zmiana asysty)
-        if (!upState && (currentTime - lastDebounceTime) > DEBOUNCE_DELAY) {
-            if (!upPressStartTime) {
-                upPressStartTime = currentTime;
-            } else if (!upLongPressExecuted && (currentTime - upPressStartTime) > LONG_PRESS_TIME) {
-                lightMode = (lightMode + 1) % 3;
-                
-                #ifdef DEBUG
-                Serial.print("Zmieniono tryb świateł na: ");
-                Serial.println(lightMode);
-                #endif
-                
-                setLights(); // Zastosuj ustawienia zgodnie z trybem
-                upLongPressExecuted = true;
-            }
-        } else if (upState && upPressStartTime) {
-            if (!upLongPressExecuted && (currentTime - upPressStartTime) < LONG_PRESS_TIME) {
-                if (assistLevel < 5) assistLevel++;
-            }
-            upPressStartTime = 0;
-            upLongPressExecuted = false;
-            lastDebounceTime = currentTime;
-        }
+void buttonAssistDown() {
+    if (assistLevel > 0) assistLevel--;
+}
 
-        // Obsługa przycisku DOWN (zmiana asysty)
-        if (!downState && (currentTime - lastDebounceTime) > DEBOUNCE_DELAY) {
-            if (!downPressStartTime) {
-                downPressStartTime = currentTime;
-            } else if (!downLongPressExecuted && (currentTime - downPressStartTime) > LONG_PRESS_TIME) {
-                assistLevelAsText = !assistLevelAsText;
-                downLongPressExecuted = true;
-            }
-        } else if (downState && downPressStartTime) {
-            if (!downLongPressExecuted && (currentTime - downPressStartTime) < LONG_PRESS_TIME) {
-                if (assistLevel > 0) assistLevel--;
-            }
-            downPressStartTime = 0;
-            downLongPressExecuted = false;
-            lastDebounceTime = currentTime;
-        }
+void buttonNextLightMode() {
+    lightMode = (lightMode + 1) % 3;
 
-        // Obsługa przycisku SET
-        static unsigned long lastSetRelease = 0;
-        static bool waitingForSecondClick = false;
+    #ifdef DEBUG
+    Serial.print("Zmieniono tryb świateł na: ");
+    Serial.println(lightMode);
+    #endif
 
-        if (!setState) {  // Przycisk wciśnięty
-            if (!setPressStartTime) {
-                setPressStartTime = currentTime;
-            } else if (!setLongPressExecuted && (currentTime - setPressStartTime) > SET_LONG_PRESS) {
-                // Długie przytrzymanie (>3s) - wyłączenie
-                display.clearBuffer();
-                display.setFont(czcionka_srednia);
-                display.drawStr(5, 32, "Do widzenia ;)");
-                display.sendBuffer();
-                messageStartTime = currentTime;
-                setLongPressExecuted = true;
-            }
-        } else if (setPressStartTime) {  // Przycisk puszczony
-            if (!setLongPressExecuted) {
-                unsigned long releaseTime = currentTime;
-
-                if (waitingForSecondClick && (releaseTime - lastSetRelease) < DOUBLE_CLICK_TIME) {
-                    // Podwójne kliknięcie
-                    if (currentMainScreen == USB_SCREEN) {
-                        // Przełącz stan USB
-                        usbEnabled = !usbEnabled;
-                        digitalWrite(UsbPin, usbEnabled ? HIGH : LOW);
-                    } else if (inSubScreen) {
-                        inSubScreen = false;  // Wyjście z pod-ekranów
-                    } else if (hasSubScreens(currentMainScreen)) {
-                        inSubScreen = true;  // Wejście do pod-ekranów
-                        currentSubScreen = 0;
-                    }
-                    waitingForSecondClick = false;
-                } else {
-                    // Pojedyncze kliknięcie
-                    if (!waitingForSecondClick) {
-                        waitingForSecondClick = true;
-                        lastSetRelease = releaseTime;
-                    } else if ((releaseTime - lastSetRelease) >= DOUBLE_CLICK_TIME) {
-                        // Przełączanie ekranów/pod-ekranów
-                        if (inSubScreen) {
-                            currentSubScreen = (currentSubScreen + 1) % getSubScreenCount(currentMainScreen);
-                        } else {
-                            currentMainScreen = (MainScreen)((currentMainScreen + 1) % MAIN_SCREEN_COUNT);
-                        }
-                        waitingForSecondClick = false;
-                    }
-                }
-            }
-            setPressStartTime = 0;
-            setLongPressExecuted = false;
-            lastDebounceTime = currentTime;
-        }
+    setLights(); // Zastosuj ustawienia zgodnie z trybem
+}
 
-        // Reset flagi oczekiwania na drugie kliknięcie po upływie czasu
-        if (waitingForSecondClick && (currentTime - lastSetRelease) >= DOUBLE_CLICK_TIME) {
-          // Wykonaj akcję pojedynczego kliknięcia
-          if (inSubScreen) {
-            currentSubScreen = (currentSubScreen + 1) % getSubScreenCount(currentMainScreen);
-          } else {
-            currentMainScreen = (MainScreen)((currentMainScreen + 1) % MAIN_SCREEN_COUNT);
-          }
-          waitingForSecondClick = false;
-        }
+void buttonToggleAssistText() {
+    assistLevelAsText = !assistLevelAsText;
+}
+
+// przełączanie ekranów/pod-ekranów (kliknięcie SET)
+void buttonNextScreen() {
+    if (inSubScreen) {
+        currentSubScreen = (currentSubScreen + 1) % getSubScreenCount(currentMainScreen);
+    } else {
+        currentMainScreen = (MainScreen)((currentMainScreen + 1) % MAIN_SCREEN_COUNT);
     }
+}
 
-    // Obsługa komunikatów powitalnych/pożegnalnych
-    if (messageStartTime > 0 && (currentTime - messageStartTime) >= GOODBYE_DELAY) {
-      if (!showingWelcome) {
-          displayActive = false;
+// podwójne kliknięcie SET: USB na ekranie USB, wejście/wyjście z pod-ekranów
+void buttonScreenAction() {
+    if (currentMainScreen == USB_SCREEN) {
+        usbEnabled = !usbEnabled;
+        digitalWrite(UsbPin, usbEnabled ? HIGH : LOW);
+    } else if (inSubScreen) {
+        inSubScreen = false;
+    } else if (hasSubScreens(currentMainScreen)) {
+        inSubScreen = true;
+        currentSubScreen = 0;
+    }
+}
+
+void buttonConfigMode() {
+    if (!configModeActive) activateConfigMode();
+}
+
+const ButtonBinding BUTTON_BINDINGS[] = {
+    { GESTURE_LONG_PRESS,   BUTTON_MASK(BUTTON_SET), BUTTON_CTX_OFF,    buttonPowerOn },
+    { GESTURE_LONG_PRESS,   BUTTON_MASK(BUTTON_SET), BUTTON_CTX_ACTIVE, buttonPowerOff },
+    { GESTURE_CLICK,        BUTTON_MASK(BUTTON_SET), BUTTON_CTX_ACTIVE, buttonNextScreen },
+    { GESTURE_DOUBLE_CLICK, BUTTON_MASK(BUTTON_SET), BUTTON_CTX_ACTIVE, buttonScreenAction },
+    { GESTURE_CLICK,        BUTTON_MASK(BUTTON_UP),  BUTTON_CTX_ACTIVE, buttonAssistUp },
+    { GESTURE_LONG_PRESS,   BUTTON_MASK(BUTTON_UP),  BUTTON_CTX_ACTIVE, buttonNextLightMode },
+    { GESTURE_CLICK,        BUTTON_MASK(BUTTON_DOWN), BUTTON_CTX_ACTIVE, buttonAssistDown },
+    { GESTURE_LONG_PRESS,   BUTTON_MASK(BUTTON_DOWN), BUTTON_CTX_ACTIVE, buttonToggleAssistText },
+    { GESTURE_CHORD, BUTTON_MASK(BUTTON_UP) | BUTTON_MASK(BUTTON_SET),  BUTTON_CTX_ACTIVE, toggleLegalMode },
+    { GESTURE_CHORD, BUTTON_MASK(BUTTON_UP) | BUTTON_MASK(BUTTON_DOWN), BUTTON_CTX_OFF | BUTTON_CTX_ACTIVE, buttonConfigMode },
+    { GESTURE_PRESS,        BUTTON_MASK(BUTTON_SET), BUTTON_CTX_CONFIG, deactivateConfigMode },
+};
+
+// gest z silnika przycisków (wywoływane z buttons.process() w zadaniu wejścia)
+void handleButtonEvent(const ButtonEvent& event) {
+    uint8_t context;
+    if (configModeActive) {
+        context = BUTTON_CTX_CONFIG;
+    } else if (!displayActive) {
+        context = BUTTON_CTX_OFF;
+    } else if (messageStartTime == 0) {
+        context = BUTTON_CTX_ACTIVE;
+    } else {
+        return; // Powitanie/pożegnanie - przyciski nieaktywne
+    }
+
+    #ifdef DEBUG
+    Serial.printf("Przyciski: gest %d, maska 0x%02X\n", event.gesture, event.buttons);
+    #endif
+
+    for (const ButtonBinding& binding : BUTTON_BINDINGS) {
+        if (binding.gesture != event.gesture || binding.buttons != event.buttons) continue;
+        if (!(binding.contexts & context)) continue;
+
+        binding.action();
+
+        // Po zmianie trybu puszczenie przycisków nie może wywołać kolejnej akcji
+        if (configModeActive != (context == BUTTON_CTX_CONFIG) || event.gesture == GESTURE_CHORD) {
+            buttons.suppress(millis());
+        }
+        return;
+    }
+}
+
+// wybudzenie zadania wejścia z przerwania przycisku
+void IRAM_ATTR wakeInputTask() {
+    scheduler.notifyFromISR(inputTaskId);
+}
+
+// obsługa przycisków
+void handleButtons() {
+    PERF_SCOPE(PERF_BUTTONS);
+
+    buttons.process(millis());
+
+    // Obsługa komunikatów powitalnych/pożegnalnych (czas po process() - akcja
+    // przycisku mogła właśnie ustawić messageStartTime)
+    unsigned long currentTime = millis();
+    if (messageStartTime > 0 && (currentTime - messageStartTime) >= GOODBYE_DELAY) {
+      if (!showingWelcome) {
+          displayActive = false;
           goToSleep();
       }
       messageStartTime = 0;
@@ -1547,26 +1564,55 @@ void handleButtons() {
     }
 }
 
-// sprawdzanie trybu konfiguracji
-void checkConfigMode() {
-    static unsigned long upDownPressTime = 0;
-    static bool bothButtonsPressed = false;
+// pusty dokument odpowiedzi JSON (wspólny bufor - handlery serwera działają w jednym zadaniu)
+JsonDocument& beginJsonResponse() {
+    #if PERF_ENABLED
+    httpHeapBefore = ESP.getFreeHeap();
+    #endif
+    webJson->clear();
+    return *webJson;
+}
 
-    if (!digitalRead(BTN_UP) && !digitalRead(BTN_DOWN)) {
-        if (!bothButtonsPressed) {
-            bothButtonsPressed = true;
-            upDownPressTime = millis();
-        } else if ((millis() - upDownPressTime > 500) && !configModeActive) {
-            activateConfigMode();
+#if PERF_ENABLED
+// pomiar sterty po przekazaniu odpowiedzi (wysyłana po powrocie z handlera)
+void recordResponseHeap(const String& uri) {
+    uint32_t freeHeap = ESP.getFreeHeap();
+    uint32_t held = httpHeapBefore > freeHeap ? httpHeapBefore - freeHeap : 0;
+    uint32_t maxAlloc = ESP.getMaxAllocHeap();
+    if (maxAlloc < httpMinMaxAlloc) httpMinMaxAlloc = maxAlloc;
+
+    for (HttpHeapStats& stats : httpHeapStats) {
+        if (stats.requests == 0) {
+            strlcpy(stats.uri, uri.c_str(), sizeof(stats.uri));
+        } else if (strcmp(stats.uri, uri.c_str()) != 0) {
+            continue;
         }
-    } else {
-        bothButtonsPressed = false;
+        stats.requests++;
+        stats.totalBytes += held;
+        if (held > stats.maxBytes) stats.maxBytes = held;
+        return;
     }
 }
+#endif
+
+// wysłanie dokumentu JSON prosto do bufora odpowiedzi (bez pośredniego String)
+void sendJson(AsyncWebServerRequest* request, const JsonDocument& doc, int code = 200) {
+    AsyncResponseStream* response = request->beginResponseStream("application/json", measureJson(doc));
+    response->setCode(code);
+    serializeJson(doc, *response);
+    request->send(response);
+    #if PERF_ENABLED
+    recordResponseHeap(request->url());
+    #endif
+}
 
 // Implementacja aktywacji trybu konfiguracji
 void activateConfigMode() {
+    waitForSystemReady();
     configModeActive = true;
+
+    // Próbki z bufora do pliku, żeby były dostępne do pobrania
+    rideLogger.flush();
     
     // 1. Inicjalizacja LittleFS
     if (!LittleFS.begin(true)) {
@@ -1579,6 +1625,9 @@ void activateConfigMode() {
     Serial.println("LittleFS zainicjalizowany");
     #endif
 
+    // Bufor odpowiedzi REST zostaje w pamięci do kolejnego wejścia w tryb konfiguracji
+    if (webJson == nullptr) webJson = new DynamicJsonDocument(WEB_JSON_CAPACITY);
+
     // 2. Włączenie WiFi w trybie AP
     WiFi.mode(WIFI_AP);
     WiFi.softAP("e-Bike System PMW", "#mamrower");
@@ -1586,26 +1635,11 @@ void activateConfigMode() {
     Serial.println("Tryb AP aktywny");
     #endif
 
-    // 3. Konfiguracja serwera - najpierw pliki statyczne
-    server.serveStatic("/", LittleFS, "/").setDefaultFile("index.html");
-    
-    // Dodanie obsługi typów MIME
-    server.on("/style.css", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/style.css", "text/css");
-    });
-    
-    server.on("/script.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/script.js", "application/javascript");
-    });
-
+    // 3. Konfiguracja serwera
     server.on("/api/version", HTTP_GET, [](AsyncWebServerRequest *request) {
-        StaticJsonDocument<200> doc;
+        JsonDocument& doc = beginJsonResponse();
         doc["version"] = VERSION;
-        
-        String response;
-        serializeJson(doc, response);
-        
-        request->send(200, "application/json", response);
+        sendJson(request, doc);
     });
 
     // 4. Dodanie endpointów API
@@ -1624,18 +1658,17 @@ void deactivateConfigMode() {
     server.end();                   // Zatrzymaj serwer HTTP
     WiFi.softAPdisconnect(true);    // Wyłącz punkt dostępowy WiFi
     WiFi.mode(WIFI_OFF);            // Wyłącz moduł WiFi
-    LittleFS.end();                 // Odmontuj system plików
     
     configModeActive = false;
     
-    display.clearBuffer();
-    display.sendBuffer();
+    postDisplayEvent(DISPLAY_EVT_CLEAR);
 }
 
 // przełączanie trybu legal
 void toggleLegalMode() {
     legalMode = !legalMode;
     
+    DisplayLock lock;
     display.clearBuffer();
         
     drawCenteredText("Tryb legalny", 20, czcionka_srednia);
@@ -1643,10 +1676,9 @@ void toggleLegalMode() {
     drawCenteredText(legalMode ? "wlaczony" : "wylaczony", 50, czcionka_srednia);
     
     display.sendBuffer();
-    delay(1500);
-    
-    display.clearBuffer();
-    display.sendBuffer();
+
+    // Zadanie wyświetlacza wraca do ekranu głównego po upływie czasu komunikatu
+    overlayUntil = millis() + LEGAL_MESSAGE_TIME;
 }
 
 // --- Funkcje pomocnicze ---
@@ -1680,23 +1712,66 @@ int getSubScreenCount(MainScreen screen) {
     }
 }
 
+// oczekiwanie na koniec inicjalizacji w tle (przed uśpieniem i trybem konfiguracji)
+void waitForSystemReady() {
+    while (!systemReady) delay(10);
+}
+
+// zapis stanu do szybkiego wznowienia po wybudzeniu
+void storeResumeState() {
+    ResumeData resume;
+    resume.mainScreen = currentMainScreen;
+    resume.subScreen = currentSubScreen;
+    resume.inSubScreen = inSubScreen;
+    resume.assistLevel = assistLevel;
+    resume.lightMode = lightMode;
+    resume.displayBrightness = displayBrightness;
+    resume.tripMeters = odometerManager.getTripMeters();
+    wheelSensor.getTripStats(resume.rideMm, resume.movingMs, resume.maxSpeed);
+    resume.configCrc = configStore.getCrc();
+    ResumeState::store(resume);
+}
+
+// odtworzenie stanu sprzed uśpienia (bez odczytu flash)
+void applyResumeState(const ResumeData& resume) {
+    currentMainScreen = resume.mainScreen < MAIN_SCREEN_COUNT ? static_cast<MainScreen>(resume.mainScreen) : SPEED_SCREEN;
+    currentSubScreen = resume.subScreen < getSubScreenCount(currentMainScreen) ? resume.subScreen : 0;
+    inSubScreen = resume.inSubScreen && hasSubScreens(currentMainScreen);
+    assistLevel = min((int)resume.assistLevel, 5);
+    lightMode = min((int)resume.lightMode, 2);
+    setDisplayBrightness(resume.displayBrightness);
+
+    // Dane podróży do pierwszej klatki, potem nadpisywane przez zadanie czujników
+    telemetry.update([&](TelemetrySnapshot& t) {
+        t.distance_km = resume.tripMeters / 1000.0f;
+        t.speed_max_kmh = resume.maxSpeed;
+        t.speed_avg_kmh = resume.movingMs > 0 ? resume.rideMm * 3.6f / resume.movingMs : 0.0f;
+    });
+}
+
 // tryb uśpienia
 void goToSleep() {
+    // Po szybkim wznowieniu licznik i zapis przejazdu mogą być jeszcze inicjalizowane
+    waitForSystemReady();
+
     // Wyłącz wszystkie LEDy
-    digitalWrite(FrontDayPin, LOW);
-    digitalWrite(FrontPin, LOW);
-    digitalWrite(RearPin, LOW);
+    lightEngine.off();
     digitalWrite(UsbPin, LOW);
 
     delay(50);
 
     // Wyłącz OLED
+    DisplayLock lock;
     display.clearBuffer();
     display.sendBuffer();
     display.setPowerSave(1);  // Wprowadź OLED w tryb oszczędzania energii
 
-    // Zapisz licznik całkowity
+    // Zapisz licznik całkowity i próbki przejazdu z bufora
     odometerManager.shutdown();
+    rideLogger.flush();
+    storeResumeState();
+    rangeEstimator.store();
+    systemClock.store();
 
     // Konfiguracja wybudzania przez przycisk SET
     esp_sleep_enable_ext0_wakeup(GPIO_NUM_12, 0);  // GPIO12 (BTN_SET) stan niski
@@ -1705,12 +1780,31 @@ void goToSleep() {
     esp_deep_sleep_start();
 }
 
-// ustawiania świateł
-void setLights() {
-    // Wyłącz wszystkie światła
-    digitalWrite(FrontDayPin, LOW);
-    digitalWrite(FrontPin, LOW);
-    digitalWrite(RearPin, LOW);
+// ustawiania świateł (applyBacklight = false - podświetlenie bez zmian)
+void setLights(bool applyBacklight) {
+    // Konfiguracja aktywnego trybu (0 - wyłączone, 1 - dzienny, 2 - nocny)
+    LightSettings::LightMode lights = LightSettings::NONE;
+    uint8_t brightness = 0;
+    bool blink = false;
+    if (lightMode == 1) {
+        lights = lightSettings.dayLights;
+        brightness = lightSettings.dayBrightness;
+        blink = lightSettings.dayBlink;
+    } else if (lightMode == 2) {
+        lights = lightSettings.nightLights;
+        brightness = lightSettings.nightBrightness;
+        blink = lightSettings.nightBlink;
+    }
+
+    bool front = lights == LightSettings::FRONT || lights == LightSettings::BOTH;
+    bool rear = lights == LightSettings::REAR || lights == LightSettings::BOTH;
+
+    // Przejścia płynne, miganie tylnego światła generuje LEDC
+    lightEngine.setRamp(lightSettings.rampMs);
+    lightEngine.setBlinkPeriod(lightSettings.blinkFrequency);
+    lightEngine.set(LightEngine::OUTPUT_FRONT_DAY, lightMode == 1 && front ? brightness : 0);
+    lightEngine.set(LightEngine::OUTPUT_FRONT, lightMode == 2 && front ? brightness : 0);
+    lightEngine.set(LightEngine::OUTPUT_REAR, rear ? brightness : 0, blink);
 
     // Jeśli światła wyłączone (lightMode == 0), kończymy
     if (lightMode == 0) {
@@ -1720,43 +1814,8 @@ void setLights() {
         return;
     }
 
-    // Zastosuj ustawienia zgodnie z trybem
-    if (lightMode == 1) { // Tryb dzienny
-        switch (lightSettings.dayLights) {
-            case LightSettings::NONE:
-                // Wszystkie światła pozostają wyłączone
-                break;
-            case LightSettings::FRONT:
-                digitalWrite(FrontDayPin, HIGH);
-                break;
-            case LightSettings::REAR:
-                digitalWrite(RearPin, HIGH);
-                break;
-            case LightSettings::BOTH:
-                digitalWrite(FrontDayPin, HIGH);
-                digitalWrite(RearPin, HIGH);
-                break;
-        }
-    } else if (lightMode == 2) { // Tryb nocny
-        switch (lightSettings.nightLights) {
-            case LightSettings::NONE:
-                // Wszystkie światła pozostają wyłączone
-                break;
-            case LightSettings::FRONT:
-                digitalWrite(FrontPin, HIGH);
-                break;
-            case LightSettings::REAR:
-                digitalWrite(RearPin, HIGH);
-                break;
-            case LightSettings::BOTH:
-                digitalWrite(FrontPin, HIGH);
-                digitalWrite(RearPin, HIGH);
-                break;
-        }
-    }
-    
     // Dodaj wywołanie funkcji aktualizującej jasność wyświetlacza
-    applyBacklightSettings();
+    if (applyBacklight) applyBacklightSettings();
 }
 
 // ustawienia podświetlenia
@@ -1784,7 +1843,8 @@ void applyBacklightSettings() {
     // Minimum ustawiamy na 16, bo niektóre wyświetlacze OLED mogą się wyłączać przy niższych wartościach
     displayBrightness = map(normalized, 0, 100, 16, 255);
     
-    // Zastosuj jasność do wyświetlacza
+    // Zastosuj jasność do wyświetlacza (wywołania z zadań wejścia, WWW i inicjalizacji)
+    DisplayLock lock;
     display.setContrast(displayBrightness);
     
     #ifdef DEBUG
@@ -1797,169 +1857,59 @@ void applyBacklightSettings() {
     #endif
 }
 
-// sprawdzanie poprawności temperatury
-bool isValidTemperature(float temp) {
-    return (temp >= -50.0 && temp <= 100.0);
-}
-
 // obsługa temperatury
 void handleTemperature() {
-    unsigned long currentMillis = millis();
-
-    if (!conversionRequested && (currentMillis - lastTempRequest >= TEMP_REQUEST_INTERVAL)) {
-        // Żądanie konwersji z obu czujników
-        sensorsAir.requestTemperatures();
-        sensorsController.requestTemperatures();
-        conversionRequested = true;
-        lastTempRequest = currentMillis;
-    }
+    PERF_SCOPE(PERF_TEMPERATURE);
+
+    uint32_t now = millis();
+    temperatureEngine.update(now);
+
+    // Brak czujnika lub nieaktualny odczyt - DEVICE_DISCONNECTED_C ("---" na ekranie)
+    float air = DEVICE_DISCONNECTED_C;
+    float controller = DEVICE_DISCONNECTED_C;
+    temperatureEngine.getTemperature(TEMP_CHANNEL_AIR, air, now);
+    temperatureEngine.getTemperature(TEMP_CHANNEL_CONTROLLER, controller, now);
+    telemetry.update([&](TelemetrySnapshot& t) {
+        t.temp_air = air;
+        t.temp_controller = controller;
+    });
 
-    if (conversionRequested && (currentMillis - lastTempRequest >= 750)) {
-        // Odczyt z obu czujników
-        currentTemp = sensorsAir.getTempCByIndex(0);
-        temp_controller = sensorsController.getTempCByIndex(0);
-        conversionRequested = false;
-    }
+    updateMotorTemperature(now);
 }
 
-// --- Funkcje konfiguracji systemu ---
+// temperatura silnika z NTC - stałe tempo publikacji (ekran i WebSocket)
+void updateMotorTemperature(uint32_t now) {
+    static uint32_t lastUpdate = 0;
+    if (now - lastUpdate < MOTOR_TEMP_INTERVAL) return;
+    lastUpdate = now;
 
-// wczytywanie wszystkich ustawień
-void loadSettings() {
-    File configFile = LittleFS.open("/config.json", "r");
-    if (!configFile) {
-        #ifdef DEBUG
-        Serial.println("Failed to open config file");
-        #endif
-        return;
+    // Brak próbek, zwarcie lub brak czujnika - DEVICE_DISCONNECTED_C ("---" na ekranie)
+    float millivolts;
+    float motor = DEVICE_DISCONNECTED_C;
+    if (motorNtcChannel >= 0 && adcSampler.getMillivolts(motorNtcChannel, millivolts)) {
+        NtcTable::celsiusFromMillivolts(millivolts, motor);
     }
+    telemetry.update([&](TelemetrySnapshot& t) {
+        t.temp_motor = motor;
+    });
+}
 
-    StaticJsonDocument<1024> doc;
-    DeserializationError error = deserializeJson(doc, configFile);
-
-    if (error) {
-        #ifdef DEBUG
-        Serial.println("Failed to parse config file");
-        #endif
+// napięcie i temperatura NTC silnika (polecenie "temp")
+void printMotorTemperature() {
+    float millivolts;
+    if (motorNtcChannel < 0 || !adcSampler.getMillivolts(motorNtcChannel, millivolts)) {
+        Serial.println("NTC silnika: brak próbek ADC");
         return;
     }
-
-    // Wczytywanie ustawień świateł
-    if (doc.containsKey("light")) {
-        lightSettings.dayLights = static_cast<LightSettings::LightMode>(doc["light"]["dayLights"] | 0);
-        lightSettings.nightLights = static_cast<LightSettings::LightMode>(doc["light"]["nightLights"] | 0);
-        lightSettings.dayBlink = doc["light"]["dayBlink"] | false;
-        lightSettings.nightBlink = doc["light"]["nightBlink"] | false;
-        lightSettings.blinkFrequency = doc["light"]["blinkFrequency"] | 500;
-    }
-
-    // Wczytywanie ustawień podświetlenia
-    if (doc.containsKey("backlight")) {
-        backlightSettings.dayBrightness = doc["backlight"]["dayBrightness"] | 100;
-        backlightSettings.nightBrightness = doc["backlight"]["nightBrightness"] | 50;
-        backlightSettings.autoMode = doc["backlight"]["autoMode"] | false;
-    }
-
-    // Wczytywanie ustawień WiFi
-    if (doc.containsKey("wifi")) {
-        strlcpy(wifiSettings.ssid, doc["wifi"]["ssid"] | "", sizeof(wifiSettings.ssid));
-        strlcpy(wifiSettings.password, doc["wifi"]["password"] | "", sizeof(wifiSettings.password));
-    }
-
-
-    // Wczytywanie ustawień sterownika
-    if (doc.containsKey("controller")) {
-        controllerSettings.type = doc["controller"]["type"] | "kt-lcd";
-        
-        if (controllerSettings.type == "kt-lcd") {
-            for (int i = 1; i <= 5; i++) {
-                controllerSettings.ktParams[i-1] = doc["controller"]["p"][String(i)] | 0;
-            }
-            for (int i = 1; i <= 15; i++) {
-                controllerSettings.ktParams[i+4] = doc["controller"]["c"][String(i)] | 0;
-            }
-            for (int i = 1; i <= 3; i++) {
-                controllerSettings.ktParams[i+19] = doc["controller"]["l"][String(i)] | 0;
-            }
-        } else {
-            for (int i = 1; i <= 20; i++) {
-                controllerSettings.s866Params[i-1] = doc["controller"]["p"][String(i)] | 0;
-            }
-        }
-    }
-
-  configFile.close();
-}
-
-// zapis wszystkich ustawień
-void saveSettings() {
-    StaticJsonDocument<1024> doc;
-
-    // Zapisywanie ustawień czasu
-    JsonObject timeObj = doc.createNestedObject("time");
-    timeObj["ntpEnabled"] = timeSettings.ntpEnabled;
-    timeObj["hours"] = timeSettings.hours;
-    timeObj["minutes"] = timeSettings.minutes;
-    timeObj["seconds"] = timeSettings.seconds;
-    timeObj["day"] = timeSettings.day;
-    timeObj["month"] = timeSettings.month;
-    timeObj["year"] = timeSettings.year;
-
-    // Zapisywanie ustawień świateł
-    JsonObject lightObj = doc.createNestedObject("light");
-    lightObj["dayLights"] = static_cast<int>(lightSettings.dayLights);
-    lightObj["nightLights"] = static_cast<int>(lightSettings.nightLights);
-    lightObj["dayBlink"] = lightSettings.dayBlink;
-    lightObj["nightBlink"] = lightSettings.nightBlink;
-    lightObj["blinkFrequency"] = lightSettings.blinkFrequency;
-
-    // Zapisywanie ustawień podświetlenia
-    JsonObject backlightObj = doc.createNestedObject("backlight");
-    backlightObj["dayBrightness"] = backlightSettings.dayBrightness;
-    backlightObj["nightBrightness"] = backlightSettings.nightBrightness;
-    backlightObj["autoMode"] = backlightSettings.autoMode;
-
-    // Zapisywanie ustawień WiFi
-    JsonObject wifiObj = doc.createNestedObject("wifi");
-    wifiObj["ssid"] = wifiSettings.ssid;
-    wifiObj["password"] = wifiSettings.password;
-
-    // Zapisywanie ustawień sterownika
-    JsonObject controllerObj = doc.createNestedObject("controller");
-    controllerObj["type"] = controllerSettings.type;
-    
-    JsonObject paramsObj = controllerObj.createNestedObject("params");
-    if (controllerSettings.type == "kt-lcd") {
-      for (int i = 1; i <= 5; i++) {
-        paramsObj["p"][String(i)] = controllerSettings.ktParams[i-1];
-      }
-      for (int i = 1; i <= 15; i++) {
-        paramsObj["c"][String(i)] = controllerSettings.ktParams[i+4];
-      }
-      for (int i = 1; i <= 3; i++) {
-        paramsObj["l"][String(i)] = controllerSettings.ktParams[i+19];
-      }
+    float celsius;
+    if (NtcTable::celsiusFromMillivolts(millivolts, celsius)) {
+        Serial.printf("NTC silnika: %.1f mV, %.2f °C", millivolts, celsius);
     } else {
-      for (int i = 1; i <= 20; i++) {
-        paramsObj["p"][String(i)] = controllerSettings.s866Params[i-1];
-      }
+        Serial.printf("NTC silnika: %.1f mV - poza zakresem (%u-%u mV)", millivolts,
+                      NtcTable::MIN_MV, NtcTable::MAX_MV);
     }
-
-  File configFile = LittleFS.open("/config.json", "w");
-  if (!configFile) {
-    #ifdef DEBUG
-    Serial.println("Failed to open config file for writing");
-    #endif
-    return;
-  }
-
-  if (serializeJson(doc, configFile) == 0) {
-    #ifdef DEBUG
-    Serial.println("Failed to write config file");
-    #endif
-  }
-
-  configFile.close();
+    Serial.printf(", próbek %u, przepełnienia bufora ADC %u\n",
+                  adcSampler.getSampleCount(motorNtcChannel), (unsigned)adcSampler.getOverflows());
 }
 
 // konwersja parametru na indeks
@@ -1989,7 +1939,7 @@ void updateControllerParam(const String& param, int value) {
             }
         }
     }
-    saveSettings();
+    saveConfig();
 }
 
 // konwersja trybu świateł na string
@@ -2005,31 +1955,88 @@ const char* getLightModeString(LightSettings::LightMode mode) {
 
 // --- Funkcje serwera WWW ---
 
+// przekazanie subskrypcji do zadania sieciowego
+void postTelemetrySubscription(const TelemetrySubscription& subscription) {
+    if (wsSubscriptionQueue == nullptr) return;
+    if (xQueueSend(wsSubscriptionQueue, &subscription, 0) == pdTRUE) {
+        scheduler.notify(networkTaskId);
+    }
+}
+
+// wiadomość od klienta WebSocket:
+// {"subscribe":["speed","power","cells"],"rate":10,"format":"binary"}
+void handleWebSocketMessage(AsyncWebSocketClient* client, AwsFrameInfo* info, uint8_t* data, size_t len) {
+    // Tylko kompletne, niepodzielone wiadomości tekstowe
+    if (!info->final || info->index != 0 || info->len != len || info->opcode != WS_TEXT) return;
+
+    StaticJsonDocument<512> doc;
+    if (deserializeJson(doc, (const char*)data, len)) return;
+
+    JsonArray fields = doc["subscribe"];
+    if (fields.isNull()) return;
+
+    uint32_t mask = 0;
+    for (JsonVariant field : fields) {
+        mask |= TelemetryStream::fieldMaskFromName(field.as<const char*>());
+    }
+    if (mask == 0) mask = TELEMETRY_DEFAULT_FIELDS;
+
+    TelemetrySubscription subscription;
+    subscription.clientId = client->id();
+    subscription.fieldMask = mask;
+    // Ograniczenie przed zawężeniem do uint8_t (np. 300 dałoby 44 Hz)
+    int rate = doc["rate"] | 1;
+    subscription.rateHz = constrain(rate, TelemetryStream::MIN_RATE_HZ, TelemetryStream::MAX_RATE_HZ);
+    subscription.format = strcmp(doc["format"] | "json", "binary") == 0 ? TELEMETRY_FORMAT_BINARY : TELEMETRY_FORMAT_JSON;
+    postTelemetrySubscription(subscription);
+
+    #ifdef DEBUG
+    Serial.printf("WebSocket client #%u: pola 0x%04X, %u Hz, %s\n", client->id(), mask,
+                  subscription.rateHz, subscription.format == TELEMETRY_FORMAT_BINARY ? "binarnie" : "JSON");
+    #endif
+}
+
 // konfiguracja serwera WWW
 void setupWebServer() {
-    // Serwowanie plików statycznych
-    server.serveStatic("/", LittleFS, "/");
+    // Pliki interfejsu (gzip, ETag) - tylko adresy z manifestu, reszta LittleFS nie jest udostępniana
+    if (!webAssets.begin(LittleFS)) {
+        #ifdef DEBUG
+        Serial.println("Brak plików interfejsu webowego (/www/manifest.txt)");
+        #endif
+    }
+    server.removeHandler(&webAssets);
+    server.addHandler(&webAssets);
 
     // Licznik całkowity 
     server.on("/api/odometer", HTTP_GET, [](AsyncWebServerRequest *request) {
         #ifdef DEBUG
         Serial.print("Odczyt licznika: ");
-        Serial.println(odometer.getRawTotal());
+        Serial.println(odometerManager.getTotalMeters());
         #endif
-        request->send(200, "text/plain", String(odometer.getRawTotal()));
+        request->send(200, "text/plain", String(odometerManager.getTotalMeters() / 1000.0, 3));
     });
 
     server.on("/api/setOdometer", HTTP_POST, [](AsyncWebServerRequest *request) {
         if (request->hasParam("value", true)) {
             float newValue = request->getParam("value", true)->value().toFloat();
-            bool success = odometer.setInitialValue(newValue);
+            OdometerSetResult result = odometerManager.setTotalDistance(newValue);
             #ifdef DEBUG
             Serial.print("Ustawienie licznika na ");
             Serial.print(newValue);
-            Serial.println(success ? ": OK" : ": Błąd");
+            Serial.println(result == ODOMETER_SET_OK ? ": OK" : ": Błąd");
             #endif
-            request->send(success ? 200 : 400, "text/plain", 
-                        success ? "OK" : "Invalid value");
+            switch (result) {
+                case ODOMETER_SET_OK:
+                    request->send(200, "text/plain", "OK");
+                    break;
+                case ODOMETER_SET_INVALID:
+                    request->send(400, "text/plain", "Invalid value");
+                    break;
+                case ODOMETER_SET_SAVE_FAILED:
+                    // Wartość przyjęta, ale nie zapisana - kolejna próba przy następnym zapisie
+                    request->send(500, "text/plain", "Save failed");
+                    break;
+            }
         } else {
             #ifdef DEBUG
             Serial.println("Błąd: brak parametru value");
@@ -2040,7 +2047,7 @@ void setupWebServer() {
 
     // Światła
     server.on("/api/status", HTTP_GET, [](AsyncWebServerRequest* request) {
-        StaticJsonDocument<512> doc;
+        JsonDocument& doc = beginJsonResponse();
         JsonObject lightsObj = doc.createNestedObject("lights");
         
         lightsObj["dayLights"] = getLightModeString(lightSettings.dayLights);
@@ -2048,10 +2055,11 @@ void setupWebServer() {
         lightsObj["dayBlink"] = lightSettings.dayBlink;
         lightsObj["nightBlink"] = lightSettings.nightBlink;
         lightsObj["blinkFrequency"] = lightSettings.blinkFrequency;
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response);
+        lightsObj["dayBrightness"] = lightSettings.dayBrightness;
+        lightsObj["nightBrightness"] = lightSettings.nightBrightness;
+        lightsObj["rampMs"] = lightSettings.rampMs;
+
+        sendJson(request, doc);
     });
 
     server.on("/api/lights/config", HTTP_POST, [](AsyncWebServerRequest* request) {
@@ -2086,9 +2094,12 @@ void setupWebServer() {
                 lightSettings.dayBlink = doc["dayBlink"] | false;
                 lightSettings.nightBlink = doc["nightBlink"] | false;
                 lightSettings.blinkFrequency = doc["blinkFrequency"] | 500;
+                lightSettings.dayBrightness = constrain(doc["dayBrightness"] | 100, 0, 100);
+                lightSettings.nightBrightness = constrain(doc["nightBrightness"] | 100, 0, 100);
+                lightSettings.rampMs = constrain(doc["rampMs"] | 300, 0, (int)LightEngine::MAX_RAMP_MS);
                 
                 // Zapisz do pliku
-                saveLightSettings();
+                saveConfig();
                 
                 // Od razu zastosuj nowe ustawienia jeśli jakiś tryb jest aktywny
                 if (lightMode > 0) {
@@ -2104,9 +2115,9 @@ void setupWebServer() {
 
     // Endpoint do pobierania czasu (GET)
     server.on("/api/time", HTTP_GET, [](AsyncWebServerRequest* request) {
-        DateTime now = rtc.now();
+        DateTime now(systemClock.now());
         
-        StaticJsonDocument<200> doc;
+        JsonDocument& doc = beginJsonResponse();
         JsonObject time = doc.createNestedObject("time");
         time["year"] = now.year();
         time["month"] = now.month();
@@ -2114,16 +2125,8 @@ void setupWebServer() {
         time["hours"] = now.hour();
         time["minutes"] = now.minute();
         time["seconds"] = now.second();
-        
-        String response;
-        serializeJson(doc, response);
-        
-        #ifdef DEBUG
-        //Serial.print("Wysyłam aktualny czas: ");
-        //Serial.println(response);
-        #endif
-        
-        request->send(200, "application/json", response);
+
+        sendJson(request, doc);
     });
 
     // Endpoint do ustawiania czasu (POST)
@@ -2148,7 +2151,12 @@ void setupWebServer() {
                     minute >= 0 && minute <= 59 &&
                     second >= 0 && second <= 59) {
                     
-                    rtc.adjust(DateTime(year, month, day, hour, minute, second));
+                    DateTime time(year, month, day, hour, minute, second);
+                    {
+                        DisplayLock lock;   // Magistrala I2C wspólna z OLED
+                        systemClock.adjust(time.unixtime());
+                    }
+                    rideLogger.setTime(time.unixtime(), millis());
                     
                     #ifdef DEBUG
                     Serial.println("Czas został zaktualizowany:");
@@ -2195,17 +2203,14 @@ void setupWebServer() {
                 backlightSettings.autoMode = doc["autoMode"] | backlightSettings.autoMode;
                 
                 // Zapisz do pliku
-                saveBacklightSettingsToFile();
+                saveConfig();
                 
                 // Zastosuj nowe ustawienia
                 applyBacklightSettings();
                 
-                // Odpowiedz używając send()
-                String response = "{\"status\":\"ok\"}";
-                request->send(200, "application/json", response);
+                request->send(200, "application/json", "{\"status\":\"ok\"}");
             } else {
-                String response = "{\"status\":\"error\",\"message\":\"Invalid JSON\"}";
-                request->send(400, "application/json", response);
+                request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid JSON\"}");
             }
         }
     );
@@ -2234,7 +2239,8 @@ void setupWebServer() {
                     }
                     
                     // Zapisz ustawienia od razu po zmianie
-                    saveGeneralSettingsToFile();
+                    saveConfig();
+                    wheelSensor.setCircumference(WheelSpeedSensor::circumferenceForWheelSize(generalSettings.wheelSize));
                     #ifdef DEBUG
                     Serial.println("General settings saved");
                     Serial.print("Wheel size: ");
@@ -2250,13 +2256,10 @@ void setupWebServer() {
 
     // Dodaj w setupWebServer():
     server.on("/get-bluetooth-config", HTTP_GET, [](AsyncWebServerRequest *request) {
-        StaticJsonDocument<64> doc;
+        JsonDocument& doc = beginJsonResponse();
         doc["bmsEnabled"] = bluetoothConfig.bmsEnabled;
         doc["tpmsEnabled"] = bluetoothConfig.tpmsEnabled;
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response);
+        sendJson(request, doc);
     });
 
     server.on("/save-bluetooth-config", HTTP_POST, [](AsyncWebServerRequest *request) {
@@ -2269,7 +2272,7 @@ void setupWebServer() {
                 bluetoothConfig.bmsEnabled = doc["bmsEnabled"] | false;
                 bluetoothConfig.tpmsEnabled = doc["tpmsEnabled"] | false;
                 
-                saveBluetoothConfigToFile();
+                saveConfig();
                 request->send(200, "application/json", "{\"success\":true}");
             } else {
                 request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
@@ -2281,46 +2284,41 @@ void setupWebServer() {
     
     // Endpoint do pobierania aktualnych ustawień ogólnych
     server.on("/get-general-settings", HTTP_GET, [](AsyncWebServerRequest *request) {
-        StaticJsonDocument<64> doc;
+        JsonDocument& doc = beginJsonResponse();
         if (generalSettings.wheelSize == 0) {
             doc["wheelSize"] = "700C";
         } else {
             doc["wheelSize"] = generalSettings.wheelSize;
         }
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response);
+        sendJson(request, doc);
     });
     
     // Dodaj ten endpoint w setupWebServer() przed istniejącym POST endpoint'em
     server.on("/api/controller/config", HTTP_GET, [](AsyncWebServerRequest* request) {
-        StaticJsonDocument<512> doc;
+        JsonDocument& doc = beginJsonResponse();
         doc["type"] = controllerSettings.type;
         
         if (controllerSettings.type == "kt-lcd") {
             JsonObject p = doc.createNestedObject("p");
             for (int i = 1; i <= 5; i++) {
-                p[String(i)] = controllerSettings.ktParams[i-1];
+                p[PARAM_KEYS[i]] = controllerSettings.ktParams[i-1];
             }
             JsonObject c = doc.createNestedObject("c");
             for (int i = 1; i <= 15; i++) {
-                c[String(i)] = controllerSettings.ktParams[i+4];
+                c[PARAM_KEYS[i]] = controllerSettings.ktParams[i+4];
             }
             JsonObject l = doc.createNestedObject("l");
             for (int i = 1; i <= 3; i++) {
-                l[String(i)] = controllerSettings.ktParams[i+19];
+                l[PARAM_KEYS[i]] = controllerSettings.ktParams[i+19];
             }
         } else {
             JsonObject p = doc.createNestedObject("p");
             for (int i = 1; i <= 20; i++) {
-                p[String(i)] = controllerSettings.s866Params[i-1];
+                p[PARAM_KEYS[i]] = controllerSettings.s866Params[i-1];
             }
         }
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response);
+
+        sendJson(request, doc);
     });
 
     server.on("/api/controller/config", HTTP_POST, [](AsyncWebServerRequest* request) {
@@ -2334,29 +2332,29 @@ void setupWebServer() {
                 
                 if (controllerSettings.type == "kt-lcd") {
                     for (int i = 1; i <= 5; i++) {
-                        if (doc["p"].containsKey(String(i))) {
-                            controllerSettings.ktParams[i-1] = doc["p"][String(i)].as<int>();
+                        if (doc["p"].containsKey(PARAM_KEYS[i])) {
+                            controllerSettings.ktParams[i-1] = doc["p"][PARAM_KEYS[i]].as<int>();
                         }
                     }
                     for (int i = 1; i <= 15; i++) {
-                        if (doc["c"].containsKey(String(i))) {
-                            controllerSettings.ktParams[i+4] = doc["c"][String(i)].as<int>();
+                        if (doc["c"].containsKey(PARAM_KEYS[i])) {
+                            controllerSettings.ktParams[i+4] = doc["c"][PARAM_KEYS[i]].as<int>();
                         }
                     }
                     for (int i = 1; i <= 3; i++) {
-                        if (doc["l"].containsKey(String(i))) {
-                            controllerSettings.ktParams[i+19] = doc["l"][String(i)].as<int>();
+                        if (doc["l"].containsKey(PARAM_KEYS[i])) {
+                            controllerSettings.ktParams[i+19] = doc["l"][PARAM_KEYS[i]].as<int>();
                         }
                     }
                 } else {
                     for (int i = 1; i <= 20; i++) {
-                        if (doc["p"].containsKey(String(i))) {
-                            controllerSettings.s866Params[i-1] = doc["p"][String(i)].as<int>();
+                        if (doc["p"].containsKey(PARAM_KEYS[i])) {
+                            controllerSettings.s866Params[i-1] = doc["p"][PARAM_KEYS[i]].as<int>();
                         }
                     }
                 }
                 
-                saveSettings();
+                saveConfig();
                 request->send(200, "application/json", "{\"status\":\"ok\"}");
             } else {
                 request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid JSON\"}");
@@ -2366,17 +2364,153 @@ void setupWebServer() {
         }
     });
 
+    #if PERF_ENABLED
+    // Czasy wykonania podsystemów i zadań
+    server.on("/api/perf", HTTP_GET, [](AsyncWebServerRequest* request) {
+        JsonDocument& doc = beginJsonResponse();
+
+        JsonObject boot = doc.createNestedObject("boot");
+        boot["configUs"] = configLoadUs;
+        boot["configSource"] = configSource;
+        boot["configCorrupted"] = configStore.isCorrupted();
+        boot["fastResume"] = bootProfile.isFastResume();
+        JsonObject phases = boot.createNestedObject("phasesUs");
+        for (uint8_t i = 0; i < BOOT_PHASE_COUNT; i++) {
+            if (bootProfile.isMarked((BootPhase)i)) {
+                phases[BootProfile::getPhaseName((BootPhase)i)] = bootProfile.getPhaseUs((BootPhase)i);
+            }
+        }
+
+        // Błędy zapisu pamięci trwałej
+        JsonObject storage = doc.createNestedObject("storage");
+        storage["configSaveErrors"] = configStore.getSaveErrors();
+        storage["odometerSaveErrors"] = odometerManager.getSaveErrors();
+        storage["odometerJournal"] = odometerManager.isJournalReady();
+        storage["odometerEntries"] = odometerManager.getJournal().getEntriesWritten();
+        storage["odometerErases"] = odometerManager.getJournal().getSectorErases();
+        storage["rideLogger"] = rideLogger.isReady();
+
+        // Sterta układu i zajętość przez odpowiedzi (bieżące zapytanie liczone po wysłaniu)
+        JsonObject heap = doc.createNestedObject("heap");
+        heap["free"] = ESP.getFreeHeap();
+        heap["minFree"] = ESP.getMinFreeHeap();
+        heap["maxAlloc"] = ESP.getMaxAllocHeap();
+        heap["minMaxAlloc"] = httpMinMaxAlloc;
+        JsonObject responses = heap.createNestedObject("responses");
+        for (const HttpHeapStats& stats : httpHeapStats) {
+            if (stats.requests == 0) break;
+            JsonObject endpoint = responses.createNestedObject((const char*)stats.uri);
+            endpoint["count"] = stats.requests;
+            endpoint["avgBytes"] = stats.totalBytes / stats.requests;
+            endpoint["maxBytes"] = stats.maxBytes;
+        }
+
+        JsonArray bounds = doc.createNestedArray("bucketsUs");
+        for (uint8_t i = 0; i < PERF_BUCKET_COUNT; i++) {
+            bounds.add(PerfMonitor::getBucketLowerBound(i));
+        }
+
+        JsonObject sections = doc.createNestedObject("sections");
+        for (uint8_t i = 0; i < PERF_SECTION_COUNT; i++) {
+            PerfStats stats = perfMonitor.getStats((PerfSection)i);
+            JsonObject section = sections.createNestedObject(PerfMonitor::getSectionName((PerfSection)i));
+            section["count"] = stats.count;
+            section["last"] = stats.lastUs;
+            section["min"] = stats.minUs;
+            section["avg"] = stats.avgUs;
+            section["p50"] = stats.p50Us;
+            section["p90"] = stats.p90Us;
+            section["p99"] = stats.p99Us;
+            section["max"] = stats.maxUs;
+            JsonArray histogram = section.createNestedArray("histogram");
+            for (uint8_t b = 0; b < PERF_BUCKET_COUNT; b++) {
+                histogram.add(stats.buckets[b]);
+            }
+        }
+
+        JsonObject tasks = doc.createNestedObject("tasks");
+        for (uint8_t i = 0; i < scheduler.getTaskCount(); i++) {
+            TaskStats stats = scheduler.getStats(i);
+            JsonObject task = tasks.createNestedObject(scheduler.getTaskName(i));
+            task["runs"] = stats.runs;
+            task["overruns"] = stats.overruns;
+            task["lastUs"] = stats.lastRunUs;
+            task["maxUs"] = stats.maxRunUs;
+            task["maxLatenessUs"] = stats.maxLatenessUs;
+        }
+
+        sendJson(request, doc);
+    });
+    #endif
+
+    // Lista segmentów zapisu przejazdu
+    server.on("/api/rides", HTTP_GET, [](AsyncWebServerRequest* request) {
+        RideLoggerStats stats = rideLogger.getStats();
+        JsonDocument& doc = beginJsonResponse();
+        doc["ready"] = rideLogger.isReady();
+        doc["recordSize"] = sizeof(RideRecord);
+        doc["buffered"] = stats.buffered;
+        doc["written"] = stats.recordsWritten;
+        doc["dropped"] = stats.recordsDropped;
+
+        JsonArray segments = doc.createNestedArray("segments");
+        for (uint32_t segment = stats.firstSegment; segment <= stats.lastSegment; segment++) {
+            char path[24];
+            RideLogger::getSegmentPath(segment, path, sizeof(path));
+            File file = LittleFS.open(path, "r");
+            if (!file) continue;
+            JsonObject entry = segments.createNestedObject();
+            entry["id"] = segment;
+            entry["size"] = file.size();
+            file.close();
+        }
+
+        sendJson(request, doc);
+    });
+
+    // Pobieranie zapisu: jeden segment (?segment=N) albo wszystkie po kolei,
+    // odczytywane fragmentami z pliku bez buforowania całości w RAM
+    server.on("/api/rides/download", HTTP_GET, [](AsyncWebServerRequest* request) {
+        if (request->hasParam("segment")) {
+            char path[24];
+            RideLogger::getSegmentPath(request->getParam("segment")->value().toInt(), path, sizeof(path));
+            if (!LittleFS.exists(path)) {
+                request->send(404, "application/json", "{\"error\":\"Segment not found\"}");
+                return;
+            }
+            request->send(LittleFS, path, "application/octet-stream", true);
+            return;
+        }
+
+        RideDownload download = rideLogger.beginDownload();
+        AsyncWebServerResponse* response = request->beginChunkedResponse("application/octet-stream",
+            [download](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+                (void)index;
+                return rideLogger.read(download, buffer, maxLen);
+            });
+        response->addHeader("Content-Disposition", "attachment; filename=rides.bin");
+        request->send(response);
+    });
+
     ws.onEvent([](AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len) {
         switch (type) {
             case WS_EVT_CONNECT:
                 #ifdef DEBUG
                 Serial.printf("WebSocket client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
                 #endif
+                // Do czasu subskrypcji - dotychczasowy JSON co 1 s
+                postTelemetrySubscription({client->id(), TELEMETRY_DEFAULT_FIELDS, 1, TELEMETRY_FORMAT_JSON});
                 break;
             case WS_EVT_DISCONNECT:
                 #ifdef DEBUG
                 Serial.printf("WebSocket client #%u disconnected\n", client->id());
                 #endif
+                postTelemetrySubscription({client->id(), 0, 0, TELEMETRY_FORMAT_JSON});
+                break;
+            case WS_EVT_DATA:
+                handleWebSocketMessage(client, (AwsFrameInfo*)arg, data, len);
+                break;
+            default:
                 break;
         }
     });
@@ -2466,44 +2600,6 @@ void listFiles() {
     }
 }
 
-// wczytywanie konfiguracji
-bool loadConfig() {
-    if(!LittleFS.exists("/config.json")) {
-        #ifdef DEBUG
-        Serial.println("Creating default config file...");
-        #endif
-        // Tworzymy domyślną konfigurację
-        StaticJsonDocument<512> defaultConfig;
-        defaultConfig["version"] = "1.0.0";
-        defaultConfig["timezone"] = "Europe/Warsaw";
-        defaultConfig["lastUpdate"] = "";
-        
-        File configFile = LittleFS.open("/config.json", "w");
-        if(!configFile) {
-            #ifdef DEBUG
-            Serial.println("Failed to create config file");
-            #endif
-            return false;
-        }
-        serializeJson(defaultConfig, configFile);
-        configFile.close();
-    }
-    
-    // Czytamy konfigurację
-    File configFile = LittleFS.open("/config.json", "r");
-    if(!configFile) {
-        #ifdef DEBUG
-        Serial.println("Failed to open config file");
-        #endif
-        return false;
-    }
-    
-    #ifdef DEBUG
-    Serial.println("Config file loaded successfully");
-    #endif
-    return true;
-}
-
 // --- Funkcje czasu ---
 
 // Synchronizacja RTC z NTP
@@ -2513,14 +2609,15 @@ void syncRTCWithNTP() {
     time_t now;
     struct tm timeinfo;
     if (getLocalTime(&timeinfo)) {
-        rtc.adjust(DateTime(
+        DisplayLock lock;
+        systemClock.adjust(DateTime(
             timeinfo.tm_year + 1900,
             timeinfo.tm_mon + 1,
             timeinfo.tm_mday,
             timeinfo.tm_hour,
             timeinfo.tm_min,
             timeinfo.tm_sec
-        ));
+        ).unixtime());
     }
 }
 
@@ -2542,9 +2639,10 @@ void synchronizeTime() {
 
     struct tm timeinfo;
     gmtime_r(&now, &timeinfo);
-    rtc.adjust(DateTime(timeinfo.tm_year + 1900, timeinfo.tm_mon + 1,
-                        timeinfo.tm_mday, timeinfo.tm_hour,
-                        timeinfo.tm_min, timeinfo.tm_sec));
+    DisplayLock lock;
+    systemClock.adjust(DateTime(timeinfo.tm_year + 1900, timeinfo.tm_mon + 1,
+                                timeinfo.tm_mday, timeinfo.tm_hour,
+                                timeinfo.tm_min, timeinfo.tm_sec).unixtime());
 }
 
 /********************************************************************
@@ -2568,6 +2666,9 @@ void initializeDefaultSettings() {
     lightSettings.dayBlink = false;
     lightSettings.nightBlink = false;
     lightSettings.blinkFrequency = 500;
+    lightSettings.dayBrightness = 100;
+    lightSettings.nightBrightness = 100;
+    lightSettings.rampMs = 300;
 
     // Podświetlenie
     backlightSettings.dayBrightness = 100;
@@ -2579,14 +2680,410 @@ void initializeDefaultSettings() {
     memset(wifiSettings.password, 0, sizeof(wifiSettings.password));
 }
 
+// --- Funkcje zadań FreeRTOS ---
+
+// podpis stanu interfejsu (do wykrywania zmian po obsłudze przycisków)
+uint32_t uiStateSignature() {
+    return (uint32_t)(currentMainScreen & 0x0F)
+         | ((uint32_t)(currentSubScreen & 0x0F) << 4)
+         | ((uint32_t)inSubScreen << 8)
+         | ((uint32_t)(assistLevel & 0x07) << 9)
+         | ((uint32_t)assistLevelAsText << 12)
+         | ((uint32_t)(lightMode & 0x03) << 13)
+         | ((uint32_t)legalMode << 15)
+         | ((uint32_t)usbEnabled << 16)
+         | ((uint32_t)displayActive << 17);
+}
+
+// aktualizacja danych symulowanych (do czasu podłączenia prawdziwych czujników)
+void updateSimulatedData() {
+    static unsigned long lastUpdate = 0;
+    const unsigned long updateInterval = 2000;
+    unsigned long currentTime = millis();
+
+    if (currentTime - lastUpdate < updateInterval) return;
+    lastUpdate = currentTime;
+
+    telemetry.update([&](TelemetrySnapshot& t) {
+        t.power_w = 100 + random(300);
+        t.power_avg_w = t.power_w * 0.8;
+        t.power_max_w = t.power_w * 1.2;
+    });
+    assistMode = (assistMode + 1) % 5;
+}
+
+// stan naładowania baterii (każdy okres zadania czujników, 10 Hz)
+void updateBattery() {
+    static uint32_t seenFrames = 0;
+    uint32_t now = millis();
+
+    uint32_t frames = bmsBasicFrames.load();
+    if (frames != seenFrames) {
+        seenFrames = frames;
+        socEstimator.addBmsSample(telemetry.read().bms, now);
+    } else if (!socEstimator.isBmsOnline(now)) {
+        // BLE rozłączone - napięcie z dzielnika (bez dzielnika odczyt jest odrzucany)
+        float millivolts;
+        if (batteryAdcChannel >= 0 && adcSampler.getMillivolts(batteryAdcChannel, millivolts)) {
+            socEstimator.addVoltageSample(millivolts / 1000.0f * BATTERY_ADC_RATIO, now);
+        }
+    }
+    socEstimator.update(now);
+
+    telemetry.update([](TelemetrySnapshot& t) {
+        t.battery_soc = socEstimator.getSoc();
+        t.battery_capacity_percent = (int)lroundf(t.battery_soc);
+        t.battery_voltage = socEstimator.getVoltage();
+        t.battery_current = socEstimator.getCurrent();
+        t.battery_capacity_ah = socEstimator.getRemainingAh();
+        t.battery_capacity_wh = socEstimator.getRemainingWh();
+    });
+}
+
+// prędkość i dystans z czujnika koła, kadencja (każdy okres zadania czujników)
+void updateWheelSpeed() {
+    wheelSensor.update(millis());
+
+    uint32_t meters = wheelSensor.takeMeters();
+    if (meters > 0) odometerManager.addDistance(meters);
+    rangeEstimator.update(meters, assistLevel, millis());
+
+    telemetry.update([](TelemetrySnapshot& t) {
+        t.speed_kmh = wheelSensor.getSpeed();
+        t.speed_avg_kmh = wheelSensor.getAverageSpeed();
+        t.speed_max_kmh = wheelSensor.getMaxSpeed();
+        t.distance_km = odometerManager.getTripDistance();
+        // Energia w baterii ze stanu naładowania (0 bez danych o baterii)
+        t.range_km = rangeEstimator.estimateKm(socEstimator.getRemainingWh(), assistLevel);
+        // Kadencję liczy timer czujnika, tu tylko kopia wyniku
+        t.cadence_rpm = cadenceSensor.getCadence();
+        t.cadence_avg_rpm = cadenceSensor.getAverageCadence();
+    });
+}
+
+// polecenia z portu szeregowego (linie zakończone '\n')
+void handleSerialCommands() {
+    static char line[32];
+    static uint8_t length = 0;
+
+    while (Serial.available() > 0) {
+        char c = Serial.read();
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (length < sizeof(line) - 1) line[length++] = c;
+            continue;
+        }
+        line[length] = '\0';
+        length = 0;
+
+        if (strcmp(line, "boot") == 0) {
+            bootProfile.printReport(Serial);
+        } else if (strcmp(line, "range") == 0) {
+            rangeEstimator.printReport(Serial);
+        } else if (strcmp(line, "temp") == 0) {
+            temperatureEngine.printReport(Serial, millis());
+            printMotorTemperature();
+        } else if (strcmp(line, "clock") == 0) {
+            systemClock.printReport(Serial);
+        } else if (strcmp(line, "odo") == 0) {
+            odometerManager.printReport(Serial);
+            Serial.printf("Konfiguracja: %s%s, błędy zapisu: %lu\n", configSource,
+                          configStore.isCorrupted() ? " (uszkodzony /config.bin)" : "",
+                          (unsigned long)configStore.getSaveErrors());
+        } else if (strcmp(line, "owbench") == 0) {
+            // Magistrala należy do zadania czujników - tam pomiar
+            oneWireBenchRequested = true;
+        }
+
+        #if PERF_ENABLED
+        if (strcmp(line, "perf") == 0) {
+            perfMonitor.printReport(Serial);
+        } else if (strcmp(line, "perf reset") == 0) {
+            perfMonitor.reset();
+            Serial.println("perf: wyzerowano");
+        }
+        #endif
+    }
+}
+
+// zadanie wejścia: przyciski i tryb konfiguracji
+void inputTaskStep() {
+    handleSerialCommands();
+
+    uint32_t stateBefore = uiStateSignature();
+    handleButtons();
+    if (uiStateSignature() != stateBefore) {
+        postDisplayEvent(DISPLAY_EVT_REDRAW);
+    }
+}
+
+// zadanie czujników: temperatura, licznik, dane pomiarowe
+void sensorTaskStep() {
+    if (!systemReady) return;
+
+    if (oneWireBenchRequested.exchange(false)) {
+        const TemperatureEngine::Sensor& sensor = temperatureEngine.getSensor(TEMP_CHANNEL_AIR);
+        OneWireBench::run(oneWireAir, sensor.present ? sensor.rom : nullptr, Serial);
+    }
+
+    // Próbki ADC z DMA: napięcie baterii, NTC silnika
+    adcSampler.update();
+    updateBattery();
+
+    {
+        PERF_SCOPE(PERF_ODOMETER);
+        updateWheelSpeed();
+        odometerManager.update();
+    }
+
+    if (displayActive && messageStartTime == 0 && !configModeActive) {
+        handleTemperature();
+        updateSimulatedData();
+        rideLogger.sample(telemetry.read(), millis());
+    }
+}
+
+// zadanie BLE: zapytania do BMS i dekodowanie odpowiedzi
+void bleTaskStep() {
+    if (!systemReady) return;
+
+    processBmsFrames();
+
+    if (displayActive && messageStartTime == 0 && !configModeActive) {
+        updateBmsData();
+        updateTpms();
+    } else {
+        tpmsScanner.stop();
+    }
+}
+
+// raport statystyk wyświetlacza
+void printRenderStats() {
+    #ifdef DEBUG
+    static unsigned long lastReport = 0;
+    unsigned long now = millis();
+    if (now - lastReport < RENDER_STATS_INTERVAL) return;
+    lastReport = now;
+
+    RenderStats stats = renderTracker.getStats();
+    Serial.printf("OLED: %.1f kl/s, %u B/s, I2C %u us/s | klatki %u, pełne %u, bez zmian %u, wysłano %u B\n",
+                  stats.framesPerSecond, stats.bytesPerSecond, stats.i2cUsPerSecond,
+                  stats.frames, stats.fullFrames, stats.skippedFrames, stats.bytesSent);
+    #endif
+}
+
+// rysowanie ekranu głównego
+void drawMainScreen() {
+    DisplayLock lock;
+
+    // Bufor w RAM jest rysowany w całości, do OLED trafiają tylko zmienione kafelki
+    TelemetrySnapshot t = telemetry.read();
+    display.clearBuffer();
+    renderTracker.beginFrame();
+    drawTopBar(t);
+    drawHorizontalLine();
+    drawVerticalLine();
+    drawAssistLevel();
+    drawMainDisplay(t);
+    drawLightStatus();
+
+    {
+        PERF_SCOPE(PERF_RENDER);
+        renderTracker.flush(display, millis());
+    }
+    bootProfile.mark(BOOT_FIRST_FRAME);
+}
+
+// zadanie wyświetlacza
+void renderTaskStep() {
+    DisplayEvent event;
+    bool clearRequested = false;
+    while (displayEventQueue && xQueueReceive(displayEventQueue, &event, 0) == pdTRUE) {
+        if (event == DISPLAY_EVT_CLEAR) clearRequested = true;
+    }
+
+    DisplayLock lock;
+
+    // Korekta zegara z DS3231, gdy potrzebna (ta sama magistrala I2C)
+    systemClock.update(millis());
+
+    // Ekran konfiguracji jest statyczny - wysyłany raz po wejściu w tryb
+    static bool configScreenShown = false;
+    if (configModeActive) {
+        if (configScreenShown) return;
+
+        display.clearBuffer();
+
+        // Wycentruj każdą linię tekstu
+        drawCenteredText("e-Bike System", 12, czcionka_srednia);
+        drawCenteredText("Konfiguracja on-line", 25, czcionka_mala);
+        drawCenteredText("siec: e-Bike System", 40, czcionka_mala);
+        drawCenteredText("haslo: #mamrower", 51, czcionka_mala);
+        drawCenteredText("IP: 192.168.4.1", 62, czcionka_mala);
+
+        display.sendBuffer();
+        renderTracker.invalidate();
+        configScreenShown = true;
+        return;
+    }
+    configScreenShown = false;
+
+    // Komunikat (np. tryb legalny) zasłania ekran główny do upływu czasu
+    if (overlayUntil != 0) {
+        if ((long)(millis() - overlayUntil) < 0) return;
+        overlayUntil = 0;
+        renderTracker.invalidate();
+    }
+
+    // Aktualizuj wyświetlacz tylko jeśli jest aktywny i nie wyświetla komunikatów
+    if (displayActive && messageStartTime == 0) {
+        drawMainScreen();
+    } else if (clearRequested) {
+        display.clearBuffer();
+        display.sendBuffer();
+        renderTracker.invalidate();
+    }
+
+    printRenderStats();
+}
+
+// zadanie sieciowe: wysyłanie danych przez WebSocket
+void networkTaskStep() {
+    TelemetrySubscription subscription;
+    while (wsSubscriptionQueue && xQueueReceive(wsSubscriptionQueue, &subscription, 0) == pdTRUE) {
+        if (!telemetryStream.apply(subscription)) {
+            // Brak miejsca na kolejnego klienta - komunikat dla interfejsu i rozłączenie
+            AsyncWebSocketClient* client = ws.client(subscription.clientId);
+            if (client) {
+                char message[48];
+                snprintf(message, sizeof(message), "{\"error\":\"tooManyClients\",\"maxClients\":%u}",
+                         (unsigned)TelemetryStream::MAX_CLIENTS);
+                client->text(message);
+                client->close();
+            }
+        }
+    }
+
+    if (ws.count() > 0) {
+        PERF_SCOPE(PERF_WEBSOCKET);
+        telemetryStream.update(telemetry.read(), systemClock.now(), millis(), ws);
+    }
+}
+
+// utworzenie kolejek i blokady wyświetlacza (przed inicjalizacją w tle)
+void createTaskQueues() {
+    displayMutex = xSemaphoreCreateRecursiveMutex();
+    displayEventQueue = xQueueCreate(DISPLAY_EVENT_QUEUE_LENGTH, sizeof(DisplayEvent));
+    wsSubscriptionQueue = xQueueCreate(WS_SUBSCRIPTION_QUEUE_LENGTH, sizeof(TelemetrySubscription));
+}
+
+// uruchomienie zadań
+void startTasks() {
+    // Wejście, czujniki i wyświetlacz na APP_CPU, radio (BLE, WiFi) na PRO_CPU razem ze stosami
+    inputTaskId = scheduler.addTask({"input", inputTaskStep, INPUT_TASK_PERIOD, INPUT_TASK_PRIORITY, 1, 8192});
+    sensorTaskId = scheduler.addTask({"sensors", sensorTaskStep, SENSOR_TASK_PERIOD, SENSOR_TASK_PRIORITY, 1, 4096});
+    bleTaskId = scheduler.addTask({"ble", bleTaskStep, BLE_TASK_PERIOD, BLE_TASK_PRIORITY, 0, 8192});
+    renderTaskId = scheduler.addTask({"render", renderTaskStep, RENDER_TASK_PERIOD, RENDER_TASK_PRIORITY, 1, 4096});
+    networkTaskId = scheduler.addTask({"network", networkTaskStep, NETWORK_TASK_PERIOD, NETWORK_TASK_PRIORITY, 0, 6144});
+
+    // Bez zadań urządzenie nie działa - komunikat także bez DEBUG
+    if (!scheduler.begin()) {
+        Serial.println("Błąd uruchamiania zadań (brak pamięci na stos)");
+    }
+}
+
 // --- Główne funkcje programu ---
 
+// inicjalizacja czujników, pamięci i BLE (w setup() lub w tle po szybkim wznowieniu)
+void initSystem(const ResumeData* resume) {
+    // Inicjalizacja DS18B20 - wyszukanie adresów ROM, pierwsza konwersja w zadaniu czujników
+    temperatureEngine.addChannel(&sensorsAir);
+    temperatureEngine.addChannel(&sensorsController);
+    temperatureEngine.begin(millis());
+    // ADC1 w trybie ciągłym: dzielnik baterii i NTC silnika
+    batteryAdcChannel = adcSampler.addChannel(BATTERY_ADC_PIN);
+    motorNtcChannel = adcSampler.addChannel(MOTOR_NTC_PIN);
+    adcSampler.begin();
+    bootProfile.mark(BOOT_TEMP_SENSORS);
+
+    // Inicjalizacja LittleFS i wczytanie ustawień
+    if (!LittleFS.begin(true)) {
+        #ifdef DEBUG
+        Serial.println("Błąd montowania LittleFS");
+        #endif
+    } else {
+        #ifdef DEBUG
+        Serial.println("LittleFS zamontowany pomyślnie");
+        #endif
+        // Wczytaj ustawienia (jeden odczyt /config.bin lub migracja starych plików JSON)
+        loadConfig();
+
+        // Zapis przejazdu (czas próbek liczony od odczytu RTC); stan w /api/perf i /api/rides
+        if (!rideLogger.begin(LittleFS)) {
+            Serial.println("Zapis przejazdu wyłączony: brak katalogu /rides");
+        }
+        rideLogger.setTime(bootUnixTime, bootMillis);
+    }
+    bootProfile.mark(BOOT_STORAGE);
+
+    // Inicjalizacja licznika, czujnika prędkości i kadencji
+    odometerManager.begin();
+    wheelSensor.begin(WHEEL_SENSOR_PIN, WheelSpeedSensor::circumferenceForWheelSize(generalSettings.wheelSize));
+    if (resume) {
+        wheelSensor.restoreTripStats(resume->rideMm, resume->movingMs, resume->maxSpeed);
+    }
+    if (!cadenceSensor.begin(CADENCE_SENSOR_PIN, CADENCE_MAGNETS)) {
+        #ifdef DEBUG
+        Serial.println("Błąd inicjalizacji czujnika kadencji");
+        #endif
+    }
+    bootProfile.mark(BOOT_SENSORS);
+
+    // Inicjalizacja BLE
+    if (bluetoothConfig.bmsEnabled || bluetoothConfig.tpmsEnabled) {
+        BLEDevice::init("e-Bike System PMW");
+        bleClient = BLEDevice::createClient();
+        // Połączenie z BMS nawiązuje w tle zadanie BLE (nie blokuje startu)
+        if (bluetoothConfig.tpmsEnabled) tpmsScanner.begin();
+    }
+    bootProfile.mark(BOOT_BLE);
+
+    // Zastosuj wczytane ustawienia
+    if (!lightEngine.begin(FrontDayPin, FrontPin, RearPin)) {
+        #ifdef DEBUG
+        Serial.println("Błąd inicjalizacji LEDC (światła)");
+        #endif
+    }
+    setLights(false);
+
+    // Po wznowieniu jasność jest już odtworzona - zmieniana tylko po zmianie konfiguracji
+    if (resume == nullptr || resume->configCrc != configStore.getCrc()) {
+        applyBacklightSettings();
+    }
+}
+
+// zadanie jednorazowe: reszta inicjalizacji po szybkim wznowieniu
+void deferredInitTask(void* param) {
+    initSystem(static_cast<const ResumeData*>(param));
+    systemReady = true;
+    bootProfile.mark(BOOT_READY);
+
+    #ifdef DEBUG
+    bootProfile.printReport(Serial);
+    #endif
+
+    vTaskDelete(NULL);
+}
+
 // SETUP
 void setup() { 
     // Sprawdź przyczynę wybudzenia
     esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
 
     Serial.begin(115200);
+
+    // Kolejki i blokada wyświetlacza przed uruchomieniem czegokolwiek w tle
+    createTaskQueues();
     
     // Inicjalizacja I2C
     Wire.begin();
@@ -2596,18 +3093,7 @@ void setup() {
     display.setFontDirection(0);
     display.clearBuffer();
     display.sendBuffer();
-
-    // Inicjalizacja DS18B20
-    sensorsAir.begin();
-    sensorsController.begin();
-    sensorsAir.setWaitForConversion(false);      // Tryb nieblokujący
-    sensorsController.setWaitForConversion(false);// Tryb nieblokujący
-    sensorsAir.setResolution(12);                // Najwyższa rozdzielczość
-    sensorsController.setResolution(12);         // Najwyższa rozdzielczość
-    
-    // Pierwsze żądanie pomiaru
-    sensorsAir.requestTemperatures();
-    sensorsController.requestTemperatures();
+    bootProfile.mark(BOOT_DISPLAY);
 
     // Inicjalizacja RTC
     if (!rtc.begin()) {
@@ -2623,6 +3109,11 @@ void setup() {
         #endif
         rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
     }
+    // Jedyny odczyt DS3231 przy starcie (po uśpieniu - czas z pamięci RTC)
+    systemClock.begin(rtc, RTC_SQW_PIN, wakeup_reason == ESP_SLEEP_WAKEUP_EXT0);
+    bootUnixTime = systemClock.now();
+    bootMillis = millis();
+    bootProfile.mark(BOOT_RTC);
 
     // Konfiguracja pinów
     pinMode(BTN_UP, INPUT_PULLUP);
@@ -2641,62 +3132,52 @@ void setup() {
     pinMode(UsbPin, OUTPUT);
     digitalWrite(UsbPin, LOW);
 
-    // Inicjalizacja LittleFS i wczytanie ustawień
-    if (!LittleFS.begin(true)) {
-        #ifdef DEBUG
-        Serial.println("Błąd montowania LittleFS");
-        #endif
-    } else {
-        #ifdef DEBUG
-        Serial.println("LittleFS zamontowany pomyślnie");
-        #endif
-        // Wczytaj ustawienia z pliku
-        loadSettings();              // Wczytaj główne ustawienia
-        loadLightSettings();         // Wczytaj ustawienia świateł
-        loadBacklightSettingsFromFile();
-        loadGeneralSettingsFromFile();
-        loadBluetoothConfigFromFile();
-    }
+    // Brak odczytu z czujników do pierwszej konwersji
+    telemetry.update([](TelemetrySnapshot& t) {
+        t.temp_air = DEVICE_DISCONNECTED_C;
+        t.temp_controller = DEVICE_DISCONNECTED_C;
+        t.temp_motor = DEVICE_DISCONNECTED_C;
+    });
 
-    // Inicjalizacja licznika
-    odometer.initialize();
-    odometerManager.begin();
+    // Wyuczone zużycie energii (po odłączeniu zasilania - wartości domyślne)
+    rangeEstimator.restore();
 
-    // Inicjalizacja BLE
-    if (bluetoothConfig.bmsEnabled || bluetoothConfig.tpmsEnabled) {
-        BLEDevice::init("e-Bike System PMW");
-        bleClient = BLEDevice::createClient();
-        if (bluetoothConfig.bmsEnabled) {
-            connectToBms();
-        }
-    }
+    // Szybkie wznowienie: stan z pamięci RTC od razu, reszta inicjalizacji w tle
+    static ResumeData resume;
+    bool fastResume = wakeup_reason == ESP_SLEEP_WAKEUP_EXT0 && ResumeState::restore(resume);
+    bootProfile.setFastResume(fastResume);
 
-    // Zastosuj wczytane ustawienia
-    setLights();  
-    applyBacklightSettings();
+    if (fastResume) {
+        applyResumeState(resume);
+        bootProfile.mark(BOOT_RESTORE);
+        xTaskCreatePinnedToCore(deferredInitTask, "init", 8192, &resume, 1, NULL, 0);
+    } else {
+        initSystem(nullptr);
+        systemReady = true;
 
-    #ifdef DEBUG
-        Serial.println("\n--- Memory Info ---");
-        Serial.printf("Total heap: %d\n", ESP.getHeapSize());
-        Serial.printf("Free heap: %d\n", ESP.getFreeHeap());
-        Serial.printf("Total PSRAM: %d\n", ESP.getPsramSize());
-        Serial.printf("Free PSRAM: %d\n", ESP.getFreePsram());
-        
-        Serial.println("\n--- Flash Info ---");
-        Serial.printf("Flash size: %d\n", ESP.getFlashChipSize());
-        Serial.printf("Sketch size: %d\n", ESP.getSketchSize());
-        Serial.printf("Free sketch space: %d\n", ESP.getFreeSketchSpace());
-        
-        Serial.println("\n--- Partition Info ---");
-        esp_partition_iterator_t pi = esp_partition_find(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, NULL);
-        while (pi != NULL) {
-            const esp_partition_t* partition = esp_partition_get(pi);
-            Serial.printf("Partition '%s': size %d\n", partition->label, partition->size);
-            pi = esp_partition_next(pi);
-        }
-        esp_partition_iterator_release(pi);
-        Serial.println("-------------------\n");
-    #endif
+        #ifdef DEBUG
+            Serial.println("\n--- Memory Info ---");
+            Serial.printf("Total heap: %d\n", ESP.getHeapSize());
+            Serial.printf("Free heap: %d\n", ESP.getFreeHeap());
+            Serial.printf("Total PSRAM: %d\n", ESP.getPsramSize());
+            Serial.printf("Free PSRAM: %d\n", ESP.getFreePsram());
+            
+            Serial.println("\n--- Flash Info ---");
+            Serial.printf("Flash size: %d\n", ESP.getFlashChipSize());
+            Serial.printf("Sketch size: %d\n", ESP.getSketchSize());
+            Serial.printf("Free sketch space: %d\n", ESP.getFreeSketchSpace());
+            
+            Serial.println("\n--- Partition Info ---");
+            esp_partition_iterator_t pi = esp_partition_find(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, NULL);
+            while (pi != NULL) {
+                const esp_partition_t* partition = esp_partition_get(pi);
+                Serial.printf("Partition '%s': size %d\n", partition->label, partition->size);
+                pi = esp_partition_next(pi);
+            }
+            esp_partition_iterator_release(pi);
+            Serial.println("-------------------\n");
+        #endif
+    }
 
     // Jeśli wybudzenie przez przycisk SET
     if (wakeup_reason == ESP_SLEEP_WAKEUP_EXT0) {
@@ -2704,11 +3185,18 @@ void setup() {
         while (!digitalRead(BTN_SET)) {  // Czekaj na puszczenie przycisku
             if ((millis() - startTime) > SET_LONG_PRESS) {
                 displayActive = true;
-                showingWelcome = true;
-                messageStartTime = millis();
-                if (!welcomeAnimationDone) {
-                    showWelcomeMessage();  // Pokaż animację powitania
-                }                
+                bootProfile.mark(BOOT_BUTTON_HOLD);
+                if (fastResume) {
+                    // Bez animacji powitania - od razu ekran sprzed uśpienia
+                    welcomeAnimationDone = true;
+                    drawMainScreen();
+                } else {
+                    showingWelcome = true;
+                    messageStartTime = millis();
+                    if (!welcomeAnimationDone) {
+                        showWelcomeMessage();  // Pokaż animację powitania
+                    }
+                }
                 while (!digitalRead(BTN_SET)) {  // Czekaj na puszczenie przycisku
                     delay(10);
                 }
@@ -2717,126 +3205,35 @@ void setup() {
             delay(10);
         }
     }
-}
 
-// Implementacja funkcji loop
-void loop() {
-    static unsigned long lastButtonCheck = 0;
-    static unsigned long lastUpdate = 0;
-    const unsigned long buttonInterval = 5;
-    const unsigned long updateInterval = 2000;
+    // Przyciski na przerwaniach (po oczekiwaniu na puszczenie SET po wybudzeniu)
+    buttons.begin(handleButtonEvent, wakeInputTask);
+    buttons.addButton(BTN_UP, LONG_PRESS_TIME);
+    buttons.addButton(BTN_DOWN, LONG_PRESS_TIME);
+    buttons.addButton(BTN_SET, SET_LONG_PRESS, DOUBLE_CLICK_TIME);
 
-    unsigned long currentTime = millis();
+    // Kolejność zapytań w cyklu odczytu BMS
+    bmsPipeline.addCommand(BMS_BASIC_INFO, sizeof(BMS_BASIC_INFO));
+    bmsPipeline.addCommand(BMS_CELL_INFO, sizeof(BMS_CELL_INFO));
+    bmsPipeline.addCommand(BMS_TEMP_INFO, sizeof(BMS_TEMP_INFO));
 
-    odometerManager.update();
-
-    if (configModeActive) {      
-        display.clearBuffer();
-
-        // Wycentruj każdą linię tekstu
-        drawCenteredText("e-Bike System", 12, czcionka_srednia);
-        drawCenteredText("Konfiguracja on-line", 25, czcionka_mala);
-        drawCenteredText("siec: e-Bike System", 40, czcionka_mala);
-        drawCenteredText("haslo: #mamrower", 51, czcionka_mala);
-        drawCenteredText("IP: 192.168.4.1", 62, czcionka_mala);
-
-        display.sendBuffer();
-
-        // Sprawdź długie przytrzymanie SET do wyjścia
-        static unsigned long setPressStartTime = 0;
-        if (!digitalRead(BTN_SET)) { 
-            if (setPressStartTime == 0) {
-                setPressStartTime = millis();
-            } else if (millis() - setPressStartTime > 50) {
-                deactivateConfigMode();
-                setPressStartTime = 0;
-            }
-        } else {
-            setPressStartTime = 0;
-        }
-        return;
-    }
-
-    // Sprawdzaj czy nie trzeba włączyć trybu konfiguracji
-    checkConfigMode();
+    #if PERF_ENABLED
+    perfMonitor.begin();
+    #endif
 
-    if (currentTime - lastButtonCheck >= buttonInterval) {
-        handleButtons();
-        lastButtonCheck = currentTime;
-    }
+    // Uruchom zadania FreeRTOS (zastępują pętlę loop())
+    startTasks();
 
-    static unsigned long lastWebSocketUpdate = 0;
-    if (currentTime - lastWebSocketUpdate >= 1000) { // Aktualizuj co sekundę
-        if (ws.count() > 0) {
-            String json = "{";
-            json += "\"speed\":" + String(speed_kmh) + ",";
-            json += "\"temperature\":" + String(currentTemp) + ",";
-            json += "\"battery\":" + String(battery_capacity_percent) + ",";
-            json += "\"power\":" + String(power_w);
-            json += "}";
-            ws.textAll(json);
-        }
-        lastWebSocketUpdate = currentTime;
+    if (!fastResume) {
+        bootProfile.mark(BOOT_READY);
+        #ifdef DEBUG
+        bootProfile.printReport(Serial);
+        #endif
     }
+}
 
-    // Aktualizuj wyświetlacz tylko jeśli jest aktywny i nie wyświetla komunikatów
-    if (displayActive && messageStartTime == 0) {
-        display.clearBuffer();
-        drawTopBar();
-        drawHorizontalLine();
-        drawVerticalLine();
-        drawAssistLevel();
-        drawMainDisplay();
-        drawLightStatus();
-        display.sendBuffer();
-        handleTemperature();
-        updateBmsData();
-
-        if (currentTime - lastUpdate >= updateInterval) {
-            speed_kmh = (speed_kmh >= 35.0) ? 0.0 : speed_kmh + 0.1;
-            cadence_rpm = random(60, 90);
-            temp_motor = 30.0 + random(20);
-            range_km = 50.0 - (random(20) / 10.0);
-            // Aktualizacja dystansu            
-            //odometer.update(distance_km);
-            odometer.updateTotal(distance_km);
-            distance_km += 0.1;
-            power_w = 100 + random(300);
-            power_avg_w = power_w * 0.8;
-            power_max_w = power_w * 1.2;
-            battery_current = random(50, 150) / 10.0;
-            battery_capacity_wh = battery_voltage * battery_capacity_ah;
-            pressure_bar = 2.0 + (random(20) / 10.0);
-            pressure_voltage = 0.5 + (random(20) / 100.0);
-            pressure_temp = 20.0 + (random(100) / 10.0);
-            battery_capacity_wh = 14.5 - (random(20) / 10.0);
-            battery_capacity_percent = (battery_capacity_percent <= 0) ? 100 : battery_capacity_percent - 1;
-            battery_voltage = (battery_voltage <= 42.0) ? 50.0 : battery_voltage - 0.1;
-            assistMode = (assistMode + 1) % 5;
-            lastUpdate = currentTime;
-            pressure_rear_bar = 2.0 + (random(20) / 10.0);
-            pressure_rear_voltage = 0.5 + (random(20) / 100.0);
-            pressure_rear_temp = 20.0 + (random(100) / 10.0);
-            // Aktualizacja średniej prędkości (przykładowa implementacja)
-            static float speed_sum = 0;
-            static int speed_count = 0;
-            speed_sum += speed_kmh;
-            speed_count++;
-            speed_avg_kmh = speed_sum / speed_count;
-            // Aktualizacja maksymalnej prędkości
-            if (speed_kmh > speed_max_kmh) {
-                speed_max_kmh = speed_kmh;
-            }
-
-            // Aktualizacja kadencji
-            cadence_rpm = random(60, 90);
-
-            // Aktualizacja średniej kadencji (przykładowa implementacja)
-            static int cadence_sum = 0;
-            static int cadence_count = 0;
-            cadence_sum += cadence_rpm;
-            cadence_count++;
-            cadence_avg_rpm = cadence_sum / cadence_count;
-        }
-    }
-}
\ No newline at end of file
+// Implementacja funkcji loop
+void loop() {
+    // Cała praca odbywa się w zadaniach FreeRTOS uruchomionych w setup()
+    vTaskDelete(NULL);
+}
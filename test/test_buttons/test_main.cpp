@@ -0,0 +1,183 @@
+// ButtonEngine: odtworzenie scenariusza sim/scenarios/buttons.txt (zbocza
+// przez sim::setInputLevel, jak w symulatorze) i porównanie ciągu gestów
+// z oczekiwanym. Konfiguracja przycisków i anulowanie gestów po kombinacji
+// jak w main.cpp. Przerwy bez wciśniętego przycisku są skracane do 600 ms
+// (dłużej niż czas na drugie kliknięcie), pozostałe odstępy bez zmian.
+
+#include <Arduino.h>
+#include <SimRuntime.h>
+#include <unity.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ButtonEngine.h"
+
+namespace {
+
+    const char* const SCENARIO = "sim/scenarios/buttons.txt";
+    const uint8_t BTN_UP = 13;
+    const uint8_t BTN_DOWN = 14;
+    const uint8_t BTN_SET = 12;
+    const uint16_t LONG_PRESS_TIME = 1000;
+    const uint16_t SET_LONG_PRESS = 2000;
+    const uint16_t DOUBLE_CLICK_TIME = 300;
+    const uint32_t IDLE_GAP_MS = 600;
+
+    const uint8_t UP = 0x01;       // Maski (kolejność addButton)
+    const uint8_t DOWN = 0x02;
+    const uint8_t SET = 0x04;
+
+    struct Step {
+        uint32_t time;
+        uint8_t pin;
+        bool press;
+    };
+
+    struct Expected {
+        ButtonGesture gesture;
+        uint8_t buttons;
+    };
+
+    ButtonEngine buttons;
+    std::vector<ButtonEvent> events;
+    bool configMode = false;
+    bool started = false;
+    int8_t indices[3];
+
+    // Jak handleButtonEvent w main.cpp: po kombinacji i po wyjściu z trybu
+    // konfiguracji puszczenie przycisków nie wywołuje kolejnych gestów
+    void handleEvent(const ButtonEvent& event) {
+        events.push_back(event);
+        if (event.gesture == GESTURE_CHORD) {
+            if (event.buttons == (UP | DOWN)) configMode = true;
+            buttons.suppress(millis());
+        } else if (configMode && event.gesture == GESTURE_PRESS && event.buttons == SET) {
+            configMode = false;
+            buttons.suppress(millis());
+        }
+    }
+
+    std::vector<Step> loadScenario() {
+        std::vector<Step> steps;
+        std::ifstream file(SCENARIO);
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            uint32_t time;
+            std::string command;
+            int pin;
+            if (!(fields >> time >> command >> pin)) continue;   // Komentarze, "quit"
+            if (command == "press" || command == "release") {
+                Step step = { time, (uint8_t)pin, command == "press" };
+                steps.push_back(step);
+            }
+        }
+        return steps;
+    }
+
+    void processUntil(uint32_t until) {
+        while ((int32_t)(millis() - until) < 0) {
+            buttons.process(millis());
+            delay(1);
+        }
+    }
+
+    // Czas gestu względem poprzedniego zdarzenia danego rodzaju dla tych samych przycisków
+    uint32_t sincePrevious(size_t index, ButtonGesture gesture) {
+        for (size_t i = index; i-- > 0;) {
+            if (events[i].gesture == gesture && events[i].buttons & events[index].buttons) {
+                return events[index].time - events[i].time;
+            }
+        }
+        return UINT32_MAX;
+    }
+
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_begin() {
+    TEST_ASSERT_TRUE(started);
+    TEST_ASSERT_EQUAL_INT(0, indices[0]);
+    TEST_ASSERT_EQUAL_INT(1, indices[1]);
+    TEST_ASSERT_EQUAL_INT(2, indices[2]);
+}
+
+void test_scenario_gesture_sequence() {
+    std::vector<Step> steps = loadScenario();
+    TEST_ASSERT_GREATER_THAN(20, steps.size());
+
+    // Odtworzenie z zachowaniem odstępów (poza przerwami bez wciśniętych przycisków)
+    uint32_t start = millis();
+    uint32_t target = 0;
+    uint32_t previous = 0;
+    uint8_t held = 0;
+    for (const Step& step : steps) {
+        uint32_t gap = step.time - previous;
+        if (held == 0 && gap > IDLE_GAP_MS) gap = IDLE_GAP_MS;
+        target += gap;
+        previous = step.time;
+
+        processUntil(start + target);
+        sim::setInputLevel(step.pin, step.press ? LOW : HIGH);
+        if (step.press) held++; else if (held > 0) held--;
+    }
+    processUntil(millis() + IDLE_GAP_MS);
+
+    const Expected expected[] = {
+        // Włączenie - przytrzymanie SET
+        { GESTURE_PRESS, SET }, { GESTURE_LONG_PRESS, SET },
+        // UP: kliknięcie, przytrzymanie
+        { GESTURE_PRESS, UP }, { GESTURE_CLICK, UP }, { GESTURE_PRESS, UP }, { GESTURE_LONG_PRESS, UP },
+        // DOWN: kliknięcie, przytrzymanie
+        { GESTURE_PRESS, DOWN }, { GESTURE_CLICK, DOWN }, { GESTURE_PRESS, DOWN }, { GESTURE_LONG_PRESS, DOWN },
+        // SET: kliknięcie (po czasie na drugie), podwójne kliknięcie
+        { GESTURE_PRESS, SET }, { GESTURE_CLICK, SET },
+        { GESTURE_PRESS, SET }, { GESTURE_PRESS, SET }, { GESTURE_DOUBLE_CLICK, SET },
+        // Drgania styku - jedno kliknięcie UP
+        { GESTURE_PRESS, UP }, { GESTURE_CLICK, UP },
+        // UP + SET - kombinacja, puszczenie bez kliknięć
+        { GESTURE_PRESS, UP }, { GESTURE_PRESS, SET }, { GESTURE_CHORD, UP | SET },
+        // UP + DOWN - tryb konfiguracji, SET - wyjście (bez kliknięcia)
+        { GESTURE_PRESS, UP }, { GESTURE_PRESS, DOWN }, { GESTURE_CHORD, UP | DOWN },
+        { GESTURE_PRESS, SET },
+        // Przytrzymanie SET - uśpienie
+        { GESTURE_PRESS, SET }, { GESTURE_LONG_PRESS, SET },
+    };
+    const size_t expectedCount = sizeof(expected) / sizeof(expected[0]);
+
+    for (size_t i = 0; i < events.size() && i < expectedCount; i++) {
+        char message[48];
+        snprintf(message, sizeof(message), "gest %u: %d/0x%02X", (unsigned)i, events[i].gesture, events[i].buttons);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(expected[i].gesture, events[i].gesture, message);
+        TEST_ASSERT_EQUAL_HEX8_MESSAGE(expected[i].buttons, events[i].buttons, message);
+    }
+    TEST_ASSERT_EQUAL_UINT32(expectedCount, events.size());
+
+    // Czasy: przytrzymanie i kliknięcie SET liczone od zbocza (dokładnie),
+    // kombinacja od drugiego wciśnięcia (w kroku process)
+    for (size_t i = 0; i < events.size(); i++) {
+        const ButtonEvent& event = events[i];
+        if (event.gesture == GESTURE_LONG_PRESS) {
+            uint32_t longPress = event.buttons == SET ? SET_LONG_PRESS : LONG_PRESS_TIME;
+            TEST_ASSERT_EQUAL_UINT32(longPress, sincePrevious(i, GESTURE_PRESS));
+        } else if (event.gesture == GESTURE_CHORD) {
+            TEST_ASSERT_UINT32_WITHIN(20, ButtonEngine::CHORD_MS + 10, sincePrevious(i, GESTURE_PRESS));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, buttons.getPressedMask());
+}
+
+int main() {
+    started = buttons.begin(handleEvent);
+    indices[0] = buttons.addButton(BTN_UP, LONG_PRESS_TIME);
+    indices[1] = buttons.addButton(BTN_DOWN, LONG_PRESS_TIME);
+    indices[2] = buttons.addButton(BTN_SET, SET_LONG_PRESS, DOUBLE_CLICK_TIME);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_begin);
+    RUN_TEST(test_scenario_gesture_sequence);
+    return UNITY_END();
+}
@@ -0,0 +1,116 @@
+// CadenceSensor z impulsami symulatora (PCNT i esp_timer symulatora):
+// kadencja w trybie pomiaru okresu i w trybie zliczania impulsów w oknie 1 s,
+// histereza przełączania i zero po zatrzymaniu korby.
+// Tarcza PAS z 12 magnesami; impulsy w czasie rzeczywistym hosta.
+
+#include <Arduino.h>
+#include <SimRuntime.h>
+#include <unity.h>
+#include "CadenceSensor.h"
+
+namespace {
+
+    const uint8_t PIN = 25;
+    const uint8_t MAGNETS = 12;
+    // Pomiar okresu to jeden odstęp między impulsami - impuls może być
+    // przesunięty przez planistę hosta (jak w test_wheel_speed)
+    const double HOST_JITTER_MS = 10.0;
+
+    CadenceSensor sensor;
+    bool started = false;
+
+    // Okres impulsów [ms] dla kadencji [obr/min]
+    double pulsePeriodMs(uint16_t rpm) {
+        return 60000.0 / ((double)rpm * MAGNETS);
+    }
+
+    // Kadencja z okresu impulsów [ms]
+    double cadenceForPeriod(double periodMs) {
+        return 60000.0 / (periodMs * MAGNETS);
+    }
+
+    // Kadencja dla okresu dłuższego lub krótszego o HOST_JITTER_MS
+    // (+0,5 na zaokrąglenie wyniku do całych obr/min)
+    void assertPeriodCadence(uint16_t rpm, uint16_t cadence) {
+        double periodMs = pulsePeriodMs(rpm);
+        double fastest = cadenceForPeriod(periodMs - HOST_JITTER_MS) + 0.5;
+        double slowest = cadenceForPeriod(periodMs + HOST_JITTER_MS) - 0.5;
+        TEST_ASSERT_FLOAT_WITHIN((fastest - slowest) / 2, (fastest + slowest) / 2, cadence);
+    }
+
+    void pedal(uint16_t rpm, uint32_t waitMs) {
+        sim::startPulses(PIN, pulsePeriodMs(rpm), 0);
+        delay(waitMs);
+    }
+
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_begin() {
+    TEST_ASSERT_TRUE(started);
+    TEST_ASSERT_EQUAL_UINT16(0, sensor.getCadence());
+}
+
+void test_period_mode_at_low_cadence() {
+    // 60 obr/min = 12 impulsów/s < 20 - pomiar okresu, wynik z dwóch ostatnich impulsów
+    pedal(60, 1500);
+    TEST_ASSERT_FALSE(sensor.isCounting());
+    assertPeriodCadence(60, sensor.getCadence());
+
+    pedal(40, 1000);
+    TEST_ASSERT_FALSE(sensor.isCounting());
+    assertPeriodCadence(40, sensor.getCadence());
+}
+
+void test_counting_mode_at_high_cadence() {
+    // 120 obr/min = 24 impulsy/s - zliczanie w oknie 1 s (rozdzielczość 5 obr/min)
+    pedal(120, 2000);
+    TEST_ASSERT_TRUE(sensor.isCounting());
+    TEST_ASSERT_UINT32_WITHIN(5, 120, sensor.getCadence());
+
+    pedal(100, 1500);
+    TEST_ASSERT_TRUE(sensor.isCounting());
+    TEST_ASSERT_UINT32_WITHIN(5, 100, sensor.getCadence());
+}
+
+void test_hysteresis_between_modes() {
+    pedal(120, 2000);
+    TEST_ASSERT_TRUE(sensor.isCounting());
+
+    // 80 obr/min = 16 impulsów/s: między progami 15 i 20 - tryb bez zmiany
+    pedal(80, 1500);
+    TEST_ASSERT_TRUE(sensor.isCounting());
+    TEST_ASSERT_UINT32_WITHIN(5, 80, sensor.getCadence());
+
+    // 60 obr/min = 12 impulsów/s < 15 - powrót do pomiaru okresu
+    pedal(60, 1500);
+    TEST_ASSERT_FALSE(sensor.isCounting());
+    assertPeriodCadence(60, sensor.getCadence());
+}
+
+void test_zero_after_pedaling_stops() {
+    pedal(60, 1000);
+    TEST_ASSERT_GREATER_THAN(0, sensor.getCadence());
+
+    // Bez impulsu przez czas obrotu przy MIN_RPM / magnesy (0,5 s) - brak pedałowania
+    sim::startPulses(PIN, 0, 0);
+    delay(800);
+    TEST_ASSERT_EQUAL_UINT16(0, sensor.getCadence());
+
+    // Średnia tylko z próbek z pedałowaniem - w zakresie użytych kadencji 40-120
+    TEST_ASSERT_UINT32_WITHIN(40, 80, sensor.getAverageCadence());
+}
+
+int main() {
+    started = sensor.begin(PIN, MAGNETS);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_begin);
+    RUN_TEST(test_period_mode_at_low_cadence);
+    RUN_TEST(test_counting_mode_at_high_cadence);
+    RUN_TEST(test_hysteresis_between_modes);
+    RUN_TEST(test_zero_after_pedaling_stops);
+    return UNITY_END();
+}
@@ -0,0 +1,343 @@
+// ConfigStore i LegacyConfig na LittleFS symulatora (katalog .sim/test_config_store):
+// zapis i odczyt obrazu /config.bin, odrzucenie obrazu z błędnym CRC (wartości
+// domyślne i isCorrupted()), starszy (krótszy) obraz bez sekcji lightLevels,
+// przeniesienie ustawień z dawnych plików JSON (tryb świateł jako liczba
+// i jako nazwa) z usunięciem tych plików. Na końcu czas odczytu: pliki JSON
+// (dawny start) i obraz binarny - tylko raport, bez progów (czas hosta).
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <SimRuntime.h>
+#include <unity.h>
+#include <stddef.h>
+#include <string.h>
+#include "ConfigStore.h"
+#include "Crc32.h"
+#include "LegacyConfig.h"
+
+namespace {
+
+    const uint16_t TIMING_REPEATS = 200;
+
+    // Ustawienia w dawnym formacie (jak zapisywała wersja bez /config.bin)
+    const char* const CONFIG_JSON =
+        "{\"light\":{\"dayLights\":2,\"nightLights\":3,\"dayBlink\":true,\"nightBlink\":false,\"blinkFrequency\":700},"
+        "\"backlight\":{\"dayBrightness\":80,\"nightBrightness\":20,\"autoMode\":true},"
+        "\"wifi\":{\"ssid\":\"rower\",\"password\":\"tajne-haslo\"},"
+        "\"time\":{\"ntpEnabled\":true},"
+        "\"controller\":{\"type\":\"kt-lcd\",\"params\":{"
+        "\"p\":{\"1\":11,\"2\":12,\"3\":13,\"4\":14,\"5\":15},"
+        "\"c\":{\"1\":21,\"2\":22,\"3\":23,\"4\":24,\"5\":25,\"6\":26,\"7\":27,\"8\":28,\"9\":29,\"10\":30,"
+        "\"11\":31,\"12\":32,\"13\":33,\"14\":34,\"15\":35},"
+        "\"l\":{\"1\":41,\"2\":42,\"3\":43}}}}";
+    const char* const LIGHTS_JSON =
+        "{\"dayLights\":\"REAR\",\"nightLights\":\"BOTH\",\"dayBlink\":false,\"nightBlink\":true,\"blinkFrequency\":300}";
+    const char* const DISPLAY_JSON = "{\"dayBrightness\":150,\"nightBrightness\":35,\"autoMode\":false}";
+    const char* const GENERAL_JSON = "{\"wheelSize\":28}";
+    const char* const BLUETOOTH_JSON = "{\"bmsEnabled\":true,\"tpmsEnabled\":true}";
+
+    void writeFile(const char* path, const void* data, size_t length) {
+        File file = LittleFS.open(path, "w");
+        TEST_ASSERT_TRUE(file);
+        TEST_ASSERT_EQUAL_UINT32(length, file.write((const uint8_t*)data, length));
+        file.close();
+    }
+
+    void writeText(const char* path, const char* text) {
+        writeFile(path, text, strlen(text));
+    }
+
+    void writeAllLegacyFiles() {
+        writeText("/config.json", CONFIG_JSON);
+        writeText("/lights.json", LIGHTS_JSON);
+        writeText("/display_config.json", DISPLAY_JSON);
+        writeText("/general_config.json", GENERAL_JSON);
+        writeText("/bluetooth_config.json", BLUETOOTH_JSON);
+    }
+
+    void assertDefaults(const ConfigStore& store) {
+        TEST_ASSERT_EQUAL_UINT8(LIGHTS_FRONT, store.lights().dayLights);
+        TEST_ASSERT_EQUAL_UINT8(LIGHTS_BOTH, store.lights().nightLights);
+        TEST_ASSERT_EQUAL_UINT16(500, store.lights().blinkFrequency);
+        TEST_ASSERT_EQUAL_UINT8(100, store.backlight().dayBrightness);
+        TEST_ASSERT_EQUAL_UINT8(50, store.backlight().nightBrightness);
+        TEST_ASSERT_EQUAL_UINT8(CONTROLLER_KT_LCD, store.controller().type);
+        TEST_ASSERT_EQUAL_UINT8(26, store.general().wheelSize);
+        TEST_ASSERT_EQUAL_UINT8(100, store.lightLevels().dayBrightness);
+        TEST_ASSERT_EQUAL_UINT8(100, store.lightLevels().nightBrightness);
+        TEST_ASSERT_EQUAL_UINT16(300, store.lightLevels().rampMs);
+    }
+
+    // Ustawienia różne od domyślnych we wszystkich sekcjach
+    void setCustom(ConfigStore& store) {
+        ConfigLights lights = { LIGHTS_REAR, LIGHTS_NONE, 1, 0, 800 };
+        store.setLights(lights);
+        ConfigBacklight backlight = { 70, 10, 1 };
+        store.setBacklight(backlight);
+        ConfigWifi wifi;
+        memset(&wifi, 0, sizeof(wifi));
+        strlcpy(wifi.ssid, "siec", sizeof(wifi.ssid));
+        strlcpy(wifi.password, "haslo123", sizeof(wifi.password));
+        store.setWifi(wifi);
+        ConfigController controller;
+        controller.type = CONTROLLER_S866;
+        for (int i = 0; i < 23; i++) controller.ktParams[i] = -i;
+        for (int i = 0; i < 20; i++) controller.s866Params[i] = 100 + i;
+        store.setController(controller);
+        ConfigGeneral general = { 29, 1 };
+        store.setGeneral(general);
+        ConfigBluetooth bluetooth = { 1, 0 };
+        store.setBluetooth(bluetooth);
+        ConfigLightLevels lightLevels = { 60, 90, 1200 };
+        store.setLightLevels(lightLevels);
+    }
+
+}
+
+void setUp() {
+    sim::setOutputDir(".sim/test_config_store");
+    TEST_ASSERT_TRUE(LittleFS.format());
+    TEST_ASSERT_TRUE(LittleFS.begin(false));
+}
+
+void tearDown() {}
+
+void test_missing_image_gives_defaults() {
+    ConfigStore store;
+    TEST_ASSERT_FALSE(store.begin(LittleFS));
+    TEST_ASSERT_FALSE(store.isLoaded());
+    TEST_ASSERT_FALSE(store.isCorrupted());
+    assertDefaults(store);
+}
+
+void test_round_trip() {
+    ConfigStore written;
+    TEST_ASSERT_FALSE(written.begin(LittleFS));
+    setCustom(written);
+    TEST_ASSERT_TRUE(written.save());
+    TEST_ASSERT_FALSE(LittleFS.exists("/config.tmp"));
+
+    // Nagłówek 12 B + dane 200 B
+    TEST_ASSERT_EQUAL_UINT32(212, ConfigStore::getImageSize());
+    File file = LittleFS.open("/config.bin", "r");
+    TEST_ASSERT_EQUAL_UINT32(212, file.size());
+    file.close();
+
+    ConfigStore read;
+    TEST_ASSERT_TRUE(read.begin(LittleFS));
+    TEST_ASSERT_TRUE(read.isLoaded());
+    TEST_ASSERT_FALSE(read.isCorrupted());
+    TEST_ASSERT_EQUAL_UINT32(written.getCrc(), read.getCrc());
+
+    TEST_ASSERT_EQUAL_UINT8(LIGHTS_REAR, read.lights().dayLights);
+    TEST_ASSERT_EQUAL_UINT8(LIGHTS_NONE, read.lights().nightLights);
+    TEST_ASSERT_EQUAL_UINT8(1, read.lights().dayBlink);
+    TEST_ASSERT_EQUAL_UINT16(800, read.lights().blinkFrequency);
+    TEST_ASSERT_EQUAL_UINT8(70, read.backlight().dayBrightness);
+    TEST_ASSERT_EQUAL_UINT8(10, read.backlight().nightBrightness);
+    TEST_ASSERT_EQUAL_UINT8(1, read.backlight().autoMode);
+    TEST_ASSERT_EQUAL_STRING("siec", read.wifi().ssid);
+    TEST_ASSERT_EQUAL_STRING("haslo123", read.wifi().password);
+    TEST_ASSERT_EQUAL_UINT8(CONTROLLER_S866, read.controller().type);
+    TEST_ASSERT_EQUAL_INT16(-22, read.controller().ktParams[22]);
+    TEST_ASSERT_EQUAL_INT16(119, read.controller().s866Params[19]);
+    TEST_ASSERT_EQUAL_UINT8(29, read.general().wheelSize);
+    TEST_ASSERT_EQUAL_UINT8(1, read.general().ntpEnabled);
+    TEST_ASSERT_EQUAL_UINT8(1, read.bluetooth().bmsEnabled);
+    TEST_ASSERT_EQUAL_UINT8(60, read.lightLevels().dayBrightness);
+    TEST_ASSERT_EQUAL_UINT8(90, read.lightLevels().nightBrightness);
+    TEST_ASSERT_EQUAL_UINT16(1200, read.lightLevels().rampMs);
+}
+
+void test_corrupted_crc_gives_defaults() {
+    ConfigStore written;
+    written.begin(LittleFS);
+    setCustom(written);
+    TEST_ASSERT_TRUE(written.save());
+
+    uint8_t image[212];
+    File file = LittleFS.open("/config.bin", "r");
+    TEST_ASSERT_EQUAL_UINT32(sizeof(image), file.read(image, sizeof(image)));
+    file.close();
+
+    // Jeden bit w danych (nazwa sieci) - CRC się nie zgadza
+    image[sizeof(ConfigHeader) + offsetof(ConfigData, wifi)] ^= 0x01;
+    writeFile("/config.bin", image, sizeof(image));
+
+    ConfigStore read;
+    TEST_ASSERT_FALSE(read.begin(LittleFS));
+    TEST_ASSERT_FALSE(read.isLoaded());
+    TEST_ASSERT_TRUE(read.isCorrupted());
+    assertDefaults(read);
+
+    // Obraz obcięty w połowie nagłówka
+    writeFile("/config.bin", image, sizeof(ConfigHeader) / 2);
+    TEST_ASSERT_FALSE(read.begin(LittleFS));
+    TEST_ASSERT_TRUE(read.isCorrupted());
+    assertDefaults(read);
+}
+
+void test_shorter_image_keeps_light_level_defaults() {
+    // Obraz sprzed dodania sekcji lightLevels: dane bez ostatnich 4 B
+    ConfigStore source;
+    setCustom(source);
+    ConfigData data;
+    memcpy(&data.lights, &source.lights(), sizeof(data.lights));
+    memcpy(&data.backlight, &source.backlight(), sizeof(data.backlight));
+    memcpy(&data.wifi, &source.wifi(), sizeof(data.wifi));
+    memcpy(&data.controller, &source.controller(), sizeof(data.controller));
+    memcpy(&data.general, &source.general(), sizeof(data.general));
+    memcpy(&data.bluetooth, &source.bluetooth(), sizeof(data.bluetooth));
+    const uint16_t oldLength = offsetof(ConfigData, lightLevels);
+    TEST_ASSERT_EQUAL_UINT16(196, oldLength);
+
+    uint8_t image[sizeof(ConfigHeader) + sizeof(ConfigData)];
+    ConfigHeader header = { ConfigStore::MAGIC, ConfigStore::VERSION, oldLength, crc32(&data, oldLength) };
+    memcpy(image, &header, sizeof(header));
+    memcpy(image + sizeof(header), &data, oldLength);
+    writeFile("/config.bin", image, sizeof(header) + oldLength);
+
+    ConfigStore read;
+    TEST_ASSERT_TRUE(read.begin(LittleFS));
+    TEST_ASSERT_FALSE(read.isCorrupted());
+    TEST_ASSERT_EQUAL_UINT8(LIGHTS_REAR, read.lights().dayLights);
+    TEST_ASSERT_EQUAL_UINT16(800, read.lights().blinkFrequency);
+    TEST_ASSERT_EQUAL_STRING("siec", read.wifi().ssid);
+    TEST_ASSERT_EQUAL_UINT8(1, read.bluetooth().bmsEnabled);
+    TEST_ASSERT_EQUAL_UINT8(100, read.lightLevels().dayBrightness);
+    TEST_ASSERT_EQUAL_UINT8(100, read.lightLevels().nightBrightness);
+    TEST_ASSERT_EQUAL_UINT16(300, read.lightLevels().rampMs);
+}
+
+void test_migrate_numeric_light_modes() {
+    // Tylko config.json: tryb świateł jako liczba
+    writeText("/config.json", CONFIG_JSON);
+
+    ConfigStore store;
+    TEST_ASSERT_FALSE(store.begin(LittleFS));
+    TEST_ASSERT_TRUE(LegacyConfig::read(LittleFS, store));
+    TEST_ASSERT_TRUE(LegacyConfig::commit(LittleFS, store));
+    TEST_ASSERT_FALSE(LittleFS.exists("/config.json"));
+
+    ConfigStore read;
+    TEST_ASSERT_TRUE(read.begin(LittleFS));
+    TEST_ASSERT_EQUAL_UINT8(LIGHTS_REAR, read.lights().dayLights);
+    TEST_ASSERT_EQUAL_UINT8(LIGHTS_BOTH, read.lights().nightLights);
+    TEST_ASSERT_EQUAL_UINT8(1, read.lights().dayBlink);
+    TEST_ASSERT_EQUAL_UINT8(0, read.lights().nightBlink);
+    TEST_ASSERT_EQUAL_UINT16(700, read.lights().blinkFrequency);
+    TEST_ASSERT_EQUAL_UINT8(80, read.backlight().dayBrightness);
+    TEST_ASSERT_EQUAL_UINT8(20, read.backlight().nightBrightness);
+    TEST_ASSERT_EQUAL_UINT8(1, read.backlight().autoMode);
+    TEST_ASSERT_EQUAL_STRING("rower", read.wifi().ssid);
+    TEST_ASSERT_EQUAL_STRING("tajne-haslo", read.wifi().password);
+    TEST_ASSERT_EQUAL_UINT8(1, read.general().ntpEnabled);
+    TEST_ASSERT_EQUAL_UINT8(CONTROLLER_KT_LCD, read.controller().type);
+    TEST_ASSERT_EQUAL_INT16(11, read.controller().ktParams[0]);     // P1
+    TEST_ASSERT_EQUAL_INT16(15, read.controller().ktParams[4]);     // P5
+    TEST_ASSERT_EQUAL_INT16(21, read.controller().ktParams[5]);     // C1
+    TEST_ASSERT_EQUAL_INT16(35, read.controller().ktParams[19]);    // C15
+    TEST_ASSERT_EQUAL_INT16(41, read.controller().ktParams[20]);    // L1
+    TEST_ASSERT_EQUAL_INT16(43, read.controller().ktParams[22]);    // L3
+    // Pola spoza dawnych plików - domyślne
+    TEST_ASSERT_EQUAL_UINT8(26, read.general().wheelSize);
+    TEST_ASSERT_EQUAL_UINT16(300, read.lightLevels().rampMs);
+}
+
+void test_migrate_named_light_modes() {
+    // lights.json (nazwy trybów) nadpisuje światła z config.json,
+    // display_config.json - podświetlenie (150% obcięte do 100%)
+    writeAllLegacyFiles();
+
+    ConfigStore store;
+    TEST_ASSERT_FALSE(store.begin(LittleFS));
+    TEST_ASSERT_TRUE(LegacyConfig::read(LittleFS, store));
+    TEST_ASSERT_TRUE(LegacyConfig::commit(LittleFS, store));
+    for (size_t i = 0; i < LegacyConfig::FILE_COUNT; i++) {
+        TEST_ASSERT_FALSE_MESSAGE(LittleFS.exists(LegacyConfig::FILES[i]), LegacyConfig::FILES[i]);
+    }
+
+    ConfigStore read;
+    TEST_ASSERT_TRUE(read.begin(LittleFS));
+    TEST_ASSERT_EQUAL_UINT8(LIGHTS_REAR, read.lights().dayLights);
+    TEST_ASSERT_EQUAL_UINT8(LIGHTS_BOTH, read.lights().nightLights);
+    TEST_ASSERT_EQUAL_UINT8(0, read.lights().dayBlink);
+    TEST_ASSERT_EQUAL_UINT8(1, read.lights().nightBlink);
+    TEST_ASSERT_EQUAL_UINT16(300, read.lights().blinkFrequency);
+    TEST_ASSERT_EQUAL_UINT8(100, read.backlight().dayBrightness);
+    TEST_ASSERT_EQUAL_UINT8(35, read.backlight().nightBrightness);
+    TEST_ASSERT_EQUAL_UINT8(0, read.backlight().autoMode);
+    TEST_ASSERT_EQUAL_UINT8(28, read.general().wheelSize);
+    TEST_ASSERT_EQUAL_UINT8(1, read.general().ntpEnabled);
+    TEST_ASSERT_EQUAL_UINT8(1, read.bluetooth().bmsEnabled);
+    TEST_ASSERT_EQUAL_UINT8(1, read.bluetooth().tpmsEnabled);
+    TEST_ASSERT_EQUAL_STRING("rower", read.wifi().ssid);
+}
+
+void test_migrate_s866_and_unknown_values() {
+    // Parametry bezpośrednio w "controller" (dawny odczyt), nieznana nazwa
+    // trybu - wyłączone, liczba poza zakresem - wartość domyślna lights.json
+    writeText("/config.json",
+              "{\"controller\":{\"type\":\"s866\",\"p\":{\"1\":5,\"20\":-3}}}");
+    writeText("/lights.json", "{\"dayLights\":\"LEFT\",\"nightLights\":7}");
+    writeText("/general_config.json", "{\"wheelSize\":");   // Uszkodzony - pomijany
+
+    ConfigStore store;
+    store.begin(LittleFS);
+    TEST_ASSERT_TRUE(LegacyConfig::read(LittleFS, store));
+    TEST_ASSERT_EQUAL_UINT8(CONTROLLER_S866, store.controller().type);
+    TEST_ASSERT_EQUAL_INT16(5, store.controller().s866Params[0]);
+    TEST_ASSERT_EQUAL_INT16(0, store.controller().s866Params[1]);
+    TEST_ASSERT_EQUAL_INT16(-3, store.controller().s866Params[19]);
+    TEST_ASSERT_EQUAL_UINT8(LIGHTS_NONE, store.lights().dayLights);
+    TEST_ASSERT_EQUAL_UINT8(LIGHTS_BOTH, store.lights().nightLights);
+    TEST_ASSERT_EQUAL_UINT8(26, store.general().wheelSize);
+
+    // Bez dawnych plików nic do przeniesienia
+    TEST_ASSERT_TRUE(LegacyConfig::commit(LittleFS, store));
+    ConfigStore empty;
+    TEST_ASSERT_FALSE(LegacyConfig::read(LittleFS, empty));
+}
+
+void test_load_time_json_vs_binary() {
+    writeAllLegacyFiles();
+
+    // Dawny start: pięć plików JSON
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < TIMING_REPEATS; i++) {
+        ConfigStore store;
+        TEST_ASSERT_TRUE(LegacyConfig::read(LittleFS, store));
+    }
+    uint32_t jsonUs = micros() - start;
+
+    ConfigStore store;
+    store.begin(LittleFS);
+    LegacyConfig::read(LittleFS, store);
+    TEST_ASSERT_TRUE(LegacyConfig::commit(LittleFS, store));
+
+    // Obecny start: jeden odczyt /config.bin
+    start = micros();
+    for (uint16_t i = 0; i < TIMING_REPEATS; i++) {
+        TEST_ASSERT_TRUE(store.begin(LittleFS));
+    }
+    uint32_t binaryUs = micros() - start;
+
+    char line[160];
+    snprintf(line, sizeof(line), "odczyt konfiguracji (średnio z %u): pliki JSON %.1f us, /config.bin %.1f us (%u B)",
+             (unsigned)TIMING_REPEATS, (double)jsonUs / TIMING_REPEATS, (double)binaryUs / TIMING_REPEATS,
+             (unsigned)ConfigStore::getImageSize());
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_missing_image_gives_defaults);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_corrupted_crc_gives_defaults);
+    RUN_TEST(test_shorter_image_keeps_light_level_defaults);
+    RUN_TEST(test_migrate_numeric_light_modes);
+    RUN_TEST(test_migrate_named_light_modes);
+    RUN_TEST(test_migrate_s866_and_unknown_values);
+    RUN_TEST(test_load_time_json_vs_binary);
+    return UNITY_END();
+}
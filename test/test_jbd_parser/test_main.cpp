@@ -0,0 +1,399 @@
+// JbdParser: odtwarzanie zapisanych odpowiedzi BMS pociętych na fragmenty
+// o losowych granicach (1-20 B, jak powiadomienia BLE), przemieszanych
+// z bajtami śmieci i ramkami błędnymi. Liczniki parsera muszą się zgadzać
+// dokładnie z tym, co zostało wysłane, a zdekodowane wartości z ramkami.
+// Śmieci z bajtami 0xDD (fałszywy start z wiarygodną długością) - każda
+// poprawna ramka odzyskana. Na końcu przepustowość odtwarzania [us/ramkę].
+
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "JbdParser.h"
+
+namespace {
+
+    // Odpowiedzi BMS 13S z dwoma czujnikami NTC
+    const uint8_t BASIC_INFO[] = {   // 48,12 V, -2,00 A, 30/40 Ah, 17 cykli, 75 %, 25/26 °C
+        0xDD, 0x03, 0x00, 0x1B, 0x12, 0xCC, 0xFF, 0x38, 0x0B, 0xB8, 0x0F, 0xA0, 0x00, 0x11, 0x2A, 0x41,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x4B, 0x03, 0x0D, 0x02, 0x0B, 0xA5, 0x0B, 0xAF, 0xFA,
+        0x0B, 0x77
+    };
+    const uint8_t CELL_INFO[] = {    // 3,700 ... 3,712 V
+        0xDD, 0x04, 0x00, 0x1A, 0x0E, 0x74, 0x0E, 0x75, 0x0E, 0x76, 0x0E, 0x77, 0x0E, 0x78, 0x0E, 0x79,
+        0x0E, 0x7A, 0x0E, 0x7B, 0x0E, 0x7C, 0x0E, 0x7D, 0x0E, 0x7E, 0x0E, 0x7F, 0x0E, 0x80, 0xF8, 0xFE,
+        0x77
+    };
+    const uint8_t TEMPERATURES[] = { // 24 / 28 °C
+        0xDD, 0x08, 0x00, 0x04, 0x0B, 0x9B, 0x0B, 0xC3, 0xFE, 0x88, 0x77
+    };
+
+    // Ramki błędne (bez 0xDD poza bajtem startu - przewidywalna synchronizacja)
+    const uint8_t BAD_CHECKSUM[] = { // CELL_INFO z uszkodzoną sumą
+        0xDD, 0x04, 0x00, 0x1A, 0x0E, 0x74, 0x0E, 0x75, 0x0E, 0x76, 0x0E, 0x77, 0x0E, 0x78, 0x0E, 0x79,
+        0x0E, 0x7A, 0x0E, 0x7B, 0x0E, 0x7C, 0x0E, 0x7D, 0x0E, 0x7E, 0x0E, 0x7F, 0x0E, 0x80, 0xF8, 0xFF,
+        0x77
+    };
+    const uint8_t ODD_LENGTH[] = {   // Rejestr 0x04 z nieparzystą długością, poprawna suma
+        0xDD, 0x04, 0x00, 0x05, 0x0E, 0x74, 0x0E, 0x75, 0x0E, 0xFE, 0xE8, 0x77
+    };
+    const uint8_t FALSE_START[] = {  // 0xDD w śmieciach z długością > 128
+        0xDD, 0x03, 0x00, 0xF0
+    };
+    const uint8_t STATUS_ERROR[] = { // BMS zgłasza błąd odczytu rejestru
+        0xDD, 0x03, 0x80, 0x00, 0xFF, 0x80, 0x77
+    };
+
+    // Fałszywy start z długością 16 (mieści się w limicie 128 B) - parser czeka
+    // na 23 B, więc w tym oknie są bajty następnych ramek
+    const uint8_t STRAY_START[] = { 0xDD, 0x05, 0x00, 0x10 };
+
+    enum Chunk { BASIC, CELLS, TEMPS, CHECKSUM, LENGTH, FALSE_START_CHUNK, STATUS, GARBAGE, CHUNK_KINDS };
+
+    struct Expected {
+        uint32_t framesOk = 0;
+        uint32_t checksumErrors = 0;
+        uint32_t lengthErrors = 0;
+        uint32_t statusErrors = 0;
+        uint32_t skippedBytes = 0;
+        uint32_t strayStarts = 0;    // Bajty 0xDD w śmieciach
+    };
+
+    // Deterministyczny generator (xorshift32) - powtarzalne przebiegi
+    struct Random {
+        uint32_t state;
+        explicit Random(uint32_t seed) : state(seed) {}
+        uint32_t next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t below(uint32_t limit) { return next() % limit; }
+    };
+
+    void append(std::vector<uint8_t>& stream, const uint8_t* data, size_t length) {
+        stream.insert(stream.end(), data, data + length);
+    }
+
+    // Strumień losowych ramek i śmieci wraz z oczekiwanymi licznikami;
+    // strayEvery > 0 - średnio co tyle bajtów śmieci bajt 0xDD
+    std::vector<uint8_t> buildStream(Random& random, size_t chunks, Expected& expected, uint32_t strayEvery = 0) {
+        std::vector<uint8_t> stream;
+        for (size_t i = 0; i < chunks; i++) {
+            switch (random.below(CHUNK_KINDS)) {
+                case BASIC:
+                    append(stream, BASIC_INFO, sizeof(BASIC_INFO));
+                    expected.framesOk++;
+                    break;
+                case CELLS:
+                    append(stream, CELL_INFO, sizeof(CELL_INFO));
+                    expected.framesOk++;
+                    break;
+                case TEMPS:
+                    append(stream, TEMPERATURES, sizeof(TEMPERATURES));
+                    expected.framesOk++;
+                    break;
+                case CHECKSUM:
+                    // Odrzucony bajt startu, reszta ramki pomijana przy synchronizacji
+                    append(stream, BAD_CHECKSUM, sizeof(BAD_CHECKSUM));
+                    expected.checksumErrors++;
+                    expected.skippedBytes += sizeof(BAD_CHECKSUM) - 1;
+                    break;
+                case LENGTH:
+                    append(stream, ODD_LENGTH, sizeof(ODD_LENGTH));
+                    expected.lengthErrors++;
+                    break;
+                case FALSE_START_CHUNK:
+                    append(stream, FALSE_START, sizeof(FALSE_START));
+                    expected.lengthErrors++;
+                    expected.skippedBytes += sizeof(FALSE_START) - 1;
+                    break;
+                case STATUS:
+                    append(stream, STATUS_ERROR, sizeof(STATUS_ERROR));
+                    expected.statusErrors++;
+                    break;
+                default: {
+                    uint32_t count = 1 + random.below(40);
+                    for (uint32_t b = 0; b < count; b++) {
+                        uint8_t garbage = (uint8_t)random.next();
+                        if (garbage == 0xDD) garbage = 0x00;
+                        if (strayEvery > 0 && random.below(strayEvery) == 0) {
+                            // Bajt startu odrzucany przez błąd ramki, nie liczony jako pominięty
+                            garbage = 0xDD;
+                            expected.strayStarts++;
+                        } else {
+                            expected.skippedBytes++;
+                        }
+                        stream.push_back(garbage);
+                    }
+                    break;
+                }
+            }
+        }
+        return stream;
+    }
+
+    // Odtworzenie strumienia fragmentami 1-20 B co 1 ms; na końcu czas do
+    // porzucenia niekompletnej ramki. Zwraca liczbę zdekodowanych ramek.
+    uint32_t replay(JbdParser& parser, const std::vector<uint8_t>& stream, Random& random) {
+        BmsData bms = {};
+        uint8_t command = 0;
+        uint32_t decoded = 0;
+        unsigned long now = 0;
+
+        size_t offset = 0;
+        while (offset < stream.size()) {
+            size_t length = 1 + random.below(20);
+            if (length > stream.size() - offset) length = stream.size() - offset;
+            parser.push(&stream[offset], length);
+            offset += length;
+            now++;
+            while (parser.poll(bms, command, now)) decoded++;
+        }
+        // Fałszywy start blisko końca czeka na bajty, które nie przyjdą
+        for (uint8_t i = 0; i < 8; i++) {
+            now += 1000;
+            while (parser.poll(bms, command, now)) decoded++;
+        }
+        return decoded;
+    }
+
+    void assertBasicInfo(const BmsData& bms) {
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, 48.12f, bms.voltage);
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, -2.0f, bms.current);
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, 30.0f, bms.remainingCapacity);
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, 40.0f, bms.totalCapacity);
+        TEST_ASSERT_EQUAL_UINT16(17, bms.cycles);
+        TEST_ASSERT_EQUAL_UINT8(75, bms.soc);
+        TEST_ASSERT_TRUE(bms.charging);
+        TEST_ASSERT_TRUE(bms.discharging);
+        TEST_ASSERT_EQUAL_UINT8(13, bms.cellCount);
+        TEST_ASSERT_EQUAL_UINT8(2, bms.ntcCount);
+    }
+
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_recorded_frames_decode() {
+    JbdParser parser;
+    BmsData bms = {};
+    uint8_t command = 0;
+
+    parser.push(BASIC_INFO, sizeof(BASIC_INFO));
+    TEST_ASSERT_TRUE(parser.poll(bms, command, 0));
+    TEST_ASSERT_EQUAL_HEX8(0x03, command);
+    assertBasicInfo(bms);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 25.0f, bms.temperatures[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 26.0f, bms.temperatures[1]);
+
+    parser.push(CELL_INFO, sizeof(CELL_INFO));
+    TEST_ASSERT_TRUE(parser.poll(bms, command, 0));
+    TEST_ASSERT_EQUAL_HEX8(0x04, command);
+    TEST_ASSERT_EQUAL_UINT8(13, bms.cellCount);
+    for (uint8_t i = 0; i < 13; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.0001f, 3.700f + i * 0.001f, bms.cellVoltages[i]);
+    }
+
+    parser.push(TEMPERATURES, sizeof(TEMPERATURES));
+    TEST_ASSERT_TRUE(parser.poll(bms, command, 0));
+    TEST_ASSERT_EQUAL_HEX8(0x08, command);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 24.0f, bms.temperatures[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 28.0f, bms.temperatures[1]);
+
+    TEST_ASSERT_FALSE(parser.poll(bms, command, 0));
+    TEST_ASSERT_EQUAL_UINT32(3, parser.getStats().framesOk);
+}
+
+void test_random_fragments_with_garbage() {
+    const uint32_t RUNS = 200;
+
+    for (uint32_t seed = 1; seed <= RUNS; seed++) {
+        Random random(seed * 2654435761u);
+        Expected expected;
+        std::vector<uint8_t> stream = buildStream(random, 100, expected);
+
+        JbdParser parser;
+        BmsData bms = {};
+        uint8_t command = 0;
+        uint32_t decoded = 0;
+        unsigned long now = 0;
+
+        // Fragmenty 1-20 B co 1 ms, po każdym odbiór wszystkich gotowych ramek
+        size_t offset = 0;
+        while (offset < stream.size()) {
+            size_t length = 1 + random.below(20);
+            if (length > stream.size() - offset) length = stream.size() - offset;
+            parser.push(&stream[offset], length);
+            offset += length;
+            now++;
+
+            while (parser.poll(bms, command, now)) {
+                decoded++;
+                if (command == 0x03) assertBasicInfo(bms);
+                if (command == 0x04) TEST_ASSERT_FLOAT_WITHIN(0.0001f, 3.712f, bms.cellVoltages[12]);
+                if (command == 0x08) TEST_ASSERT_FLOAT_WITHIN(0.001f, 28.0f, bms.temperatures[1]);
+            }
+        }
+
+        char message[32];
+        snprintf(message, sizeof(message), "ziarno %u", (unsigned)seed);
+        JbdParserStats stats = parser.getStats();
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.framesOk, decoded, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.framesOk, stats.framesOk, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.checksumErrors, stats.checksumErrors, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.lengthErrors, stats.lengthErrors, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.statusErrors, stats.statusErrors, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.skippedBytes, stats.skippedBytes, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, stats.endByteErrors, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, stats.unknownCommands, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, stats.timeouts, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, stats.overflows, message);
+    }
+}
+
+void test_stray_start_with_plausible_length() {
+    JbdParser parser(500);
+    BmsData bms = {};
+    uint8_t command = 0;
+
+    // Fałszywy start, zaraz za nim dwie ramki: okno 23 B kończy się w CELL_INFO
+    // (bajt 0x75 zamiast 0x77) - start odrzucony, 3 bajty pominięte, obie ramki całe
+    std::vector<uint8_t> stream;
+    append(stream, STRAY_START, sizeof(STRAY_START));
+    append(stream, TEMPERATURES, sizeof(TEMPERATURES));
+    append(stream, CELL_INFO, sizeof(CELL_INFO));
+    parser.push(stream.data(), stream.size());
+
+    TEST_ASSERT_TRUE(parser.poll(bms, command, 0));
+    TEST_ASSERT_EQUAL_HEX8(0x08, command);
+    TEST_ASSERT_TRUE(parser.poll(bms, command, 0));
+    TEST_ASSERT_EQUAL_HEX8(0x04, command);
+    JbdParserStats stats = parser.getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.framesOk);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.endByteErrors);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.skippedBytes);
+
+    // Fałszywy start przed ostatnią ramką: okno dłuższe niż dane - ramka
+    // czeka do limitu czasu, potem odzyskana
+    parser.push(STRAY_START, sizeof(STRAY_START));
+    parser.push(TEMPERATURES, sizeof(TEMPERATURES));
+    TEST_ASSERT_FALSE(parser.poll(bms, command, 1000));
+    TEST_ASSERT_FALSE(parser.poll(bms, command, 1499));
+    TEST_ASSERT_TRUE(parser.poll(bms, command, 1500));
+    TEST_ASSERT_EQUAL_HEX8(0x08, command);
+    stats = parser.getStats();
+    TEST_ASSERT_EQUAL_UINT32(3, stats.framesOk);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(6, stats.skippedBytes);
+}
+
+void test_random_stray_starts_in_garbage() {
+    const uint32_t RUNS = 200;
+
+    for (uint32_t seed = 1; seed <= RUNS; seed++) {
+        Random random(seed * 2246822519u);
+        Expected expected;
+        // Średnio co 8. bajt śmieci to 0xDD
+        std::vector<uint8_t> stream = buildStream(random, 100, expected, 8);
+
+        JbdParser parser(500);
+        uint32_t decoded = replay(parser, stream, random);
+
+        // Każdy fałszywy start kończy się dokładnie jednym błędem (koniec ramki,
+        // długość, suma lub limit czasu) i nie zabiera żadnej poprawnej ramki
+        char message[32];
+        snprintf(message, sizeof(message), "ziarno %u", (unsigned)seed);
+        JbdParserStats stats = parser.getStats();
+        uint32_t errors = stats.checksumErrors + stats.lengthErrors + stats.endByteErrors + stats.statusErrors +
+                          stats.unknownCommands + stats.timeouts;
+        uint32_t expectedErrors = expected.checksumErrors + expected.lengthErrors + expected.statusErrors +
+                                  expected.strayStarts;
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.framesOk, decoded, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.framesOk, stats.framesOk, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expectedErrors, errors, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.skippedBytes, stats.skippedBytes, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, stats.overflows, message);
+    }
+}
+
+void test_replay_throughput() {
+    // Zapisane odpowiedzi (cykl zapytań 0x03, 0x04, 0x08) we fragmentach 1-20 B
+    const uint32_t CYCLES = 20000;
+    std::vector<uint8_t> frames;
+    for (uint32_t i = 0; i < CYCLES; i++) {
+        append(frames, BASIC_INFO, sizeof(BASIC_INFO));
+        append(frames, CELL_INFO, sizeof(CELL_INFO));
+        append(frames, TEMPERATURES, sizeof(TEMPERATURES));
+    }
+    // Ten sam strumień ze śmieciami i fałszywymi startami
+    Random streamRandom(12345);
+    Expected expected;
+    std::vector<uint8_t> noisy = buildStream(streamRandom, 3 * CYCLES, expected, 8);
+
+    struct Case { const char* name; const std::vector<uint8_t>* stream; uint32_t frames; };
+    const Case cases[] = {
+        {"zapisane ramki", &frames, 3 * CYCLES},
+        {"ramki, śmieci i fałszywe starty", &noisy, expected.framesOk},
+    };
+
+    for (const Case& replayCase : cases) {
+        JbdParser parser(500);
+        Random random(7);
+        uint32_t start = micros();
+        uint32_t decoded = replay(parser, *replayCase.stream, random);
+        uint32_t elapsedUs = micros() - start;
+        TEST_ASSERT_EQUAL_UINT32(replayCase.frames, decoded);
+
+        char message[128];
+        double seconds = elapsedUs / 1e6;
+        snprintf(message, sizeof(message), "%s: %u B, %u ramek, %.2f us/ramkę, %.1f MB/s (host)",
+                 replayCase.name, (unsigned)replayCase.stream->size(), (unsigned)decoded,
+                 decoded ? (double)elapsedUs / decoded : 0.0,
+                 seconds > 0 ? replayCase.stream->size() / seconds / 1e6 : 0.0);
+        TEST_MESSAGE(message);
+    }
+}
+
+void test_truncated_frame_times_out() {
+    JbdParser parser(500);
+    BmsData bms = {};
+    uint8_t command = 0;
+
+    // Początek ramki bez reszty (zerwane połączenie)
+    parser.push(BASIC_INFO, 10);
+    TEST_ASSERT_FALSE(parser.poll(bms, command, 1000));
+    TEST_ASSERT_FALSE(parser.poll(bms, command, 1499));
+    TEST_ASSERT_EQUAL_UINT32(0, parser.getStats().timeouts);
+
+    // Po limicie: bajt startu odrzucony, reszta pominięta
+    TEST_ASSERT_FALSE(parser.poll(bms, command, 1500));
+    JbdParserStats stats = parser.getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(9, stats.skippedBytes);
+
+    parser.push(CELL_INFO, sizeof(CELL_INFO));
+    TEST_ASSERT_TRUE(parser.poll(bms, command, 1501));
+    TEST_ASSERT_EQUAL_HEX8(0x04, command);
+}
+
+void test_overflow_is_counted() {
+    JbdParser parser;
+    std::vector<uint8_t> burst(JbdRingBuffer::CAPACITY + 100, 0x00);
+
+    parser.push(burst.data(), burst.size());
+    TEST_ASSERT_EQUAL_UINT32(100, parser.getStats().overflows);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_recorded_frames_decode);
+    RUN_TEST(test_random_fragments_with_garbage);
+    RUN_TEST(test_stray_start_with_plausible_length);
+    RUN_TEST(test_random_stray_starts_in_garbage);
+    RUN_TEST(test_replay_throughput);
+    RUN_TEST(test_truncated_frame_times_out);
+    RUN_TEST(test_overflow_is_counted);
+    return UNITY_END();
+}
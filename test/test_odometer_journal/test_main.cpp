@@ -0,0 +1,124 @@
+// OdometerJournal na emulacji esp_partition symulatora (NOR: zapis tylko
+// zeruje bity, kasowanie sektorami; plik .sim/test_odometer_journal/flash/odometer.bin).
+// Pomiar zużycia flash: 1000 km przy zapisie co 100 m. Wynik ustawienia
+// licznika w OdometerManager (POST /api/setOdometer: 200 / 400 / 500).
+
+#include <Arduino.h>
+#include <SimRuntime.h>
+#include <unity.h>
+#include <cstdio>
+#include "OdometerJournal.h"
+#include "OdometerManager.h"
+
+namespace {
+
+    const char* const LABEL = "odometer";
+    const uint32_t STEP_METERS = 100;                 // SAVE_DISTANCE w OdometerManager
+    const uint32_t BENCH_METERS = 1000000;            // 1000 km
+    const size_t PAYLOAD_BYTES = 2 * sizeof(uint32_t);   // Przebieg i dystans podróży
+
+    const esp_partition_t* findPartition() {
+        return esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, LABEL);
+    }
+
+}
+
+void setUp() {
+    sim::setOutputDir(".sim/test_odometer_journal");
+    std::remove(sim::outputPath("flash/odometer.bin").c_str());   // Nowa (skasowana) partycja
+}
+
+void tearDown() {}
+
+void test_write_amplification_1000_km() {
+    OdometerJournal journal;
+    TEST_ASSERT_TRUE(journal.begin(LABEL));
+    TEST_ASSERT_TRUE(journal.isEmpty());
+
+    uint64_t bytesBefore = sim::counters().flashBytesWritten;
+    uint32_t erasesBefore = sim::counters().flashSectorErases;
+
+    uint32_t saves = 0;
+    for (uint32_t meters = STEP_METERS; meters <= BENCH_METERS; meters += STEP_METERS) {
+        TEST_ASSERT_TRUE(journal.append(meters, meters % 50000));
+        saves++;
+    }
+
+    uint64_t bytes = sim::counters().flashBytesWritten - bytesBefore;
+    uint32_t erases = sim::counters().flashSectorErases - erasesBefore;
+    uint32_t sectors = findPartition()->size / OdometerJournal::SECTOR_SIZE;
+    float amplification = (float)bytes / (saves * PAYLOAD_BYTES);
+
+    char report[128];
+    snprintf(report, sizeof(report), "%u zapisów: %llu B flash (WA %.2f), %u kasowań, %.2f cyklu na sektor",
+             (unsigned)saves, (unsigned long long)bytes, amplification, (unsigned)erases, (float)erases / sectors);
+    TEST_MESSAGE(report);
+
+    // Jeden wpis 16 B na zapis (8 B danych), kasowanie co 256 wpisów
+    TEST_ASSERT_EQUAL_UINT32(10000, saves);
+    TEST_ASSERT_EQUAL_UINT32(saves, journal.getEntriesWritten());
+    TEST_ASSERT_EQUAL_UINT64(saves * sizeof(OdometerEntry), bytes);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f, amplification);
+    TEST_ASSERT_EQUAL_UINT32((saves + OdometerJournal::ENTRIES_PER_SECTOR - 1) / OdometerJournal::ENTRIES_PER_SECTOR, erases);
+    TEST_ASSERT_EQUAL_UINT32(erases, journal.getSectorErases());
+    // Kasowania rozłożone na cały pierścień sektorów: najwyżej 3 cykle na sektor na 1000 km
+    TEST_ASSERT_LESS_OR_EQUAL(3, (erases + sectors - 1) / sectors);
+
+    // Stan odtwarzany z ostatniego wpisu
+    OdometerJournal restored;
+    TEST_ASSERT_TRUE(restored.begin(LABEL));
+    TEST_ASSERT_FALSE(restored.isEmpty());
+    TEST_ASSERT_EQUAL_UINT32(BENCH_METERS, restored.getTotalMeters());
+    TEST_ASSERT_EQUAL_UINT32(BENCH_METERS % 50000, restored.getTripMeters());
+}
+
+void test_torn_entry_is_skipped() {
+    OdometerJournal journal;
+    TEST_ASSERT_TRUE(journal.begin(LABEL));
+    TEST_ASSERT_TRUE(journal.append(1200, 300));
+    TEST_ASSERT_TRUE(journal.append(1300, 400));
+
+    // Zanik zasilania w trakcie zapisu trzeciego wpisu: zapisana tylko połowa
+    OdometerEntry torn = {2, 1400, 500, 0};
+    TEST_ASSERT_EQUAL(ESP_OK, esp_partition_write(findPartition(), 2 * sizeof(OdometerEntry), &torn, 8));
+
+    OdometerJournal restored;
+    TEST_ASSERT_TRUE(restored.begin(LABEL));
+    TEST_ASSERT_EQUAL_UINT32(1300, restored.getTotalMeters());
+    TEST_ASSERT_EQUAL_UINT32(400, restored.getTripMeters());
+
+    // Kolejny wpis za uszkodzonym, po ponownym starcie odczytany poprawnie
+    TEST_ASSERT_TRUE(restored.append(1500, 600));
+    OdometerJournal next;
+    TEST_ASSERT_TRUE(next.begin(LABEL));
+    TEST_ASSERT_EQUAL_UINT32(1500, next.getTotalMeters());
+}
+
+void test_manager_set_total_distance_results() {
+    OdometerManager manager;
+    manager.begin();
+    TEST_ASSERT_TRUE(manager.isJournalReady());
+
+    // Niepoprawne wartości - licznik bez zmiany, to nie jest błąd zapisu
+    TEST_ASSERT_EQUAL_UINT8(ODOMETER_SET_INVALID, manager.setTotalDistance(-1.0f));
+    TEST_ASSERT_EQUAL_UINT8(ODOMETER_SET_INVALID, manager.setTotalDistance(NAN));
+    TEST_ASSERT_EQUAL_UINT8(ODOMETER_SET_INVALID, manager.setTotalDistance(5000000.0f));
+    TEST_ASSERT_EQUAL_UINT32(0, manager.getTotalMeters());
+    TEST_ASSERT_EQUAL_UINT32(0, manager.getSaveErrors());
+
+    TEST_ASSERT_EQUAL_UINT8(ODOMETER_SET_OK, manager.setTotalDistance(1234.5f));
+    TEST_ASSERT_EQUAL_UINT32(1234500, manager.getTotalMeters());
+
+    // Wartość w dzienniku
+    OdometerJournal journal;
+    TEST_ASSERT_TRUE(journal.begin(LABEL));
+    TEST_ASSERT_EQUAL_UINT32(1234500, journal.getTotalMeters());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_write_amplification_1000_km);
+    RUN_TEST(test_torn_entry_is_skipped);
+    RUN_TEST(test_manager_set_total_distance_results);
+    return UNITY_END();
+}
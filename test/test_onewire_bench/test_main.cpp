@@ -0,0 +1,79 @@
+// OneWireBench ("owbench") na symulatorze: opóźnienie przerwania timera
+// sprzętowego (co 100 us) podczas ciągłych odczytów modelu DS18B20.
+// Biblioteka OneWire trzyma przerwania wyłączone w każdym slocie (do 70 us
+// przy impulsie obecności), RMT nie wyłącza ich wcale - opóźnienie to tylko
+// przekazanie wątku przerwania na hoście. Opóźnienia w us zależą od
+// obciążenia hosta, więc są tylko raportowane; sprawdzane są proporcje.
+
+#include <Arduino.h>
+#include <unity.h>
+#include "OneWireBench.h"
+
+namespace {
+
+    const uint8_t BENCH_PIN = 4;
+
+    // Odsetek przerwań opóźnionych o >= 50 us przez RMT co najmniej tyle razy
+    // mniejszy niż bit po bicie (na symulatorze zwykle 0 wobec ~20%)
+    const uint32_t LATE_FRACTION_RATIO = 5;
+
+    RmtOneWire wire(BENCH_PIN, RMT_CHANNEL_0, RMT_CHANNEL_1);
+    uint8_t rom[8];
+
+    void printResult(const char* name, const OneWireBench::Result& result) {
+        char line[160];
+        snprintf(line, sizeof(line), "%s: odczyty %u (błędy %u), przerwania %u, maks. opóźnienie %u us, >=50 us: %u",
+                 name, (unsigned)result.reads, (unsigned)result.readErrors, (unsigned)result.interrupts,
+                 (unsigned)result.maxLatencyUs, (unsigned)result.histogram[OneWireBench::BUCKETS - 1]);
+        TEST_MESSAGE(line);
+    }
+
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_sensor_found() {
+    TEST_ASSERT_TRUE(wire.begin());
+    wire.reset_search();
+    TEST_ASSERT_TRUE(wire.search(rom));
+    TEST_ASSERT_EQUAL_UINT8(rom[7], RmtOneWire::crc8(rom, 7));
+}
+
+void test_missing_sensor_is_reported() {
+    OneWireBench::Result bitBang, rmt;
+    TEST_ASSERT_FALSE(OneWireBench::measure(wire, nullptr, bitBang, rmt));
+}
+
+void test_rmt_keeps_interrupt_latency_low() {
+    OneWireBench::Result bitBang, rmt;
+    TEST_ASSERT_TRUE(OneWireBench::measure(wire, rom, bitBang, rmt));
+    printResult("OneWire (bit po bicie)", bitBang);
+    printResult("RMT", rmt);
+
+    // Obie metody czytają poprawnie (bit po bicie wolniej - uśpienia hosta w slotach)
+    TEST_ASSERT_GREATER_THAN(10, bitBang.reads);
+    TEST_ASSERT_GREATER_THAN(10, rmt.reads);
+    TEST_ASSERT_EQUAL_UINT32(0, bitBang.readErrors);
+    TEST_ASSERT_EQUAL_UINT32(0, rmt.readErrors);
+    TEST_ASSERT_GREATER_THAN(100, bitBang.interrupts);
+    TEST_ASSERT_GREATER_THAN(100, rmt.interrupts);
+
+    // Bit po bicie część przerwań czeka na koniec slotu (>= 50 us), przez RMT
+    // odsetek takich przerwań wyraźnie mniejszy - niezależnie od obciążenia
+    // hosta, które opóźnia obie metody tak samo
+    uint32_t bitBangLate = bitBang.histogram[OneWireBench::BUCKETS - 1];
+    uint32_t rmtLate = rmt.histogram[OneWireBench::BUCKETS - 1];
+    TEST_ASSERT_GREATER_THAN(0, bitBangLate);
+    // rmtLate / rmt.interrupts * RATIO <= bitBangLate / bitBang.interrupts
+    TEST_ASSERT_TRUE((uint64_t)rmtLate * bitBang.interrupts * LATE_FRACTION_RATIO <=
+                     (uint64_t)bitBangLate * rmt.interrupts);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_sensor_found);
+    RUN_TEST(test_missing_sensor_is_reported);
+    RUN_TEST(test_rmt_keeps_interrupt_latency_low);
+    return UNITY_END();
+}
@@ -0,0 +1,188 @@
+// RangeEstimator: Wh/km z energii BMS (36 V, moc stała w odcinku) i dystansu
+// z czujnika koła, próbka i update() co 1 s. 360 W przy 10 m/s = 100 mWh na
+// 10 m = 10 Wh/km. Odcinek zamykany po 200 m, średnia zwykła przez 10 odcinków,
+// potem wykładnicza (alfa 1/10), energia na postoju i przy zmianie poziomu
+// pomijana, ograniczenia MIN/MAX, zapis w pamięci RTC symulatora.
+
+#include <Arduino.h>
+#include <SimRuntime.h>
+#include <unity.h>
+#include "RangeEstimator.h"
+
+namespace {
+
+    const float VOLTAGE = 36.0f;
+
+    // Jazda ze stałą mocą [W] i prędkością [m/s]; próbka BMS i update() co 1 s
+    void ride(RangeEstimator& estimator, uint32_t& nowMs, float powerW, uint32_t metersPerSecond,
+              uint32_t seconds, uint8_t level) {
+        // Próbka z nową mocą w tej samej chwili - bez uśredniania z poprzednim odcinkiem
+        estimator.addPowerSample(VOLTAGE, -powerW / VOLTAGE, nowMs);
+        for (uint32_t i = 0; i < seconds; i++) {
+            nowMs += 1000;
+            estimator.addPowerSample(VOLTAGE, -powerW / VOLTAGE, nowMs);
+            estimator.update(metersPerSecond, level, nowMs);
+        }
+    }
+
+}
+
+void setUp() {
+    sim::setOutputDir(".sim/test_range_estimator");
+    sim::clearRtcMemory();
+}
+
+void tearDown() {}
+
+void test_defaults_before_first_segment() {
+    RangeEstimator estimator;
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, estimator.getWhPerKm(0));
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, estimator.getWhPerKm(1));
+    TEST_ASSERT_EQUAL_FLOAT(16.0f, estimator.getWhPerKm(5));
+    TEST_ASSERT_EQUAL_UINT16(0, estimator.getSegments(1));
+
+    // 480 Wh przy 6 Wh/km; poziom spoza zakresu - jak najwyższy (16 Wh/km)
+    TEST_ASSERT_EQUAL_FLOAT(80.0f, estimator.estimateKm(480.0f, 1));
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, estimator.estimateKm(480.0f, 9));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, estimator.estimateKm(-5.0f, 1));
+}
+
+void test_segment_closes_at_200_m() {
+    RangeEstimator estimator;
+    uint32_t now = 0;
+
+    // 190 m - odcinek otwarty
+    ride(estimator, now, 360.0f, 10, 19, 1);
+    TEST_ASSERT_EQUAL_UINT16(0, estimator.getSegments(1));
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, estimator.getWhPerKm(1));
+
+    // 200 m, 2000 mWh - pierwszy pomiar zastępuje wartość domyślną
+    ride(estimator, now, 360.0f, 10, 1, 1);
+    TEST_ASSERT_EQUAL_UINT16(1, estimator.getSegments(1));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, estimator.getWhPerKm(1));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 48.0f, estimator.estimateKm(480.0f, 1));
+}
+
+void test_warmup_mean_then_ewma() {
+    RangeEstimator estimator;
+    uint32_t now = 0;
+
+    // 10 odcinków na przemian 10 i 20 Wh/km - średnia 15
+    for (uint8_t i = 0; i < RangeEstimator::WARMUP_SEGMENTS; i++) {
+        ride(estimator, now, i % 2 == 0 ? 360.0f : 720.0f, 10, 20, 2);
+    }
+    TEST_ASSERT_EQUAL_UINT16(10, estimator.getSegments(2));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 15.0f, estimator.getWhPerKm(2));
+
+    // Dalej alfa 1/10: 15 + (25 - 15) / 10 = 16, potem 16 + (25 - 16) / 10 = 16,9
+    ride(estimator, now, 900.0f, 10, 20, 2);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 16.0f, estimator.getWhPerKm(2));
+    ride(estimator, now, 900.0f, 10, 20, 2);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 16.9f, estimator.getWhPerKm(2));
+    TEST_ASSERT_EQUAL_UINT16(12, estimator.getSegments(2));
+
+    // Inne poziomy bez zmian
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, estimator.getWhPerKm(1));
+}
+
+void test_standstill_energy_dropped() {
+    RangeEstimator estimator;
+    uint32_t now = 0;
+
+    // 100 m (1000 mWh), 15 s postoju przy 360 W, 100 m (1000 mWh).
+    // Pierwsze 10 s postoju (STANDSTILL_MS) liczone jak krótki przystanek
+    // (1000 mWh), kolejne 5 s (500 mWh) pominięte: 3000 mWh / 200 m
+    ride(estimator, now, 360.0f, 10, 10, 1);
+    ride(estimator, now, 360.0f, 0, 15, 1);
+    TEST_ASSERT_EQUAL_UINT16(0, estimator.getSegments(1));
+    ride(estimator, now, 360.0f, 10, 10, 1);
+    TEST_ASSERT_EQUAL_UINT16(1, estimator.getSegments(1));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 15.0f, estimator.getWhPerKm(1));
+}
+
+void test_level_change_drops_open_segment() {
+    RangeEstimator estimator;
+    uint32_t now = 0;
+
+    // 150 m na poziomie 1 przy 720 W - porzucone przy zmianie na 2
+    ride(estimator, now, 720.0f, 10, 15, 1);
+    ride(estimator, now, 360.0f, 10, 20, 2);
+    TEST_ASSERT_EQUAL_UINT16(0, estimator.getSegments(1));
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, estimator.getWhPerKm(1));
+    TEST_ASSERT_EQUAL_UINT16(1, estimator.getSegments(2));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, estimator.getWhPerKm(2));
+}
+
+void test_min_max_clamping() {
+    RangeEstimator estimator;
+    uint32_t now = 0;
+
+    // Odzysk z górki (ładowanie 360 W) - najmniejsze zużycie 0,5 Wh/km
+    ride(estimator, now, -360.0f, 10, 20, 0);
+    TEST_ASSERT_EQUAL_UINT16(1, estimator.getSegments(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, RangeEstimator::MIN_WH_PER_KM, estimator.getWhPerKm(0));
+
+    // 720 W przy 1 m/s = 200 Wh/km > 100 - błąd danych, odcinek odrzucony
+    ride(estimator, now, 720.0f, 1, 200, 3);
+    TEST_ASSERT_EQUAL_UINT16(0, estimator.getSegments(3));
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, estimator.getWhPerKm(3));
+
+    // Dokładnie 100 Wh/km (360 W przy 1 m/s) - przyjęte
+    ride(estimator, now, 360.0f, 1, 200, 3);
+    TEST_ASSERT_EQUAL_UINT16(1, estimator.getSegments(3));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, RangeEstimator::MAX_WH_PER_KM, estimator.getWhPerKm(3));
+}
+
+void test_sample_gap_not_integrated() {
+    RangeEstimator estimator;
+
+    // Dwie próbki po 720 W w odstępie 6 s (przerwa > MAX_SAMPLE_GAP_MS) - bez
+    // energii (inaczej +1200 mWh i 16 Wh/km), potem 200 m przy 360 W
+    estimator.addPowerSample(VOLTAGE, -20.0f, 0);
+    estimator.addPowerSample(VOLTAGE, -20.0f, 6000);
+    uint32_t now = 6000;
+    ride(estimator, now, 360.0f, 10, 20, 4);
+    TEST_ASSERT_EQUAL_UINT16(1, estimator.getSegments(4));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, estimator.getWhPerKm(4));
+}
+
+void test_rtc_slot_round_trip() {
+    RangeEstimator learned;
+    uint32_t now = 0;
+    ride(learned, now, 360.0f, 10, 20, 1);     // 10 Wh/km
+    ride(learned, now, 900.0f, 10, 20, 5);     // 25 Wh/km
+
+    // Po włączeniu zasilania brak zapisu - wartości domyślne
+    RangeEstimator cold;
+    TEST_ASSERT_FALSE(cold.restore());
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, cold.getWhPerKm(1));
+
+    // Uśpienie i wybudzenie (pamięć RTC przez plik symulatora)
+    learned.store();
+    TEST_ASSERT_TRUE(sim::saveRtcMemory());
+    sim::clearRtcMemory();
+    TEST_ASSERT_TRUE(sim::loadRtcMemory());
+
+    RangeEstimator resumed;
+    TEST_ASSERT_TRUE(resumed.restore());
+    for (uint8_t level = 0; level < RangeEstimator::LEVELS; level++) {
+        TEST_ASSERT_EQUAL_FLOAT(learned.getWhPerKm(level), resumed.getWhPerKm(level));
+        TEST_ASSERT_EQUAL_UINT16(learned.getSegments(level), resumed.getSegments(level));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, resumed.getWhPerKm(1));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 25.0f, resumed.getWhPerKm(5));
+    TEST_ASSERT_EQUAL_UINT16(1, resumed.getSegments(5));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_defaults_before_first_segment);
+    RUN_TEST(test_segment_closes_at_200_m);
+    RUN_TEST(test_warmup_mean_then_ewma);
+    RUN_TEST(test_standstill_energy_dropped);
+    RUN_TEST(test_level_change_drops_open_segment);
+    RUN_TEST(test_min_max_clamping);
+    RUN_TEST(test_sample_gap_not_integrated);
+    RUN_TEST(test_rtc_slot_round_trip);
+    return UNITY_END();
+}
@@ -0,0 +1,146 @@
+// ResumeState w pamięci RTC symulatora (katalog .sim/test_resume_state):
+// stan zapisany przed uśpieniem (sim::saveRtcMemory() jak w esp_deep_sleep_start)
+// odtwarzany po wybudzeniu (sim::loadRtcMemory() jak przy --wakeup ext0);
+// po włączeniu zasilania, po invalidate() i przy uszkodzonym zapisie - brak stanu.
+
+#include <Arduino.h>
+#include <SimRuntime.h>
+#include <unity.h>
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+#include <vector>
+#include "ResumeState.h"
+
+namespace {
+
+    ResumeData sampleState() {
+        ResumeData data;
+        memset(&data, 0, sizeof(data));
+        data.mainScreen = 2;
+        data.subScreen = 1;
+        data.inSubScreen = 1;
+        data.assistLevel = 4;
+        data.lightMode = 2;
+        data.displayBrightness = 135;
+        data.tripMeters = 12345;
+        data.rideMm = 9876543;
+        data.movingMs = 1800000;
+        data.maxSpeed = 41.5f;
+        data.configCrc = 0xCAFEBABE;
+        return data;
+    }
+
+    // Uśpienie i wybudzenie: zapis pamięci RTC, nowy proces (pamięć od zera), odczyt
+    bool sleepAndWake() {
+        if (!sim::saveRtcMemory()) return false;
+        sim::clearRtcMemory();
+        return sim::loadRtcMemory();
+    }
+
+    std::vector<char> readRtcFile() {
+        std::ifstream file(sim::outputPath("rtc_memory.bin"), std::ios::binary);
+        return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    void writeRtcFile(const std::vector<char>& data) {
+        std::ofstream file(sim::outputPath("rtc_memory.bin"), std::ios::binary | std::ios::trunc);
+        file.write(data.data(), data.size());
+    }
+
+}
+
+void setUp() {
+    sim::setOutputDir(".sim/test_resume_state");
+    sim::clearRtcMemory();
+}
+
+void tearDown() {}
+
+void test_power_on_has_no_state() {
+    ResumeData data;
+    TEST_ASSERT_FALSE(ResumeState::restore(data));
+}
+
+void test_state_survives_deep_sleep() {
+    ResumeData stored = sampleState();
+    ResumeState::store(stored);
+    TEST_ASSERT_TRUE(sleepAndWake());
+
+    ResumeData restored;
+    memset(&restored, 0xA5, sizeof(restored));
+    TEST_ASSERT_TRUE(ResumeState::restore(restored));
+    TEST_ASSERT_EQUAL_UINT8(2, restored.mainScreen);
+    TEST_ASSERT_EQUAL_UINT8(1, restored.subScreen);
+    TEST_ASSERT_EQUAL_UINT8(4, restored.assistLevel);
+    TEST_ASSERT_EQUAL_UINT8(2, restored.lightMode);
+    TEST_ASSERT_EQUAL_UINT8(135, restored.displayBrightness);
+    TEST_ASSERT_EQUAL_UINT32(12345, restored.tripMeters);
+    TEST_ASSERT_EQUAL_UINT32(9876543, restored.rideMm);
+    TEST_ASSERT_EQUAL_UINT32(1800000, restored.movingMs);
+    TEST_ASSERT_EQUAL_FLOAT(41.5f, restored.maxSpeed);
+    TEST_ASSERT_EQUAL_HEX32(0xCAFEBABE, restored.configCrc);
+}
+
+void test_cleared_memory_without_wake_has_no_state() {
+    // Zapis przed uśpieniem, ale start bez wybudzenia (odłączone zasilanie)
+    ResumeState::store(sampleState());
+    TEST_ASSERT_TRUE(sim::saveRtcMemory());
+    sim::clearRtcMemory();
+
+    ResumeData data;
+    TEST_ASSERT_FALSE(ResumeState::restore(data));
+}
+
+void test_invalidated_state_not_restored() {
+    ResumeState::store(sampleState());
+    ResumeState::invalidate();
+    TEST_ASSERT_TRUE(sleepAndWake());
+
+    ResumeData data;
+    TEST_ASSERT_FALSE(ResumeState::restore(data));
+}
+
+void test_corrupted_state_rejected() {
+    ResumeState::store(sampleState());
+    TEST_ASSERT_TRUE(sim::saveRtcMemory());
+
+    // Bit w danych za znacznikiem "PMWR" (ekran główny) - CRC się nie zgadza
+    std::vector<char> image = readRtcFile();
+    const char magic[] = { 'P', 'M', 'W', 'R' };
+    std::vector<char>::iterator slot = std::search(image.begin(), image.end(), magic, magic + sizeof(magic));
+    TEST_ASSERT_TRUE(slot != image.end());
+    slot[sizeof(magic)] ^= 0x01;
+    writeRtcFile(image);
+
+    sim::clearRtcMemory();
+    TEST_ASSERT_TRUE(sim::loadRtcMemory());
+    ResumeData data;
+    TEST_ASSERT_FALSE(ResumeState::restore(data));
+}
+
+void test_image_of_other_build_not_loaded() {
+    ResumeState::store(sampleState());
+    TEST_ASSERT_TRUE(sim::saveRtcMemory());
+
+    // Inny rozmiar sekcji (inna kompilacja) - pamięć zostaje pusta
+    std::vector<char> image = readRtcFile();
+    image.push_back(0);
+    writeRtcFile(image);
+
+    sim::clearRtcMemory();
+    TEST_ASSERT_FALSE(sim::loadRtcMemory());
+    ResumeData data;
+    TEST_ASSERT_FALSE(ResumeState::restore(data));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_power_on_has_no_state);
+    RUN_TEST(test_state_survives_deep_sleep);
+    RUN_TEST(test_cleared_memory_without_wake_has_no_state);
+    RUN_TEST(test_invalidated_state_not_restored);
+    RUN_TEST(test_corrupted_state_rejected);
+    RUN_TEST(test_image_of_other_build_not_loaded);
+    return UNITY_END();
+}
@@ -0,0 +1,135 @@
+// RideLogger na LittleFS symulatora (katalog .sim/test_ride_logger):
+// niepełny zapis partii (sim::limitNextFsWrite) nie może zdublować rekordów
+// zapisanych w całości ani zgubić reszty bufora; bez katalogu /rides
+// begin() zwraca false i zapis jest wyłączony.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <SimRuntime.h>
+#include <unity.h>
+#include <vector>
+#include "RideLogger.h"
+
+namespace {
+
+    RideLogger* logger = nullptr;
+
+    void sampleRecords(uint16_t records, unsigned long& now) {
+        TelemetrySnapshot t = {};
+        for (uint16_t i = 0; i < records; i++) {
+            t.speed_kmh = 20.0f + i;
+            logger->sample(t, now);
+            now += RideLogger::SAMPLE_INTERVAL_MS;
+        }
+    }
+
+    // Numery kolejnych rekordów ze wszystkich segmentów (jak GET /api/rides/download)
+    std::vector<uint16_t> downloadSequences() {
+        std::vector<uint16_t> sequences;
+        RideDownload download = logger->beginDownload();
+        uint8_t data[100];    // Nie wielokrotność rekordu - fragmenty jak w odpowiedzi HTTP
+        std::vector<uint8_t> bytes;
+        size_t length;
+        while ((length = logger->read(download, data, sizeof(data))) > 0) {
+            bytes.insert(bytes.end(), data, data + length);
+        }
+        TEST_ASSERT_EQUAL_UINT32(0, bytes.size() % sizeof(RideRecord));
+        for (size_t offset = 0; offset < bytes.size(); offset += sizeof(RideRecord)) {
+            RideRecord record;
+            memcpy(&record, &bytes[offset], sizeof(record));
+            TEST_ASSERT_TRUE(RideLogger::isValid(record));
+            sequences.push_back(record.sequence);
+        }
+        return sequences;
+    }
+
+}
+
+void setUp() {
+    sim::setOutputDir(".sim/test_ride_logger");
+    TEST_ASSERT_TRUE(LittleFS.format());    // Każdy test od pustych segmentów
+    TEST_ASSERT_TRUE(LittleFS.begin(false));
+    logger = new RideLogger();
+    TEST_ASSERT_TRUE(logger->begin(LittleFS));
+    logger->setTime(1700000000, 0);
+}
+
+void tearDown() {
+    delete logger;
+    logger = nullptr;
+}
+
+void test_flush_writes_all_records() {
+    unsigned long now = 0;
+    sampleRecords(10, now);
+    TEST_ASSERT_TRUE(logger->flush());
+
+    RideLoggerStats stats = logger->getStats();
+    TEST_ASSERT_EQUAL_UINT32(10, stats.recordsWritten);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.buffered);
+    TEST_ASSERT_EQUAL_UINT32(10, downloadSequences().size());
+}
+
+void test_short_write_keeps_complete_records_once() {
+    unsigned long now = 0;
+    sampleRecords(10, now);
+
+    // Zapis urwany w środku czwartego rekordu
+    sim::limitNextFsWrite(3 * sizeof(RideRecord) + 10);
+    TEST_ASSERT_FALSE(logger->flush());
+
+    RideLoggerStats stats = logger->getStats();
+    TEST_ASSERT_EQUAL_UINT32(3, stats.recordsWritten);
+    TEST_ASSERT_EQUAL_UINT16(7, stats.buffered);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.lastSegment);
+
+    // Zapis zawodzi, zanim powstanie choć jeden pełny rekord
+    sim::limitNextFsWrite(10);
+    TEST_ASSERT_FALSE(logger->flush());
+    TEST_ASSERT_EQUAL_UINT32(3, logger->getStats().recordsWritten);
+
+    // Reszta w kolejnych segmentach (niepełne rekordy na końcu plików pomijane)
+    TEST_ASSERT_TRUE(logger->flush());
+    stats = logger->getStats();
+    TEST_ASSERT_EQUAL_UINT32(10, stats.recordsWritten);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.buffered);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.lastSegment);
+
+    std::vector<uint16_t> sequences = downloadSequences();
+    TEST_ASSERT_EQUAL_UINT32(10, sequences.size());
+    for (uint16_t i = 0; i < sequences.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT16(i, sequences[i]);
+    }
+}
+
+void test_begin_without_rides_directory() {
+    TEST_ASSERT_TRUE(logger->isReady());
+
+    // Plik w miejscu katalogu /rides - begin() zgłasza błąd, próbki pomijane
+    TEST_ASSERT_TRUE(LittleFS.rmdir("/rides"));
+    File blocker = LittleFS.open("/rides", "w");
+    TEST_ASSERT_TRUE((bool)blocker);
+    blocker.close();
+
+    RideLogger disabled;
+    TEST_ASSERT_FALSE(disabled.begin(LittleFS));
+    TEST_ASSERT_FALSE(disabled.isReady());
+
+    unsigned long now = 0;
+    TelemetrySnapshot t = {};
+    for (uint16_t i = 0; i < RideLogger::FLUSH_RECORDS; i++) {
+        disabled.sample(t, now);
+        now += RideLogger::SAMPLE_INTERVAL_MS;
+    }
+    disabled.flush();
+    TEST_ASSERT_EQUAL_UINT32(0, disabled.getStats().recordsWritten);
+    TEST_ASSERT_EQUAL_UINT16(0, disabled.getStats().buffered);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_flush_writes_all_records);
+    RUN_TEST(test_short_write_keeps_complete_records_once);
+    RUN_TEST(test_begin_without_rides_directory);
+    return UNITY_END();
+}
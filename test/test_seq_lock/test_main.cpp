@@ -0,0 +1,131 @@
+// SeqLock<TelemetrySnapshot> pod obciążeniem: dwóch pisarzy i trzech
+// czytelników na wątkach POSIX (jak zadania na dwóch rdzeniach ESP32).
+// Każdy zapis ustawia wszystkie sprawdzane pola na numer zapisu - czytelnik
+// nie może zobaczyć kopii z polami z różnych zapisów ani niezgodnej wersji.
+// Wątki działają bez oddawania procesora przez ustalony czas: na jednym
+// rdzeniu hosta rozdzielenie odczytu zapisem zdarza się tylko przy
+// wywłaszczeniu w trakcie kopiowania (sprawdzone: bez powtarzania odczytu
+// w SeqLock::read() test wykrywa rozdarte kopie).
+
+#include <Arduino.h>
+#include <unity.h>
+#include <atomic>
+#include <pthread.h>
+#include "Telemetry.h"
+
+namespace {
+
+    const uint32_t RUN_MS = 1500;
+    const int WRITERS = 2;
+    const int READERS = 3;
+
+    Telemetry telemetry;
+    std::atomic<bool> stop{false};
+    std::atomic<int> writersDone{0};
+    std::atomic<uint32_t> writes{0};
+
+    struct ReaderResult {
+        uint32_t reads;
+        uint32_t torn;             // Pola z różnych zapisów
+        uint32_t versionMismatch;  // Numer zapisu w danych różny od wersji
+        uint32_t backwards;        // Wersja mniejsza niż w poprzednim odczycie
+        uint32_t distinctVersions;
+    };
+
+    // Liczba całkowita dokładnie zapisywalna we float
+    float asFloat(int n) {
+        return (float)(n & 0xFFFFF);
+    }
+
+    void* writerThread(void*) {
+        while (!stop) {
+            telemetry.update([](TelemetrySnapshot& d) {
+                // Odczyt-modyfikacja-zapis: zgubiony zapis przy braku serializacji pisarzy
+                int n = d.power_w + 1;
+                float f = asFloat(n);
+                d.power_w = n;
+                d.cadence_rpm = n;
+                d.battery_capacity_percent = n;
+                d.speed_kmh = f;
+                d.distance_km = f;
+                d.temp_motor = f;
+                d.pressure_rear_temp = f;
+                d.bms.voltage = f;
+                d.bms.cycles = (uint16_t)n;
+                for (uint8_t c = 0; c < BMS_MAX_CELLS; c++) d.bms.cellVoltages[c] = f;
+                for (uint8_t t = 0; t < BMS_MAX_NTC; t++) d.bms.temperatures[t] = f;
+            });
+            writes++;
+        }
+        writersDone++;
+        return nullptr;
+    }
+
+    bool consistent(const TelemetrySnapshot& d) {
+        int n = d.power_w;
+        float f = asFloat(n);
+        if (d.cadence_rpm != n || d.battery_capacity_percent != n) return false;
+        if (d.speed_kmh != f || d.distance_km != f || d.temp_motor != f || d.pressure_rear_temp != f) return false;
+        if (d.bms.voltage != f || d.bms.cycles != (uint16_t)n) return false;
+        for (uint8_t c = 0; c < BMS_MAX_CELLS; c++) if (d.bms.cellVoltages[c] != f) return false;
+        for (uint8_t t = 0; t < BMS_MAX_NTC; t++) if (d.bms.temperatures[t] != f) return false;
+        return true;
+    }
+
+    void* readerThread(void* arg) {
+        ReaderResult* result = static_cast<ReaderResult*>(arg);
+        uint32_t lastVersion = 0;
+        while (writersDone < WRITERS) {
+            uint32_t version;
+            TelemetrySnapshot d = telemetry.read(&version);
+            result->reads++;
+            if (!consistent(d)) result->torn++;
+            if ((uint32_t)d.power_w != version) result->versionMismatch++;
+            if (version < lastVersion) result->backwards++;
+            if (version != lastVersion) result->distinctVersions++;
+            lastVersion = version;
+        }
+        return nullptr;
+    }
+
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_readers_never_see_torn_snapshot() {
+    pthread_t writers[WRITERS];
+    pthread_t readers[READERS];
+    ReaderResult results[READERS] = {};
+
+    for (int i = 0; i < READERS; i++) pthread_create(&readers[i], nullptr, readerThread, &results[i]);
+    for (int i = 0; i < WRITERS; i++) pthread_create(&writers[i], nullptr, writerThread, nullptr);
+    delay(RUN_MS);
+    stop = true;
+    for (int i = 0; i < WRITERS; i++) pthread_join(writers[i], nullptr);
+    for (int i = 0; i < READERS; i++) pthread_join(readers[i], nullptr);
+
+    // Żaden zapis nie zginął, wersja = liczba zapisów
+    TelemetrySnapshot last = telemetry.read();
+    TEST_ASSERT_EQUAL_INT(writes, last.power_w);
+    TEST_ASSERT_EQUAL_UINT32(writes, telemetry.version());
+    TEST_ASSERT_TRUE(consistent(last));
+
+    for (int i = 0; i < READERS; i++) {
+        char message[96];
+        snprintf(message, sizeof(message), "czytelnik %d: %u odczytów, %u wersji (zapisów %u)", i,
+                 (unsigned)results[i].reads, (unsigned)results[i].distinctVersions, (unsigned)writes);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, results[i].torn, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, results[i].versionMismatch, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, results[i].backwards, message);
+        // Odczyty przeplatały się z zapisami
+        TEST_ASSERT_GREATER_THAN(1, results[i].distinctVersions);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_readers_never_see_torn_snapshot);
+    return UNITY_END();
+}
@@ -0,0 +1,192 @@
+// SocEstimator: pakiet 10S 10 Ah. Pierwsza ramka BMS ustawia wynik wprost,
+// kolejne ciągną go o BMS_GAIN, między ramkami zliczanie ładunku z ostatniego
+// prądu (-10 A przez 1 s = -0,02778 %), korekta z tablicy OCV dopiero po
+// REST_TIME_MS małego prądu, bez BMS samo napięcie (filtr VOLTAGE_GAIN),
+// odczyt poniżej 2,5 V na celę odrzucony.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string.h>
+#include "SocEstimator.h"
+
+namespace {
+
+    const uint8_t CELLS = 10;
+    const float CAPACITY_AH = 10.0f;
+
+    BmsData bmsFrame(float remainingAh, float currentA, float packVoltage) {
+        BmsData bms;
+        memset(&bms, 0, sizeof(bms));
+        bms.voltage = packVoltage;
+        bms.current = currentA;
+        bms.remainingCapacity = remainingAh;
+        bms.totalCapacity = CAPACITY_AH;
+        bms.soc = (uint8_t)(100.0f * remainingAh / CAPACITY_AH);
+        bms.cellCount = CELLS;
+        return bms;
+    }
+
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_first_bms_frame_sets_soc() {
+    SocEstimator estimator(CELLS, CAPACITY_AH);
+    TEST_ASSERT_EQUAL(SocEstimator::SOURCE_NONE, estimator.getSource());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, estimator.getSoc());
+
+    // 5 z 10 Ah - dokładnie 50 %, bez wygładzania
+    estimator.addBmsSample(bmsFrame(5.0f, -2.0f, 37.0f), 0);
+    TEST_ASSERT_EQUAL(SocEstimator::SOURCE_BMS, estimator.getSource());
+    TEST_ASSERT_TRUE(estimator.isBmsOnline(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, estimator.getSoc());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 5.0f, estimator.getRemainingAh());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 185.0f, estimator.getRemainingWh());
+}
+
+void test_frame_without_capacity_uses_bms_soc() {
+    SocEstimator estimator(CELLS, CAPACITY_AH);
+    BmsData bms = bmsFrame(0.0f, -2.0f, 37.0f);
+    bms.totalCapacity = 0;
+    bms.soc = 73;
+    estimator.addBmsSample(bms, 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 73.0f, estimator.getSoc());
+}
+
+void test_next_bms_frame_pulls_by_gain() {
+    SocEstimator estimator(CELLS, CAPACITY_AH);
+    estimator.addBmsSample(bmsFrame(5.0f, -2.0f, 37.0f), 0);
+
+    // BMS 60 %: 50 + (60 - 50) * 0,1 = 51, potem 51 + 9 * 0,1 = 51,9
+    estimator.addBmsSample(bmsFrame(6.0f, -2.0f, 37.0f), 1000);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 51.0f, estimator.getSoc());
+    estimator.addBmsSample(bmsFrame(6.0f, -2.0f, 37.0f), 2000);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 51.9f, estimator.getSoc());
+}
+
+void test_coulomb_step_per_update() {
+    SocEstimator estimator(CELLS, CAPACITY_AH);
+    estimator.addBmsSample(bmsFrame(5.0f, -10.0f, 37.0f), 0);
+    estimator.update(0);
+
+    // -10 A przez 1000 ms: 10 * 1000 / 3 600 000 / 10 Ah * 100 = 0,02778 %
+    estimator.update(1000);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 49.97222f, estimator.getSoc());
+
+    // Krok 1500 ms > MAX_STEP_MS - bez całkowania
+    estimator.update(2500);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 49.97222f, estimator.getSoc());
+
+    // 500 ms: 0,01389 %
+    estimator.update(3000);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 49.95833f, estimator.getSoc());
+
+    // Do BMS_TIMEOUT_MS od ramki jeszcze całkowane (2 x 1000 ms)
+    estimator.update(4000);
+    estimator.update(5000);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 49.90278f, estimator.getSoc());
+    // BMS bez ramki dłużej - bez całkowania mimo krótkiego kroku
+    estimator.update(5100);
+    TEST_ASSERT_FALSE(estimator.isBmsOnline(5100));
+    estimator.update(5200);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 49.90278f, estimator.getSoc());
+}
+
+void test_ocv_correction_after_rest_time() {
+    SocEstimator estimator(CELLS, CAPACITY_AH);
+
+    // BMS 60 %, napięcie spoczynkowe 3,74 V na celę = 50 % z tablicy OCV
+    uint32_t now = 0;
+    for (; now < SocEstimator::REST_TIME_MS; now += 1000) {
+        estimator.addBmsSample(bmsFrame(6.0f, 0.1f, 37.4f), now);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 60.0f, estimator.getSoc());
+
+    // Po 5 min: korekta BMS (60) i OCV: 60 + (50 - 60) * 0,02 = 59,8
+    estimator.addBmsSample(bmsFrame(6.0f, 0.1f, 37.4f), now);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 59.8f, estimator.getSoc());
+    // 59,8 + 0,2 * 0,1 = 59,82, potem 59,82 - 9,82 * 0,02 = 59,6236
+    now += 1000;
+    estimator.addBmsSample(bmsFrame(6.0f, 0.1f, 37.4f), now);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 59.6236f, estimator.getSoc());
+
+    // Prąd 2 A przerywa spoczynek - kolejne ramki tylko z korektą BMS
+    now += 1000;
+    estimator.addBmsSample(bmsFrame(6.0f, 2.0f, 37.4f), now);
+    for (uint8_t i = 0; i < 10; i++) {
+        now += 1000;
+        estimator.addBmsSample(bmsFrame(6.0f, 0.1f, 37.4f), now);
+    }
+    float expected = 59.6236f;
+    for (uint8_t i = 0; i < 11; i++) expected += (60.0f - expected) * SocEstimator::BMS_GAIN;
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, expected, estimator.getSoc());
+}
+
+void test_voltage_only_fallback() {
+    SocEstimator estimator(CELLS, CAPACITY_AH);
+
+    // 24 V = 2,4 V na celę - brak dzielnika, odczyt odrzucony
+    estimator.addVoltageSample(24.0f, 0);
+    TEST_ASSERT_EQUAL(SocEstimator::SOURCE_NONE, estimator.getSource());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, estimator.getSoc());
+
+    // Pierwszy odczyt wprost: 37,4 V = 3,74 V na celę = 50 %
+    estimator.addVoltageSample(37.4f, 100);
+    TEST_ASSERT_EQUAL(SocEstimator::SOURCE_VOLTAGE, estimator.getSource());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, estimator.getSoc());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 37.4f, estimator.getVoltage());
+
+    // 38 V: filtr 37,4 + 0,6 * 0,01 = 37,406 V (50,1 %), wynik 50 + 0,1 * 0,01
+    estimator.addVoltageSample(38.0f, 200);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 37.406f, estimator.getVoltage());
+    TEST_ASSERT_FLOAT_WITHIN(0.0002f, 50.001f, estimator.getSoc());
+
+    // Samo napięcie - bez zliczania ładunku
+    estimator.update(300);
+    TEST_ASSERT_FLOAT_WITHIN(0.0002f, 50.001f, estimator.getSoc());
+}
+
+void test_voltage_ignored_while_bms_online() {
+    SocEstimator estimator(CELLS, CAPACITY_AH);
+    estimator.addBmsSample(bmsFrame(6.0f, -3.0f, 37.4f), 0);
+
+    estimator.addVoltageSample(40.0f, 3000);
+    TEST_ASSERT_EQUAL(SocEstimator::SOURCE_BMS, estimator.getSource());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 60.0f, estimator.getSoc());
+
+    // Utrata BMS: płynne przejście 60 -> 50 (OCV) o VOLTAGE_GAIN, prąd zerowany
+    estimator.addVoltageSample(37.4f, 5001);
+    TEST_ASSERT_EQUAL(SocEstimator::SOURCE_VOLTAGE, estimator.getSource());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 59.9f, estimator.getSoc());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, estimator.getCurrent());
+
+    // Powrót BMS - ramka znów ustawia wynik wprost
+    estimator.addBmsSample(bmsFrame(7.0f, -3.0f, 37.4f), 6000);
+    TEST_ASSERT_EQUAL(SocEstimator::SOURCE_BMS, estimator.getSource());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 70.0f, estimator.getSoc());
+}
+
+void test_soc_from_cell_voltage_interpolation() {
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, SocEstimator::socFromCellVoltage(2.8f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, SocEstimator::socFromCellVoltage(3.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.5f, SocEstimator::socFromCellVoltage(3.15f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 45.0f, SocEstimator::socFromCellVoltage(3.71f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, SocEstimator::socFromCellVoltage(3.74f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 95.0f, SocEstimator::socFromCellVoltage(4.13f));
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, SocEstimator::socFromCellVoltage(4.2f));
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, SocEstimator::socFromCellVoltage(4.35f));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_bms_frame_sets_soc);
+    RUN_TEST(test_frame_without_capacity_uses_bms_soc);
+    RUN_TEST(test_next_bms_frame_pulls_by_gain);
+    RUN_TEST(test_coulomb_step_per_update);
+    RUN_TEST(test_ocv_correction_after_rest_time);
+    RUN_TEST(test_voltage_only_fallback);
+    RUN_TEST(test_voltage_ignored_while_bms_online);
+    RUN_TEST(test_soc_from_cell_voltage_interpolation);
+    return UNITY_END();
+}
@@ -0,0 +1,152 @@
+// TaskScheduler na FreeRTOS symulatora (zadania to wątki POSIX, tick 1 ms):
+// okres, opóźnienie startu, przekroczenia okresu, wybudzenie przez notify().
+// Zadania działają do końca procesu - każdy test ma własny harmonogram,
+// a po teście krok zadania tylko czeka.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <atomic>
+#include "TaskScheduler.h"
+
+namespace {
+
+    struct Probe {
+        std::atomic<uint32_t> runs{0};
+        std::atomic<uint32_t> workMs{0};        // Czas wykonania kroku
+        std::atomic<uint32_t> lastRunMs{0};
+        std::atomic<bool> parked{false};
+    };
+
+    Probe probes[3];
+
+    template<int N>
+    void probeStep() {
+        Probe& probe = probes[N];
+        if (probe.parked) {
+            vTaskDelay(pdMS_TO_TICKS(60000));
+            return;
+        }
+        probe.runs++;
+        probe.lastRunMs = millis();
+        if (probe.workMs > 0) delay(probe.workMs);
+    }
+
+    void idleStep() {}
+
+    TaskConfig config(const char* name, void (*step)(), uint32_t periodMs) {
+        TaskConfig task = {name, step, periodMs, 2, 1, 4096};
+        return task;
+    }
+
+    // Czekanie na warunek z limitem [ms]
+    template<typename Predicate>
+    bool waitUntil(Predicate ready, uint32_t timeoutMs) {
+        uint32_t start = millis();
+        while (!ready()) {
+            if (millis() - start > timeoutMs) return false;
+            delay(1);
+        }
+        return true;
+    }
+
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_add_task_rejects_invalid_config() {
+    TaskScheduler scheduler;
+
+    TEST_ASSERT_EQUAL_INT(-1, scheduler.addTask(config("null", nullptr, 10)));
+    TEST_ASSERT_EQUAL_INT(-1, scheduler.addTask(config("zero", idleStep, 0)));
+
+    // Najwyżej 8 zadań
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_INT(i, scheduler.addTask(config("idle", idleStep, 10)));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, scheduler.addTask(config("ninth", idleStep, 10)));
+    TEST_ASSERT_EQUAL_UINT8(8, scheduler.getTaskCount());
+    TEST_ASSERT_EQUAL_STRING("idle", scheduler.getTaskName(0));
+    TEST_ASSERT_EQUAL_STRING("", scheduler.getTaskName(8));
+}
+
+void test_period_is_kept() {
+    static TaskScheduler scheduler;
+    Probe& probe = probes[0];
+
+    TEST_ASSERT_EQUAL_INT(0, scheduler.addTask(config("periodic", probeStep<0>, 50)));
+    TEST_ASSERT_TRUE(scheduler.begin());
+    TEST_ASSERT_FALSE(scheduler.begin());
+    TEST_ASSERT_EQUAL_INT(-1, scheduler.addTask(config("late", idleStep, 50)));
+
+    delay(2000);
+    TaskStats stats = scheduler.getStats(0);
+    probe.parked = true;
+
+    // 2 s / 50 ms = 40 wywołań (plus pierwsze od razu po starcie) - terminy
+    // liczone od poprzedniego terminu, więc spóźnienia się nie sumują
+    TEST_ASSERT_UINT32_WITHIN(2, 41, stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.wakeups);
+    // Wątki hosta budzą się z opóźnieniem do kilkunastu ms - granica pół okresu
+    TEST_ASSERT_LESS_OR_EQUAL(25000, stats.maxLatenessUs);
+}
+
+void test_overrun_resynchronizes_instead_of_bursting() {
+    static TaskScheduler scheduler;
+    Probe& probe = probes[1];
+    probe.workMs = 25;   // Dłużej niż okres 10 ms
+
+    TEST_ASSERT_EQUAL_INT(0, scheduler.addTask(config("overrun", probeStep<1>, 10)));
+    TEST_ASSERT_TRUE(scheduler.begin());
+
+    delay(1000);
+    TaskStats stats = scheduler.getStats(0);
+    probe.parked = true;
+
+    // Każde wywołanie przekracza okres; termin liczony od nowa, więc opóźnienie
+    // nie narasta (bez nadrabiania zaległych wywołań byłoby ~600 ms)
+    TEST_ASSERT_UINT32_WITHIN(5, 40, stats.runs);
+    TEST_ASSERT_GREATER_OR_EQUAL(stats.runs - 3, stats.overruns);
+    TEST_ASSERT_LESS_OR_EQUAL(40000, stats.maxLatenessUs);
+    TEST_ASSERT_GREATER_OR_EQUAL(20000, stats.maxRunUs);
+}
+
+void test_notify_wakes_task_early() {
+    static TaskScheduler scheduler;
+    Probe& probe = probes[2];
+
+    int8_t id = scheduler.addTask(config("notified", probeStep<2>, 1000));
+    TEST_ASSERT_EQUAL_INT(0, id);
+    TEST_ASSERT_TRUE(scheduler.begin());
+    TEST_ASSERT_TRUE(waitUntil([&probe]() { return probe.runs == 1; }, 100));
+
+    for (uint32_t i = 0; i < 5; i++) {
+        delay(30);
+        uint32_t runsBefore = probe.runs;
+        uint32_t notifiedMs = millis();
+        scheduler.notify(id);
+        TEST_ASSERT_TRUE(waitUntil([&probe, runsBefore]() { return probe.runs > runsBefore; }, 50));
+        // Okres 1 s - wywołanie po kilku ms to wybudzenie, nie termin
+        TEST_ASSERT_LESS_OR_EQUAL(20, probe.lastRunMs - notifiedMs);
+    }
+
+    TaskStats stats = scheduler.getStats(0);
+    probe.parked = true;
+    TEST_ASSERT_EQUAL_UINT32(6, stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.wakeups);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.overruns);
+
+    // Nieprawidłowy identyfikator - bez skutku
+    scheduler.notify(-1);
+    scheduler.notify(3);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_add_task_rejects_invalid_config);
+    RUN_TEST(test_period_is_kept);
+    RUN_TEST(test_overrun_resynchronizes_instead_of_bursting);
+    RUN_TEST(test_notify_wakes_task_early);
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+// TemperatureEngine na modelu DS18B20 symulatora (RMT, pin 4), czas symulacji
+// przyspieszony SPEED razy. Temperatura modelu ustawiana przez
+// sim::setOneWireTemperature(): stała, narastanie 0,5 °C/s (10 bitów po
+// RESOLUTION_HOLD_MS, żądania co 250 ms) i odczyt migający na granicy
+// kwantyzacji 10 bitów (31,75 / 32,00 °C) - zmiana o 1 LSB pomijana, powrót
+// do 12 bitów po dwóch okresach histerezy.
+
+#include <Arduino.h>
+#include <SimRuntime.h>
+#include <unity.h>
+#include "TemperatureEngine.h"
+
+namespace {
+
+    const uint8_t SENSOR_PIN = 4;
+    const double SPEED = 100.0;
+    const uint32_t STEP_MS = 5;
+
+    // Surowo 511 i 512 (1/16 °C): przy 10 bitach 508 i 512 - 31,75 i 32,00 °C
+    const float FLICKER_LOW_C = 31.9375f;
+    const float FLICKER_HIGH_C = 32.0f;
+    const float RAMP_C_PER_S = 0.5f;
+
+    RmtOneWire wire(SENSOR_PIN, RMT_CHANNEL_0, RMT_CHANNEL_1);
+    Ds18b20Bus bus(&wire);
+
+    enum Profile { STEADY, RAMP, FLICKER };
+
+    // update() co STEP_MS czasu symulacji przez durationMs; temperatura modelu
+    // z profilu (narastanie od rampStartMs, miganie co odczyt)
+    void run(TemperatureEngine& engine, Profile profile, uint32_t durationMs, uint32_t rampStartMs = 0) {
+        uint32_t start = millis();
+        while (millis() - start < durationMs) {
+            uint32_t now = millis();
+            float celsius = 25.0f;
+            if (profile == RAMP) {
+                celsius = RAMP_C_PER_S * (now - rampStartMs) / 1000.0f;
+            } else if (profile == FLICKER) {
+                celsius = engine.getSensor(0).reads % 2 == 0 ? FLICKER_LOW_C : FLICKER_HIGH_C;
+            }
+            sim::setOneWireTemperature(SENSOR_PIN, celsius);
+            engine.update(now);
+            delay(STEP_MS);
+        }
+    }
+
+    void printSensor(const char* name, const TemperatureEngine::Sensor& sensor, uint32_t intervalMs) {
+        char line[160];
+        snprintf(line, sizeof(line), "%s: %.4f °C, %u bit, %.3f °C/s, odczyty %u, błędy %u, żądania co %u ms",
+                 name, sensor.value, sensor.resolution, sensor.rate, (unsigned)sensor.reads,
+                 (unsigned)sensor.errors, (unsigned)intervalMs);
+        TEST_MESSAGE(line);
+    }
+
+}
+
+void setUp() {
+    sim::setSpeed(SPEED);
+}
+
+void tearDown() {
+    sim::setOneWireTemperature(SENSOR_PIN, NAN);
+}
+
+void test_steady_temperature_keeps_12_bits() {
+    TemperatureEngine engine;
+    TEST_ASSERT_EQUAL_UINT8(0, engine.addChannel(&bus));
+    engine.begin(millis());
+    TEST_ASSERT_TRUE(engine.getSensor(0).present);
+
+    run(engine, STEADY, TemperatureEngine::RESOLUTION_HOLD_MS + 10000);
+    const TemperatureEngine::Sensor& sensor = engine.getSensor(0);
+    printSensor("stała 25 °C", sensor, engine.getRequestIntervalMs());
+
+    TEST_ASSERT_EQUAL_UINT8(12, sensor.resolution);
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, sensor.value);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, sensor.rate);
+    TEST_ASSERT_EQUAL_UINT32(0, sensor.errors);
+    TEST_ASSERT_EQUAL_UINT32(1000, engine.getRequestIntervalMs());
+    // Żądania co 1 s - najwyżej 70 odczytów w 70 s
+    TEST_ASSERT_LESS_OR_EQUAL(70, sensor.reads);
+}
+
+void test_fast_change_drops_to_10_bits() {
+    TemperatureEngine engine;
+    engine.addChannel(&bus);
+    uint32_t start = millis();
+    engine.begin(start);
+
+    // 0,5 °C/s przez okres histerezy - tempo z okna 5 s, potem 10 bitów
+    run(engine, RAMP, TemperatureEngine::RESOLUTION_HOLD_MS + 2000, start);
+    const TemperatureEngine::Sensor& sensor = engine.getSensor(0);
+    printSensor("narastanie 0,5 °C/s", sensor, engine.getRequestIntervalMs());
+    TEST_ASSERT_EQUAL_UINT8(10, sensor.resolution);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, RAMP_C_PER_S, sensor.rate);
+    TEST_ASSERT_EQUAL_UINT32(250, engine.getRequestIntervalMs());
+
+    // Przy 10 bitach żądania co 250 ms - w 10 s ponad dwa razy więcej odczytów niż przy 1 s
+    uint32_t reads = sensor.reads;
+    run(engine, RAMP, 10000, start);
+    printSensor("10 s przy 10 bitach", sensor, engine.getRequestIntervalMs());
+    TEST_ASSERT_GREATER_THAN(20, sensor.reads - reads);
+    TEST_ASSERT_EQUAL_UINT32(0, sensor.errors);
+}
+
+void test_quantization_flicker_returns_to_12_bits() {
+    TemperatureEngine engine;
+    engine.addChannel(&bus);
+    uint32_t start = millis();
+    engine.begin(start);
+
+    // Narastanie do 32 °C (64 s) - 10 bitów
+    run(engine, RAMP, 64000, start);
+    const TemperatureEngine::Sensor& sensor = engine.getSensor(0);
+    TEST_ASSERT_EQUAL_UINT8(10, sensor.resolution);
+
+    // Odczyt na zmianę 31,75 i 32,00 °C (1 LSB przy 10 bitach): wcześniej
+    // 0,25 °C w 1 s między odczytami dawało tempo ponad FAST_RATE_C_PER_S
+    run(engine, FLICKER, 2 * TemperatureEngine::RATE_WINDOW_MS + 1000);
+    printSensor("miganie przy 10 bitach", sensor, engine.getRequestIntervalMs());
+    TEST_ASSERT_EQUAL_UINT8(10, sensor.resolution);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, sensor.rate);
+    TEST_ASSERT_TRUE(sensor.value == 31.75f || sensor.value == 32.0f);
+
+    // Po każdym okresie histerezy bit w górę (przy 11 bitach miganie to też 1 LSB)
+    run(engine, FLICKER, 2 * TemperatureEngine::RESOLUTION_HOLD_MS);
+    printSensor("miganie po 2 min", sensor, engine.getRequestIntervalMs());
+    TEST_ASSERT_EQUAL_UINT8(12, sensor.resolution);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, sensor.rate);
+    TEST_ASSERT_EQUAL_UINT32(1000, engine.getRequestIntervalMs());
+    TEST_ASSERT_EQUAL_UINT32(0, sensor.errors);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_temperature_keeps_12_bits);
+    RUN_TEST(test_fast_change_drops_to_10_bits);
+    RUN_TEST(test_quantization_flicker_returns_to_12_bits);
+    return UNITY_END();
+}
@@ -0,0 +1,170 @@
+// TpmsDecoder: zapisane rozgłoszenia czujników (sim/scenarios/tpms.txt)
+// z oczekiwanym ciśnieniem, temperaturą i baterią; ramki obcych producentów,
+// obcięte i z wartościami poza zakresem muszą być odrzucone bez zmiany odczytu.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string.h>
+#include "TpmsDecoder.h"
+
+namespace {
+
+    // Przód (0x80): 28131 Pa, 27,90 °C, bateria 91%
+    const uint8_t FRONT[] = {
+        0x00, 0x01, 0x80, 0xEA, 0xCA, 0x10, 0x8A, 0x78, 0xE3, 0x6D, 0x00, 0x00, 0xE6, 0x0A, 0x00, 0x00,
+        0x5B, 0x00
+    };
+    // Tył (0x81): 350000 Pa, 21,00 °C, bateria 88%
+    const uint8_t REAR[] = {
+        0x00, 0x01, 0x81, 0xEA, 0xCA, 0x20, 0x8C, 0x11, 0x30, 0x57, 0x05, 0x00, 0x34, 0x08, 0x00, 0x00,
+        0x58, 0x00
+    };
+    // Przód po napompowaniu: 100000 Pa
+    const uint8_t FRONT_INFLATED[] = {
+        0x00, 0x01, 0x80, 0xEA, 0xCA, 0x10, 0x8A, 0x78, 0xA0, 0x86, 0x01, 0x00, 0xE6, 0x0A, 0x00, 0x00,
+        0x5B, 0x00
+    };
+    // iBeacon (Apple 0x004C) z rozgłoszeń w otoczeniu
+    const uint8_t IBEACON[] = { 0x4C, 0x00, 0x02, 0x15, 0xAA, 0xBB, 0xCC, 0xDD };
+
+    // Odczyt z wartościami, których dekoder nigdy nie ustawia
+    TpmsReading untouched() {
+        TpmsReading reading;
+        memset(&reading, 0xA5, sizeof(reading));
+        return reading;
+    }
+
+    void assertUntouched(const TpmsReading& reading) {
+        TpmsReading expected = untouched();
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &reading, sizeof(reading));
+    }
+
+    void assertRejected(const uint8_t* data, size_t length) {
+        TpmsReading reading = untouched();
+        TEST_ASSERT_FALSE(decodeTpmsAdvertisement(data, length, reading));
+        assertUntouched(reading);
+    }
+
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_recorded_front_sensor() {
+    TpmsReading reading = untouched();
+    TEST_ASSERT_TRUE(decodeTpmsAdvertisement(FRONT, sizeof(FRONT), reading));
+    TEST_ASSERT_EQUAL_UINT8(TPMS_FORMAT_0001, reading.format);
+    TEST_ASSERT_EQUAL_UINT8(0, reading.position);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.28131f, reading.pressureBar);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 27.9f, reading.temperatureC);
+    TEST_ASSERT_EQUAL_UINT8(91, reading.batteryPercent);
+    TEST_ASSERT_FALSE(reading.alarm);
+}
+
+void test_recorded_rear_sensor() {
+    TpmsReading reading = untouched();
+    TEST_ASSERT_TRUE(decodeTpmsAdvertisement(REAR, sizeof(REAR), reading));
+    TEST_ASSERT_EQUAL_UINT8(TPMS_FORMAT_0001, reading.format);
+    TEST_ASSERT_EQUAL_UINT8(1, reading.position);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 3.5f, reading.pressureBar);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 21.0f, reading.temperatureC);
+    TEST_ASSERT_EQUAL_UINT8(88, reading.batteryPercent);
+    TEST_ASSERT_FALSE(reading.alarm);
+}
+
+void test_recorded_front_after_inflation() {
+    TpmsReading reading = untouched();
+    TEST_ASSERT_TRUE(decodeTpmsAdvertisement(FRONT_INFLATED, sizeof(FRONT_INFLATED), reading));
+    TEST_ASSERT_EQUAL_UINT8(0, reading.position);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, reading.pressureBar);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 27.9f, reading.temperatureC);
+}
+
+void test_alarm_and_negative_temperature() {
+    uint8_t frame[sizeof(FRONT)];
+    memcpy(frame, FRONT, sizeof(frame));
+    // -12,50 °C = -1250 (int32 LE), alarm zgłoszony przez czujnik
+    frame[12] = 0x1E;
+    frame[13] = 0xFB;
+    frame[14] = 0xFF;
+    frame[15] = 0xFF;
+    frame[17] = 0x01;
+
+    TpmsReading reading = untouched();
+    TEST_ASSERT_TRUE(decodeTpmsAdvertisement(frame, sizeof(frame), reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -12.5f, reading.temperatureC);
+    TEST_ASSERT_TRUE(reading.alarm);
+}
+
+void test_foreign_frames_rejected() {
+    assertRejected(IBEACON, sizeof(IBEACON));
+    assertRejected(nullptr, sizeof(FRONT));
+
+    uint8_t frame[sizeof(FRONT)];
+    // Inny identyfikator producenta (0x0100 - odwrócona kolejność bajtów)
+    memcpy(frame, FRONT, sizeof(frame));
+    frame[0] = 0x01;
+    frame[1] = 0x00;
+    assertRejected(frame, sizeof(frame));
+
+    // 0x0001 bez numeru czujnika w adresie
+    memcpy(frame, FRONT, sizeof(frame));
+    frame[2] = 0x40;
+    assertRejected(frame, sizeof(frame));
+}
+
+void test_truncated_and_extended_frames_rejected() {
+    // Każdy początek zapisanej ramki (rozgłoszenie obcięte przy odbiorze)
+    for (size_t length = 0; length < sizeof(FRONT); length++) {
+        assertRejected(FRONT, length);
+    }
+
+    // Dłuższe dane producenta - inny format
+    uint8_t extended[sizeof(REAR) + 1];
+    memcpy(extended, REAR, sizeof(REAR));
+    extended[sizeof(REAR)] = 0x00;
+    assertRejected(extended, sizeof(extended));
+}
+
+void test_out_of_range_values_rejected() {
+    uint8_t frame[sizeof(FRONT)];
+
+    // 1000001 Pa - ponad 10 bar
+    memcpy(frame, FRONT, sizeof(frame));
+    frame[8] = 0x41;
+    frame[9] = 0x42;
+    frame[10] = 0x0F;
+    frame[11] = 0x00;
+    assertRejected(frame, sizeof(frame));
+
+    // 125,01 °C
+    memcpy(frame, FRONT, sizeof(frame));
+    frame[12] = 0xD5;
+    frame[13] = 0x30;
+    assertRejected(frame, sizeof(frame));
+
+    // -40,01 °C
+    memcpy(frame, FRONT, sizeof(frame));
+    frame[12] = 0x5F;
+    frame[13] = 0xF0;
+    frame[14] = 0xFF;
+    frame[15] = 0xFF;
+    assertRejected(frame, sizeof(frame));
+
+    // Bateria 101%
+    memcpy(frame, FRONT, sizeof(frame));
+    frame[16] = 101;
+    assertRejected(frame, sizeof(frame));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_recorded_front_sensor);
+    RUN_TEST(test_recorded_rear_sensor);
+    RUN_TEST(test_recorded_front_after_inflation);
+    RUN_TEST(test_alarm_and_negative_temperature);
+    RUN_TEST(test_foreign_frames_rejected);
+    RUN_TEST(test_truncated_and_extended_frames_rejected);
+    RUN_TEST(test_out_of_range_values_rejected);
+    return UNITY_END();
+}
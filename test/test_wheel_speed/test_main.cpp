@@ -0,0 +1,130 @@
+// WheelSpeedSensor z impulsami symulatora (sim::startPulses, jak polecenie
+// "pulses" w scenariuszu): prędkość przy zadanych okresach obrotu koła,
+// odrzucanie drgań styku, postój i dystans dla licznika.
+// Impulsy w czasie rzeczywistym hosta - prędkość z jednego okresu, więc
+// tolerancja to przesunięcie impulsu o HOST_JITTER_MS przez planistę hosta.
+
+#include <Arduino.h>
+#include <SimRuntime.h>
+#include <unity.h>
+#include "WheelSpeedSensor.h"
+
+namespace {
+
+    const uint8_t PIN = 27;
+    const uint16_t CIRCUMFERENCE_MM = 2075;      // 26" (domyślny obwód)
+    const float HOST_JITTER_MS = 10.0f;
+
+    WheelSpeedSensor sensor;
+
+    // Prędkość oczekiwana: obwód [mm] * 3,6 / okres [ms]
+    float expectedSpeed(float periodMs) {
+        return CIRCUMFERENCE_MM * 3.6f / periodMs;
+    }
+
+    // Prędkość dla okresu dłuższego lub krótszego o HOST_JITTER_MS
+    void assertSpeedForPeriod(float periodMs, float speed, const char* message) {
+        float fastest = expectedSpeed(periodMs - HOST_JITTER_MS);
+        float slowest = expectedSpeed(periodMs + HOST_JITTER_MS);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE((fastest - slowest) / 2, (fastest + slowest) / 2, speed, message);
+    }
+
+    float speedAfter(double periodMs, uint32_t waitMs) {
+        sim::startPulses(PIN, periodMs, 0);
+        delay(waitMs);
+        sensor.update(millis());
+        return sensor.getSpeed();
+    }
+
+    void stopPulses() {
+        sim::startPulses(PIN, 0, 0);
+    }
+
+}
+
+void setUp() {}
+void tearDown() {
+    stopPulses();
+}
+
+void test_circumference_for_wheel_size() {
+    TEST_ASSERT_EQUAL_UINT16(2136, WheelSpeedSensor::circumferenceForWheelSize(0));   // 700C
+    TEST_ASSERT_EQUAL_UINT16(2075, WheelSpeedSensor::circumferenceForWheelSize(26));
+    TEST_ASSERT_EQUAL_UINT16(2234, WheelSpeedSensor::circumferenceForWheelSize(28));
+}
+
+void test_speed_at_pulse_periods() {
+    const float periods[] = {500.0f, 250.0f, 150.0f, 100.0f};   // 14,9 / 29,9 / 49,8 / 74,7 km/h
+
+    for (float period : periods) {
+        float speed = speedAfter(period, (uint32_t)(period * 4 + 20));
+        char message[48];
+        snprintf(message, sizeof(message), "okres %.0f ms: %.2f km/h", period, speed);
+        TEST_MESSAGE(message);
+        assertSpeedForPeriod(period, speed, message);
+    }
+    assertSpeedForPeriod(100.0f, sensor.getMaxSpeed(), "maksimum");
+}
+
+void test_bounce_faster_than_max_speed_is_ignored() {
+    // Impulsy co 40 ms (187 km/h) - co drugi krótszy niż okres przy 100 km/h (74,7 ms)
+    float speed = speedAfter(40.0, 400);
+    TEST_ASSERT_LESS_OR_EQUAL(WheelSpeedSensor::MAX_SPEED_KMH, (int)speed);
+    assertSpeedForPeriod(80.0f, speed, "drgania");
+}
+
+void test_standstill_after_timeout() {
+    // Trzy impulsy co 250 ms (0, 250, 500 ms), potem koło stoi
+    sim::startPulses(PIN, 250.0, 3);
+    delay(600);
+    sensor.update(millis());
+    assertSpeedForPeriod(250.0f, sensor.getSpeed(), "przed postojem");
+
+    // Bez impulsu prędkość maleje (obwód / czas od impulsu), po 4 s - postój
+    delay(900);
+    sensor.update(millis());
+    assertSpeedForPeriod(1000.0f, sensor.getSpeed(), "1 s bez impulsu");
+
+    delay(WheelSpeedSensor::STANDSTILL_TIMEOUT_MS);
+    sensor.update(millis());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, sensor.getSpeed());
+
+    // Pierwszy impuls po postoju - okres nieznany, prędkość od drugiego
+    sim::startPulses(PIN, 250.0, 1);
+    delay(20);
+    sensor.update(millis());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, sensor.getSpeed());
+}
+
+void test_distance_for_odometer() {
+    // Osobny czujnik - bez reszty dystansu z poprzednich testów
+    const uint8_t ODOMETER_PIN = 26;
+    static WheelSpeedSensor wheel;
+    wheel.begin(ODOMETER_PIN, CIRCUMFERENCE_MM);
+
+    // 20 obrotów koła = 41,5 m
+    sim::startPulses(ODOMETER_PIN, 100.0, 20);
+    delay(2200);
+    wheel.update(millis());
+    TEST_ASSERT_EQUAL_UINT32(20, wheel.getPulseCount());
+    TEST_ASSERT_EQUAL_UINT32(41, wheel.takeMeters());
+    TEST_ASSERT_EQUAL_UINT32(0, wheel.takeMeters());   // Reszta 0,5 m czeka na kolejne impulsy
+
+    // Jeszcze jeden obrót: 0,5 + 2,075 m
+    sim::startPulses(ODOMETER_PIN, 100.0, 1);
+    delay(150);
+    wheel.update(millis());
+    TEST_ASSERT_EQUAL_UINT32(2, wheel.takeMeters());
+}
+
+int main() {
+    sensor.begin(PIN, CIRCUMFERENCE_MM);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_circumference_for_wheel_size);
+    RUN_TEST(test_speed_at_pulse_periods);
+    RUN_TEST(test_bounce_faster_than_max_speed_is_ignored);
+    RUN_TEST(test_standstill_after_timeout);
+    RUN_TEST(test_distance_for_odometer);
+    return UNITY_END();
+}
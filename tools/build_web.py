@@ -0,0 +1,288 @@
+# Budowanie plików interfejsu webowego: web/ -> data/www/
+#
+# - minifikacja (komentarze i wcięcia) HTML, CSS i JS
+# - kompresja gzip (bez daty w nagłówku - ten sam wynik przy każdym budowaniu)
+# - skrót treści w nazwach CSS/JS (style.<skrót>.css), odnośniki w index.html podmieniane
+# - manifest /www/manifest.txt dla WebAssets (uri, plik, ETag, max-age, typ)
+#
+# Uruchamiany przez PlatformIO przed budowaniem (extra_scripts) lub ręcznie:
+#   python tools/build_web.py
+
+import gzip
+import hashlib
+import io
+import os
+import re
+import shutil
+
+try:
+    Import("env")  # noqa: F821 - skrypt PlatformIO
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE_DIR = os.path.join(PROJECT_DIR, "web")
+OUTPUT_DIR = os.path.join(PROJECT_DIR, "data", "www")
+
+# Pliki z nazwą zawierającą skrót treści nie zmieniają się - przeglądarka trzyma je rok
+IMMUTABLE_MAX_AGE = 31536000
+
+# Plik źródłowy -> typ MIME
+ASSETS = [
+    ("style.css", "text/css"),
+    ("scripts.js", "application/javascript"),
+]
+INDEX = ("index.html", "text/html")
+
+
+# --- Minifikacja ---
+
+# Znaki, przy których odstęp w JS nie jest potrzebny (bez + - / . ze względu na ++, --, wyrażenia regularne i 1 .x)
+JS_PUNCTUATION = set("{}()[];,:=<>*%&|!?~^")
+# Po tych znakach nowa linia nie kończy instrukcji (bez ) ] } - kod bywa bez średników)
+JS_CONTINUES_AFTER = set("{([,;:=&|?")
+JS_CONTINUES_BEFORE = set("}])")
+# Po tych znakach / rozpoczyna wyrażenie regularne, a nie dzielenie
+JS_REGEX_AFTER = set("(,=:[!&|?{};+-*%<>~^")
+
+
+def skip_string(src, i):
+    quote = src[i]
+    i += 1
+    while i < len(src) and src[i] != quote:
+        i += 2 if src[i] == "\\" else 1
+    return i + 1
+
+
+def skip_template(src, i):
+    # `...${ wyrażenie }...` - zagnieżdżone nawiasy, napisy i szablony
+    i += 1
+    while i < len(src):
+        c = src[i]
+        if c == "\\":
+            i += 2
+        elif c == "`":
+            return i + 1
+        elif src.startswith("${", i):
+            depth = 1
+            i += 2
+            while i < len(src) and depth:
+                c = src[i]
+                if c in "'\"":
+                    i = skip_string(src, i)
+                elif c == "`":
+                    i = skip_template(src, i)
+                else:
+                    depth += {"{": 1, "}": -1}.get(c, 0)
+                    i += 1
+        else:
+            i += 1
+    return i
+
+
+def skip_regex(src, i):
+    i += 1
+    in_class = False
+    while i < len(src):
+        c = src[i]
+        if c == "\\":
+            i += 2
+            continue
+        if c == "[":
+            in_class = True
+        elif c == "]":
+            in_class = False
+        elif c == "/" and not in_class:
+            i += 1
+            while i < len(src) and (src[i].isalnum()):
+                i += 1
+            return i
+        i += 1
+    return i
+
+
+def minify_js(src):
+    out = []
+    i = 0
+    pending = None  # odstęp przed następnym elementem: " " lub "\n"
+
+    def last():
+        return out[-1][-1] if out else ""
+
+    def emit(text):
+        nonlocal pending
+        if pending and out:
+            prev, nxt = last(), text[0]
+            if pending == "\n":
+                keep = not (prev in JS_CONTINUES_AFTER or nxt in JS_CONTINUES_BEFORE)
+            else:
+                keep = not (prev in JS_PUNCTUATION or nxt in JS_PUNCTUATION)
+            if keep:
+                out.append(pending)
+        pending = None
+        out.append(text)
+
+    while i < len(src):
+        c = src[i]
+        if c in " \t\r\n":
+            j = i
+            while j < len(src) and src[j] in " \t\r\n":
+                j += 1
+            if pending != "\n":
+                pending = "\n" if "\n" in src[i:j] else " "
+            i = j
+        elif src.startswith("//", i):
+            j = src.find("\n", i)
+            i = len(src) if j < 0 else j
+        elif src.startswith("/*", i):
+            j = src.find("*/", i + 2)
+            i = len(src) if j < 0 else j + 2
+            if pending is None:
+                pending = " "
+        elif c in "'\"":
+            j = skip_string(src, i)
+            emit(src[i:j])
+            i = j
+        elif c == "`":
+            j = skip_template(src, i)
+            emit(src[i:j])
+            i = j
+        elif c == "/" and (not out or last() in JS_REGEX_AFTER or re.search(r"\b(return|typeof|case)$", out[-1])):
+            j = skip_regex(src, i)
+            emit(src[i:j])
+            i = j
+        else:
+            j = i + 1
+            if c.isalnum() or c in "_$":
+                while j < len(src) and (src[j].isalnum() or src[j] in "_$"):
+                    j += 1
+            emit(src[i:j])
+            i = j
+    return "".join(out) + "\n"
+
+
+def minify_css(src):
+    out = []
+    i = 0
+    while i < len(src):
+        c = src[i]
+        if src.startswith("/*", i):
+            j = src.find("*/", i + 2)
+            i = len(src) if j < 0 else j + 2
+        elif c in "'\"":
+            j = skip_string(src, i)
+            out.append(src[i:j])
+            i = j
+        elif c in " \t\r\n":
+            while i < len(src) and src[i] in " \t\r\n":
+                i += 1
+            out.append(" ")
+        else:
+            out.append(c)
+            i += 1
+    css = "".join(out)
+    css = re.sub(r" ?([{};,>]) ?", r"\1", css)
+    css = re.sub(r": ", ":", css)
+    css = css.replace(";}", "}")
+    return css.strip() + "\n"
+
+
+HTML_BLOCK = re.compile(
+    r"(<!--.*?-->|<script\b[^>]*>.*?</script>|<style\b[^>]*>.*?</style>"
+    r"|<pre\b.*?</pre>|<textarea\b.*?</textarea>|<[^>]*>)",
+    re.DOTALL | re.IGNORECASE,
+)
+
+
+def minify_html(src, rename):
+    out = []
+    for index, part in enumerate(HTML_BLOCK.split(src)):
+        if index % 2 == 0:
+            # Tekst między znacznikami - odstępy zwinięte do jednego znaku (także po usuniętym komentarzu)
+            part = re.sub(r"\s+", lambda m: "\n" if "\n" in m.group(0) else " ", part)
+            if out and out[-1][-1:] in (" ", "\n"):
+                part = part.lstrip()
+            out.append(part)
+            continue
+        lower = part.lower()
+        if lower.startswith("<!--"):
+            continue
+        if lower.startswith("<script") or lower.startswith("<style"):
+            open_end = part.index(">") + 1
+            close_start = part.rindex("</")
+            body = part[open_end:close_start]
+            body = minify_js(body) if lower.startswith("<script") else minify_css(body)
+            part = rename_refs(part[:open_end], rename) + body.strip() + part[close_start:]
+        elif not lower.startswith("<pre") and not lower.startswith("<textarea"):
+            part = rename_refs(part, rename)
+        out.append(part)
+    return "".join(out).strip() + "\n"
+
+
+def rename_refs(tag, rename):
+    for source, target in rename.items():
+        tag = re.sub(r'((?:href|src)=["\'])/?' + re.escape(source) + r'(["\'])', r"\g<1>" + target + r"\2", tag)
+    return tag
+
+
+# --- Wynik ---
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:8]
+
+
+def write_gzip(path, data):
+    buffer = io.BytesIO()
+    with gzip.GzipFile(filename="", mode="wb", fileobj=buffer, compresslevel=9, mtime=0) as archive:
+        archive.write(data)
+    with open(path, "wb") as output:
+        output.write(buffer.getvalue())
+    return len(buffer.getvalue())
+
+
+def read_source(name):
+    with open(os.path.join(SOURCE_DIR, name), encoding="utf-8") as source:
+        return source.read()
+
+
+def build():
+    if os.path.isdir(OUTPUT_DIR):
+        shutil.rmtree(OUTPUT_DIR)
+    os.makedirs(OUTPUT_DIR)
+
+    manifest = []
+    rename = {}
+    total_source = 0
+    total_output = 0
+
+    for name, content_type in ASSETS:
+        source = read_source(name)
+        minify = minify_css if name.endswith(".css") else minify_js
+        data = minify(source).encode("utf-8")
+        digest = content_hash(data)
+        stem, extension = os.path.splitext(name)
+        target = "%s.%s%s" % (stem, digest, extension)
+        rename[name] = target
+
+        total_source += len(source.encode("utf-8"))
+        total_output += write_gzip(os.path.join(OUTPUT_DIR, target + ".gz"), data)
+        manifest.append(("/" + target, "/www/" + target + ".gz", digest, IMMUTABLE_MAX_AGE, content_type))
+
+    # index.html pod stałym adresem: bez przechowywania, sprawdzany przez ETag (304)
+    name, content_type = INDEX
+    source = read_source(name)
+    data = minify_html(source, rename).encode("utf-8")
+    digest = content_hash(data)
+    total_source += len(source.encode("utf-8"))
+    total_output += write_gzip(os.path.join(OUTPUT_DIR, name + ".gz"), data)
+    for uri in ("/", "/" + name):
+        manifest.append((uri, "/www/" + name + ".gz", digest, 0, content_type))
+
+    with open(os.path.join(OUTPUT_DIR, "manifest.txt"), "w", encoding="utf-8", newline="\n") as output:
+        for entry in manifest:
+            output.write("%s %s %s %d %s\n" % entry)
+
+    print("Interfejs webowy: %d B -> %d B (gzip) w %s" % (total_source, total_output, OUTPUT_DIR))
+
+
+build()
@@ -105,7 +105,10 @@ async function saveLightConfig() {
                 nightLights: document.getElementById('night-lights'),
                 dayBlink: document.getElementById('day-blink'),
                 nightBlink: document.getElementById('night-blink'),
-                blinkFrequency: document.getElementById('blink-frequency')
+                blinkFrequency: document.getElementById('blink-frequency'),
+                dayBrightness: document.getElementById('light-day-brightness'),
+                nightBrightness: document.getElementById('light-night-brightness'),
+                rampMs: document.getElementById('light-ramp')
             };
 
             const lightConfig = {
@@ -113,7 +116,10 @@ async function saveLightConfig() {
                 nightLights: getLightMode(elements.nightLights.value),
                 dayBlink: elements.dayBlink.checked,
                 nightBlink: elements.nightBlink.checked,
-                blinkFrequency: parseInt(elements.blinkFrequency.value)
+                blinkFrequency: parseInt(elements.blinkFrequency.value),
+                dayBrightness: parseInt(elements.dayBrightness.value),
+                nightBrightness: parseInt(elements.nightBrightness.value),
+                rampMs: parseInt(elements.rampMs.value)
             };
 
             debug('Przygotowane dane:', lightConfig);
@@ -174,7 +180,10 @@ async function loadLightConfig() {
                     nightLights: document.getElementById('night-lights'),
                     dayBlink: document.getElementById('day-blink'),
                     nightBlink: document.getElementById('night-blink'),
-                    blinkFrequency: document.getElementById('blink-frequency')
+                    blinkFrequency: document.getElementById('blink-frequency'),
+                    dayBrightness: document.getElementById('light-day-brightness'),
+                    nightBrightness: document.getElementById('light-night-brightness'),
+                    rampMs: document.getElementById('light-ramp')
                 };
 
                 elements.dayLights.value = getFormValue(data.lights.dayLights, false);
@@ -182,6 +191,9 @@ async function loadLightConfig() {
                 elements.dayBlink.checked = Boolean(data.lights.dayBlink);
                 elements.nightBlink.checked = Boolean(data.lights.nightBlink);
                 elements.blinkFrequency.value = data.lights.blinkFrequency || 500;
+                elements.dayBrightness.value = data.lights.dayBrightness ?? 100;
+                elements.nightBrightness.value = data.lights.nightBrightness ?? 100;
+                elements.rampMs.value = data.lights.rampMs ?? 300;
 
                 debug('Formularz zaktualizowany pomyślnie');
             }
@@ -377,6 +389,7 @@ async function manualRTCSync() {
 // Globalne zmienne dla WebSocket
 let ws = null;
 let wsRetryCount = 0;
+let wsRejected = false;      // Serwer odrzucił połączenie (limit klientów) - bez ponawiania
 const WS_MAX_RETRY = 5;
 const WS_MESSAGE_QUEUE = [];
 const WS_MAX_QUEUE_SIZE = 100; // Maksymalna wielkość kolejki wiadomości
@@ -432,18 +445,29 @@ function setupWebSocket() {
     function connect() {
         try {
             ws = new WebSocket('ws://' + window.location.hostname + '/ws');
+            ws.binaryType = 'arraybuffer';
             
             ws.onopen = () => {
                 debug('WebSocket połączony');
                 wsRetryCount = 0; // Reset licznika prób
                 sendQueuedMessages(); // Wyślij zabuforowane wiadomości
                 fetchCurrentState(); // Pobierz aktualny stan
+                subscribeTelemetry();
             };
 
             ws.onmessage = (event) => {
+                if (event.data instanceof ArrayBuffer) {
+                    handleTelemetryFrame(event.data);
+                    return;
+                }
                 try {
                     const data = JSON.parse(event.data);
                     debug('Otrzymano dane WebSocket:', data);
+                    if (data.error === 'tooManyClients') {
+                        wsRejected = true;
+                        showMessage('error', `Dane na żywo niedostępne - połączonych jest już ${data.maxClients} klientów`);
+                        return;
+                    }
                     if (data.lights) {
                         updateLightStatus(data.lights);
                         updateLightForm(data.lights);
@@ -455,6 +479,7 @@ function setupWebSocket() {
 
             ws.onclose = (event) => {
                 debug(`WebSocket rozłączony (kod: ${event.code})`);
+                if (wsRejected) return;
                 
                 if (wsRetryCount < WS_MAX_RETRY) {
                     const delay = getRetryDelay();
@@ -483,6 +508,123 @@ function setupWebSocket() {
     connect();
 }
 
+// --- Dane na żywo (binarne ramki WebSocket) ---
+
+// Pola w kolejności bitów maski: [nazwa, rozmiar w B, dekoder]
+const TELEMETRY_FIELDS = [
+    ['speed', 2, (v, o) => v.getUint16(o, true) / 10],
+    ['cadence', 2, (v, o) => v.getUint16(o, true)],
+    ['power', 2, (v, o) => v.getInt16(o, true)],
+    ['voltage', 2, (v, o) => v.getUint16(o, true) / 100],
+    ['current', 2, (v, o) => v.getInt16(o, true) / 100],
+    ['battery', 1, (v, o) => v.getUint8(o)],
+    ['temperature', 2, (v, o) => v.getInt16(o, true) / 10],
+    ['tempController', 2, (v, o) => v.getInt16(o, true) / 10],
+    ['tempMotor', 2, (v, o) => v.getInt16(o, true) / 10],
+    ['range', 2, (v, o) => v.getUint16(o, true) / 10],
+    ['distance', 4, (v, o) => v.getUint32(o, true) / 1000],
+    ['cells', 1 + 32 * 2, (v, o) => readList(v, o, (x, p) => x.getUint16(p, true) / 1000)],
+    ['bmsTemps', 1 + 8 * 2, (v, o) => readList(v, o, (x, p) => x.getInt16(p, true) / 10)],
+    ['pressure', 4, (v, o) => [v.getUint16(o, true) / 100, v.getUint16(o + 2, true) / 100]],
+    ['time', 4, (v, o) => v.getUint32(o, true)]
+];
+const TELEMETRY_MAGIC = 0x54;       // 'T'
+const TELEMETRY_KEYFRAME = 0x01;
+const TELEMETRY_RATE_HZ = 5;
+const POWER_HISTORY_LENGTH = 150;   // 30 s przy 5 Hz
+
+const liveTelemetry = {};
+const powerHistory = [];
+let telemetrySynced = false;
+
+function readList(view, offset, read) {
+    const count = view.getUint8(offset);
+    const values = [];
+    for (let i = 0; i < count; i++) {
+        values.push(read(view, offset + 1 + i * 2));
+    }
+    return values;
+}
+
+function subscribeTelemetry() {
+    if (!document.getElementById('live-speed')) return;
+    telemetrySynced = false;
+    window.wsSend(JSON.stringify({
+        subscribe: ['speed', 'power', 'voltage', 'current', 'battery', 'cells'],
+        rate: TELEMETRY_RATE_HZ,
+        format: 'binary'
+    }));
+}
+
+// Nagłówek: magic (1B), flagi (1B), numer ramki (2B), maska pól (4B)
+function handleTelemetryFrame(buffer) {
+    const view = new DataView(buffer);
+    if (view.byteLength < 8 || view.getUint8(0) !== TELEMETRY_MAGIC) return;
+
+    const flags = view.getUint8(1);
+    const mask = view.getUint32(4, true);
+
+    // Ramki różnicowe mają sens dopiero po pierwszej ramce pełnej
+    if (flags & TELEMETRY_KEYFRAME) telemetrySynced = true;
+    if (!telemetrySynced) return;
+
+    let offset = 8;
+    TELEMETRY_FIELDS.forEach(([name, size, decode], bit) => {
+        if (!(mask & (1 << bit))) return;
+        if (offset + size > view.byteLength) return;
+        liveTelemetry[name] = decode(view, offset);
+        offset += size;
+    });
+
+    if (liveTelemetry.power !== undefined) {
+        powerHistory.push(liveTelemetry.power);
+        if (powerHistory.length > POWER_HISTORY_LENGTH) powerHistory.shift();
+    }
+    updateLiveView();
+}
+
+function updateLiveView() {
+    const t = liveTelemetry;
+    const speed = document.getElementById('live-speed');
+    if (!speed) return;
+
+    if (t.speed !== undefined) speed.textContent = `${t.speed.toFixed(1)} km/h`;
+    if (t.power !== undefined) document.getElementById('live-power').textContent = `${t.power} W`;
+    if (t.voltage !== undefined) {
+        const current = t.current !== undefined ? ` / ${t.current.toFixed(2)} A` : '';
+        const soc = t.battery !== undefined ? ` (${t.battery}%)` : '';
+        document.getElementById('live-battery').textContent = `${t.voltage.toFixed(2)} V${current}${soc}`;
+    }
+
+    const cells = document.getElementById('live-cells');
+    if (t.cells) {
+        cells.innerHTML = t.cells.map((v, i) => `<span>${i + 1}: ${v.toFixed(3)}</span>`).join('');
+    }
+
+    drawPowerChart();
+}
+
+function drawPowerChart() {
+    const canvas = document.getElementById('live-power-chart');
+    if (!canvas || powerHistory.length < 2) return;
+
+    const ctx = canvas.getContext('2d');
+    const max = Math.max(100, ...powerHistory.map(Math.abs));
+    const step = canvas.width / (POWER_HISTORY_LENGTH - 1);
+
+    ctx.clearRect(0, 0, canvas.width, canvas.height);
+    ctx.strokeStyle = getComputedStyle(document.documentElement).getPropertyValue('--primary-color') || '#2196F3';
+    ctx.lineWidth = 2;
+    ctx.beginPath();
+    powerHistory.forEach((value, i) => {
+        const x = i * step;
+        const y = canvas.height - (Math.max(0, value) / max) * (canvas.height - 4) - 2;
+        if (i === 0) ctx.moveTo(x, y);
+        else ctx.lineTo(x, y);
+    });
+    ctx.stroke();
+}
+
 // Dodaj nasłuchiwanie na zdarzenie online/offline
 window.addEventListener('online', () => {
     debug('Połączenie internetowe przywrócone');
@@ -592,6 +734,9 @@ async function fetchLightConfig() {
             document.getElementById('day-blink').checked = data.lights.dayBlink;
             document.getElementById('night-blink').checked = data.lights.nightBlink;
             document.getElementById('blink-frequency').value = data.lights.blinkFrequency;
+            document.getElementById('light-day-brightness').value = data.lights.dayBrightness;
+            document.getElementById('light-night-brightness').value = data.lights.nightBrightness;
+            document.getElementById('light-ramp').value = data.lights.rampMs;
         }
     } catch (error) {
         console.error('Błąd podczas pobierania konfiguracji świateł:', error);
@@ -604,7 +749,10 @@ function setupFormListeners() {
         'night-lights',
         'day-blink',
         'night-blink',
-        'blink-frequency'
+        'blink-frequency',
+        'light-day-brightness',
+        'light-night-brightness',
+        'light-ramp'
     ];
 
     formElements.forEach(elementId => {
@@ -648,7 +796,10 @@ function getLightFormElements() {
         nightLights: document.getElementById('night-lights'),
         dayBlink: document.getElementById('day-blink'),
         nightBlink: document.getElementById('night-blink'),
-        blinkFrequency: document.getElementById('blink-frequency')
+        blinkFrequency: document.getElementById('blink-frequency'),
+        dayBrightness: document.getElementById('light-day-brightness'),
+        nightBrightness: document.getElementById('light-night-brightness'),
+        rampMs: document.getElementById('light-ramp')
     };
 
     const missing = Object.entries(elements)
@@ -724,7 +875,10 @@ function updateLightForm(lights) {
             nightLights: document.getElementById('night-lights'),
             dayBlink: document.getElementById('day-blink'),
             nightBlink: document.getElementById('night-blink'),
-            blinkFrequency: document.getElementById('blink-frequency')
+            blinkFrequency: document.getElementById('blink-frequency'),
+            dayBrightness: document.getElementById('light-day-brightness'),
+            nightBrightness: document.getElementById('light-night-brightness'),
+            rampMs: document.getElementById('light-ramp')
         };
 
         // Konwersja LightMode na wartość selecta
@@ -747,6 +901,9 @@ function updateLightForm(lights) {
         elements.dayBlink.checked = lights.dayBlink;
         elements.nightBlink.checked = lights.nightBlink;
         elements.blinkFrequency.value = lights.blinkFrequency || 500;
+        elements.dayBrightness.value = lights.dayBrightness ?? 100;
+        elements.nightBrightness.value = lights.nightBrightness ?? 100;
+        elements.rampMs.value = lights.rampMs ?? 300;
 
         debug('Formularz zaktualizowany pomyślnie');
     } catch (error) {
@@ -1133,6 +1290,20 @@ const infoContent = {
     Mniejsza wartość oznacza szybsze mruganie, a większa - wolniejsze. Zakres: 100-2000ms.`
     },
 
+    'light-brightness-info': {
+        title: '💡 Jasność świateł',
+        description: `Jasność przednich i tylnego światła osobno dla trybu dziennego i nocnego (0-100%).
+
+    Mrugające tylne światło zawsze świeci z pełną jasnością.`
+    },
+
+    'light-ramp-info': {
+        title: '🌅 Płynne włączanie',
+        description: `Czas płynnego rozjaśniania i ściemniania świateł przy zmianie trybu w milisekundach.
+
+    0 - włączanie natychmiastowe. Zakres: 0-2000ms.`
+    },
+
     // Sekcja wyświetlacza //
 
     'display-config-info': {